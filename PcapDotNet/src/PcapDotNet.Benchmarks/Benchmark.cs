@@ -0,0 +1,39 @@
+﻿using System;
+using System.Diagnostics;
+using System.Globalization;
+
+namespace PcapDotNet.Benchmarks
+{
+    /// <summary>
+    /// Times an optimized code path against the code path it replaces and prints both times.
+    /// </summary>
+    internal abstract class Benchmark
+    {
+        public abstract string Name { get; }
+
+        public abstract void Run();
+
+        protected static void Compare(string baselineName, Action baseline, string optimizedName, Action optimized)
+        {
+            // Run both once first, so JIT compilation isn't timed.
+            baseline();
+            optimized();
+
+            TimeSpan baselineTime = Measure(baseline);
+            TimeSpan optimizedTime = Measure(optimized);
+            Console.WriteLine(string.Format(CultureInfo.InvariantCulture, "  {0}: {1:0.000} ms", baselineName, baselineTime.TotalMilliseconds));
+            Console.WriteLine(string.Format(CultureInfo.InvariantCulture, "  {0}: {1:0.000} ms ({2:0.00}x)", optimizedName, optimizedTime.TotalMilliseconds,
+                                            baselineTime.TotalMilliseconds / optimizedTime.TotalMilliseconds));
+        }
+
+        private static TimeSpan Measure(Action action)
+        {
+            GC.Collect();
+            GC.WaitForPendingFinalizers();
+            Stopwatch stopwatch = Stopwatch.StartNew();
+            action();
+            stopwatch.Stop();
+            return stopwatch.Elapsed;
+        }
+    }
+}
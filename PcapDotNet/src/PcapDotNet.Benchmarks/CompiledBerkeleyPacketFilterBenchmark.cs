@@ -0,0 +1,57 @@
+﻿using System;
+using System.Linq;
+using PcapDotNet.Core;
+using PcapDotNet.Packets;
+using PcapDotNet.Packets.Ethernet;
+using PcapDotNet.Packets.IpV4;
+using PcapDotNet.Packets.TestUtils;
+
+namespace PcapDotNet.Benchmarks
+{
+    /// <summary>
+    /// The interpreted filter against the same filter compiled to IL.
+    /// </summary>
+    internal sealed class CompiledBerkeleyPacketFilterBenchmark : Benchmark
+    {
+        public override string Name
+        {
+            get { return "CompiledBerkeleyPacketFilter"; }
+        }
+
+        public override void Run()
+        {
+            const int NumPackets = 1000;
+            const int NumRounds = 100;
+
+            Random random = new Random();
+            Packet[] packets = Enumerable.Range(0, NumPackets).Select(i => new PacketBuilder(random.NextEthernetLayer(EthernetType.None), random.NextIpV4Layer(IpV4Protocol.Tcp),
+                                                                                             random.NextTcpLayer(), random.NextPayloadLayer(100)).Build(DateTime.Now)).ToArray();
+
+            using (BerkeleyPacketFilter filter = new BerkeleyPacketFilter("ip and tcp and (port 80 or port 443) and tcp[tcpflags] & tcp-syn != 0", PacketDevice.DefaultSnapshotLength,
+                                                                          DataLinkKind.Ethernet))
+            {
+                CompiledBerkeleyPacketFilter compiledFilter = new CompiledBerkeleyPacketFilter(filter);
+                if (!compiledFilter.IsCompiled)
+                    throw new InvalidOperationException("The filter wasn't compiled");
+
+                Console.WriteLine("  " + NumPackets * NumRounds + " packets");
+                Compare("Interpreted", () => FilterPackets(packets, NumRounds, packet => filter.Test(packet)),
+                        "Compiled", () => FilterPackets(packets, NumRounds, packet => compiledFilter.Test(packet)));
+            }
+        }
+
+        private static int FilterPackets(Packet[] packets, int numRounds, Func<Packet, bool> test)
+        {
+            int matches = 0;
+            for (int round = 0; round != numRounds; ++round)
+            {
+                foreach (Packet packet in packets)
+                {
+                    if (test(packet))
+                        ++matches;
+                }
+            }
+            return matches;
+        }
+    }
+}
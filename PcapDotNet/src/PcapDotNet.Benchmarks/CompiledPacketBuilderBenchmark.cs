@@ -0,0 +1,43 @@
+﻿using System;
+using PcapDotNet.Packets;
+using PcapDotNet.Packets.Ethernet;
+using PcapDotNet.Packets.IpV4;
+using PcapDotNet.Packets.Transport;
+
+namespace PcapDotNet.Benchmarks
+{
+    /// <summary>
+    /// Building UDP packets one by one against building them back to back with a compiled builder.
+    /// </summary>
+    internal sealed class CompiledPacketBuilderBenchmark : Benchmark
+    {
+        public override string Name
+        {
+            get { return "CompiledPacketBuilder"; }
+        }
+
+        public override void Run()
+        {
+            const int NumPackets = 100000;
+
+            UdpLayer udpLayer = new UdpLayer {CalculateChecksumValue = true};
+            PacketBuilder packetBuilder = new PacketBuilder(new EthernetLayer(), new IpV4Layer(), udpLayer, new PayloadLayer {Data = new Datagram(new byte[100])});
+            CompiledPacketBuilder compiledBuilder = packetBuilder.Compile();
+
+            byte[] buffer = new byte[NumPackets * compiledBuilder.Length];
+            int[] offsets = new int[NumPackets];
+            int[] lengths = new int[NumPackets];
+
+            Console.WriteLine("  " + NumPackets + " packets");
+            Compare("PacketBuilder.Build", () =>
+                                           {
+                                               for (int i = 0; i != NumPackets; ++i)
+                                               {
+                                                   udpLayer.SourcePort = (ushort)i;
+                                                   packetBuilder.Build(DateTime.Now);
+                                               }
+                                           },
+                    "CompiledPacketBuilder.BuildMany", () => compiledBuilder.BuildMany(buffer, 0, NumPackets, i => udpLayer.SourcePort = (ushort)i, offsets, lengths));
+        }
+    }
+}
@@ -0,0 +1,68 @@
+﻿using System;
+using PcapDotNet.Packets;
+using PcapDotNet.Packets.Ethernet;
+using PcapDotNet.Packets.Filtering;
+using PcapDotNet.Packets.Http;
+using PcapDotNet.Packets.IpV4;
+using PcapDotNet.Packets.Transport;
+
+namespace PcapDotNet.Benchmarks
+{
+    /// <summary>
+    /// The compiled display filter predicate against the same condition written by hand.
+    /// </summary>
+    internal sealed class DisplayFilterBenchmark : Benchmark
+    {
+        public override string Name
+        {
+            get { return "DisplayFilter"; }
+        }
+
+        public override void Run()
+        {
+            const int NumPackets = 1000000;
+
+            Packet[] packets = {BuildHttpRequest("POST", 500), BuildHttpRequest("GET", 2000)};
+            DisplayFilter filter = new DisplayFilter("tcp.window_size < 1000 && http.request.method == \"POST\"");
+
+            Console.WriteLine("  " + NumPackets + " packets");
+            Compare("Hand written", () => FilterPackets(packets, NumPackets, IsSmallWindowPost),
+                    "Display filter", () => FilterPackets(packets, NumPackets, filter.Predicate));
+        }
+
+        private static bool IsSmallWindowPost(Packet packet)
+        {
+            TcpDatagram tcp = DisplayFilterLayers.GetTcp(packet);
+            if (tcp == null || tcp.Window >= 1000)
+                return false;
+            HttpRequestDatagram http = DisplayFilterLayers.GetHttpRequest(packet);
+            return http != null && http.Method != null && http.Method.Method == "POST";
+        }
+
+        private static int FilterPackets(Packet[] packets, int numPackets, Func<Packet, bool> predicate)
+        {
+            int matches = 0;
+            for (int i = 0; i != numPackets; ++i)
+            {
+                if (predicate(packets[i % packets.Length]))
+                    ++matches;
+            }
+            return matches;
+        }
+
+        private static Packet BuildHttpRequest(string method, ushort window)
+        {
+            return PacketBuilder.Build(DateTime.Now,
+                                       new EthernetLayer(),
+                                       new IpV4Layer {Source = new IpV4Address("10.1.2.3"), CurrentDestination = new IpV4Address("192.168.0.1"), Ttl = 64},
+                                       new TcpLayer {SourcePort = 1234, DestinationPort = 80, Window = window, ControlBits = TcpControlBits.Synchronize},
+                                       new HttpRequestLayer
+                                       {
+                                           Method = new HttpRequestMethod(method),
+                                           Uri = "/upload",
+                                           Version = HttpVersion.Version11,
+                                           Header = new HttpHeader(),
+                                       });
+        }
+    }
+}
@@ -0,0 +1,56 @@
+﻿using System;
+using PcapDotNet.Packets;
+using PcapDotNet.Packets.Ethernet;
+using PcapDotNet.Packets.IpV4;
+using PcapDotNet.Packets.Transport;
+
+namespace PcapDotNet.Benchmarks
+{
+    /// <summary>
+    /// Writing packets from a template with changing fields against building every packet from its layers.
+    /// </summary>
+    internal sealed class PacketTemplateBenchmark : Benchmark
+    {
+        public override string Name
+        {
+            get { return "PacketTemplate"; }
+        }
+
+        public override void Run()
+        {
+            const int NumPackets = 1000000;
+            const int NumBufferPackets = 100;
+
+            EthernetLayer ethernetLayer = new EthernetLayer();
+            IpV4Layer ipV4Layer = new IpV4Layer {Source = new IpV4Address("10.0.0.1"), Ttl = 64};
+            TcpLayer tcpLayer = new TcpLayer {ControlBits = TcpControlBits.Synchronize};
+            PayloadLayer payloadLayer = new PayloadLayer {Data = new Datagram(new byte[1000])};
+
+            PacketBuilder builder = new PacketBuilder(ethernetLayer, ipV4Layer, tcpLayer, payloadLayer);
+            PacketTemplate template = new PacketTemplate(ethernetLayer, ipV4Layer, tcpLayer, payloadLayer);
+            PacketTemplateField source = template.DeclareField(PacketTemplateFieldKind.IpV4Source);
+            PacketTemplateField port = template.DeclareField(PacketTemplateFieldKind.TransportSourcePort);
+            byte[] buffer = new byte[template.Length * NumBufferPackets];
+
+            Console.WriteLine("  " + NumPackets + " packets");
+            Compare("PacketBuilder.Build", () =>
+                                           {
+                                               for (int i = 0; i != NumPackets; ++i)
+                                               {
+                                                   ipV4Layer.Source = new IpV4Address((uint)i);
+                                                   tcpLayer.SourcePort = (ushort)i;
+                                                   builder.Build(DateTime.Now);
+                                               }
+                                           },
+                    "PacketTemplate.Write", () =>
+                                            {
+                                                for (int i = 0; i != NumPackets; ++i)
+                                                {
+                                                    source.Value = (uint)i;
+                                                    port.Value = (uint)(i & 0xFFFF);
+                                                    template.Write(buffer, i % NumBufferPackets * template.Length);
+                                                }
+                                            });
+        }
+    }
+}
@@ -0,0 +1,31 @@
+﻿using System;
+using System.Linq;
+
+namespace PcapDotNet.Benchmarks
+{
+    internal static class Program
+    {
+        private static readonly Benchmark[] Benchmarks =
+        {
+            new CompiledBerkeleyPacketFilterBenchmark(),
+            new CompiledPacketBuilderBenchmark(),
+            new DisplayFilterBenchmark(),
+            new PacketTemplateBenchmark(),
+            new Sum16BitsBenchmark(),
+            new TcpSegmenterBenchmark(),
+        };
+
+        /// <summary>
+        /// Runs the benchmarks named in the arguments, or all of them when there are no arguments.
+        /// Should be run from a release build without a debugger attached.
+        /// </summary>
+        private static void Main(string[] args)
+        {
+            foreach (Benchmark benchmark in Benchmarks.Where(benchmark => args.Length == 0 || args.Contains(benchmark.Name, StringComparer.OrdinalIgnoreCase)))
+            {
+                Console.WriteLine(benchmark.Name);
+                benchmark.Run();
+            }
+        }
+    }
+}
@@ -0,0 +1,72 @@
+﻿using System;
+using System.Collections.Generic;
+using PcapDotNet.Packets;
+using PcapDotNet.Packets.Ethernet;
+using PcapDotNet.Packets.IpV4;
+using PcapDotNet.Packets.TestUtils;
+using PcapDotNet.Packets.Transport;
+using PcapDotNet.TestUtils;
+
+namespace PcapDotNet.Benchmarks
+{
+    /// <summary>
+    /// Validating the UDP checksum of jumbo frames against a naive byte by byte sum of the same bytes.
+    /// </summary>
+    internal sealed class Sum16BitsBenchmark : Benchmark
+    {
+        public override string Name
+        {
+            get { return "Sum16Bits"; }
+        }
+
+        public override void Run()
+        {
+            const int NumPackets = 100;
+            const int Iterations = 100;
+            const int TransportOffset = EthernetDatagram.HeaderLengthValue + IpV4Datagram.HeaderMinimumLength;
+
+            // Odd and even payload lengths around a 9000 bytes MTU.
+            Random random = new Random();
+            List<Packet> packets = new List<Packet>();
+            for (int i = 0; i != NumPackets; ++i)
+            {
+                packets.Add(PacketBuilder.Build(DateTime.Now, new EthernetLayer(), new IpV4Layer(),
+                                                new UdpLayer {SourcePort = random.NextUShort(), DestinationPort = random.NextUShort(), CalculateChecksumValue = true},
+                                                random.NextPayloadLayer(9000 - 20 - 8 + i % 2)));
+            }
+
+            Console.WriteLine("  " + NumPackets * Iterations + " jumbo frames");
+            Compare("Reference sum", () =>
+                                     {
+                                         uint sum = 0;
+                                         for (int i = 0; i != Iterations; ++i)
+                                         {
+                                             foreach (Packet packet in packets)
+                                                 sum += Sum16Bits(packet.Buffer, TransportOffset, packet.Length - TransportOffset);
+                                         }
+                                     },
+                    "IsTransportChecksumCorrect", () =>
+                                                  {
+                                                      for (int i = 0; i != Iterations; ++i)
+                                                      {
+                                                          // A new packet for every validation, so the cached checksum result isn't reused.
+                                                          foreach (Packet packet in packets)
+                                                          {
+                                                              if (!new Packet(packet.Buffer, packet.Timestamp, DataLinkKind.Ethernet).Ethernet.IpV4.IsTransportChecksumCorrect)
+                                                                  throw new InvalidOperationException("Wrong checksum");
+                                                          }
+                                                      }
+                                                  });
+        }
+
+        private static uint Sum16Bits(byte[] buffer, int offset, int length)
+        {
+            uint sum = 0;
+            for (int i = 0; i < length - 1; i += 2)
+                sum += (uint)((buffer[offset + i] << 8) + buffer[offset + i + 1]);
+            if (length % 2 == 1)
+                sum += (uint)(buffer[offset + length - 1] << 8);
+            return sum;
+        }
+    }
+}
@@ -0,0 +1,47 @@
+﻿using System;
+using PcapDotNet.Packets;
+using PcapDotNet.Packets.Ethernet;
+using PcapDotNet.Packets.IpV4;
+using PcapDotNet.Packets.Transport;
+using PcapDotNet.TestUtils;
+
+namespace PcapDotNet.Benchmarks
+{
+    /// <summary>
+    /// Segmenting a large payload with a segmenter against building every segment from its layers.
+    /// </summary>
+    internal sealed class TcpSegmenterBenchmark : Benchmark
+    {
+        public override string Name
+        {
+            get { return "TcpSegmenter"; }
+        }
+
+        public override void Run()
+        {
+            const int MaximumSegmentSize = 1460;
+
+            EthernetLayer ethernetLayer = new EthernetLayer();
+            IpV4Layer ipV4Layer = new IpV4Layer();
+            TcpLayer tcpLayer = new TcpLayer {ControlBits = TcpControlBits.Acknowledgment};
+            byte[] payload = new Random().NextBytes(10 * 1024 * 1024);
+
+            Console.WriteLine("  " + payload.Length + " bytes in " + (payload.Length + MaximumSegmentSize - 1) / MaximumSegmentSize + " segments");
+            Compare("PacketBuilder.Build", () =>
+                                           {
+                                               for (int offset = 0; offset < payload.Length; offset += MaximumSegmentSize)
+                                               {
+                                                   byte[] segmentPayload = new byte[Math.Min(MaximumSegmentSize, payload.Length - offset)];
+                                                   Buffer.BlockCopy(payload, offset, segmentPayload, 0, segmentPayload.Length);
+                                                   tcpLayer.SequenceNumber = (uint)offset;
+                                                   PacketBuilder.Build(DateTime.Now, ethernetLayer, ipV4Layer, tcpLayer, new PayloadLayer {Data = new Datagram(segmentPayload)});
+                                               }
+                                           },
+                    "TcpSegmenter.Segment", () =>
+                                            {
+                                                tcpLayer.SequenceNumber = 0;
+                                                new TcpSegmenter(ethernetLayer, ipV4Layer, tcpLayer).Segment(DateTime.Now, payload, MaximumSegmentSize);
+                                            });
+        }
+    }
+}
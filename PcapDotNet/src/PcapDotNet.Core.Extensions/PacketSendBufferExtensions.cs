@@ -0,0 +1,43 @@
+﻿using System;
+using PcapDotNet.Packets;
+
+namespace PcapDotNet.Core.Extensions
+{
+    /// <summary>
+    /// Extension methods for PacketSendBuffer class.
+    /// <seealso cref="PacketSendBuffer"/>
+    /// </summary>
+    public static class PacketSendBufferExtensions
+    {
+        /// <summary>
+        /// Adds packets generated from a template at the end of the send buffer.
+        /// Before each packet is added, the given callback sets the values of the template fields for that packet.
+        /// Each packet is written directly into the send buffer, so no memory is allocated per packet.
+        /// </summary>
+        /// <param name="sendBuffer">The send buffer to add the packets to.</param>
+        /// <param name="template">The template to generate the packets from.</param>
+        /// <param name="count">The number of packets to add.</param>
+        /// <param name="setFields">Called with the template and the index of the packet before generating each packet.</param>
+        /// <param name="timestamp">The timestamp of all the packets, used to synchronize the packets when transmitting with isSync.</param>
+        /// <exception cref="ArgumentNullException">The send buffer, the template or the callback is null.</exception>
+        /// <exception cref="ArgumentOutOfRangeException">The count is negative.</exception>
+        /// <exception cref="InvalidOperationException">Thrown on failure.</exception>
+        public static void Enqueue(this PacketSendBuffer sendBuffer, PacketTemplate template, int count, Action<PacketTemplate, int> setFields, DateTime timestamp)
+        {
+            if (sendBuffer == null)
+                throw new ArgumentNullException("sendBuffer");
+            if (template == null)
+                throw new ArgumentNullException("template");
+            if (setFields == null)
+                throw new ArgumentNullException("setFields");
+            if (count < 0)
+                throw new ArgumentOutOfRangeException("count", count, "Must be non negative");
+
+            for (int i = 0; i != count; ++i)
+            {
+                setFields(template, i);
+                sendBuffer.Enqueue(template, timestamp);
+            }
+        }
+    }
+}
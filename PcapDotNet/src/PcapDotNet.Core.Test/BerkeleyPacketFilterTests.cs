@@ -1,8 +1,15 @@
 using System;
+using System.Collections;
+using System.Collections.Generic;
 using System.Diagnostics.CodeAnalysis;
+using System.IO;
+using System.Linq;
 using Microsoft.VisualStudio.TestTools.UnitTesting;
 using PcapDotNet.Packets;
+using PcapDotNet.Packets.Ethernet;
+using PcapDotNet.Packets.IpV4;
 using PcapDotNet.Packets.TestUtils;
+using PcapDotNet.Packets.Transport;
 
 namespace PcapDotNet.Core.Test
 {
@@ -114,6 +121,24 @@ namespace PcapDotNet.Core.Test
             }
         }
 
+        [TestMethod]
+        public void TestEmptySegmentTest()
+        {
+            // An empty packet that starts at the end of its buffer.
+            Packet packet = new Packet(new byte[10], 10, 0, DateTime.Now, new DataLink(DataLinkKind.Ethernet));
+
+            using (BerkeleyPacketFilter filter = new BerkeleyPacketFilter("len == 0", PacketDevice.DefaultSnapshotLength, DataLinkKind.Ethernet))
+            {
+                Assert.IsTrue(filter.Test(packet));
+                int[] snapshotLengths;
+                Assert.IsTrue(filter.TestMany(out snapshotLengths, new[] {packet})[0]);
+            }
+            using (BerkeleyPacketFilter filter = new BerkeleyPacketFilter("ip", PacketDevice.DefaultSnapshotLength, DataLinkKind.Ethernet))
+            {
+                Assert.IsFalse(filter.Test(packet));
+            }
+        }
+
         [TestMethod]
         [ExpectedException(typeof(ArgumentNullException), AllowDerivedTypes = false)]
         public void TestNullTest()
@@ -125,6 +150,383 @@ namespace PcapDotNet.Core.Test
             Assert.Fail();
         }
 
+        [TestMethod]
+        public void TestManyTest()
+        {
+            Random random = new Random();
+            List<Packet> packets = new List<Packet>();
+            for (int i = 0; i != 100; ++i)
+            {
+                packets.Add(new PacketBuilder(random.NextEthernetLayer(EthernetType.None), random.NextIpV4Layer(null), random.NextUdpLayer(),
+                                              random.NextPayloadLayer(random.Next(200))).Build(DateTime.Now));
+            }
+
+            using (BerkeleyPacketFilter filter = new BerkeleyPacketFilter("udp and len > 100", 150, DataLinkKind.Ethernet))
+            {
+                int[] snapshotLengths;
+                BitArray matches = filter.TestMany(out snapshotLengths, packets);
+                Assert.AreEqual(packets.Count, matches.Count);
+                Assert.AreEqual(packets.Count, snapshotLengths.Length);
+
+                byte[] buffer = packets.SelectMany(packet => packet.Buffer).ToArray();
+                int[] lengths = packets.Select(packet => packet.Length).ToArray();
+                int[] offsets = new int[lengths.Length];
+                for (int i = 1; i != offsets.Length; ++i)
+                    offsets[i] = offsets[i - 1] + lengths[i - 1];
+                int[] bufferSnapshotLengths;
+                BitArray bufferMatches = filter.TestMany(out bufferSnapshotLengths, buffer, offsets, lengths);
+
+                for (int i = 0; i != packets.Count; ++i)
+                {
+                    int expectedSnapshotLength;
+                    Assert.AreEqual(filter.Test(out expectedSnapshotLength, packets[i]), matches[i]);
+                    Assert.AreEqual(expectedSnapshotLength, snapshotLengths[i]);
+                    Assert.AreEqual(matches[i], bufferMatches[i]);
+                    Assert.AreEqual(snapshotLengths[i], bufferSnapshotLengths[i]);
+                }
+
+                BitArray emptyMatches = filter.TestMany(out snapshotLengths, new Packet[0]);
+                Assert.AreEqual(0, emptyMatches.Count);
+                Assert.AreEqual(0, snapshotLengths.Length);
+            }
+        }
+
+        [TestMethod]
+        [ExpectedException(typeof(ArgumentOutOfRangeException), AllowDerivedTypes = false)]
+        public void TestManyOutOfRangeTest()
+        {
+            using (BerkeleyPacketFilter filter = new BerkeleyPacketFilter("udp", PacketDevice.DefaultSnapshotLength, DataLinkKind.Ethernet))
+            {
+                int[] snapshotLengths;
+                filter.TestMany(out snapshotLengths, new byte[100], new[] {0, 60}, new[] {60, 41});
+            }
+            Assert.Fail();
+        }
+
+        [TestMethod]
+        [ExpectedException(typeof(ArgumentNullException), AllowDerivedTypes = false)]
+        public void TestManyNullTest()
+        {
+            using (BerkeleyPacketFilter filter = new BerkeleyPacketFilter("udp", PacketDevice.DefaultSnapshotLength, DataLinkKind.Ethernet))
+            {
+                int[] snapshotLengths;
+                filter.TestMany(out snapshotLengths, new Packet[] {null});
+            }
+            Assert.Fail();
+        }
+
+        [TestMethod]
+        public void CacheTest()
+        {
+            Packet packet = new PacketBuilder(new EthernetLayer(), new IpV4Layer(), new UdpLayer()).Build(DateTime.Now);
+            using (BerkeleyPacketFilterCache cache = new BerkeleyPacketFilterCache())
+            {
+                Assert.AreEqual(BerkeleyPacketFilterCache.DefaultCapacity, cache.Capacity);
+                using (BerkeleyPacketFilter filter = cache.GetFilter("udp", 100, DataLinkKind.Ethernet))
+                {
+                    cache.GetFilter("udp", 100, DataLinkKind.Ethernet).Dispose();
+                    Assert.AreEqual(1, cache.Count);
+                    cache.GetFilter("udp", 200, DataLinkKind.Ethernet).Dispose();
+                    cache.GetFilter("tcp", 100, DataLinkKind.Ethernet).Dispose();
+                    cache.GetFilter("udp", 100, DataLinkKind.IpV4).Dispose();
+                    Assert.AreEqual(4, cache.Count);
+
+                    // Disposing a filter returned by the cache doesn't free the cached program.
+                    using (BerkeleyPacketFilter cachedFilter = cache.GetFilter("udp", 100, DataLinkKind.Ethernet))
+                    {
+                        int snapshotLength;
+                        Assert.IsTrue(cachedFilter.Test(out snapshotLength, packet));
+                        Assert.AreEqual(100, snapshotLength);
+                    }
+
+                    // Filters returned before clearing the cache stay valid.
+                    cache.Clear();
+                    Assert.AreEqual(0, cache.Count);
+                    int clearedSnapshotLength;
+                    Assert.IsTrue(filter.Test(out clearedSnapshotLength, packet));
+                    Assert.AreEqual(100, clearedSnapshotLength);
+                }
+            }
+        }
+
+        [TestMethod]
+        public void CacheEvictionTest()
+        {
+            Packet packet = new PacketBuilder(new EthernetLayer(), new IpV4Layer(), new UdpLayer()).Build(DateTime.Now);
+            using (BerkeleyPacketFilterCache cache = new BerkeleyPacketFilterCache(2))
+            {
+                Assert.AreEqual(2, cache.Capacity);
+                using (BerkeleyPacketFilter filter = cache.GetFilter("udp", 100, DataLinkKind.Ethernet))
+                {
+                    cache.GetFilter("tcp", 100, DataLinkKind.Ethernet).Dispose();
+
+                    // Using udp again makes tcp the least recently used filter.
+                    cache.GetFilter("udp", 100, DataLinkKind.Ethernet).Dispose();
+                    cache.GetFilter("arp", 100, DataLinkKind.Ethernet).Dispose();
+                    Assert.AreEqual(2, cache.Count);
+
+                    using (MemoryStream stream = new MemoryStream())
+                    {
+                        cache.Save(stream);
+                        stream.Position = 0;
+                        using (BerkeleyPacketFilterCache loadedCache = new BerkeleyPacketFilterCache())
+                        {
+                            loadedCache.GetFilter("udp", 100, DataLinkKind.Ethernet).Dispose();
+                            Assert.AreEqual(1, loadedCache.Load(stream));
+                            Assert.AreEqual(2, loadedCache.Count);
+                        }
+                    }
+
+                    // An evicted filter stays valid.
+                    cache.GetFilter("tcp", 100, DataLinkKind.Ethernet).Dispose();
+                    cache.GetFilter("ip6", 100, DataLinkKind.Ethernet).Dispose();
+                    Assert.AreEqual(2, cache.Count);
+                    int snapshotLength;
+                    Assert.IsTrue(filter.Test(out snapshotLength, packet));
+                    Assert.AreEqual(100, snapshotLength);
+                }
+            }
+        }
+
+        [TestMethod]
+        [ExpectedException(typeof(ArgumentOutOfRangeException), AllowDerivedTypes = false)]
+        public void CacheCapacityNotPositiveTest()
+        {
+            using (new BerkeleyPacketFilterCache(0))
+            {
+            }
+            Assert.Fail();
+        }
+
+        [TestMethod]
+        public void CacheSaveLoadTest()
+        {
+            string[] filterValues = {"udp", "tcp port 80", "ip src net 10.0.0.0/8 and len > 100", "ip6 or arp"};
+
+            Random random = new Random();
+            Packet[] packets = Enumerable.Range(0, 100).Select(i => new PacketBuilder(random.NextEthernetLayer(EthernetType.None), random.NextIpV4Layer(null),
+                                                                                     random.NextPayloadLayer(random.Next(200))).Build(DateTime.Now)).ToArray();
+
+            using (MemoryStream stream = new MemoryStream())
+            {
+                using (BerkeleyPacketFilterCache cache = new BerkeleyPacketFilterCache())
+                {
+                    foreach (string filterValue in filterValues)
+                        cache.GetFilter(filterValue, PacketDevice.DefaultSnapshotLength, DataLinkKind.Ethernet).Dispose();
+                    cache.Save(stream);
+                }
+
+                using (BerkeleyPacketFilterCache cache = new BerkeleyPacketFilterCache())
+                {
+                    cache.GetFilter("udp", PacketDevice.DefaultSnapshotLength, DataLinkKind.Ethernet).Dispose();
+                    stream.Position = 0;
+                    Assert.AreEqual(filterValues.Length - 1, cache.Load(stream));
+                    Assert.AreEqual(filterValues.Length, cache.Count);
+
+                    foreach (string filterValue in filterValues)
+                    {
+                        using (BerkeleyPacketFilter loadedFilter = cache.GetFilter(filterValue, PacketDevice.DefaultSnapshotLength, DataLinkKind.Ethernet))
+                        using (BerkeleyPacketFilter filter = new BerkeleyPacketFilter(filterValue, PacketDevice.DefaultSnapshotLength, DataLinkKind.Ethernet))
+                        {
+                            Assert.AreEqual(filterValues.Length, cache.Count);
+                            foreach (Packet packet in packets)
+                            {
+                                int expectedSnapshotLength;
+                                int actualSnapshotLength;
+                                Assert.AreEqual(filter.Test(out expectedSnapshotLength, packet), loadedFilter.Test(out actualSnapshotLength, packet), filterValue);
+                                Assert.AreEqual(expectedSnapshotLength, actualSnapshotLength, filterValue);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        [TestMethod]
+        [ExpectedException(typeof(InvalidDataException), AllowDerivedTypes = false)]
+        public void CacheLoadInvalidTest()
+        {
+            using (BerkeleyPacketFilterCache cache = new BerkeleyPacketFilterCache())
+            {
+                using (MemoryStream stream = new MemoryStream(new byte[] {1, 2, 3, 4, 5, 6, 7, 8}))
+                {
+                    cache.Load(stream);
+                }
+            }
+            Assert.Fail();
+        }
+
+        [TestMethod]
+        public void CacheLoadProgramTest()
+        {
+            // ld #len; jeq #60, 0, 1; ret a; ret #0
+            ushort[] codes = {0x80, 0x15, 0x16, 0x06};
+            byte[] jumpsTrue = {0, 0, 0, 0};
+            byte[] jumpsFalse = {0, 1, 0, 0};
+            uint[] values = {0, 60, 0, 0};
+            using (BerkeleyPacketFilterCache cache = new BerkeleyPacketFilterCache())
+            {
+                using (MemoryStream stream = CreateSavedFilter("len = 60", codes, jumpsTrue, jumpsFalse, values))
+                {
+                    Assert.AreEqual(1, cache.Load(stream));
+                }
+
+                using (BerkeleyPacketFilter filter = cache.GetFilter("len = 60", PacketDevice.DefaultSnapshotLength, DataLinkKind.Ethernet))
+                {
+                    int snapshotLength;
+                    Assert.IsTrue(filter.Test(out snapshotLength, new Packet(new byte[60], DateTime.Now, DataLinkKind.Ethernet)));
+                    Assert.AreEqual(60, snapshotLength);
+                    Assert.IsFalse(filter.Test(new Packet(new byte[61], DateTime.Now, DataLinkKind.Ethernet)));
+                }
+            }
+        }
+
+        [TestMethod]
+        [ExpectedException(typeof(InvalidDataException), AllowDerivedTypes = false)]
+        public void CacheLoadJumpOutOfRangeTest()
+        {
+            // ld #len; jeq #60, 0, 2; ret a; ret #0
+            ushort[] codes = {0x80, 0x15, 0x16, 0x06};
+            byte[] jumpsTrue = {0, 0, 0, 0};
+            byte[] jumpsFalse = {0, 2, 0, 0};
+            uint[] values = {0, 60, 0, 0};
+            using (BerkeleyPacketFilterCache cache = new BerkeleyPacketFilterCache())
+            {
+                using (MemoryStream stream = CreateSavedFilter("len = 60", codes, jumpsTrue, jumpsFalse, values))
+                {
+                    cache.Load(stream);
+                }
+            }
+            Assert.Fail();
+        }
+
+        [TestMethod]
+        public void CompiledFilterTest()
+        {
+            string[] filterValues =
+            {
+                "tcp port 80", "udp", "ip src net 10.0.0.0/8", "len > 100", "less 200", "ip[2:2] > 100", "tcp[tcpflags] & tcp-syn != 0",
+                "ip6", "icmp", "vlan", "ip[8] * 2 + 1 > ip[9] / 3 - 1", "ip[0] & 0xf != 5 or ip[6] & 0x20 != 0", "udp[4:2] << 1 >> 2 > 100",
+                "ip and (tcp or udp) and not port 53", "ether src 11:22:33:44:55:66", "ip[0] * 4 = len / 16"
+            };
+
+            Random random = new Random();
+            List<Packet> packets = new List<Packet>();
+            for (int i = 0; i != 200; ++i)
+            {
+                PacketBuilder builder;
+                switch (i % 5)
+                {
+                    case 0:
+                        builder = new PacketBuilder(random.NextEthernetLayer(EthernetType.None), random.NextIpV4Layer(IpV4Protocol.Tcp), random.NextTcpLayer(), random.NextPayloadLayer(random.Next(100)));
+                        break;
+                    case 1:
+                        builder = new PacketBuilder(random.NextEthernetLayer(EthernetType.None), random.NextIpV4Layer(IpV4Protocol.Udp), random.NextUdpLayer(), random.NextPayloadLayer(random.Next(100)));
+                        break;
+                    case 2:
+                        builder = new PacketBuilder(random.NextEthernetLayer(EthernetType.None), random.NextIpV6Layer(IpV4Protocol.Udp, false), random.NextUdpLayer(), random.NextPayloadLayer(random.Next(100)));
+                        break;
+                    case 3:
+                        builder = new PacketBuilder(random.NextEthernetLayer(EthernetType.None), random.NextIpV4Layer(null), random.NextIcmpLayer());
+                        break;
+                    default:
+                        builder = new PacketBuilder(random.NextEthernetLayer(EthernetType.None), random.NextVLanTaggedFrameLayer(EthernetType.None), random.NextIpV4Layer(IpV4Protocol.Udp),
+                                                    random.NextUdpLayer(), random.NextPayloadLayer(random.Next(100)));
+                        break;
+                }
+                Packet packet = builder.Build(DateTime.Now);
+                packets.Add(packet);
+
+                // Truncated packets check that loads beyond the captured bytes reject like the interpreter.
+                packets.Add(new Packet(packet.Buffer.Take(random.Next(packet.Length)).ToArray(), packet.Timestamp, DataLinkKind.Ethernet));
+            }
+
+            // The same packets in the middle of bigger arrays must give the same results.
+            List<Packet> segmentPackets = new List<Packet>();
+            foreach (Packet packet in packets)
+            {
+                int offset = random.Next(1, 10);
+                byte[] buffer = new byte[offset + packet.Length + random.Next(10)];
+                random.NextBytes(buffer);
+                packet.CopyTo(buffer, offset);
+                segmentPackets.Add(new Packet(buffer, offset, packet.Length, packet.Timestamp, packet.DataLink));
+            }
+
+            foreach (string filterValue in filterValues)
+            {
+                using (BerkeleyPacketFilter filter = new BerkeleyPacketFilter(filterValue, PacketDevice.DefaultSnapshotLength, DataLinkKind.Ethernet))
+                {
+                    CompiledBerkeleyPacketFilter compiledFilter = new CompiledBerkeleyPacketFilter(filter);
+                    Assert.IsTrue(compiledFilter.IsCompiled, filterValue);
+                    Assert.AreEqual(filter, compiledFilter.Filter);
+
+                    for (int i = 0; i != packets.Count; ++i)
+                    {
+                        Packet packet = packets[i];
+                        int expectedSnapshotLength;
+                        bool expectedResult = filter.Test(out expectedSnapshotLength, packet);
+
+                        int actualSnapshotLength;
+                        Assert.AreEqual(expectedResult, compiledFilter.Test(out actualSnapshotLength, packet), filterValue);
+                        Assert.AreEqual(expectedSnapshotLength, actualSnapshotLength, filterValue);
+                        Assert.AreEqual(expectedResult, compiledFilter.Test(out actualSnapshotLength, packet.Buffer, packet.Length, packet.OriginalLength), filterValue);
+                        Assert.AreEqual(expectedSnapshotLength, actualSnapshotLength, filterValue);
+
+                        Assert.AreEqual(expectedResult, filter.Test(out actualSnapshotLength, segmentPackets[i]), filterValue);
+                        Assert.AreEqual(expectedSnapshotLength, actualSnapshotLength, filterValue);
+                        Assert.AreEqual(expectedResult, compiledFilter.Test(out actualSnapshotLength, segmentPackets[i]), filterValue);
+                        Assert.AreEqual(expectedSnapshotLength, actualSnapshotLength, filterValue);
+                    }
+
+                    int[] expectedSnapshotLengths;
+                    BitArray expectedResults = filter.TestMany(out expectedSnapshotLengths, packets);
+                    int[] actualSnapshotLengths;
+                    CollectionAssert.AreEqual(expectedResults, filter.TestMany(out actualSnapshotLengths, segmentPackets), filterValue);
+                    CollectionAssert.AreEqual(expectedSnapshotLengths, actualSnapshotLengths, filterValue);
+                }
+            }
+        }
+
+        [TestMethod]
+        public void CompiledFilterTcpFlagsTest()
+        {
+            const int NumPackets = 1000;
+
+            Random random = new Random();
+            Packet[] packets = Enumerable.Range(0, NumPackets).Select(i => new PacketBuilder(random.NextEthernetLayer(EthernetType.None), random.NextIpV4Layer(IpV4Protocol.Tcp),
+                                                                                             random.NextTcpLayer(), random.NextPayloadLayer(100)).Build(DateTime.Now)).ToArray();
+
+            using (BerkeleyPacketFilter filter = new BerkeleyPacketFilter("ip and tcp and (port 80 or port 443) and tcp[tcpflags] & tcp-syn != 0", PacketDevice.DefaultSnapshotLength,
+                                                                          DataLinkKind.Ethernet))
+            {
+                CompiledBerkeleyPacketFilter compiledFilter = new CompiledBerkeleyPacketFilter(filter);
+                Assert.IsTrue(compiledFilter.IsCompiled);
+
+                foreach (Packet packet in packets)
+                    Assert.AreEqual(filter.Test(packet), compiledFilter.Test(packet));
+            }
+        }
+
+        [TestMethod]
+        [ExpectedException(typeof(ArgumentNullException), AllowDerivedTypes = false)]
+        public void CompiledFilterNullTest()
+        {
+            Assert.IsNotNull(new CompiledBerkeleyPacketFilter(null));
+            Assert.Fail();
+        }
+
+        [TestMethod]
+        [ExpectedException(typeof(ArgumentOutOfRangeException), AllowDerivedTypes = false)]
+        public void CompiledFilterLengthOutOfRangeTest()
+        {
+            using (BerkeleyPacketFilter filter = new BerkeleyPacketFilter("udp", PacketDevice.DefaultSnapshotLength, DataLinkKind.Ethernet))
+            {
+                int snapshotLength;
+                new CompiledBerkeleyPacketFilter(filter).Test(out snapshotLength, new byte[10], 11, 11);
+            }
+            Assert.Fail();
+        }
+
         private static void TestFilter(PacketCommunicator communicator, BerkeleyPacketFilter filter, Packet expectedPacket, Packet unexpectedPacket)
         {
             communicator.SetFilter(filter);
@@ -147,5 +549,29 @@ namespace PcapDotNet.Core.Test
             Assert.AreEqual(PacketCommunicatorReceiveResult.Timeout, result);
             Assert.IsNull(packet);
         }
+
+        private static MemoryStream CreateSavedFilter(string filterValue, ushort[] codes, byte[] jumpsTrue, byte[] jumpsFalse, uint[] values)
+        {
+            MemoryStream stream = new MemoryStream();
+            BinaryWriter writer = new BinaryWriter(stream);
+            writer.Write(0x43465042);
+            writer.Write(1);
+            writer.Write(1);
+            writer.Write(filterValue);
+            writer.Write(1); // DLT_EN10MB
+            writer.Write(PacketDevice.DefaultSnapshotLength);
+            writer.Write(0U);
+            writer.Write((uint)codes.Length);
+            for (int i = 0; i != codes.Length; ++i)
+            {
+                writer.Write(codes[i]);
+                writer.Write(jumpsTrue[i]);
+                writer.Write(jumpsFalse[i]);
+                writer.Write(values[i]);
+            }
+            writer.Flush();
+            stream.Position = 0;
+            return stream;
+        }
     }
 }
\ No newline at end of file
@@ -308,6 +308,46 @@ namespace PcapDotNet.Core.Test
             }
         }
 
+        [TestMethod]
+        public void EmulatedStatisticsModeTest()
+        {
+            const string SourceMac = "11:22:33:44:55:66";
+            const string DestinationMac = "77:88:99:AA:BB:CC";
+            const int NumPacketsToSend = 100;
+            const int PacketSize = 100;
+
+            using (PacketCommunicator communicator = OpenLiveDevice())
+            {
+                communicator.EmulateStatisticsMode = true;
+                communicator.Mode = PacketCommunicatorMode.Statistics;
+                Assert.IsTrue(communicator.EmulateStatisticsMode);
+                communicator.SetFilter("ether src " + SourceMac + " and ether dst " + DestinationMac);
+
+                Packet sentPacket = _random.NextEthernetPacket(PacketSize, SourceMac, DestinationMac);
+
+                PacketSampleStatistics statistics;
+                PacketCommunicatorReceiveResult result = communicator.ReceiveStatistics(out statistics);
+                Assert.AreEqual(PacketCommunicatorReceiveResult.Ok, result);
+                MoreAssert.IsInRange(DateTime.Now.AddSeconds(-1), DateTime.Now.AddSeconds(1), statistics.Timestamp);
+                Assert.AreEqual<ulong>(0, statistics.AcceptedPackets);
+                Assert.AreEqual<ulong>(0, statistics.AcceptedBytes);
+
+                for (int i = 0; i != NumPacketsToSend; ++i)
+                    communicator.SendPacket(sentPacket);
+
+                result = communicator.ReceiveStatistics(out statistics);
+
+                Assert.AreEqual(PacketCommunicatorReceiveResult.Ok, result);
+                MoreAssert.IsInRange(DateTime.Now.AddSeconds(-1), DateTime.Now.AddSeconds(1), statistics.Timestamp);
+                Assert.AreEqual<ulong>(NumPacketsToSend, statistics.AcceptedPackets, "AcceptedPackets");
+                Assert.AreEqual<ulong>((ulong)(sentPacket.Length * NumPacketsToSend), statistics.AcceptedBytes, "AcceptedBytes");
+
+                communicator.Mode = PacketCommunicatorMode.Capture;
+                communicator.EmulateStatisticsMode = false;
+                Assert.IsFalse(communicator.EmulateStatisticsMode);
+            }
+        }
+
         [TestMethod]
         public void GetStatisticsTest()
         {
@@ -645,6 +685,114 @@ namespace PcapDotNet.Core.Test
             }
         }
 
+        [TestMethod]
+        public void TunerReceiveSomePacketsTest()
+        {
+            const string SourceMac = "11:22:33:44:55:66";
+            const string DestinationMac = "77:88:99:AA:BB:CC";
+            const int NumPacketsToSend = 10;
+
+            using (PacketCommunicator communicator = OpenLiveDevice())
+            {
+                communicator.SetFilter("ether src " + SourceMac + " and ether dst " + DestinationMac);
+                LivePacketCommunicatorTuner tuner = new LivePacketCommunicatorTuner((LivePacketCommunicator)communicator)
+                                                    {
+                                                        SampleInterval = TimeSpan.Zero,
+                                                        IdleSamplesBeforeShrink = 1
+                                                    };
+                List<PacketCommunicatorTuningEventArgs> adjustments = new List<PacketCommunicatorTuningEventArgs>();
+                tuner.Adjusted += (sender, args) => adjustments.Add(args);
+                Assert.AreEqual(LivePacketCommunicatorTuner.DefaultKernelBufferSize, tuner.KernelBufferSize);
+                Assert.AreEqual(LivePacketCommunicatorTuner.DefaultKernelMinimumBytesToCopy, tuner.KernelMinimumBytesToCopy);
+                Assert.AreEqual(LivePacketCommunicatorTuner.DefaultBatchSize, tuner.BatchSize);
+
+                Packet sentPacket = _random.NextEthernetPacket(100, SourceMac, DestinationMac);
+                for (int i = 0; i != NumPacketsToSend; ++i)
+                    communicator.SendPacket(sentPacket);
+
+                int numPacketsGot;
+                PacketCommunicatorReceiveResult result = tuner.ReceiveSomePackets(out numPacketsGot, packet => Assert.AreEqual(sentPacket, packet));
+                Assert.AreEqual(PacketCommunicatorReceiveResult.Ok, result);
+                Assert.AreEqual(NumPacketsToSend, numPacketsGot);
+
+                // Other traffic on the network decides whether the parameters are shrunk, but every adjustment must be reported.
+                for (int i = 0; i != 3; ++i)
+                    tuner.Sample(TimeSpan.Zero);
+                foreach (PacketCommunicatorTuningEventArgs args in adjustments)
+                {
+                    Assert.AreNotEqual(args.PreviousValue, args.NewValue);
+                    Assert.IsNotNull(args.Statistics);
+                    Assert.IsNotNull(args.ToString());
+                }
+                Assert.AreEqual(tuner.KernelBufferSize,
+                                adjustments.Where(args => args.Parameter == PacketCommunicatorTuningParameter.KernelBufferSize)
+                                           .Select(args => args.NewValue).DefaultIfEmpty(LivePacketCommunicatorTuner.DefaultKernelBufferSize).Last());
+                Assert.AreEqual(tuner.BatchSize,
+                                adjustments.Where(args => args.Parameter == PacketCommunicatorTuningParameter.BatchSize)
+                                           .Select(args => args.NewValue).DefaultIfEmpty(LivePacketCommunicatorTuner.DefaultBatchSize).Last());
+            }
+        }
+
+        [TestMethod]
+        public void TunerRangeChangeClampsValueTest()
+        {
+            using (PacketCommunicator communicator = OpenLiveDevice())
+            {
+                LivePacketCommunicatorTuner tuner = new LivePacketCommunicatorTuner((LivePacketCommunicator)communicator);
+                List<PacketCommunicatorTuningEventArgs> adjustments = new List<PacketCommunicatorTuningEventArgs>();
+                tuner.Adjusted += (sender, args) => adjustments.Add(args);
+
+                tuner.MaximumBatchSize = LivePacketCommunicatorTuner.DefaultBatchSize / 2;
+                Assert.AreEqual(LivePacketCommunicatorTuner.DefaultBatchSize / 2, tuner.BatchSize);
+                tuner.MinimumKernelMinimumBytesToCopy = LivePacketCommunicatorTuner.DefaultKernelMinimumBytesToCopy * 2;
+                Assert.AreEqual(LivePacketCommunicatorTuner.DefaultKernelMinimumBytesToCopy * 2, tuner.KernelMinimumBytesToCopy);
+                tuner.MinimumBatchSize = 1;
+                Assert.AreEqual(LivePacketCommunicatorTuner.DefaultBatchSize / 2, tuner.BatchSize);
+
+                Assert.AreEqual(2, adjustments.Count);
+                Assert.AreEqual(PacketCommunicatorTuningParameter.BatchSize, adjustments[0].Parameter);
+                Assert.AreEqual(LivePacketCommunicatorTuner.DefaultBatchSize, adjustments[0].PreviousValue);
+                Assert.IsNull(adjustments[0].Statistics);
+                Assert.AreEqual(PacketCommunicatorTuningParameter.KernelMinimumBytesToCopy, adjustments[1].Parameter);
+            }
+        }
+
+        [TestMethod]
+        public void TunerRangeErrorActualValueTest()
+        {
+            using (PacketCommunicator communicator = OpenLiveDevice())
+            {
+                LivePacketCommunicatorTuner tuner = new LivePacketCommunicatorTuner((LivePacketCommunicator)communicator);
+                try
+                {
+                    tuner.MaximumKernelBufferSize = tuner.MinimumKernelBufferSize - 1;
+                    Assert.Fail();
+                }
+                catch (ArgumentOutOfRangeException exception)
+                {
+                    Assert.AreEqual(tuner.MinimumKernelBufferSize - 1, exception.ActualValue);
+                }
+            }
+        }
+
+        [TestMethod]
+        [ExpectedException(typeof(ArgumentOutOfRangeException), AllowDerivedTypes = false)]
+        public void TunerMinimumBiggerThanMaximumErrorTest()
+        {
+            using (PacketCommunicator communicator = OpenLiveDevice())
+            {
+                LivePacketCommunicatorTuner tuner = new LivePacketCommunicatorTuner((LivePacketCommunicator)communicator);
+                tuner.MinimumBatchSize = tuner.MaximumBatchSize + 1;
+            }
+        }
+
+        [TestMethod]
+        [ExpectedException(typeof(ArgumentNullException), AllowDerivedTypes = false)]
+        public void TunerNullCommunicatorTest()
+        {
+            Assert.IsNotNull(new LivePacketCommunicatorTuner(null));
+        }
+
         [TestMethod]
         [ExpectedException(typeof(InvalidOperationException), AllowDerivedTypes = false)]
         public void SetInvalidDataLink()
@@ -1,11 +1,16 @@
 ﻿using System;
+using System.Collections.Generic;
 using System.Diagnostics.CodeAnalysis;
 using System.IO;
 using System.Linq;
 using System.Threading;
 using Microsoft.VisualStudio.TestTools.UnitTesting;
+using PcapDotNet.Base;
 using PcapDotNet.Packets;
+using PcapDotNet.Packets.Arp;
 using PcapDotNet.Packets.Ethernet;
+using PcapDotNet.Packets.IpV4;
+using PcapDotNet.Packets.Transport;
 using PcapDotNet.Packets.TestUtils;
 using PcapDotNet.TestUtils;
 
@@ -157,6 +162,30 @@ namespace PcapDotNet.Core.Test
             TestReceivePackets(NumPacketsToSend, NumPacketsToSend, 0, PacketCommunicatorReceiveResult.BreakLoop, 0, 0.05, 0.05);
         }
 
+        [TestMethod]
+        public void BreakAfterLoopEndedTest()
+        {
+            const string SourceMac = "11:22:33:44:55:66";
+            const string DestinationMac = "77:88:99:AA:BB:CC";
+            const int NumPacketsToSend = 10;
+
+            Packet expectedPacket = _random.NextEthernetPacket(100, SourceMac, DestinationMac);
+            using (PacketCommunicator communicator = OpenOfflineDevice(NumPacketsToSend, expectedPacket))
+            {
+                // The break arrives with the last packet of the count, so the loop ends without seeing it.
+                int numPacketsGot = 0;
+                Assert.AreEqual(PacketCommunicatorReceiveResult.Ok,
+                                communicator.ReceivePackets(NumPacketsToSend / 2, delegate
+                                                                                  {
+                                                                                      if (++numPacketsGot == NumPacketsToSend / 2)
+                                                                                          communicator.Break();
+                                                                                  }));
+
+                Assert.AreEqual(PacketCommunicatorReceiveResult.Eof, communicator.ReceivePackets(0, packet => ++numPacketsGot));
+                Assert.AreEqual(NumPacketsToSend, numPacketsGot);
+            }
+        }
+
         [TestMethod]
         [ExpectedException(typeof(InvalidOperationException), AllowDerivedTypes = false)]
         public void StatisticsModeErrorTest()
@@ -167,6 +196,16 @@ namespace PcapDotNet.Core.Test
             }
         }
 
+        [TestMethod]
+        [ExpectedException(typeof(InvalidOperationException), AllowDerivedTypes = false)]
+        public void EmulateStatisticsModeErrorTest()
+        {
+            using (PacketCommunicator communicator = OpenOfflineDevice())
+            {
+                communicator.EmulateStatisticsMode = true;
+            }
+        }
+
         [TestMethod]
         public void SetNonBlockTest()
         {
@@ -287,6 +326,424 @@ namespace PcapDotNet.Core.Test
             }
         }
 
+        [TestMethod]
+        public void SetSamplingMethodFlowHashTest()
+        {
+            const int NumFlows = 100;
+            const int NumPacketsPerFlow = 6;
+            const ushort FirstPort = 10000;
+            const ushort ServerPort = 53;
+
+            IpV4Address client = new IpV4Address("1.2.3.4");
+            IpV4Address server = new IpV4Address("5.6.7.8");
+            List<Packet> packets = new List<Packet>(NumFlows * NumPacketsPerFlow);
+            for (int i = 0; i != NumPacketsPerFlow; ++i)
+            {
+                for (int flow = 0; flow != NumFlows; ++flow)
+                {
+                    bool fromClient = i % 2 == 0;
+                    ushort clientPort = (ushort)(FirstPort + flow);
+                    packets.Add(PacketBuilder.Build(DateTime.Now, new EthernetLayer(),
+                                                    new IpV4Layer
+                                                    {
+                                                        Source = fromClient ? client : server,
+                                                        CurrentDestination = fromClient ? server : client,
+                                                    },
+                                                    new UdpLayer
+                                                    {
+                                                        SourcePort = fromClient ? clientPort : ServerPort,
+                                                        DestinationPort = fromClient ? ServerPort : clientPort,
+                                                    },
+                                                    new PayloadLayer {Data = new Datagram(new byte[10])}));
+                }
+            }
+
+            string filename = Path.GetTempPath() + @"flowHash.pcap";
+            PacketDumpFile.Dump(filename, DataLinkKind.Ethernet, PacketDevice.DefaultSnapshotLength, packets);
+
+            using (PacketCommunicator communicator = new OfflinePacketDevice(filename).Open())
+            {
+                communicator.SetSamplingMethod(new SamplingMethodFlowHash(4));
+
+                Dictionary<ushort, int> packetsPerFlow = new Dictionary<ushort, int>();
+                Assert.AreEqual(PacketCommunicatorReceiveResult.Eof, communicator.ReceivePackets(-1, delegate(Packet packet)
+                {
+                    UdpDatagram udp = packet.Ethernet.IpV4.Udp;
+                    ushort clientPort = udp.SourcePort == ServerPort ? udp.DestinationPort : udp.SourcePort;
+                    int count;
+                    packetsPerFlow.TryGetValue(clientPort, out count);
+                    packetsPerFlow[clientPort] = count + 1;
+                }));
+
+                // Flows are kept whole, in both directions.
+                MoreAssert.IsInRange(1, NumFlows - 1, packetsPerFlow.Count);
+                foreach (KeyValuePair<ushort, int> flow in packetsPerFlow)
+                    Assert.AreEqual(NumPacketsPerFlow, flow.Value, flow.Key.ToString());
+            }
+        }
+
+        [TestMethod]
+        public void SetSamplingMethodFlowHashFragmentsTest()
+        {
+            const int NumFlows = 100;
+
+            // Every flow has a TCP fragment from the client and a UDP fragment from the server, neither of them the first fragment.
+            IpV4Address server = new IpV4Address("5.6.7.8");
+            List<Packet> packets = new List<Packet>(2 * NumFlows);
+            for (int flow = 0; flow != NumFlows; ++flow)
+            {
+                IpV4Address client = new IpV4Address((uint)(0x01020000 + flow));
+                IpV4Fragmentation fragmentation = new IpV4Fragmentation(IpV4FragmentationOptions.None, 8);
+                Packet tcpFragment = PacketBuilder.Build(DateTime.Now, new EthernetLayer(),
+                                                         new IpV4Layer {Source = client, CurrentDestination = server, Fragmentation = fragmentation},
+                                                         new TcpLayer {SourcePort = 10000, DestinationPort = 80});
+                Packet udpFragment = PacketBuilder.Build(DateTime.Now, new EthernetLayer(),
+                                                         new IpV4Layer {Source = server, CurrentDestination = client, Fragmentation = fragmentation},
+                                                         new UdpLayer {SourcePort = 53, DestinationPort = 20000});
+
+                // The managed parser gives both fragments the same flow.
+                PacketFlowInfo tcpInfo;
+                PacketFlowInfo udpInfo;
+                Assert.IsTrue(PacketFlowParser.TryParse(tcpFragment, out tcpInfo));
+                Assert.IsTrue(PacketFlowParser.TryParse(udpFragment, out udpInfo));
+                Assert.AreEqual(tcpInfo.FlowKey, udpInfo.FlowKey.Reverse());
+
+                packets.Add(tcpFragment);
+                packets.Add(udpFragment);
+            }
+
+            string filename = Path.GetTempPath() + @"flowHashFragments.pcap";
+            PacketDumpFile.Dump(filename, DataLinkKind.Ethernet, PacketDevice.DefaultSnapshotLength, packets);
+
+            using (PacketCommunicator communicator = new OfflinePacketDevice(filename).Open())
+            {
+                communicator.SetSamplingMethod(new SamplingMethodFlowHash(4));
+
+                Dictionary<IpV4Address, int> packetsPerClient = new Dictionary<IpV4Address, int>();
+                Assert.AreEqual(PacketCommunicatorReceiveResult.Eof, communicator.ReceivePackets(-1, delegate(Packet packet)
+                {
+                    IpV4Datagram ipV4 = packet.Ethernet.IpV4;
+                    IpV4Address client = ipV4.Source == server ? ipV4.CurrentDestination : ipV4.Source;
+                    int count;
+                    packetsPerClient.TryGetValue(client, out count);
+                    packetsPerClient[client] = count + 1;
+                }));
+
+                // The native flow hash agrees with the managed flow key and keeps or drops both fragments.
+                MoreAssert.IsInRange(1, NumFlows - 1, packetsPerClient.Count);
+                foreach (KeyValuePair<IpV4Address, int> client in packetsPerClient)
+                    Assert.AreEqual(2, client.Value, client.Key.ToString());
+            }
+        }
+
+        [TestMethod]
+        public void SetSamplingMethodFlowHashNonIpTest()
+        {
+            const int NumHosts = 100;
+
+            MacAddress gateway = new MacAddress("00:00:00:00:00:01");
+            ArpLayer arpLayer = _random.NextArpLayer();
+            List<Packet> packets = new List<Packet>(2 * NumHosts);
+            for (int host = 0; host != NumHosts; ++host)
+            {
+                MacAddress hostAddress = new MacAddress((UInt48)(0x10000 + host));
+                packets.Add(PacketBuilder.Build(DateTime.Now, new EthernetLayer {Source = hostAddress, Destination = gateway}, arpLayer));
+                packets.Add(PacketBuilder.Build(DateTime.Now, new EthernetLayer {Source = gateway, Destination = hostAddress}, arpLayer));
+            }
+
+            string filename = Path.GetTempPath() + @"flowHashNonIp.pcap";
+            PacketDumpFile.Dump(filename, DataLinkKind.Ethernet, PacketDevice.DefaultSnapshotLength, packets);
+
+            using (PacketCommunicator communicator = new OfflinePacketDevice(filename).Open())
+            {
+                communicator.SetSamplingMethod(new SamplingMethodFlowHash(4));
+
+                Dictionary<MacAddress, int> packetsPerHost = new Dictionary<MacAddress, int>();
+                Assert.AreEqual(PacketCommunicatorReceiveResult.Eof, communicator.ReceivePackets(-1, delegate(Packet packet)
+                {
+                    EthernetDatagram ethernet = packet.Ethernet;
+                    MacAddress host = ethernet.Source == gateway ? ethernet.Destination : ethernet.Source;
+                    int count;
+                    packetsPerHost.TryGetValue(host, out count);
+                    packetsPerHost[host] = count + 1;
+                }));
+
+                // Non IP packets are sampled by their MAC addresses, in both directions.
+                MoreAssert.IsInRange(1, NumHosts - 1, packetsPerHost.Count);
+                foreach (KeyValuePair<MacAddress, int> host in packetsPerHost)
+                    Assert.AreEqual(2, host.Value, host.Key.ToString());
+            }
+        }
+
+        [TestMethod]
+        [ExpectedException(typeof(ArgumentOutOfRangeException), AllowDerivedTypes = false)]
+        public void SetSamplingMethodFlowHashErrorTest()
+        {
+            using (PacketCommunicator communicator = OpenOfflineDevice())
+            {
+                communicator.SetSamplingMethod(new SamplingMethodFlowHash(0));
+            }
+        }
+
+        [TestMethod]
+        public void LoadShedderTruncatePayloadsTest()
+        {
+            const int NumPackets = 10;
+            const int HeadersLength = EthernetDatagram.HeaderLengthValue + IpV4Datagram.HeaderMinimumLength + UdpDatagram.HeaderLength;
+
+            Packet expectedPacket = PacketBuilder.Build(DateTime.Now, new EthernetLayer(), new IpV4Layer(), new UdpLayer(),
+                                                        new PayloadLayer {Data = new Datagram(new byte[100])});
+            using (PacketCommunicator communicator = OpenOfflineDevice(NumPackets, expectedPacket))
+            {
+                PacketLoadShedder loadShedder = new PacketLoadShedder
+                                                {
+                                                    QueueCapacity = 10,
+                                                    QueueDepth = 6,
+                                                    MaximumLag = TimeSpan.Zero,
+                                                };
+                communicator.LoadShedder = loadShedder;
+
+                Packet packet;
+                for (int i = 0; i != NumPackets; ++i)
+                {
+                    Assert.AreEqual(PacketCommunicatorReceiveResult.Ok, communicator.ReceivePacket(out packet));
+                    Assert.AreEqual(HeadersLength, packet.Length);
+                    Assert.AreEqual((uint)expectedPacket.Length, packet.OriginalLength);
+                }
+                Assert.AreEqual(PacketCommunicatorReceiveResult.Eof, communicator.ReceivePacket(out packet));
+
+                PacketLoadSheddingStatistics statistics = loadShedder.Statistics;
+                Assert.AreEqual(PacketLoadSheddingLevel.TruncatePayloads, statistics.Level);
+                Assert.AreEqual<ulong>(NumPackets, statistics.PacketsTruncated);
+                Assert.AreEqual<ulong>(NumPackets * (ulong)(expectedPacket.Length - HeadersLength), statistics.BytesTruncated);
+                Assert.AreEqual<ulong>(NumPackets, statistics.TotalPackets);
+            }
+        }
+
+        [TestMethod]
+        public void LoadShedderDropBulkFlowsTest()
+        {
+            const int NumPackets = 10;
+            const int NumPacketsBeforeBulk = 3;
+
+            Packet expectedPacket = PacketBuilder.Build(DateTime.Now, new EthernetLayer(), new IpV4Layer(), new UdpLayer(),
+                                                        new PayloadLayer {Data = new Datagram(new byte[100])});
+            using (PacketCommunicator communicator = OpenOfflineDevice(NumPackets, expectedPacket))
+            {
+                PacketLoadShedder loadShedder = new PacketLoadShedder
+                                                {
+                                                    QueueCapacity = 10,
+                                                    QueueDepth = 10,
+                                                    MaximumLag = TimeSpan.Zero,
+                                                    SampledFlowsFraction = 1,
+                                                    BulkFlowBytes = NumPacketsBeforeBulk * expectedPacket.Length,
+                                                };
+                communicator.LoadShedder = loadShedder;
+
+                int numPacketsGot = 0;
+                Assert.AreEqual(PacketCommunicatorReceiveResult.Eof, communicator.ReceivePackets(NumPackets, packet => ++numPacketsGot));
+                Assert.AreEqual(NumPacketsBeforeBulk, numPacketsGot);
+
+                PacketLoadSheddingStatistics statistics = loadShedder.Statistics;
+                Assert.AreEqual(PacketLoadSheddingLevel.DropBulkFlows, statistics.Level);
+                Assert.AreEqual<ulong>(NumPacketsBeforeBulk, statistics.PacketsTruncated);
+                Assert.AreEqual<ulong>(0, statistics.PacketsSampledOut);
+                Assert.AreEqual<ulong>(NumPackets - NumPacketsBeforeBulk, statistics.PacketsDroppedAsBulk);
+                Assert.AreEqual<ulong>((NumPackets - NumPacketsBeforeBulk) * (ulong)expectedPacket.Length, statistics.BytesDroppedAsBulk);
+            }
+        }
+
+        [TestMethod]
+        [ExpectedException(typeof(ArgumentOutOfRangeException), AllowDerivedTypes = false)]
+        public void LoadShedderDescendingPressureThresholdsErrorTest()
+        {
+            new PacketLoadShedder().SetPressureThresholds(0.8, 0.5, 0.9);
+        }
+
+        [TestMethod]
+        public void PayloadCutoffTruncateToHeadersTest()
+        {
+            const int NumPackets = 10;
+            const int PayloadLength = 100;
+            const int CutoffBytes = 250;
+            const int HeadersLength = EthernetDatagram.HeaderLengthValue + IpV4Datagram.HeaderMinimumLength + UdpDatagram.HeaderLength;
+
+            Packet expectedPacket = PacketBuilder.Build(DateTime.Now, new EthernetLayer(), new IpV4Layer(), new UdpLayer(),
+                                                        new PayloadLayer {Data = new Datagram(new byte[PayloadLength])});
+            using (PacketCommunicator communicator = OpenOfflineDevice(NumPackets, expectedPacket))
+            {
+                PacketFlowPayloadCutoff payloadCutoff = new PacketFlowPayloadCutoff(CutoffBytes, PacketFlowPayloadCutoffAction.TruncateToHeaders);
+                communicator.PayloadCutoff = payloadCutoff;
+
+                Packet packet;
+                for (int i = 0; i != NumPackets; ++i)
+                {
+                    Assert.AreEqual(PacketCommunicatorReceiveResult.Ok, communicator.ReceivePacket(out packet));
+                    int expectedPayloadLength = Math.Max(0, Math.Min(PayloadLength, CutoffBytes - i * PayloadLength));
+                    Assert.AreEqual(HeadersLength + expectedPayloadLength, packet.Length);
+                    Assert.AreEqual((uint)expectedPacket.Length, packet.OriginalLength);
+                }
+                Assert.AreEqual(PacketCommunicatorReceiveResult.Eof, communicator.ReceivePacket(out packet));
+
+                PacketFlowPayloadCutoffStatistics statistics = payloadCutoff.Statistics;
+                Assert.AreEqual<ulong>(CutoffBytes / PayloadLength, statistics.PacketsPassed);
+                Assert.AreEqual<ulong>(NumPackets - CutoffBytes / PayloadLength, statistics.PacketsTruncated);
+                Assert.AreEqual<ulong>(NumPackets * PayloadLength - CutoffBytes, statistics.BytesTruncated);
+                Assert.AreEqual<ulong>(0, statistics.PacketsDropped);
+            }
+        }
+
+        [TestMethod]
+        public void PayloadCutoffDropTest()
+        {
+            const int NumPackets = 10;
+            const int PayloadLength = 100;
+            const int CutoffBytes = 250;
+
+            Packet expectedPacket = PacketBuilder.Build(DateTime.Now, new EthernetLayer(), new IpV4Layer(), new UdpLayer(),
+                                                        new PayloadLayer {Data = new Datagram(new byte[PayloadLength])});
+            using (PacketCommunicator communicator = OpenOfflineDevice(NumPackets, expectedPacket))
+            {
+                PacketFlowPayloadCutoff payloadCutoff = new PacketFlowPayloadCutoff(CutoffBytes, PacketFlowPayloadCutoffAction.Drop);
+                communicator.PayloadCutoff = payloadCutoff;
+
+                int numPacketsGot = 0;
+                Assert.AreEqual(PacketCommunicatorReceiveResult.Eof, communicator.ReceivePackets(NumPackets, packet => ++numPacketsGot));
+
+                // The packet that crosses the cutoff is truncated and the rest are dropped.
+                const int NumPacketsDelivered = CutoffBytes / PayloadLength + 1;
+                Assert.AreEqual(NumPacketsDelivered, numPacketsGot);
+
+                PacketFlowPayloadCutoffStatistics statistics = payloadCutoff.Statistics;
+                Assert.AreEqual<ulong>(1, statistics.PacketsTruncated);
+                Assert.AreEqual<ulong>(NumPackets - NumPacketsDelivered, statistics.PacketsDropped);
+                Assert.AreEqual<ulong>((NumPackets - NumPacketsDelivered) * (ulong)expectedPacket.Length, statistics.BytesDropped);
+                Assert.AreEqual<ulong>(NumPackets, statistics.TotalPackets);
+            }
+        }
+
+        [TestMethod]
+        public void PayloadCutoffTruncatedCaptureTest()
+        {
+            const int NumPackets = 10;
+            const int PayloadLength = 100;
+            const int CutoffBytes = 310;
+            const int CapturedLength = EthernetDatagram.HeaderLengthValue + IpV4Datagram.HeaderMinimumLength + 4;
+
+            Packet fullPacket = PacketBuilder.Build(DateTime.Now, new EthernetLayer(), new IpV4Layer(), new UdpLayer(),
+                                                    new PayloadLayer {Data = new Datagram(new byte[PayloadLength])});
+            // Captured up to the middle of the UDP header.
+            Packet expectedPacket = new Packet(fullPacket.Take(CapturedLength).ToArray(), fullPacket.Timestamp, DataLinkKind.Ethernet, (uint)fullPacket.Length);
+            using (PacketCommunicator communicator = OpenOfflineDevice(NumPackets, expectedPacket))
+            {
+                PacketFlowPayloadCutoff payloadCutoff = new PacketFlowPayloadCutoff(CutoffBytes, PacketFlowPayloadCutoffAction.Drop);
+                communicator.PayloadCutoff = payloadCutoff;
+
+                int numPacketsGot = 0;
+                Assert.AreEqual(PacketCommunicatorReceiveResult.Eof, communicator.ReceivePackets(NumPackets, packet => ++numPacketsGot));
+
+                // Only the payload is counted and not the part of the UDP header that wasn't captured.
+                const int NumPacketsDelivered = CutoffBytes / PayloadLength + 1;
+                Assert.AreEqual(NumPacketsDelivered, numPacketsGot);
+                Assert.AreEqual<ulong>(NumPackets - NumPacketsDelivered, payloadCutoff.Statistics.PacketsDropped);
+            }
+        }
+
+        [TestMethod]
+        public void CaptureRingTriggerTest()
+        {
+            const int NumPackets = 10;
+            const int RingPackets = 5;
+            const int PacketLength = 100;
+            const int RecordLength = 16 + PacketLength + 4;
+
+            Packet expectedPacket = _random.NextEthernetPacket(PacketLength);
+            string dumpFileName;
+            using (PacketCommunicator communicator = OpenOfflineDevice(NumPackets, expectedPacket, TimeSpan.FromSeconds(1)))
+            {
+                using (PacketCaptureRing captureRing = new PacketCaptureRing(communicator, RingPackets * RecordLength, Path.GetTempPath() + @"captureRing"))
+                {
+                    captureRing.PostTriggerDuration = TimeSpan.FromSeconds(1.5);
+
+                    Packet packet;
+                    for (int i = 0; i != NumPackets - 2; ++i)
+                        Assert.AreEqual(PacketCommunicatorReceiveResult.Ok, communicator.ReceivePacket(out packet));
+                    Assert.AreEqual(RingPackets, captureRing.PacketCount);
+                    Assert.AreEqual(RingPackets * RecordLength, captureRing.UsedBytes);
+                    Assert.IsFalse(captureRing.IsDumping);
+                    Assert.IsNull(captureRing.LastDumpFileName);
+
+                    captureRing.Trigger();
+                    Assert.AreEqual(PacketCommunicatorReceiveResult.Ok, communicator.ReceivePacket(out packet));
+                    Assert.IsTrue(captureRing.IsDumping);
+                    Assert.AreEqual(1, captureRing.DumpCount);
+                    // The ring content went to the writer thread and recording continues in the spare slab.
+                    Assert.AreEqual(0, captureRing.PacketCount);
+                    Assert.AreEqual(PacketCommunicatorReceiveResult.Ok, communicator.ReceivePacket(out packet));
+                    Assert.AreEqual(expectedPacket, packet);
+                    dumpFileName = captureRing.LastDumpFileName;
+                    Assert.IsTrue(dumpFileName.StartsWith(Path.GetTempPath() + @"captureRing_"));
+                }
+            }
+
+            try
+            {
+                // The ring content when the trigger fired and the packet received during the post trigger duration.
+                using (PacketCommunicator communicator = new OfflinePacketDevice(dumpFileName).Open())
+                {
+                    Packet packet;
+                    for (int i = 0; i != RingPackets + 1; ++i)
+                    {
+                        Assert.AreEqual(PacketCommunicatorReceiveResult.Ok, communicator.ReceivePacket(out packet));
+                        Assert.AreEqual(expectedPacket, packet);
+                    }
+                    Assert.AreEqual(PacketCommunicatorReceiveResult.Eof, communicator.ReceivePacket(out packet));
+                }
+            }
+            finally
+            {
+                File.Delete(dumpFileName);
+            }
+        }
+
+        [TestMethod]
+        public void CaptureRingIdleTimeoutTest()
+        {
+            const int NumPackets = 5;
+
+            Packet expectedPacket = _random.NextEthernetPacket(100);
+            using (PacketCommunicator communicator = OpenOfflineDevice(NumPackets, expectedPacket, TimeSpan.FromSeconds(1)))
+            {
+                using (PacketCaptureRing captureRing = new PacketCaptureRing(communicator, 10000, Path.GetTempPath() + @"captureRingIdle"))
+                {
+                    captureRing.PostTriggerDuration = TimeSpan.FromSeconds(0.5);
+
+                    Packet packet;
+                    captureRing.Trigger();
+                    Assert.AreEqual(PacketCommunicatorReceiveResult.Ok, communicator.ReceivePacket(out packet));
+                    string dumpFileName = captureRing.LastDumpFileName;
+                    try
+                    {
+                        // No packet follows the trigger, so only the writer thread can close the dump file.
+                        for (int i = 0; i != 100 && captureRing.IsDumping; ++i)
+                            Thread.Sleep(TimeSpan.FromSeconds(0.1));
+                        Assert.IsFalse(captureRing.IsDumping);
+
+                        using (PacketCommunicator dumpCommunicator = new OfflinePacketDevice(dumpFileName).Open())
+                        {
+                            Assert.AreEqual(PacketCommunicatorReceiveResult.Ok, dumpCommunicator.ReceivePacket(out packet));
+                            Assert.AreEqual(expectedPacket, packet);
+                            Assert.AreEqual(PacketCommunicatorReceiveResult.Eof, dumpCommunicator.ReceivePacket(out packet));
+                        }
+                    }
+                    finally
+                    {
+                        File.Delete(dumpFileName);
+                    }
+                }
+            }
+        }
+
         [TestMethod]
         [ExpectedException(typeof(InvalidOperationException), AllowDerivedTypes = false)]
         public void DumpToBadFileTest()
@@ -0,0 +1,189 @@
+using System;
+using System.Collections.Generic;
+using System.Diagnostics.CodeAnalysis;
+using System.Linq;
+using Microsoft.VisualStudio.TestTools.UnitTesting;
+using PcapDotNet.Packets;
+using PcapDotNet.Packets.Ethernet;
+using PcapDotNet.Packets.IpV4;
+using PcapDotNet.Packets.TestUtils;
+using PcapDotNet.TestUtils;
+
+namespace PcapDotNet.Core.Test
+{
+    /// <summary>
+    /// Summary description for PacketClassifierTests
+    /// </summary>
+    [TestClass]
+    [ExcludeFromCodeCoverage]
+    public class PacketClassifierTests
+    {
+        /// <summary>
+        /// Gets or sets the test context which provides
+        /// information about and functionality for the current test run.
+        /// </summary>
+        public TestContext TestContext { get; set; }
+
+        [TestMethod]
+        public void ClassifyTest()
+        {
+            string[] filterValues =
+            {
+                "tcp", "tcp port 80", "tcp[tcpflags] & tcp-syn != 0", "udp", "udp and len > 100", "ip src net 10.0.0.0/8", "icmp", "ip6", "ip6 and udp", "arp",
+                "ip or ip6", "len > 50"
+            };
+
+            Random random = new Random();
+            List<Packet> packets = new List<Packet>();
+            for (int i = 0; i != 300; ++i)
+            {
+                PacketBuilder builder;
+                switch (i % 4)
+                {
+                    case 0:
+                        builder = new PacketBuilder(random.NextEthernetLayer(EthernetType.None), random.NextIpV4Layer(IpV4Protocol.Tcp), random.NextTcpLayer(), random.NextPayloadLayer(random.Next(100)));
+                        break;
+                    case 1:
+                        builder = new PacketBuilder(random.NextEthernetLayer(EthernetType.None), random.NextIpV4Layer(IpV4Protocol.Udp), random.NextUdpLayer(), random.NextPayloadLayer(random.Next(100)));
+                        break;
+                    case 2:
+                        builder = new PacketBuilder(random.NextEthernetLayer(EthernetType.None), random.NextIpV6Layer(IpV4Protocol.Udp, false), random.NextUdpLayer(), random.NextPayloadLayer(random.Next(100)));
+                        break;
+                    default:
+                        builder = new PacketBuilder(random.NextEthernetLayer(EthernetType.None), random.NextIpV4Layer(null), random.NextIcmpLayer());
+                        break;
+                }
+                packets.Add(builder.Build(DateTime.Now));
+            }
+
+            using (PacketClassifier classifier = new PacketClassifier(DataLinkKind.Ethernet, PacketDevice.DefaultSnapshotLength))
+            {
+                PacketClassifierSubscription[] subscriptions = filterValues.Select(filterValue => classifier.Subscribe(filterValue, filterValue, packets.Count)).ToArray();
+                Assert.AreEqual(filterValues.Length, classifier.Subscriptions.Count);
+
+                // The ethernet type and IP protocol checks are shared.
+                MoreAssert.IsSmaller(filterValues.Length * 2, classifier.SharedCheckCount);
+
+                int expectedMatches = 0;
+                List<Packet>[] expectedPackets = filterValues.Select(filterValue => new List<Packet>()).ToArray();
+                for (int i = 0; i != filterValues.Length; ++i)
+                {
+                    using (BerkeleyPacketFilter filter = new BerkeleyPacketFilter(filterValues[i], PacketDevice.DefaultSnapshotLength, DataLinkKind.Ethernet))
+                    {
+                        expectedPackets[i].AddRange(packets.Where(filter.Test));
+                        expectedMatches += expectedPackets[i].Count;
+                    }
+                }
+
+                Assert.AreEqual(expectedMatches, packets.Sum(packet => classifier.Classify(packet)));
+
+                for (int i = 0; i != subscriptions.Length; ++i)
+                {
+                    PacketClassifierSubscription subscription = subscriptions[i];
+                    Assert.AreEqual(expectedPackets[i].Count, subscription.MatchedPackets, subscription.Name);
+                    Assert.AreEqual(0, subscription.DroppedPackets, subscription.Name);
+                    Assert.AreEqual(expectedPackets[i].Count, subscription.QueuedPackets, subscription.Name);
+
+                    foreach (Packet expectedPacket in expectedPackets[i])
+                    {
+                        Packet packet;
+                        Assert.IsTrue(subscription.TryDequeue(out packet), subscription.Name);
+                        Assert.AreSame(expectedPacket, packet, subscription.Name);
+                    }
+                    Packet noPacket;
+                    Assert.IsFalse(subscription.TryDequeue(out noPacket), subscription.Name);
+                    Assert.IsNull(noPacket);
+                }
+            }
+        }
+
+        [TestMethod]
+        public void ClassifyAlternativeChecksTest()
+        {
+            // tcp and udp accept both IPv4 and IPv6, so they don't start with a single ethernet type check.
+            int tcpCheckCount = GetSharedCheckCount("tcp");
+            int udpCheckCount = GetSharedCheckCount("udp");
+            MoreAssert.IsBigger(0, tcpCheckCount);
+            MoreAssert.IsBigger(0, udpCheckCount);
+
+            // The ethernet type checks are shared and the IP protocol checks are not.
+            int tcpUdpCheckCount = GetSharedCheckCount("tcp", "udp");
+            MoreAssert.IsSmaller(tcpCheckCount + udpCheckCount, tcpUdpCheckCount);
+            MoreAssert.IsBigger(Math.Max(tcpCheckCount, udpCheckCount), tcpUdpCheckCount);
+            Assert.AreEqual(tcpCheckCount, GetSharedCheckCount("tcp", "tcp"));
+
+            // The ports are loaded from an offset that depends on the IPv4 header length, so they are left to the filter.
+            Assert.AreEqual(tcpCheckCount, GetSharedCheckCount("tcp", "tcp port 80"));
+        }
+
+        [TestMethod]
+        public void ClassifyDropTest()
+        {
+            const int QueueCapacity = 5;
+            const int NumPackets = 12;
+
+            Random random = new Random();
+            using (PacketClassifier classifier = new PacketClassifier(DataLinkKind.Ethernet, PacketDevice.DefaultSnapshotLength))
+            {
+                PacketClassifierSubscription slowSubscription = classifier.Subscribe("slow", "udp", QueueCapacity);
+                PacketClassifierSubscription fastSubscription = classifier.Subscribe("fast", "udp");
+                PacketClassifierSubscription tcpSubscription = classifier.Subscribe("tcp", "tcp");
+                Assert.AreEqual(QueueCapacity, slowSubscription.QueueCapacity);
+                Assert.AreEqual(PacketClassifier.DefaultQueueCapacity, fastSubscription.QueueCapacity);
+
+                for (int i = 0; i != NumPackets; ++i)
+                {
+                    Packet packet = new PacketBuilder(random.NextEthernetLayer(EthernetType.None), random.NextIpV4Layer(IpV4Protocol.Udp), random.NextUdpLayer(),
+                                                      random.NextPayloadLayer(10)).Build(DateTime.Now);
+                    Assert.AreEqual(2, classifier.Classify(packet));
+                }
+
+                Assert.AreEqual(NumPackets, slowSubscription.MatchedPackets);
+                Assert.AreEqual(NumPackets - QueueCapacity, slowSubscription.DroppedPackets);
+                Assert.AreEqual(QueueCapacity, slowSubscription.QueuedPackets);
+                Assert.AreEqual(NumPackets, fastSubscription.MatchedPackets);
+                Assert.AreEqual(0, fastSubscription.DroppedPackets);
+                Assert.AreEqual(0, tcpSubscription.MatchedPackets);
+                Assert.IsNotNull(slowSubscription.ToString());
+                classifier.Dispose();
+
+                // Disposing completes the queues, but what was queued can still be taken.
+                Packet queuedPacket;
+                Assert.IsTrue(slowSubscription.TryDequeue(out queuedPacket, TimeSpan.FromSeconds(1)));
+                Assert.IsFalse(tcpSubscription.TryDequeue(out queuedPacket, TimeSpan.FromSeconds(1)));
+            }
+        }
+
+        private static int GetSharedCheckCount(params string[] filterValues)
+        {
+            using (PacketClassifier classifier = new PacketClassifier(DataLinkKind.Ethernet, PacketDevice.DefaultSnapshotLength))
+            {
+                foreach (string filterValue in filterValues)
+                    classifier.Subscribe(filterValue, filterValue);
+                return classifier.SharedCheckCount;
+            }
+        }
+
+        [TestMethod]
+        [ExpectedException(typeof(ArgumentException), AllowDerivedTypes = false)]
+        public void SubscribeBadFilterErrorTest()
+        {
+            using (PacketClassifier classifier = new PacketClassifier(DataLinkKind.Ethernet, PacketDevice.DefaultSnapshotLength))
+            {
+                classifier.Subscribe("bad", "illegal filter string");
+            }
+            Assert.Fail();
+        }
+
+        [TestMethod]
+        [ExpectedException(typeof(ArgumentNullException), AllowDerivedTypes = false)]
+        public void ClassifyNullTest()
+        {
+            using (PacketClassifier classifier = new PacketClassifier(DataLinkKind.Ethernet, PacketDevice.DefaultSnapshotLength))
+            {
+                classifier.Classify(null);
+            }
+            Assert.Fail();
+        }
+    }
+}
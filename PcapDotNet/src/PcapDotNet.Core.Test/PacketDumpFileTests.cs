@@ -73,6 +73,23 @@ namespace PcapDotNet.Core.Test
             }
         }
 
+        [TestMethod]
+        public void DumpEmptySegmentTest()
+        {
+            string filename = Path.GetTempPath() + @"dump.pcap";
+
+            // An empty packet that starts at the end of its buffer.
+            Packet emptyPacket = new Packet(new byte[10], 10, 0, DateTime.Now, new DataLink(DataLinkKind.Ethernet));
+            PacketDumpFile.Dump(filename, DataLinkKind.Ethernet, PacketDevice.DefaultSnapshotLength, new[] {emptyPacket});
+
+            using (PacketCommunicator communicator = new OfflinePacketDevice(filename).Open())
+            {
+                Packet actualPacket;
+                Assert.AreEqual(PacketCommunicatorReceiveResult.Ok, communicator.ReceivePacket(out actualPacket));
+                Assert.AreEqual(0, actualPacket.Length);
+            }
+        }
+
         [TestMethod]
         [ExpectedException(typeof(ArgumentNullException), AllowDerivedTypes = false)]
         public void SendNullPacketTest()
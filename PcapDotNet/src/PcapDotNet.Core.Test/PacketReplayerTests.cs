@@ -0,0 +1,144 @@
+using System;
+using System.Collections.Generic;
+using System.Diagnostics.CodeAnalysis;
+using System.IO;
+using System.Linq;
+using Microsoft.VisualStudio.TestTools.UnitTesting;
+using PcapDotNet.Packets;
+using PcapDotNet.Packets.TestUtils;
+using PcapDotNet.TestUtils;
+
+namespace PcapDotNet.Core.Test
+{
+    /// <summary>
+    /// Summary description for PacketReplayerTests
+    /// </summary>
+    [TestClass]
+    [ExcludeFromCodeCoverage]
+    public class PacketReplayerTests
+    {
+        /// <summary>
+        /// Gets or sets the test context which provides
+        /// information about and functionality for the current test run.
+        /// </summary>
+        public TestContext TestContext { get; set; }
+
+        [TestMethod]
+        public void ReplayPacketsPerSecondTest()
+        {
+            const int NumPackets = 20;
+            const int NumLoops = 2;
+            const int PacketsPerSecond = 100;
+
+            List<Packet> packets;
+            string fileName = DumpPackets(NumPackets, TimeSpan.FromSeconds(1), out packets);
+            using (LivePacketCommunicator communicator = (LivePacketCommunicator)LivePacketDeviceTests.OpenLiveDevice())
+            {
+                communicator.SetFilter("ether src " + SourceMac + " and ether dst " + DestinationMac);
+
+                PacketReplayer replayer = new PacketReplayer(communicator, fileName)
+                                          {
+                                              Mode = PacketReplayMode.PacketsPerSecond,
+                                              PacketsPerSecond = PacketsPerSecond,
+                                              LoopCount = NumLoops,
+                                              BatchSize = 5 * (packets[0].Length + 16),
+                                          };
+                PacketReplayStatistics statistics = replayer.Replay();
+
+                Assert.AreEqual<ulong>(NumPackets * NumLoops, statistics.PacketsSent);
+                Assert.AreEqual<ulong>((ulong)(packets.Sum(packet => packet.Length) * NumLoops), statistics.BytesSent);
+                MoreAssert.IsBiggerOrEqual<ulong>(NumPackets * NumLoops / 5, statistics.BatchesSent);
+                TimeSpan expectedElapsed = TimeSpan.FromSeconds((NumPackets * NumLoops - 1) / (double)PacketsPerSecond);
+                MoreAssert.IsInRange(expectedElapsed.Subtract(TimeSpan.FromSeconds(0.05)), expectedElapsed.Add(TimeSpan.FromSeconds(0.5)), statistics.Elapsed);
+                MoreAssert.IsSmallerOrEqual(TimeSpan.FromSeconds(0.1), statistics.MaximumPacingError);
+
+                int numPacketsGot;
+                int numPacketsHandled = 0;
+                PacketCommunicatorReceiveResult result =
+                    communicator.ReceiveSomePackets(out numPacketsGot, NumPackets * NumLoops,
+                                                    packet => Assert.AreEqual(packets[numPacketsHandled++ % NumPackets].Length, packet.Length));
+                Assert.AreEqual(PacketCommunicatorReceiveResult.Ok, result);
+                Assert.AreEqual(NumPackets * NumLoops, numPacketsGot);
+            }
+        }
+
+        [TestMethod]
+        public void ReplayMultiplierTest()
+        {
+            const int NumPackets = 10;
+
+            List<Packet> packets;
+            string fileName = DumpPackets(NumPackets, TimeSpan.FromSeconds(0.1), out packets);
+            using (LivePacketCommunicator communicator = (LivePacketCommunicator)LivePacketDeviceTests.OpenLiveDevice())
+            {
+                PacketReplayer replayer = new PacketReplayer(communicator, fileName)
+                                          {
+                                              Mode = PacketReplayMode.Multiplier,
+                                              Multiplier = 2,
+                                          };
+                PacketReplayStatistics statistics = replayer.Replay();
+
+                Assert.AreEqual<ulong>(NumPackets, statistics.PacketsSent);
+                TimeSpan expectedElapsed = TimeSpan.FromSeconds(0.1 * (NumPackets - 1) / 2);
+                MoreAssert.IsInRange(expectedElapsed.Subtract(TimeSpan.FromSeconds(0.05)), expectedElapsed.Add(TimeSpan.FromSeconds(0.5)), statistics.Elapsed);
+            }
+        }
+
+        [TestMethod]
+        public void ReplayEmptyFileEndlesslyTest()
+        {
+            List<Packet> packets;
+            string fileName = DumpPackets(0, TimeSpan.Zero, out packets);
+            using (LivePacketCommunicator communicator = (LivePacketCommunicator)LivePacketDeviceTests.OpenLiveDevice())
+            {
+                PacketReplayer replayer = new PacketReplayer(communicator, fileName)
+                                          {
+                                              LoopCount = 0,
+                                          };
+
+                // A pass without packets ends the replay instead of reading the file forever.
+                PacketReplayStatistics statistics = replayer.Replay();
+                Assert.AreEqual<ulong>(0, statistics.PacketsSent);
+                Assert.AreEqual<ulong>(0, statistics.BatchesSent);
+            }
+        }
+
+        [TestMethod]
+        [ExpectedException(typeof(ArgumentOutOfRangeException), AllowDerivedTypes = false)]
+        public void ReplayNonPositiveMultiplierErrorTest()
+        {
+            using (LivePacketCommunicator communicator = (LivePacketCommunicator)LivePacketDeviceTests.OpenLiveDevice())
+            {
+                PacketReplayer replayer = new PacketReplayer(communicator, "replay.pcap");
+                replayer.Multiplier = 0;
+            }
+        }
+
+        [TestMethod]
+        [ExpectedException(typeof(ArgumentNullException), AllowDerivedTypes = false)]
+        public void ReplayNullFileNameErrorTest()
+        {
+            using (LivePacketCommunicator communicator = (LivePacketCommunicator)LivePacketDeviceTests.OpenLiveDevice())
+            {
+                Assert.IsNotNull(new PacketReplayer(communicator, null));
+            }
+        }
+
+        private static string DumpPackets(int numPackets, TimeSpan intervalBetweenPackets, out List<Packet> packets)
+        {
+            DateTime timestamp = DateTime.Now;
+            packets = Enumerable.Range(0, numPackets)
+                .Select(i => _random.NextEthernetPacket(100 + i, timestamp.Add(TimeSpan.FromTicks(intervalBetweenPackets.Ticks * i)), SourceMac, DestinationMac))
+                .ToList();
+
+            string fileName = Path.GetTempPath() + @"replay.pcap";
+            PacketDumpFile.Dump(fileName, DataLinkKind.Ethernet, PacketDevice.DefaultSnapshotLength, packets);
+            return fileName;
+        }
+
+        private const string SourceMac = "11:22:33:44:55:66";
+        private const string DestinationMac = "77:88:99:AA:BB:CC";
+
+        private static readonly Random _random = new Random();
+    }
+}
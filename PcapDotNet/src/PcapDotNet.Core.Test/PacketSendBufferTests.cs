@@ -1,9 +1,13 @@
 using System;
 using System.Collections.Generic;
 using System.Diagnostics.CodeAnalysis;
+using System.Linq;
 using Microsoft.VisualStudio.TestTools.UnitTesting;
 using PcapDotNet.Packets;
+using PcapDotNet.Packets.Ethernet;
+using PcapDotNet.Packets.IpV4;
 using PcapDotNet.Packets.TestUtils;
+using PcapDotNet.Packets.Transport;
 using PcapDotNet.TestUtils;
 
 namespace PcapDotNet.Core.Test
@@ -82,6 +86,174 @@ namespace PcapDotNet.Core.Test
             Assert.Fail();
         }
 
+        [TestMethod]
+        public void EnqueueGrowTest()
+        {
+            const int NumPackets = 100;
+            const int PacketSize = 100;
+
+            using (PacketSendBuffer queue = new PacketSendBuffer(10))
+            {
+                queue.EnqueueRange(Enumerable.Range(0, NumPackets).Select(i => _random.NextEthernetPacket(PacketSize)));
+                Assert.AreEqual(NumPackets, queue.Length);
+                MoreAssert.IsBiggerOrEqual((uint)(NumPackets * (PacketSize + 16)), queue.Capacity);
+
+                uint capacity = queue.Capacity;
+                queue.Clear();
+                Assert.AreEqual(0, queue.Length);
+                Assert.AreEqual(capacity, queue.Capacity);
+
+                byte[] data = new byte[PacketSize * 2];
+                for (int i = 0; i != NumPackets; ++i)
+                    queue.Enqueue(data, PacketSize / 2, PacketSize, DateTime.Now);
+                Assert.AreEqual(NumPackets, queue.Length);
+                Assert.AreEqual(capacity, queue.Capacity);
+            }
+        }
+
+        [TestMethod]
+        public void TransmitClearedQueueToLiveTest()
+        {
+            const string SourceMac = "11:22:33:44:55:66";
+            const string DestinationMac = "77:88:99:AA:BB:CC";
+            const int NumPackets = 10;
+
+            using (PacketSendBuffer queue = new PacketSendBuffer(1))
+            {
+                using (PacketCommunicator communicator = LivePacketDeviceTests.OpenLiveDevice())
+                {
+                    communicator.SetFilter("ether src " + SourceMac + " and ether dst " + DestinationMac);
+                    for (int i = 0; i != 2; ++i)
+                    {
+                        queue.Clear();
+                        Packet packetToSend = _random.NextEthernetPacket(100 + i, SourceMac, DestinationMac);
+                        byte[] data = packetToSend.Buffer;
+                        for (int j = 0; j != NumPackets; ++j)
+                            queue.Enqueue(data, 0, data.Length, DateTime.Now);
+                        communicator.Transmit(queue, false);
+
+                        int numPacketsGot;
+                        PacketCommunicatorReceiveResult result =
+                            communicator.ReceiveSomePackets(out numPacketsGot, NumPackets, packet => Assert.AreEqual(packetToSend.Length, packet.Length));
+                        Assert.AreEqual(PacketCommunicatorReceiveResult.Ok, result);
+                        Assert.AreEqual(NumPackets, numPacketsGot);
+                    }
+                }
+            }
+        }
+
+        [TestMethod]
+        public void SendPacketsInBatchesTest()
+        {
+            const string SourceMac = "11:22:33:44:55:66";
+            const string DestinationMac = "77:88:99:AA:BB:CC";
+            const int NumPackets = 50;
+            const int PacketSize = 100;
+
+            DateTime timestamp = DateTime.Now;
+            List<Packet> packetsToSend = Enumerable.Range(0, NumPackets)
+                .Select(i => _random.NextEthernetPacket(PacketSize, timestamp.AddSeconds(0.01 * i), SourceMac, DestinationMac))
+                .ToList();
+
+            using (LivePacketCommunicator communicator = (LivePacketCommunicator)LivePacketDeviceTests.OpenLiveDevice())
+            {
+                communicator.SetFilter("ether src " + SourceMac + " and ether dst " + DestinationMac);
+                communicator.TransmitBatchSize = 10 * (PacketSize + 16);
+
+                Assert.AreEqual(NumPackets, communicator.SendPackets(packetsToSend, true));
+
+                int numPacketsHandled = 0;
+                int numPacketsGot;
+                PacketCommunicatorReceiveResult result =
+                    communicator.ReceiveSomePackets(out numPacketsGot, NumPackets, packet => Assert.AreEqual(packetsToSend[numPacketsHandled++], packet));
+                Assert.AreEqual(PacketCommunicatorReceiveResult.Ok, result);
+                Assert.AreEqual(NumPackets, numPacketsGot);
+            }
+        }
+
+        [TestMethod]
+        public void EnqueueBuilderAndTemplateToLiveTest()
+        {
+            const string SourceMac = "11:22:33:44:55:66";
+            const string DestinationMac = "77:88:99:AA:BB:CC";
+            const int NumPackets = 10;
+
+            EthernetLayer ethernetLayer = new EthernetLayer {Source = new MacAddress(SourceMac), Destination = new MacAddress(DestinationMac)};
+            IpV4Layer ipV4Layer = new IpV4Layer {Ttl = 64};
+            UdpLayer udpLayer = new UdpLayer {DestinationPort = 53, CalculateChecksumValue = true};
+            PayloadLayer payloadLayer = new PayloadLayer {Data = new Datagram(new byte[100])};
+            PacketBuilder packetBuilder = new PacketBuilder(ethernetLayer, ipV4Layer, udpLayer, payloadLayer);
+            CompiledPacketBuilder compiledBuilder = packetBuilder.Compile();
+            PacketTemplate template = new PacketTemplate(packetBuilder.Build(DateTime.Now));
+            PacketTemplateField sourcePort = template.DeclareField(PacketTemplateFieldKind.TransportSourcePort);
+
+            List<Packet> packetsToSend = new List<Packet>();
+            using (PacketSendBuffer queue = new PacketSendBuffer(1))
+            {
+                for (int i = 0; i != NumPackets; ++i)
+                {
+                    udpLayer.SourcePort = (ushort)i;
+                    packetsToSend.Add(packetBuilder.Build(DateTime.Now));
+                    if (i % 2 == 0)
+                    {
+                        queue.Enqueue(compiledBuilder, DateTime.Now);
+                    }
+                    else
+                    {
+                        sourcePort.Value = (uint)i;
+                        queue.Enqueue(template, DateTime.Now);
+                    }
+                }
+                Assert.AreEqual(NumPackets, queue.Length);
+
+                using (PacketCommunicator communicator = LivePacketDeviceTests.OpenLiveDevice())
+                {
+                    communicator.SetFilter("ether src " + SourceMac + " and ether dst " + DestinationMac);
+                    communicator.Transmit(queue, false);
+
+                    int numPacketsHandled = 0;
+                    int numPacketsGot;
+                    PacketCommunicatorReceiveResult result =
+                        communicator.ReceiveSomePackets(out numPacketsGot, NumPackets, packet => Assert.AreEqual(packetsToSend[numPacketsHandled++], packet));
+                    Assert.AreEqual(PacketCommunicatorReceiveResult.Ok, result);
+                    Assert.AreEqual(NumPackets, numPacketsGot);
+                }
+            }
+        }
+
+        [TestMethod]
+        [ExpectedException(typeof(ArgumentNullException), AllowDerivedTypes = false)]
+        public void EnqueueNullBuilderTest()
+        {
+            using (PacketSendBuffer queue = new PacketSendBuffer(10))
+            {
+                queue.Enqueue((CompiledPacketBuilder)null, DateTime.Now);
+            }
+            Assert.Fail();
+        }
+
+        [TestMethod]
+        [ExpectedException(typeof(ArgumentOutOfRangeException), AllowDerivedTypes = false)]
+        public void EnqueueSegmentOutOfRangeTest()
+        {
+            using (PacketSendBuffer queue = new PacketSendBuffer(10))
+            {
+                queue.Enqueue(new byte[100], 50, 51, DateTime.Now);
+            }
+            Assert.Fail();
+        }
+
+        [TestMethod]
+        public void EnqueueEmptySegmentTest()
+        {
+            using (PacketSendBuffer queue = new PacketSendBuffer(100))
+            {
+                // An empty packet that starts at the end of its buffer.
+                queue.Enqueue(new Packet(new byte[10], 10, 0, DateTime.Now, new DataLink(DataLinkKind.Ethernet)));
+                Assert.AreEqual(1, queue.Length);
+            }
+        }
+
         [TestMethod]
         [ExpectedException(typeof(ArgumentNullException), AllowDerivedTypes = false)]
         public void TransmitNullTest()
@@ -1,4 +1,8 @@
 #include "BerkeleyPacketFilter.h"
+
+#include <string.h>
+
+#include "BerkeleyPacketFilterBatch.h"
 #include "Pcap.h"
 #include "MarshalingServices.h"
 #include "PcapError.h"
@@ -6,7 +10,11 @@
 #include "PacketHeader.h"
 
 using namespace System;
+using namespace System::Collections;
+using namespace System::Collections::Generic;
+using namespace System::Globalization;
 using namespace System::Runtime::InteropServices;
+using namespace System::Threading;
 using namespace PcapDotNet::Core;
 using namespace PcapDotNet::Packets;
 
@@ -27,7 +35,10 @@ bool BerkeleyPacketFilter::Test([Out] int% snapshotLength, Packet^ packet)
 
     pcap_pkthdr pcapHeader;
     PacketHeader::GetPcapHeader(pcapHeader, packet);
-    pin_ptr<Byte> unmanagedPacketBytes = &packet->Buffer[0];
+    // An empty packet can start at the end of its buffer, where there's no element to pin.
+    pin_ptr<Byte> unmanagedPacketBytes = nullptr;
+    if (packet->Length != 0)
+        unmanagedPacketBytes = &packet->Buffer[packet->StartOffset];
 
     snapshotLength = pcap_offline_filter(_bpf, &pcapHeader, unmanagedPacketBytes);
     return (snapshotLength != 0);
@@ -39,10 +50,77 @@ bool BerkeleyPacketFilter::Test(Packet^ packet)
     return Test(snapshotLength, packet);
 }
 
+BitArray^ BerkeleyPacketFilter::TestMany([Out] array<int>^% snapshotLengths, IList<Packet^>^ packets)
+{
+    if (packets == nullptr)
+        throw gcnew ArgumentNullException("packets");
+
+    int count = packets->Count;
+    array<IntPtr>^ packetData = gcnew array<IntPtr>(count);
+    array<int>^ lengths = gcnew array<int>(count);
+    array<unsigned int>^ originalLengths = gcnew array<unsigned int>(count);
+    array<GCHandle>^ handles = gcnew array<GCHandle>(count);
+    try
+    {
+        // Every packet is filtered where it is instead of being copied.
+        for (int i = 0; i != count; ++i)
+        {
+            Packet^ packet = packets[i];
+            if (packet == nullptr)
+                throw gcnew ArgumentNullException("packets", "Packet " + i.ToString(CultureInfo::InvariantCulture) + " is null");
+
+            handles[i] = GCHandle::Alloc(packet->Buffer, GCHandleType::Pinned);
+            packetData[i] = IntPtr::Add(handles[i].AddrOfPinnedObject(), packet->StartOffset);
+            lengths[i] = packet->Length;
+            originalLengths[i] = packet->OriginalLength;
+        }
+
+        return TestMany(snapshotLengths, packetData, lengths, originalLengths);
+    }
+    finally
+    {
+        for (int i = 0; i != count; ++i)
+        {
+            if (handles[i].IsAllocated)
+                handles[i].Free();
+        }
+    }
+}
+
+BitArray^ BerkeleyPacketFilter::TestMany([Out] array<int>^% snapshotLengths, array<Byte>^ buffer, array<int>^ offsets, array<int>^ lengths)
+{
+    if (buffer == nullptr)
+        throw gcnew ArgumentNullException("buffer");
+    if (offsets == nullptr)
+        throw gcnew ArgumentNullException("offsets");
+    if (lengths == nullptr)
+        throw gcnew ArgumentNullException("lengths");
+    if (offsets->Length != lengths->Length)
+        throw gcnew ArgumentException("Got " + offsets->Length.ToString(CultureInfo::InvariantCulture) + " offsets and " + lengths->Length.ToString(CultureInfo::InvariantCulture) + " lengths", "lengths");
+
+    for (int i = 0; i != offsets->Length; ++i)
+    {
+        if (offsets[i] < 0 || offsets[i] > buffer->Length)
+            throw gcnew ArgumentOutOfRangeException("offsets", offsets[i], "Must be between 0 and the buffer length " + buffer->Length.ToString(CultureInfo::InvariantCulture));
+        if (lengths[i] < 0 || lengths[i] > buffer->Length - offsets[i])
+            throw gcnew ArgumentOutOfRangeException("lengths", lengths[i], "Must be between 0 and the buffer length left after the offset " + offsets[i].ToString(CultureInfo::InvariantCulture));
+    }
+
+    // Empty arrays can't be pinned. An empty buffer only holds empty packets so nothing is read from it.
+    pin_ptr<Byte> unmanagedBuffer = nullptr;
+    if (buffer->Length != 0)
+        unmanagedBuffer = &buffer[0];
+
+    array<IntPtr>^ packetData = gcnew array<IntPtr>(offsets->Length);
+    for (int i = 0; i != offsets->Length; ++i)
+        packetData[i] = IntPtr(unmanagedBuffer + offsets[i]);
+
+    return TestMany(snapshotLengths, packetData, lengths, nullptr);
+}
+
 BerkeleyPacketFilter::~BerkeleyPacketFilter()
 {
-    pcap_freecode(_bpf);
-    delete _bpf;
+    Free();
 }
 
 // Internal
@@ -52,12 +130,45 @@ BerkeleyPacketFilter::BerkeleyPacketFilter(pcap_t* pcapDescriptor, String^ filte
     Initialize(pcapDescriptor, filterString, netmask);
 }
 
+BerkeleyPacketFilter::BerkeleyPacketFilter(const bpf_insn* instructions, unsigned int numInstructions)
+{
+    // The instructions aren't allocated by WinPcap, so they can't be freed by pcap_freecode().
+    _bpf = new bpf_program();
+    _bpf->bf_len = numInstructions;
+    _bpf->bf_insns = new bpf_insn[numInstructions];
+    memcpy(_bpf->bf_insns, instructions, numInstructions * sizeof(bpf_insn));
+    _program = gcnew SharedProgram(_bpf, true);
+}
+
+BerkeleyPacketFilter::BerkeleyPacketFilter(BerkeleyPacketFilter^ other)
+{
+    other->_program->AddReference();
+    _program = other->_program;
+    _bpf = other->_bpf;
+}
+
 void BerkeleyPacketFilter::SetFilter(pcap_t* pcapDescriptor)
 {
     if (pcap_setfilter(pcapDescriptor, _bpf) != 0)
         throw PcapError::BuildInvalidOperation("Failed setting bpf filter", pcapDescriptor);
 }
 
+bpf_program* BerkeleyPacketFilter::Program::get()
+{
+    return _bpf;
+}
+
+void BerkeleyPacketFilter::Free()
+{
+    if (_program == nullptr)
+        return;
+
+    SharedProgram^ program = _program;
+    _program = nullptr;
+    _bpf = NULL;
+    program->Release();
+}
+
 // Private
 
 void BerkeleyPacketFilter::Initialize(String^ filterString, int snapshotLength, DataLinkKind kind, IpV4SocketAddress^ netmask)
@@ -74,6 +185,31 @@ void BerkeleyPacketFilter::Initialize(String^ filterString, int snapshotLength,
     }
 }
 
+BitArray^ BerkeleyPacketFilter::TestMany([Out] array<int>^% snapshotLengths, array<IntPtr>^ packetData, array<int>^ lengths, array<unsigned int>^ originalLengths)
+{
+    int count = packetData->Length;
+    array<int>^ results = gcnew array<int>(count);
+    if (count != 0)
+    {
+        pin_ptr<unsigned int> unmanagedOriginalLengths = nullptr;
+        if (originalLengths != nullptr)
+            unmanagedOriginalLengths = &originalLengths[0];
+        pin_ptr<IntPtr> unmanagedPacketData = &packetData[0];
+        pin_ptr<int> unmanagedLengths = &lengths[0];
+        pin_ptr<int> unmanagedResults = &results[0];
+
+        BerkeleyPacketFilterBatch::Test(_bpf, reinterpret_cast<const unsigned char* const*>(unmanagedPacketData), unmanagedLengths, unmanagedOriginalLengths, count,
+                                        unmanagedResults);
+    }
+
+    BitArray^ matches = gcnew BitArray(count);
+    for (int i = 0; i != count; ++i)
+        matches[i] = (results[i] != 0);
+
+    snapshotLengths = results;
+    return matches;
+}
+
 void BerkeleyPacketFilter::Initialize(pcap_t* pcapDescriptor, String^ filterString, IpV4SocketAddress^ netmask)
 {
     std::string unmanagedFilterString = MarshalingServices::ManagedToUnmanagedString(filterString);
@@ -96,4 +232,29 @@ void BerkeleyPacketFilter::Initialize(pcap_t* pcapDescriptor, String^ filterStri
         delete _bpf;
         throw;
     }
+
+    _program = gcnew SharedProgram(_bpf, false);
+}
+
+BerkeleyPacketFilter::SharedProgram::SharedProgram(bpf_program* bpf, bool ownsInstructions)
+    : Bpf(bpf), _ownsInstructions(ownsInstructions), _references(1)
+{
+}
+
+void BerkeleyPacketFilter::SharedProgram::AddReference()
+{
+    Interlocked::Increment(_references);
+}
+
+void BerkeleyPacketFilter::SharedProgram::Release()
+{
+    if (Interlocked::Decrement(_references) != 0)
+        return;
+
+    if (_ownsInstructions)
+        delete[] Bpf->bf_insns;
+    else
+        pcap_freecode(Bpf);
+    delete Bpf;
+    Bpf = NULL;
 }
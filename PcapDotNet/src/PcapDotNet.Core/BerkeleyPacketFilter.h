@@ -66,21 +66,87 @@ namespace PcapDotNet { namespace Core
         /// </returns>
         bool Test(Packets::Packet^ packet);
 
+        /// <summary>
+        /// Returns which of the given offline packets the filter applies to.
+        /// Gives the same results as calling Test() for every packet, but runs the filter over the whole batch in a single native call.
+        /// The packets are pinned where they are for the duration of the call and are not copied.
+        /// </summary>
+        /// <param name="snapshotLengths">For every packet, the length of the bytes that are currently available into the packet if the packet satisfies the filter, 0 otherwise.</param>
+        /// <param name="packets">The packets that have to be filtered.</param>
+        /// <returns>
+        /// A bit for every packet, set iff the packet satisfies the filter.
+        /// </returns>
+        /// <exception cref="System::ArgumentNullException">The packets list or one of the packets is null.</exception>
+        System::Collections::BitArray^ TestMany([System::Runtime::InteropServices::Out] array<int>^% snapshotLengths,
+                                                System::Collections::Generic::IList<Packets::Packet^>^ packets);
+
+        /// <summary>
+        /// Returns which of the packets in the given buffer the filter applies to.
+        /// Packet i is lengths[i] bytes long and starts at offsets[i]. The original length of every packet is assumed to be its length.
+        /// The filter is run over all the packets in a single native call.
+        /// </summary>
+        /// <param name="snapshotLengths">For every packet, the length of the bytes that are currently available into the packet if the packet satisfies the filter, 0 otherwise.</param>
+        /// <param name="buffer">The buffer that holds the packets.</param>
+        /// <param name="offsets">The offset of every packet in the buffer.</param>
+        /// <param name="lengths">The length of every packet.</param>
+        /// <returns>
+        /// A bit for every packet, set iff the packet satisfies the filter.
+        /// </returns>
+        /// <exception cref="System::ArgumentNullException">The buffer, the offsets or the lengths are null.</exception>
+        /// <exception cref="System::ArgumentException">The offsets and the lengths don't have the same number of elements.</exception>
+        /// <exception cref="System::ArgumentOutOfRangeException">One of the packets is not inside the buffer.</exception>
+        System::Collections::BitArray^ TestMany([System::Runtime::InteropServices::Out] array<int>^% snapshotLengths,
+                                                array<System::Byte>^ buffer, array<int>^ offsets, array<int>^ lengths);
+
         /// <summary>
         /// Free a filter.
         /// Used to free up allocated memory when that BPF program is no longer needed, for example after it has been made the filter program for a packet communicator by a call to PacketCommunicator.SetFilter().
         /// </summary>
+        /// <remarks>
+        /// Filters returned by a BerkeleyPacketFilterCache share their program with the cache. The program is freed when the cache and all these filters free it.
+        /// </remarks>
         ~BerkeleyPacketFilter(); // IDisposable
 
     internal:
         BerkeleyPacketFilter(pcap_t* pcapDescriptor, System::String^ filterString, IpV4SocketAddress^ netmask);
+        BerkeleyPacketFilter(const bpf_insn* instructions, unsigned int numInstructions);
+        // Shares the program of the other filter, which must not be freed yet.
+        BerkeleyPacketFilter(BerkeleyPacketFilter^ other);
         void SetFilter(pcap_t* pcapDescriptor);
 
+        property bpf_program* Program
+        {
+            bpf_program* get();
+        }
+
+        // Frees this filter reference to the program. Does nothing if it was already freed.
+        void Free();
+
     private:
         void Initialize(System::String^ filterString, int snapshotLength, Packets::DataLinkKind kind, IpV4SocketAddress^ netmask);
         void Initialize(pcap_t* pcapDescriptor, System::String^ filterString, IpV4SocketAddress^ netmask);
+        System::Collections::BitArray^ TestMany([System::Runtime::InteropServices::Out] array<int>^% snapshotLengths,
+                                                array<System::IntPtr>^ packetData, array<int>^ lengths, array<unsigned int>^ originalLengths);
+
+    private:
+        // A program with the number of filters that reference it.
+        ref class SharedProgram
+        {
+        public:
+            SharedProgram(bpf_program* bpf, bool ownsInstructions);
+
+            void AddReference();
+            void Release();
+
+            bpf_program* Bpf;
+
+        private:
+            bool _ownsInstructions;
+            int _references;
+        };
 
     private:
         bpf_program* _bpf;
+        SharedProgram^ _program;
     };
 }}
\ No newline at end of file
@@ -0,0 +1,23 @@
+#include "BerkeleyPacketFilterBatch.h"
+
+#include "Pcap.h"
+
+using namespace PcapDotNet::Core;
+
+#pragma managed(push, off)
+
+// static
+void BerkeleyPacketFilterBatch::Test(bpf_program* program, const unsigned char* const* packetData, const int* lengths, const unsigned int* originalLengths,
+                                     int count, int* snapshotLengths)
+{
+    // Filter programs don't look at the timestamp, so one header is reused for all the packets.
+    pcap_pkthdr pcapHeader = {};
+    for (int i = 0; i != count; ++i)
+    {
+        pcapHeader.caplen = lengths[i];
+        pcapHeader.len = originalLengths == NULL ? lengths[i] : originalLengths[i];
+        snapshotLengths[i] = pcap_offline_filter(program, &pcapHeader, packetData[i]);
+    }
+}
+
+#pragma managed(pop)
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "PcapDeclarations.h"
+
+namespace PcapDotNet { namespace Core 
+{
+    // Runs a filter program over many packets in a single native call.
+    class BerkeleyPacketFilterBatch
+    {
+    public:
+        // Tests count packets and sets their snapshot lengths, 0 for packets that don't match.
+        // If originalLengths is NULL, each packet original length is its captured length.
+        static void Test(bpf_program* program, const unsigned char* const* packetData, const int* lengths, const unsigned int* originalLengths,
+                         int count, int* snapshotLengths);
+    };
+}}
@@ -0,0 +1,311 @@
+#include "BerkeleyPacketFilterCache.h"
+#include "BerkeleyPacketFilterValidator.h"
+#include "Pcap.h"
+#include "PcapDataLink.h"
+
+using namespace System;
+using namespace System::Collections::Generic;
+using namespace System::Globalization;
+using namespace System::IO;
+using namespace System::Threading;
+using namespace PcapDotNet::Core;
+using namespace PcapDotNet::Packets;
+
+// static
+BerkeleyPacketFilterCache^ BerkeleyPacketFilterCache::Default::get()
+{
+    return _default;
+}
+
+BerkeleyPacketFilterCache::BerkeleyPacketFilterCache()
+    : _capacity(DefaultCapacity)
+{
+    _entries = gcnew Dictionary<String^, LinkedListNode<Entry^>^>();
+    _recentlyUsed = gcnew LinkedList<Entry^>();
+}
+
+BerkeleyPacketFilterCache::BerkeleyPacketFilterCache(int capacity)
+{
+    if (capacity <= 0)
+        throw gcnew ArgumentOutOfRangeException("capacity", capacity, "Must be positive");
+
+    _capacity = capacity;
+    _entries = gcnew Dictionary<String^, LinkedListNode<Entry^>^>();
+    _recentlyUsed = gcnew LinkedList<Entry^>();
+}
+
+int BerkeleyPacketFilterCache::Capacity::get()
+{
+    return _capacity;
+}
+
+int BerkeleyPacketFilterCache::Count::get()
+{
+    Monitor::Enter(_entries);
+    try
+    {
+        return _entries->Count;
+    }
+    finally
+    {
+        Monitor::Exit(_entries);
+    }
+}
+
+BerkeleyPacketFilter^ BerkeleyPacketFilterCache::GetFilter(String^ filterValue, int snapshotLength, DataLinkKind kind, IpV4SocketAddress^ netmask)
+{
+    return GetFilter(filterValue, PcapDataLink(kind).Value, snapshotLength, netmask, NULL);
+}
+
+BerkeleyPacketFilter^ BerkeleyPacketFilterCache::GetFilter(String^ filterValue, int snapshotLength, DataLinkKind kind)
+{
+    return GetFilter(filterValue, snapshotLength, kind, nullptr);
+}
+
+void BerkeleyPacketFilterCache::Clear()
+{
+    Monitor::Enter(_entries);
+    try
+    {
+        // Filters returned by GetFilter() hold their own references to the programs.
+        for each (Entry^ entry in _recentlyUsed)
+            entry->Filter->Free();
+        _entries->Clear();
+        _recentlyUsed->Clear();
+    }
+    finally
+    {
+        Monitor::Exit(_entries);
+    }
+}
+
+void BerkeleyPacketFilterCache::Save(Stream^ stream)
+{
+    if (stream == nullptr)
+        throw gcnew ArgumentNullException("stream");
+
+    BinaryWriter^ writer = gcnew BinaryWriter(stream);
+    Monitor::Enter(_entries);
+    try
+    {
+        AssertNotDisposed();
+
+        writer->Write(FormatSignature);
+        writer->Write(FormatVersion);
+        writer->Write(_entries->Count);
+        // From the least recently used, so loading the stream keeps the order.
+        for (LinkedListNode<Entry^>^ node = _recentlyUsed->Last; node != nullptr; node = node->Previous)
+        {
+            Entry^ entry = node->Value;
+            writer->Write(entry->FilterValue);
+            writer->Write(entry->DataLink);
+            writer->Write(entry->SnapshotLength);
+            writer->Write(entry->Netmask);
+
+            const bpf_program* program = entry->Filter->Program;
+            writer->Write(program->bf_len);
+            for (unsigned int i = 0; i != program->bf_len; ++i)
+            {
+                const bpf_insn& instruction = program->bf_insns[i];
+                writer->Write(instruction.code);
+                writer->Write(instruction.jt);
+                writer->Write(instruction.jf);
+                writer->Write(static_cast<unsigned int>(instruction.k));
+            }
+        }
+    }
+    finally
+    {
+        Monitor::Exit(_entries);
+    }
+
+    // Not disposing the writer, the stream belongs to the caller.
+    writer->Flush();
+}
+
+int BerkeleyPacketFilterCache::Load(Stream^ stream)
+{
+    if (stream == nullptr)
+        throw gcnew ArgumentNullException("stream");
+    AssertNotDisposed();
+
+    BinaryReader^ reader = gcnew BinaryReader(stream);
+    try
+    {
+        if (reader->ReadUInt32() != FormatSignature)
+            throw gcnew InvalidDataException("The stream doesn't hold saved filters");
+        int version = reader->ReadInt32();
+        if (version != FormatVersion)
+            throw gcnew InvalidDataException("Unsupported saved filters version " + version.ToString(CultureInfo::InvariantCulture));
+
+        int numEntries = reader->ReadInt32();
+        if (numEntries < 0)
+            throw gcnew InvalidDataException("Negative number of saved filters " + numEntries.ToString(CultureInfo::InvariantCulture));
+
+        int numAdded = 0;
+        for (int i = 0; i != numEntries; ++i)
+        {
+            String^ filterValue = reader->ReadString();
+            int dataLink = reader->ReadInt32();
+            int snapshotLength = reader->ReadInt32();
+            unsigned int netmask = reader->ReadUInt32();
+
+            // BPF_MAXINSNS
+            unsigned int numInstructions = reader->ReadUInt32();
+            if (numInstructions == 0 || numInstructions > 4096)
+                throw gcnew InvalidDataException("Invalid number of instructions " + numInstructions.ToString(CultureInfo::InvariantCulture) + " in filter <" + filterValue + ">");
+
+            BerkeleyPacketFilter^ filter;
+            bpf_insn* instructions = new bpf_insn[numInstructions];
+            try
+            {
+                for (unsigned int j = 0; j != numInstructions; ++j)
+                {
+                    instructions[j].code = reader->ReadUInt16();
+                    instructions[j].jt = reader->ReadByte();
+                    instructions[j].jf = reader->ReadByte();
+                    instructions[j].k = reader->ReadUInt32();
+                }
+
+                filter = gcnew BerkeleyPacketFilter(instructions, numInstructions);
+            }
+            finally
+            {
+                delete[] instructions;
+            }
+
+            // The interpreter trusts the program, so a program that could jump or access memory out of range is refused.
+            // Valid programs that CompiledBerkeleyPacketFilter can't compile are still run by the interpreter.
+            if (!BerkeleyPacketFilterValidator::IsValid(filter->Program->bf_insns, filter->Program->bf_len))
+            {
+                filter->Free();
+                throw gcnew InvalidDataException("Invalid program for filter <" + filterValue + ">");
+            }
+
+            if (TryAdd(gcnew Entry(filterValue, dataLink, snapshotLength, netmask, filter)))
+                ++numAdded;
+        }
+
+        return numAdded;
+    }
+    catch (EndOfStreamException^ exception)
+    {
+        throw gcnew InvalidDataException("The saved filters are truncated", exception);
+    }
+}
+
+BerkeleyPacketFilterCache::~BerkeleyPacketFilterCache()
+{
+    Monitor::Enter(_entries);
+    try
+    {
+        _disposed = true;
+    }
+    finally
+    {
+        Monitor::Exit(_entries);
+    }
+    Clear();
+}
+
+// Internal
+
+BerkeleyPacketFilter^ BerkeleyPacketFilterCache::GetFilter(pcap_t* pcapDescriptor, String^ filterValue, IpV4SocketAddress^ netmask)
+{
+    return GetFilter(filterValue, pcap_datalink(pcapDescriptor), pcap_snapshot(pcapDescriptor), netmask, pcapDescriptor);
+}
+
+// Private
+
+BerkeleyPacketFilter^ BerkeleyPacketFilterCache::GetFilter(String^ filterValue, int dataLink, int snapshotLength, IpV4SocketAddress^ netmask,
+                                                           pcap_t* pcapDescriptor)
+{
+    if (filterValue == nullptr)
+        throw gcnew ArgumentNullException("filterValue");
+
+    unsigned int netmaskValue = GetNetmaskValue(netmask);
+    String^ key = GetKey(filterValue, dataLink, snapshotLength, netmaskValue);
+    Monitor::Enter(_entries);
+    try
+    {
+        AssertNotDisposed();
+
+        LinkedListNode<Entry^>^ node;
+        if (_entries->TryGetValue(key, node))
+            return Share(node);
+    }
+    finally
+    {
+        Monitor::Exit(_entries);
+    }
+
+    // Compiling outside the lock, if another thread added the same filter meanwhile, its filter wins.
+    BerkeleyPacketFilter^ filter = pcapDescriptor == NULL
+                                       ? gcnew BerkeleyPacketFilter(filterValue, snapshotLength, PcapDataLink(dataLink).Kind, netmask)
+                                       : gcnew BerkeleyPacketFilter(pcapDescriptor, filterValue, netmask);
+    Monitor::Enter(_entries);
+    try
+    {
+        TryAdd(gcnew Entry(filterValue, dataLink, snapshotLength, netmaskValue, filter));
+        return Share(_entries[key]);
+    }
+    finally
+    {
+        Monitor::Exit(_entries);
+    }
+}
+
+bool BerkeleyPacketFilterCache::TryAdd(Entry^ entry)
+{
+    String^ key = GetKey(entry->FilterValue, entry->DataLink, entry->SnapshotLength, entry->Netmask);
+    Monitor::Enter(_entries);
+    try
+    {
+        if (_disposed || _entries->ContainsKey(key))
+        {
+            entry->Filter->Free();
+            AssertNotDisposed();
+            return false;
+        }
+
+        _entries->Add(key, _recentlyUsed->AddFirst(entry));
+        while (_recentlyUsed->Count > _capacity)
+        {
+            Entry^ evicted = _recentlyUsed->Last->Value;
+            _recentlyUsed->RemoveLast();
+            _entries->Remove(GetKey(evicted->FilterValue, evicted->DataLink, evicted->SnapshotLength, evicted->Netmask));
+            evicted->Filter->Free();
+        }
+        return true;
+    }
+    finally
+    {
+        Monitor::Exit(_entries);
+    }
+}
+
+BerkeleyPacketFilter^ BerkeleyPacketFilterCache::Share(LinkedListNode<Entry^>^ node)
+{
+    _recentlyUsed->Remove(node);
+    _recentlyUsed->AddFirst(node);
+    return gcnew BerkeleyPacketFilter(node->Value->Filter);
+}
+
+void BerkeleyPacketFilterCache::AssertNotDisposed()
+{
+    if (_disposed)
+        throw gcnew ObjectDisposedException("BerkeleyPacketFilterCache");
+}
+
+// static
+String^ BerkeleyPacketFilterCache::GetKey(String^ filterValue, int dataLink, int snapshotLength, unsigned int netmask)
+{
+    return String::Format(CultureInfo::InvariantCulture, "{0}/{1}/{2}/{3}", dataLink, snapshotLength, netmask, filterValue);
+}
+
+// static
+unsigned int BerkeleyPacketFilterCache::GetNetmaskValue(IpV4SocketAddress^ netmask)
+{
+    // pcap_compile() treats no netmask as 0.
+    return netmask == nullptr ? 0 : netmask->Address.ToValue();
+}
@@ -0,0 +1,161 @@
+#pragma once
+
+#include "BerkeleyPacketFilter.h"
+
+namespace PcapDotNet { namespace Core 
+{
+    /// <summary>
+    /// Keeps compiled filters by filter value, link layer, snapshot length and netmask, so each filter is compiled once.
+    /// The compiled programs can be saved to a stream and loaded back without compiling them again.
+    /// </summary>
+    /// <remarks>
+    ///   <para>The cache keeps up to Capacity filters. When a filter is added to a full cache, the least recently used filter is evicted.</para>
+    ///   <para>
+    ///     Every filter returned shares its program with the cache and must be disposed by the caller.
+    ///     The program is freed when it was evicted or cleared from the cache and all the filters sharing it were disposed.
+    ///   </para>
+    ///   <para>This class is thread safe.</para>
+    /// </remarks>
+    public ref class BerkeleyPacketFilterCache sealed : System::IDisposable
+    {
+    public:
+        /// <summary>
+        /// The process wide cache, used by PacketCommunicator.SetFilter(String).
+        /// </summary>
+        static property BerkeleyPacketFilterCache^ Default
+        {
+            BerkeleyPacketFilterCache^ get();
+        }
+
+        /// <summary>
+        /// The capacity of caches created without a capacity, including the Default cache.
+        /// </summary>
+        static const int DefaultCapacity = 256;
+
+        /// <summary>
+        /// Creates an empty cache with the default capacity.
+        /// </summary>
+        BerkeleyPacketFilterCache();
+
+        /// <summary>
+        /// Creates an empty cache with the given capacity.
+        /// </summary>
+        /// <param name="capacity">The maximum number of filters in the cache.</param>
+        /// <exception cref="System::ArgumentOutOfRangeException">The capacity is not positive.</exception>
+        BerkeleyPacketFilterCache(int capacity);
+
+        /// <summary>
+        /// The maximum number of filters in the cache.
+        /// </summary>
+        property int Capacity
+        {
+            int get();
+        }
+
+        /// <summary>
+        /// The number of filters in the cache.
+        /// </summary>
+        property int Count
+        {
+            int get();
+        }
+
+        /// <summary>
+        /// Returns the cached filter for the given parameters, compiling it if it isn't in the cache.
+        /// <seealso cref="BerkeleyPacketFilter::BerkeleyPacketFilter(System::String^, int, Packets::DataLinkKind, IpV4SocketAddress^)"/>
+        /// </summary>
+        /// <param name="filterValue">A high level filtering expression (see <see href="http://www.winpcap.org/docs/docs_40_2/html/group__language.html">WinPcap Filtering expression syntax</see>)</param>
+        /// <param name="snapshotLength">Length of the packet that has to be retained of the communicator this filter will be applied on.</param>
+        /// <param name="kind">The link layer of an adapter that this filter will apply upon.</param>
+        /// <param name="netmask">Specifies the IPv4 netmask of the network on which packets are being captured or null if it isn't known.</param>
+        /// <returns>A filter sharing the cached program. The caller must dispose it.</returns>
+        /// <exception cref="System::ArgumentNullException">The filter value is null.</exception>
+        /// <exception cref="System::ArgumentException">Indicates an error. Probably caused by bad syntax.</exception>
+        /// <exception cref="System::ObjectDisposedException">The cache was disposed.</exception>
+        BerkeleyPacketFilter^ GetFilter(System::String^ filterValue, int snapshotLength, Packets::DataLinkKind kind, IpV4SocketAddress^ netmask);
+
+        /// <summary>
+        /// Returns the cached filter for the given parameters, compiling it without a netmask if it isn't in the cache.
+        /// <seealso cref="BerkeleyPacketFilter::BerkeleyPacketFilter(System::String^, int, Packets::DataLinkKind)"/>
+        /// </summary>
+        /// <param name="filterValue">A high level filtering expression (see <see href="http://www.winpcap.org/docs/docs_40_2/html/group__language.html">WinPcap Filtering expression syntax</see>)</param>
+        /// <param name="snapshotLength">Length of the packet that has to be retained of the communicator this filter will be applied on.</param>
+        /// <param name="kind">The link layer of an adapter that this filter will apply upon.</param>
+        /// <returns>A filter sharing the cached program. The caller must dispose it.</returns>
+        /// <exception cref="System::ArgumentNullException">The filter value is null.</exception>
+        /// <exception cref="System::ArgumentException">Indicates an error. Probably caused by bad syntax.</exception>
+        /// <exception cref="System::ObjectDisposedException">The cache was disposed.</exception>
+        BerkeleyPacketFilter^ GetFilter(System::String^ filterValue, int snapshotLength, Packets::DataLinkKind kind);
+
+        /// <summary>
+        /// Removes all the filters from the cache. Filters returned before stay valid until they are disposed.
+        /// </summary>
+        void Clear();
+
+        /// <summary>
+        /// Writes the compiled programs of all the cached filters to the stream.
+        /// </summary>
+        /// <param name="stream">The stream to write to.</param>
+        /// <exception cref="System::ArgumentNullException">The stream is null.</exception>
+        /// <exception cref="System::ObjectDisposedException">The cache was disposed.</exception>
+        void Save(System::IO::Stream^ stream);
+
+        /// <summary>
+        /// Reads compiled programs written by Save() and adds the ones that aren't already cached.
+        /// Adding more filters than the capacity evicts the least recently used ones.
+        /// </summary>
+        /// <param name="stream">The stream to read from.</param>
+        /// <returns>The number of filters added to the cache.</returns>
+        /// <exception cref="System::ArgumentNullException">The stream is null.</exception>
+        /// <exception cref="System::IO::InvalidDataException">The stream doesn't hold filters saved by Save() or one of the programs is invalid.</exception>
+        /// <exception cref="System::ObjectDisposedException">The cache was disposed.</exception>
+        int Load(System::IO::Stream^ stream);
+
+        /// <summary>
+        /// Removes all the filters from the cache. Filters returned before stay valid until they are disposed.
+        /// </summary>
+        ~BerkeleyPacketFilterCache(); // IDisposable
+
+    internal:
+        BerkeleyPacketFilter^ GetFilter(pcap_t* pcapDescriptor, System::String^ filterValue, IpV4SocketAddress^ netmask);
+
+    private:
+        ref class Entry
+        {
+        public:
+            Entry(System::String^ filterValue, int dataLink, int snapshotLength, unsigned int netmask, BerkeleyPacketFilter^ filter)
+                : FilterValue(filterValue), DataLink(dataLink), SnapshotLength(snapshotLength), Netmask(netmask), Filter(filter)
+            {
+            }
+
+            System::String^ FilterValue;
+            int DataLink;
+            int SnapshotLength;
+            unsigned int Netmask;
+            BerkeleyPacketFilter^ Filter;
+        };
+
+        BerkeleyPacketFilter^ GetFilter(System::String^ filterValue, int dataLink, int snapshotLength, IpV4SocketAddress^ netmask, pcap_t* pcapDescriptor);
+        // Adds the entry as the most recently used one and evicts the least recently used entries beyond the capacity.
+        // If the entry isn't added, because its key is already cached or the cache was disposed, its filter is freed.
+        bool TryAdd(Entry^ entry);
+        // Marks the entry as the most recently used one and returns a filter sharing its program. Must be called with the lock held.
+        BerkeleyPacketFilter^ Share(System::Collections::Generic::LinkedListNode<Entry^>^ node);
+        void AssertNotDisposed();
+
+        static System::String^ GetKey(System::String^ filterValue, int dataLink, int snapshotLength, unsigned int netmask);
+        static unsigned int GetNetmaskValue(IpV4SocketAddress^ netmask);
+
+    private:
+        // "BPFC" when read as little endian bytes.
+        static const unsigned int FormatSignature = 0x43465042;
+        static const int FormatVersion = 1;
+        static BerkeleyPacketFilterCache^ _default = gcnew BerkeleyPacketFilterCache();
+
+        // The entries by key, and from the most recently used to the least recently used.
+        System::Collections::Generic::Dictionary<System::String^, System::Collections::Generic::LinkedListNode<Entry^>^>^ _entries;
+        System::Collections::Generic::LinkedList<Entry^>^ _recentlyUsed;
+        int _capacity;
+        bool _disposed;
+    };
+}}
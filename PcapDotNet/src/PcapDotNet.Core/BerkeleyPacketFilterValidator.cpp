@@ -0,0 +1,137 @@
+#include "BerkeleyPacketFilterValidator.h"
+
+#include "Pcap.h"
+
+using namespace PcapDotNet::Core;
+
+#pragma managed(push, off)
+
+// static
+bool BerkeleyPacketFilterValidator::IsValid(const bpf_insn* instructions, unsigned int numInstructions)
+{
+    if (instructions == NULL || numInstructions == 0)
+        return false;
+
+    for (unsigned int pc = 0; pc != numInstructions; ++pc)
+    {
+        const bpf_insn& instruction = instructions[pc];
+        switch (BPF_CLASS(instruction.code))
+        {
+        case BPF_LD:
+        case BPF_LDX:
+            if (!IsValidLoad(instruction))
+                return false;
+            break;
+
+        case BPF_ST:
+        case BPF_STX:
+            if (instruction.code != BPF_CLASS(instruction.code) || instruction.k >= BPF_MEMWORDS)
+                return false;
+            break;
+
+        case BPF_ALU:
+            if (!IsValidAlu(instruction))
+                return false;
+            break;
+
+        case BPF_JMP:
+            if (!IsValidJump(instruction, numInstructions - pc - 1))
+                return false;
+            break;
+
+        case BPF_RET:
+            if (instruction.code != (BPF_RET | BPF_K) && instruction.code != (BPF_RET | BPF_A))
+                return false;
+            break;
+
+        case BPF_MISC:
+            if (instruction.code != (BPF_MISC | BPF_TAX) && instruction.code != (BPF_MISC | BPF_TXA))
+                return false;
+            break;
+
+        default:
+            return false;
+        }
+    }
+
+    // Running past the last instruction is undefined.
+    return BPF_CLASS(instructions[numInstructions - 1].code) == BPF_RET;
+}
+
+// Private
+
+// Unlike bpf_validate(), the unused bits of the code must be 0.
+// The userland interpreter matches whole codes and aborts on codes it doesn't know.
+
+// static
+bool BerkeleyPacketFilterValidator::IsValidLoad(const bpf_insn& instruction)
+{
+    bool isLoadX = BPF_CLASS(instruction.code) == BPF_LDX;
+    switch (BPF_MODE(instruction.code))
+    {
+    case BPF_IMM:
+    case BPF_LEN:
+        return BPF_SIZE(instruction.code) == BPF_W;
+
+    case BPF_MEM:
+        return BPF_SIZE(instruction.code) == BPF_W && instruction.k < BPF_MEMWORDS;
+
+    case BPF_ABS:
+    case BPF_IND:
+        // There is no maximum packet length, the interpreter checks every packet access against the captured length.
+        return !isLoadX && (BPF_SIZE(instruction.code) == BPF_W || BPF_SIZE(instruction.code) == BPF_H || BPF_SIZE(instruction.code) == BPF_B);
+
+    case BPF_MSH:
+        return isLoadX && BPF_SIZE(instruction.code) == BPF_B;
+
+    default:
+        return false;
+    }
+}
+
+// static
+bool BerkeleyPacketFilterValidator::IsValidAlu(const bpf_insn& instruction)
+{
+    switch (BPF_OP(instruction.code))
+    {
+    case BPF_ADD:
+    case BPF_SUB:
+    case BPF_MUL:
+    case BPF_OR:
+    case BPF_AND:
+    case BPF_LSH:
+    case BPF_RSH:
+        return true;
+
+    case BPF_DIV:
+        return BPF_SRC(instruction.code) == BPF_X || instruction.k != 0;
+
+    case BPF_NEG:
+        return BPF_SRC(instruction.code) == BPF_K;
+
+    default:
+        return false;
+    }
+}
+
+// static
+bool BerkeleyPacketFilterValidator::IsValidJump(const bpf_insn& instruction, unsigned int instructionsLeft)
+{
+    // Jumps are relative to the next instruction, so they can only go forward.
+    switch (BPF_OP(instruction.code))
+    {
+    case BPF_JA:
+        return BPF_SRC(instruction.code) == BPF_K && instruction.k < instructionsLeft;
+
+    case BPF_JEQ:
+    case BPF_JGT:
+    case BPF_JGE:
+    case BPF_JSET:
+        return instruction.jt < instructionsLeft && instruction.jf < instructionsLeft;
+
+    default:
+        return false;
+    }
+}
+
+#pragma managed(pop)
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "PcapDeclarations.h"
+
+namespace PcapDotNet { namespace Core 
+{
+    // Checks that a filter program can be run by the interpreter, like bpf_validate() in libpcap.
+    // The interpreter trusts the program, so programs that weren't built by pcap_compile() must be checked first.
+    class BerkeleyPacketFilterValidator
+    {
+    public:
+        // True iff every instruction is one the interpreter runs, jumps go forward inside the program,
+        // scratch memory indices are in range, there is no division by a constant 0 and the program ends with a return.
+        static bool IsValid(const bpf_insn* instructions, unsigned int numInstructions);
+
+    private:
+        static bool IsValidLoad(const bpf_insn& instruction);
+        static bool IsValidAlu(const bpf_insn& instruction);
+        static bool IsValidJump(const bpf_insn& instruction, unsigned int instructionsLeft);
+    };
+}}
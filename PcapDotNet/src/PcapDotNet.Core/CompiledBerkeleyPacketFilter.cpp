@@ -0,0 +1,408 @@
+#include "CompiledBerkeleyPacketFilter.h"
+#include "BerkeleyPacketFilterValidator.h"
+#include "Pcap.h"
+
+using namespace System;
+using namespace System::Reflection::Emit;
+using namespace System::Runtime::InteropServices;
+using namespace PcapDotNet::Core;
+using namespace PcapDotNet::Packets;
+
+CompiledBerkeleyPacketFilter::CompiledBerkeleyPacketFilter(BerkeleyPacketFilter^ filter)
+{
+    if (filter == nullptr)
+        throw gcnew ArgumentNullException("filter");
+
+    _filter = filter;
+    _function = Compile(filter->Program);
+}
+
+BerkeleyPacketFilter^ CompiledBerkeleyPacketFilter::Filter::get()
+{
+    return _filter;
+}
+
+bool CompiledBerkeleyPacketFilter::IsCompiled::get()
+{
+    return _function != nullptr;
+}
+
+bool CompiledBerkeleyPacketFilter::Test([Out] int% snapshotLength, Packet^ packet)
+{
+    if (packet == nullptr)
+        throw gcnew ArgumentNullException("packet");
+
+    if (_function == nullptr)
+        return _filter->Test(snapshotLength, packet);
+
+    snapshotLength = static_cast<int>(_function(packet->Buffer, packet->StartOffset, packet->Length, packet->OriginalLength));
+    return (snapshotLength != 0);
+}
+
+bool CompiledBerkeleyPacketFilter::Test(Packet^ packet)
+{
+    int snapshotLength;
+    return Test(snapshotLength, packet);
+}
+
+bool CompiledBerkeleyPacketFilter::Test([Out] int% snapshotLength, array<Byte>^ data, int length, unsigned int originalLength)
+{
+    if (data == nullptr)
+        throw gcnew ArgumentNullException("data");
+    if (length < 0 || length > data->Length)
+        throw gcnew ArgumentOutOfRangeException("length", length, "Must be between 0 and the data length " + data->Length.ToString());
+
+    unsigned int result = _function == nullptr ? Interpret(data, length, originalLength) : _function(data, 0, length, originalLength);
+    snapshotLength = static_cast<int>(result);
+    return (snapshotLength != 0);
+}
+
+// Private
+
+unsigned int CompiledBerkeleyPacketFilter::Interpret(array<Byte>^ data, int length, unsigned int originalLength)
+{
+    pcap_pkthdr pcapHeader = {};
+    pcapHeader.caplen = length;
+    pcapHeader.len = originalLength;
+
+    // An empty array can't be pinned, but the program can't read anything from an empty packet either.
+    if (data->Length == 0)
+        return pcap_offline_filter(_filter->Program, &pcapHeader, NULL);
+
+    pin_ptr<Byte> unmanagedPacketBytes = &data[0];
+    return pcap_offline_filter(_filter->Program, &pcapHeader, unmanagedPacketBytes);
+}
+
+// static
+CompiledBerkeleyPacketFilter::FilterFunction^ CompiledBerkeleyPacketFilter::Compile(const bpf_program* program)
+{
+    if (!IsSupported(program))
+        return nullptr;
+
+    DynamicMethod^ method = gcnew DynamicMethod("BerkeleyPacketFilter", UInt32::typeid, gcnew array<Type^> {array<Byte>::typeid, Int32::typeid, Int32::typeid, UInt32::typeid},
+                                                CompiledBerkeleyPacketFilter::typeid->Module, true);
+    ILGenerator^ il = method->GetILGenerator();
+
+    // The accumulator, the index register and the scratch memory of the BPF machine. Locals start as 0 like A and X.
+    LocalBuilder^ a = il->DeclareLocal(UInt32::typeid);
+    LocalBuilder^ x = il->DeclareLocal(UInt32::typeid);
+    LocalBuilder^ index = il->DeclareLocal(UInt64::typeid);
+    array<LocalBuilder^>^ memory = gcnew array<LocalBuilder^>(BPF_MEMWORDS);
+    for (int i = 0; i != memory->Length; ++i)
+        memory[i] = il->DeclareLocal(UInt32::typeid);
+
+    // Every instruction gets a label since BPF jumps are relative to the instruction.
+    unsigned int numInstructions = program->bf_len;
+    array<Label>^ labels = gcnew array<Label>(numInstructions);
+    for (unsigned int pc = 0; pc != numInstructions; ++pc)
+        labels[pc] = il->DefineLabel();
+    Label reject = il->DefineLabel();
+
+    for (unsigned int pc = 0; pc != numInstructions; ++pc)
+    {
+        il->MarkLabel(labels[pc]);
+        const bpf_insn& instruction = program->bf_insns[pc];
+        int k = static_cast<int>(instruction.k);
+        switch (instruction.code)
+        {
+        case BPF_RET | BPF_K:
+            il->Emit(OpCodes::Ldc_I4, k);
+            il->Emit(OpCodes::Ret);
+            break;
+
+        case BPF_RET | BPF_A:
+            il->Emit(OpCodes::Ldloc, a);
+            il->Emit(OpCodes::Ret);
+            break;
+
+        case BPF_LD | BPF_W | BPF_ABS:
+        case BPF_LD | BPF_H | BPF_ABS:
+        case BPF_LD | BPF_B | BPF_ABS:
+        case BPF_LD | BPF_W | BPF_IND:
+        case BPF_LD | BPF_H | BPF_IND:
+        case BPF_LD | BPF_B | BPF_IND:
+        {
+            int size = BPF_SIZE(instruction.code) == BPF_W ? 4 : BPF_SIZE(instruction.code) == BPF_H ? 2 : 1;
+            EmitLoad(il, size, instruction.k, BPF_MODE(instruction.code) == BPF_IND ? x : nullptr, index, reject);
+            il->Emit(OpCodes::Stloc, a);
+            break;
+        }
+
+        case BPF_LDX | BPF_MSH | BPF_B:
+            EmitLoad(il, 1, instruction.k, nullptr, index, reject);
+            il->Emit(OpCodes::Ldc_I4, 0xf);
+            il->Emit(OpCodes::And);
+            il->Emit(OpCodes::Ldc_I4_2);
+            il->Emit(OpCodes::Shl);
+            il->Emit(OpCodes::Stloc, x);
+            break;
+
+        case BPF_LD | BPF_W | BPF_LEN:
+            il->Emit(OpCodes::Ldarg_3);
+            il->Emit(OpCodes::Stloc, a);
+            break;
+
+        case BPF_LDX | BPF_W | BPF_LEN:
+            il->Emit(OpCodes::Ldarg_3);
+            il->Emit(OpCodes::Stloc, x);
+            break;
+
+        case BPF_LD | BPF_IMM:
+            il->Emit(OpCodes::Ldc_I4, k);
+            il->Emit(OpCodes::Stloc, a);
+            break;
+
+        case BPF_LDX | BPF_IMM:
+            il->Emit(OpCodes::Ldc_I4, k);
+            il->Emit(OpCodes::Stloc, x);
+            break;
+
+        case BPF_LD | BPF_MEM:
+            il->Emit(OpCodes::Ldloc, memory[k]);
+            il->Emit(OpCodes::Stloc, a);
+            break;
+
+        case BPF_LDX | BPF_MEM:
+            il->Emit(OpCodes::Ldloc, memory[k]);
+            il->Emit(OpCodes::Stloc, x);
+            break;
+
+        case BPF_ST:
+            il->Emit(OpCodes::Ldloc, a);
+            il->Emit(OpCodes::Stloc, memory[k]);
+            break;
+
+        case BPF_STX:
+            il->Emit(OpCodes::Ldloc, x);
+            il->Emit(OpCodes::Stloc, memory[k]);
+            break;
+
+        case BPF_JMP | BPF_JA:
+            il->Emit(OpCodes::Br, labels[pc + 1 + instruction.k]);
+            break;
+
+        case BPF_JMP | BPF_JGT | BPF_K:
+        case BPF_JMP | BPF_JGE | BPF_K:
+        case BPF_JMP | BPF_JEQ | BPF_K:
+        case BPF_JMP | BPF_JSET | BPF_K:
+        case BPF_JMP | BPF_JGT | BPF_X:
+        case BPF_JMP | BPF_JGE | BPF_X:
+        case BPF_JMP | BPF_JEQ | BPF_X:
+        case BPF_JMP | BPF_JSET | BPF_X:
+        {
+            il->Emit(OpCodes::Ldloc, a);
+            if (BPF_SRC(instruction.code) == BPF_X)
+                il->Emit(OpCodes::Ldloc, x);
+            else
+                il->Emit(OpCodes::Ldc_I4, k);
+
+            Label jumpTrue = labels[pc + 1 + instruction.jt];
+            Label jumpFalse = labels[pc + 1 + instruction.jf];
+            switch (BPF_OP(instruction.code))
+            {
+            case BPF_JGT:
+                EmitBranch(il, OpCodes::Bgt_Un, jumpTrue, jumpFalse);
+                break;
+            case BPF_JGE:
+                EmitBranch(il, OpCodes::Bge_Un, jumpTrue, jumpFalse);
+                break;
+            case BPF_JEQ:
+                EmitBranch(il, OpCodes::Beq, jumpTrue, jumpFalse);
+                break;
+            default:
+                il->Emit(OpCodes::And);
+                EmitBranch(il, OpCodes::Brtrue, jumpTrue, jumpFalse);
+                break;
+            }
+            break;
+        }
+
+        case BPF_ALU | BPF_NEG:
+            il->Emit(OpCodes::Ldloc, a);
+            il->Emit(OpCodes::Neg);
+            il->Emit(OpCodes::Stloc, a);
+            break;
+
+        case BPF_MISC | BPF_TAX:
+            il->Emit(OpCodes::Ldloc, a);
+            il->Emit(OpCodes::Stloc, x);
+            break;
+
+        case BPF_MISC | BPF_TXA:
+            il->Emit(OpCodes::Ldloc, x);
+            il->Emit(OpCodes::Stloc, a);
+            break;
+
+        default:
+        {
+            // The remaining supported instructions are the arithmetic ones.
+            if (BPF_SRC(instruction.code) == BPF_X && BPF_OP(instruction.code) == BPF_DIV)
+            {
+                il->Emit(OpCodes::Ldloc, x);
+                il->Emit(OpCodes::Brfalse, reject);
+            }
+
+            il->Emit(OpCodes::Ldloc, a);
+            if (BPF_SRC(instruction.code) == BPF_X)
+                il->Emit(OpCodes::Ldloc, x);
+            else
+                il->Emit(OpCodes::Ldc_I4, k);
+
+            switch (BPF_OP(instruction.code))
+            {
+            case BPF_ADD:
+                il->Emit(OpCodes::Add);
+                break;
+            case BPF_SUB:
+                il->Emit(OpCodes::Sub);
+                break;
+            case BPF_MUL:
+                il->Emit(OpCodes::Mul);
+                break;
+            case BPF_DIV:
+                il->Emit(OpCodes::Div_Un);
+                break;
+            case BPF_AND:
+                il->Emit(OpCodes::And);
+                break;
+            case BPF_OR:
+                il->Emit(OpCodes::Or);
+                break;
+            case BPF_LSH:
+                il->Emit(OpCodes::Shl);
+                break;
+            default:
+                il->Emit(OpCodes::Shr_Un);
+                break;
+            }
+            il->Emit(OpCodes::Stloc, a);
+            break;
+        }
+        }
+    }
+
+    il->MarkLabel(reject);
+    il->Emit(OpCodes::Ldc_I4_0);
+    il->Emit(OpCodes::Ret);
+
+    return safe_cast<FilterFunction^>(method->CreateDelegate(FilterFunction::typeid));
+}
+
+// static
+bool CompiledBerkeleyPacketFilter::IsSupported(const bpf_program* program)
+{
+    // The compiled code trusts jumps and memory indices like the interpreter does.
+    if (!BerkeleyPacketFilterValidator::IsValid(program->bf_insns, program->bf_len))
+        return false;
+
+    for (unsigned int pc = 0; pc != program->bf_len; ++pc)
+    {
+        switch (program->bf_insns[pc].code)
+        {
+        case BPF_RET | BPF_K:
+        case BPF_RET | BPF_A:
+        case BPF_LD | BPF_W | BPF_ABS:
+        case BPF_LD | BPF_H | BPF_ABS:
+        case BPF_LD | BPF_B | BPF_ABS:
+        case BPF_LD | BPF_W | BPF_IND:
+        case BPF_LD | BPF_H | BPF_IND:
+        case BPF_LD | BPF_B | BPF_IND:
+        case BPF_LDX | BPF_MSH | BPF_B:
+        case BPF_LD | BPF_W | BPF_LEN:
+        case BPF_LDX | BPF_W | BPF_LEN:
+        case BPF_LD | BPF_IMM:
+        case BPF_LDX | BPF_IMM:
+        case BPF_LD | BPF_MEM:
+        case BPF_LDX | BPF_MEM:
+        case BPF_ST:
+        case BPF_STX:
+        case BPF_ALU | BPF_ADD | BPF_K:
+        case BPF_ALU | BPF_SUB | BPF_K:
+        case BPF_ALU | BPF_MUL | BPF_K:
+        case BPF_ALU | BPF_DIV | BPF_K:
+        case BPF_ALU | BPF_AND | BPF_K:
+        case BPF_ALU | BPF_OR | BPF_K:
+        case BPF_ALU | BPF_LSH | BPF_K:
+        case BPF_ALU | BPF_RSH | BPF_K:
+        case BPF_ALU | BPF_ADD | BPF_X:
+        case BPF_ALU | BPF_SUB | BPF_X:
+        case BPF_ALU | BPF_MUL | BPF_X:
+        case BPF_ALU | BPF_DIV | BPF_X:
+        case BPF_ALU | BPF_AND | BPF_X:
+        case BPF_ALU | BPF_OR | BPF_X:
+        case BPF_ALU | BPF_LSH | BPF_X:
+        case BPF_ALU | BPF_RSH | BPF_X:
+        case BPF_ALU | BPF_NEG:
+        case BPF_MISC | BPF_TAX:
+        case BPF_MISC | BPF_TXA:
+        case BPF_JMP | BPF_JA:
+        case BPF_JMP | BPF_JGT | BPF_K:
+        case BPF_JMP | BPF_JGE | BPF_K:
+        case BPF_JMP | BPF_JEQ | BPF_K:
+        case BPF_JMP | BPF_JSET | BPF_K:
+        case BPF_JMP | BPF_JGT | BPF_X:
+        case BPF_JMP | BPF_JGE | BPF_X:
+        case BPF_JMP | BPF_JEQ | BPF_X:
+        case BPF_JMP | BPF_JSET | BPF_X:
+            break;
+
+        default:
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// static
+void CompiledBerkeleyPacketFilter::EmitLoad(ILGenerator^ il, int size, unsigned int offset, LocalBuilder^ x, LocalBuilder^ index, Label reject)
+{
+    // index = X + offset, computed in 64 bits so it can't wrap around.
+    il->Emit(OpCodes::Ldc_I8, static_cast<__int64>(offset));
+    if (x != nullptr)
+    {
+        il->Emit(OpCodes::Ldloc, x);
+        il->Emit(OpCodes::Conv_U8);
+        il->Emit(OpCodes::Add);
+    }
+    il->Emit(OpCodes::Stloc, index);
+
+    // Like the interpreter, reject the packet if any of the bytes is beyond the captured length.
+    il->Emit(OpCodes::Ldarg_2);
+    il->Emit(OpCodes::Conv_U8);
+    il->Emit(OpCodes::Ldloc, index);
+    il->Emit(OpCodes::Ldc_I8, static_cast<__int64>(size));
+    il->Emit(OpCodes::Add);
+    il->Emit(OpCodes::Blt_Un, reject);
+
+    // Network byte order. The packet starts at the offset argument in the array.
+    for (int i = 0; i != size; ++i)
+    {
+        il->Emit(OpCodes::Ldarg_0);
+        il->Emit(OpCodes::Ldloc, index);
+        if (i != 0)
+        {
+            il->Emit(OpCodes::Ldc_I8, static_cast<__int64>(i));
+            il->Emit(OpCodes::Add);
+        }
+        il->Emit(OpCodes::Ldarg_1);
+        il->Emit(OpCodes::Conv_I8);
+        il->Emit(OpCodes::Add);
+        il->Emit(OpCodes::Conv_I);
+        il->Emit(OpCodes::Ldelem_U1);
+        if (i != 0)
+            il->Emit(OpCodes::Or);
+        if (i != size - 1)
+        {
+            il->Emit(OpCodes::Ldc_I4_8);
+            il->Emit(OpCodes::Shl);
+        }
+    }
+}
+
+// static
+void CompiledBerkeleyPacketFilter::EmitBranch(ILGenerator^ il, OpCode branch, Label jumpTrue, Label jumpFalse)
+{
+    il->Emit(branch, jumpTrue);
+    il->Emit(OpCodes::Br, jumpFalse);
+}
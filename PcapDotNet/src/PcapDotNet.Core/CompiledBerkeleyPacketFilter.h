@@ -0,0 +1,94 @@
+#pragma once
+
+#include "BerkeleyPacketFilter.h"
+
+namespace PcapDotNet { namespace Core 
+{
+    /// <summary>
+    /// A Berkeley Packet Filter translated to a dynamic IL method, so the JIT compiles it to machine code.
+    /// Gives the same results as BerkeleyPacketFilter.Test() without pinning the packet or building a pcap header for every packet.
+    /// </summary>
+    /// <remarks>
+    ///   <para>
+    ///   If the filter program contains an instruction the compiler doesn't support, the filter isn't compiled, IsCompiled is false
+    ///   and every test runs the interpreter of the original filter.
+    ///   </para>
+    ///   <para>The original filter must not be disposed while this filter is used.</para>
+    /// </remarks>
+    public ref class CompiledBerkeleyPacketFilter sealed
+    {
+    public:
+        /// <summary>
+        /// Compiles the program of the given filter.
+        /// </summary>
+        /// <param name="filter">The filter to compile.</param>
+        /// <exception cref="System::ArgumentNullException">The filter is null.</exception>
+        CompiledBerkeleyPacketFilter(BerkeleyPacketFilter^ filter);
+
+        /// <summary>
+        /// The original filter.
+        /// </summary>
+        property BerkeleyPacketFilter^ Filter
+        {
+            BerkeleyPacketFilter^ get();
+        }
+
+        /// <summary>
+        /// True if the program was compiled. False if the tests fall back to the interpreter.
+        /// </summary>
+        property bool IsCompiled
+        {
+            bool get();
+        }
+
+        /// <summary>
+        /// Returns if a given filter applies to an offline packet.
+        /// <seealso cref="BerkeleyPacketFilter::Test(int%, Packets::Packet)"/>
+        /// </summary>
+        /// <param name="snapshotLength">The length of the bytes that are part of the packet according to the filter. 0 if the filter fails.</param>
+        /// <param name="packet">The packet that is to be tested.</param>
+        /// <returns>True iff the filter matches the packet.</returns>
+        /// <exception cref="System::ArgumentNullException">The packet is null.</exception>
+        bool Test([System::Runtime::InteropServices::Out] int% snapshotLength, Packets::Packet^ packet);
+
+        /// <summary>
+        /// Returns if a given filter applies to an offline packet.
+        /// <seealso cref="BerkeleyPacketFilter::Test(Packets::Packet)"/>
+        /// </summary>
+        /// <param name="packet">The packet that is to be tested.</param>
+        /// <returns>True iff the filter matches the packet.</returns>
+        /// <exception cref="System::ArgumentNullException">The packet is null.</exception>
+        bool Test(Packets::Packet^ packet);
+
+        /// <summary>
+        /// Returns if a given filter applies to the raw bytes of a packet.
+        /// </summary>
+        /// <param name="snapshotLength">The length of the bytes that are part of the packet according to the filter. 0 if the filter fails.</param>
+        /// <param name="data">The captured bytes of the packet, starting at index 0.</param>
+        /// <param name="length">The number of captured bytes.</param>
+        /// <param name="originalLength">The length of the packet on the wire.</param>
+        /// <returns>True iff the filter matches the packet.</returns>
+        /// <exception cref="System::ArgumentNullException">The data is null.</exception>
+        /// <exception cref="System::ArgumentOutOfRangeException">The length is negative or bigger than the data.</exception>
+        bool Test([System::Runtime::InteropServices::Out] int% snapshotLength, array<System::Byte>^ data, int length, unsigned int originalLength);
+
+    internal:
+        // True iff the program is valid and every instruction can be compiled. Other programs are run by the interpreter.
+        static bool IsSupported(const bpf_program* program);
+
+    private:
+        delegate unsigned int FilterFunction(array<System::Byte>^ data, int offset, int length, unsigned int originalLength);
+
+        unsigned int Interpret(array<System::Byte>^ data, int length, unsigned int originalLength);
+
+        static FilterFunction^ Compile(const bpf_program* program);
+        static void EmitLoad(System::Reflection::Emit::ILGenerator^ il, int size, unsigned int offset, System::Reflection::Emit::LocalBuilder^ x,
+                             System::Reflection::Emit::LocalBuilder^ index, System::Reflection::Emit::Label reject);
+        static void EmitBranch(System::Reflection::Emit::ILGenerator^ il, System::Reflection::Emit::OpCode branch,
+                               System::Reflection::Emit::Label jumpTrue, System::Reflection::Emit::Label jumpFalse);
+
+    private:
+        BerkeleyPacketFilter^ _filter;
+        FilterFunction^ _function;
+    };
+}}
@@ -3,8 +3,12 @@
 #include "Pcap.h"
 
 using namespace System;
+using namespace System::Collections::Generic;
+using namespace System::Diagnostics;
 using namespace System::Globalization;
+using namespace System::Threading;
 using namespace PcapDotNet::Core;
+using namespace PcapDotNet::Packets;
 
 PacketTotalStatistics^ LivePacketCommunicator::TotalStatistics::get()
 {
@@ -24,15 +28,107 @@ void LivePacketCommunicator::Transmit(PacketSendBuffer^ sendBuffer, bool isSync)
 	sendBuffer->Transmit(PcapDescriptor, isSync);
 }
 
+int LivePacketCommunicator::SendPackets(IEnumerable<Packet^>^ packets, bool isSync)
+{
+    if (packets == nullptr)
+        throw gcnew ArgumentNullException("packets");
+
+    if (_batchSendBuffer == nullptr)
+        _batchSendBuffer = gcnew PacketSendBuffer(_transmitBatchSize);
+    _batchSendBuffer->Clear();
+
+    Stopwatch^ sinceFirstBatch = nullptr;
+    DateTime firstBatchTimestamp;
+    DateTime batchTimestamp;
+    int batchBytes = 0;
+    int numPacketsSent = 0;
+    for each (Packet^ packet in packets)
+    {
+        if (packet == nullptr)
+            throw gcnew ArgumentNullException("packets", "Packet " + numPacketsSent.ToString(CultureInfo::InvariantCulture) + " is null");
+
+        int packetBytes = static_cast<int>(sizeof(pcap_pkthdr)) + packet->Length;
+        if (batchBytes != 0 && batchBytes > _transmitBatchSize - packetBytes)
+        {
+            TransmitBatch(isSync, sinceFirstBatch, firstBatchTimestamp, batchTimestamp);
+            _batchSendBuffer->Clear();
+            batchBytes = 0;
+        }
+
+        if (batchBytes == 0)
+            batchTimestamp = packet->Timestamp;
+        _batchSendBuffer->Enqueue(packet);
+        batchBytes += packetBytes;
+        ++numPacketsSent;
+    }
+
+    if (batchBytes != 0)
+    {
+        TransmitBatch(isSync, sinceFirstBatch, firstBatchTimestamp, batchTimestamp);
+        _batchSendBuffer->Clear();
+    }
+
+    return numPacketsSent;
+}
+
+int LivePacketCommunicator::TransmitBatchSize::get()
+{
+    return _transmitBatchSize;
+}
+
+void LivePacketCommunicator::TransmitBatchSize::set(int value)
+{
+    if (value <= 0)
+        throw gcnew ArgumentOutOfRangeException("value", value, "Must be positive");
+    _transmitBatchSize = value;
+}
+
+LivePacketCommunicator::~LivePacketCommunicator()
+{
+    delete _batchSendBuffer;
+    _batchSendBuffer = nullptr;
+}
+
 // Internal
 
 LivePacketCommunicator::LivePacketCommunicator(const char* source, int snapshotLength, PacketDeviceOpenAttributes attributes, int readTimeout, pcap_rmtauth* auth, SocketAddress^ netmask)
-: PacketCommunicator(PcapOpen(source, snapshotLength, attributes, readTimeout, auth), netmask)
+: PacketCommunicator(PcapOpen(source, snapshotLength, attributes, readTimeout, auth), netmask), _isRemote(IsRemoteSource(source)), _readTimeout(readTimeout), _transmitBatchSize(1024 * 1024)
+{
+}
+
+bool LivePacketCommunicator::IsRemote::get()
 {
+    return _isRemote;
+}
+
+int LivePacketCommunicator::ReadTimeout::get()
+{
+    return _readTimeout;
 }
 
 // Private
 
+void LivePacketCommunicator::TransmitBatch(bool isSync, Stopwatch^% sinceFirstBatch, DateTime% firstBatchTimestamp, DateTime batchTimestamp)
+{
+    // The driver only keeps the timing inside a batch, so wait until the first packet of this batch is due.
+    if (isSync)
+    {
+        if (sinceFirstBatch == nullptr)
+        {
+            sinceFirstBatch = Stopwatch::StartNew();
+            firstBatchTimestamp = batchTimestamp;
+        }
+        else
+        {
+            TimeSpan delay = (batchTimestamp - firstBatchTimestamp) - sinceFirstBatch->Elapsed;
+            if (delay > TimeSpan::Zero)
+                Thread::Sleep(delay);
+        }
+    }
+
+    Transmit(_batchSendBuffer, isSync);
+}
+
 // static
 pcap_t* LivePacketCommunicator::PcapOpen(const char* source, int snapshotLength, PacketDeviceOpenAttributes attributes, int readTimeout, pcap_rmtauth *auth)
 {
@@ -51,3 +147,16 @@ pcap_t* LivePacketCommunicator::PcapOpen(const char* source, int snapshotLength,
 
     return pcapDescriptor;
 }
+
+// static
+bool LivePacketCommunicator::IsRemoteSource(const char* source)
+{
+    char host[PCAP_BUF_SIZE];
+    char port[PCAP_BUF_SIZE];
+    char name[PCAP_BUF_SIZE];
+    char errorBuffer[PCAP_ERRBUF_SIZE];
+    int type;
+    if (pcap_parsesrc(source, &type, host, port, name, errorBuffer) != 0)
+        return false;
+    return type == PCAP_SRC_IFREMOTE;
+}
@@ -37,11 +37,65 @@ namespace PcapDotNet { namespace Core
         /// </remarks>
         virtual void Transmit(PacketSendBuffer^ sendBuffer, bool isSync) override;
 
+        /// <summary>
+        /// Send a sequence of packets to the network in batches.
+        /// The packets are copied to an internal send buffer that is reused between calls, and every time the buffer reaches TransmitBatchSize bytes it is transmitted using a single Transmit() call.
+        /// <seealso cref="Transmit"/>
+        /// </summary>
+        /// <param name="packets">The packets to send.</param>
+        /// <param name="isSync">Determines if the send operation must be synchronized: if it is true, the packets are sent respecting the timestamps, otherwise they are sent as fast as possible.</param>
+        /// <returns>The number of packets sent.</returns>
+        /// <exception cref="System::ArgumentNullException">The packets or one of them is null.</exception>
+        /// <exception cref="System::InvalidOperationException">An error occurred during the send.</exception>
+        /// <remarks>
+        ///   <para>When isSync is true, the driver keeps the timing within a batch and this method waits between batches until the timestamp of the first packet of the next batch is due.</para>
+        ///   <para>
+        ///   WinPcap has no memory mapped transmit ring like the Linux PACKET_TX_RING, so the batches are sent with pcap_sendqueue_transmit(),
+        ///   which copies a whole batch to the driver in one call. The caller blocks while a batch is sent, and no packet is queued in the kernel between calls.
+        ///   </para>
+        /// </remarks>
+        int SendPackets(System::Collections::Generic::IEnumerable<Packets::Packet^>^ packets, bool isSync);
+
+        /// <summary>
+        /// The number of bytes SendPackets() accumulates before transmitting them. 1MB by default.
+        /// Every packet takes its length plus the size of a pcap header.
+        /// </summary>
+        /// <exception cref="System::ArgumentOutOfRangeException">The value is not positive.</exception>
+        property int TransmitBatchSize
+        {
+            int get();
+            void set(int value);
+        }
+
+        /// <summary>
+        /// Close the communicator and frees the internal send buffer used by SendPackets().
+        /// </summary>
+        ~LivePacketCommunicator();
+
     internal:
         LivePacketCommunicator(const char* source, int snapshotLength, PacketDeviceOpenAttributes attributes, int readTimeout, pcap_rmtauth* auth, 
                                SocketAddress^ netmask);
 
+        virtual property bool IsRemote
+        {
+            bool get() override;
+        }
+
+        virtual property int ReadTimeout
+        {
+            int get() override;
+        }
+
     private:
         static pcap_t* PcapOpen(const char* source, int snapshotLength, PacketDeviceOpenAttributes attributes, int readTimeout, pcap_rmtauth *auth);
+        static bool IsRemoteSource(const char* source);
+
+        void TransmitBatch(bool isSync, System::Diagnostics::Stopwatch^% sinceFirstBatch, System::DateTime% firstBatchTimestamp, System::DateTime batchTimestamp);
+
+    private:
+        bool _isRemote;
+        int _readTimeout;
+        int _transmitBatchSize;
+        PacketSendBuffer^ _batchSendBuffer;
     };
 }}
\ No newline at end of file
@@ -0,0 +1,329 @@
+#include "LivePacketCommunicatorTuner.h"
+
+using namespace System;
+using namespace System::Diagnostics;
+using namespace System::Globalization;
+using namespace System::Runtime::InteropServices;
+using namespace PcapDotNet::Base;
+using namespace PcapDotNet::Core;
+using namespace PcapDotNet::Packets;
+
+LivePacketCommunicatorTuner::LivePacketCommunicatorTuner(LivePacketCommunicator^ communicator)
+{
+    if (communicator == nullptr)
+        throw gcnew ArgumentNullException("communicator");
+
+    _communicator = communicator;
+
+    _kernelBufferSize = DefaultKernelBufferSize;
+    _minimumKernelBufferSize = 256 * 1024;
+    _maximumKernelBufferSize = 256 * 1024 * 1024;
+    _kernelMinimumBytesToCopy = DefaultKernelMinimumBytesToCopy;
+    _minimumKernelMinimumBytesToCopy = 1024;
+    _maximumKernelMinimumBytesToCopy = 1024 * 1024;
+    _batchSize = DefaultBatchSize;
+    _minimumBatchSize = 16;
+    _maximumBatchSize = 64 * 1024;
+
+    _sampleInterval = TimeSpan::FromSeconds(1);
+    _maximumConsumerLatency = TimeSpan::FromTicks(10 * TimeSpanExtensions::TicksPerMicrosecond);
+    _idleSamplesBeforeShrink = 10;
+
+    _sinceLastSample = Stopwatch::StartNew();
+}
+
+LivePacketCommunicator^ LivePacketCommunicatorTuner::Communicator::get()
+{
+    return _communicator;
+}
+
+int LivePacketCommunicatorTuner::KernelBufferSize::get()
+{
+    return _kernelBufferSize;
+}
+
+int LivePacketCommunicatorTuner::MinimumKernelBufferSize::get()
+{
+    return _minimumKernelBufferSize;
+}
+
+void LivePacketCommunicatorTuner::MinimumKernelBufferSize::set(int value)
+{
+    AssertRange("value", value, 1, _maximumKernelBufferSize);
+    _minimumKernelBufferSize = value;
+    ClampValue(PacketCommunicatorTuningParameter::KernelBufferSize, _kernelBufferSize, _minimumKernelBufferSize, _maximumKernelBufferSize);
+}
+
+int LivePacketCommunicatorTuner::MaximumKernelBufferSize::get()
+{
+    return _maximumKernelBufferSize;
+}
+
+void LivePacketCommunicatorTuner::MaximumKernelBufferSize::set(int value)
+{
+    AssertRange("value", value, _minimumKernelBufferSize, Int32::MaxValue);
+    _maximumKernelBufferSize = value;
+    ClampValue(PacketCommunicatorTuningParameter::KernelBufferSize, _kernelBufferSize, _minimumKernelBufferSize, _maximumKernelBufferSize);
+}
+
+int LivePacketCommunicatorTuner::KernelMinimumBytesToCopy::get()
+{
+    return _kernelMinimumBytesToCopy;
+}
+
+int LivePacketCommunicatorTuner::MinimumKernelMinimumBytesToCopy::get()
+{
+    return _minimumKernelMinimumBytesToCopy;
+}
+
+void LivePacketCommunicatorTuner::MinimumKernelMinimumBytesToCopy::set(int value)
+{
+    AssertRange("value", value, 1, _maximumKernelMinimumBytesToCopy);
+    _minimumKernelMinimumBytesToCopy = value;
+    ClampValue(PacketCommunicatorTuningParameter::KernelMinimumBytesToCopy, _kernelMinimumBytesToCopy, _minimumKernelMinimumBytesToCopy, _maximumKernelMinimumBytesToCopy);
+}
+
+int LivePacketCommunicatorTuner::MaximumKernelMinimumBytesToCopy::get()
+{
+    return _maximumKernelMinimumBytesToCopy;
+}
+
+void LivePacketCommunicatorTuner::MaximumKernelMinimumBytesToCopy::set(int value)
+{
+    AssertRange("value", value, _minimumKernelMinimumBytesToCopy, Int32::MaxValue);
+    _maximumKernelMinimumBytesToCopy = value;
+    ClampValue(PacketCommunicatorTuningParameter::KernelMinimumBytesToCopy, _kernelMinimumBytesToCopy, _minimumKernelMinimumBytesToCopy, _maximumKernelMinimumBytesToCopy);
+}
+
+int LivePacketCommunicatorTuner::BatchSize::get()
+{
+    return _batchSize;
+}
+
+int LivePacketCommunicatorTuner::MinimumBatchSize::get()
+{
+    return _minimumBatchSize;
+}
+
+void LivePacketCommunicatorTuner::MinimumBatchSize::set(int value)
+{
+    AssertRange("value", value, 1, _maximumBatchSize);
+    _minimumBatchSize = value;
+    ClampValue(PacketCommunicatorTuningParameter::BatchSize, _batchSize, _minimumBatchSize, _maximumBatchSize);
+}
+
+int LivePacketCommunicatorTuner::MaximumBatchSize::get()
+{
+    return _maximumBatchSize;
+}
+
+void LivePacketCommunicatorTuner::MaximumBatchSize::set(int value)
+{
+    AssertRange("value", value, _minimumBatchSize, Int32::MaxValue);
+    _maximumBatchSize = value;
+    ClampValue(PacketCommunicatorTuningParameter::BatchSize, _batchSize, _minimumBatchSize, _maximumBatchSize);
+}
+
+TimeSpan LivePacketCommunicatorTuner::SampleInterval::get()
+{
+    return _sampleInterval;
+}
+
+void LivePacketCommunicatorTuner::SampleInterval::set(TimeSpan value)
+{
+    if (value < TimeSpan::Zero)
+        throw gcnew ArgumentOutOfRangeException("value", value, "Must be non negative");
+    _sampleInterval = value;
+}
+
+TimeSpan LivePacketCommunicatorTuner::MaximumConsumerLatency::get()
+{
+    return _maximumConsumerLatency;
+}
+
+void LivePacketCommunicatorTuner::MaximumConsumerLatency::set(TimeSpan value)
+{
+    if (value < TimeSpan::Zero)
+        throw gcnew ArgumentOutOfRangeException("value", value, "Must be non negative");
+    _maximumConsumerLatency = value;
+}
+
+int LivePacketCommunicatorTuner::IdleSamplesBeforeShrink::get()
+{
+    return _idleSamplesBeforeShrink;
+}
+
+void LivePacketCommunicatorTuner::IdleSamplesBeforeShrink::set(int value)
+{
+    if (value <= 0)
+        throw gcnew ArgumentOutOfRangeException("value", value, "Must be positive");
+    _idleSamplesBeforeShrink = value;
+}
+
+PacketCommunicatorReceiveResult LivePacketCommunicatorTuner::ReceiveSomePackets([Out] int% countGot, HandlePacket^ callback)
+{
+    TimedPacketHandler^ timedHandler = gcnew TimedPacketHandler(callback);
+    PacketCommunicatorReceiveResult result = _communicator->ReceiveSomePackets(countGot, _batchSize, gcnew HandlePacket(timedHandler, &TimedPacketHandler::Handle));
+
+    _consumerTicks += timedHandler->ElapsedTicks;
+    _consumerPackets += timedHandler->PacketCounter;
+
+    if (_sinceLastSample->Elapsed >= _sampleInterval)
+    {
+        TimeSpan consumerLatency = _consumerPackets == 0
+                                       ? TimeSpan::Zero
+                                       : TimeSpan::FromSeconds(static_cast<double>(_consumerTicks) / Stopwatch::Frequency / _consumerPackets);
+        Sample(consumerLatency);
+    }
+
+    return result;
+}
+
+void LivePacketCommunicatorTuner::Sample(TimeSpan consumerLatency)
+{
+    PacketTotalStatistics^ statistics = _communicator->TotalStatistics;
+    PacketTotalStatistics^ lastStatistics = _lastStatistics;
+
+    _lastStatistics = statistics;
+    _sinceLastSample->Restart();
+    _consumerTicks = 0;
+    _consumerPackets = 0;
+
+    // The first sample is only a reference point.
+    if (lastStatistics == nullptr)
+        return;
+
+    // Unsigned subtraction keeps the deltas correct when the driver counters wrap around.
+    unsigned int packetsDropped = statistics->PacketsDroppedByDriver - lastStatistics->PacketsDroppedByDriver;
+    unsigned int packetsReceived = statistics->PacketsReceived - lastStatistics->PacketsReceived;
+
+    if (packetsDropped != 0)
+    {
+        _idleSamples = 0;
+        Grow(statistics, packetsDropped, consumerLatency);
+        return;
+    }
+
+    if (packetsReceived != 0)
+    {
+        _idleSamples = 0;
+        return;
+    }
+
+    if (++_idleSamples < _idleSamplesBeforeShrink)
+        return;
+
+    _idleSamples = 0;
+    Shrink(statistics, consumerLatency);
+}
+
+// Private
+
+void LivePacketCommunicatorTuner::Grow(PacketTotalStatistics^ statistics, unsigned int packetsDropped, TimeSpan consumerLatency)
+{
+    String^ dropsReason = packetsDropped.ToString(CultureInfo::InvariantCulture) + " packets dropped by driver since last sample";
+
+    Adjust(PacketCommunicatorTuningParameter::KernelBufferSize, _kernelBufferSize, GrowValue(_kernelBufferSize, _maximumKernelBufferSize),
+           statistics, packetsDropped, consumerLatency, dropsReason);
+
+    // A slow consumer doesn't gain anything from bigger batches, it only needs more room in the kernel.
+    if (consumerLatency > _maximumConsumerLatency)
+        return;
+
+    String^ fastConsumerReason = dropsReason + " while consumer latency " + consumerLatency.ToString() + " is below " + _maximumConsumerLatency.ToString();
+    Adjust(PacketCommunicatorTuningParameter::KernelMinimumBytesToCopy, _kernelMinimumBytesToCopy,
+           GrowValue(_kernelMinimumBytesToCopy, _maximumKernelMinimumBytesToCopy), statistics, packetsDropped, consumerLatency, fastConsumerReason);
+    Adjust(PacketCommunicatorTuningParameter::BatchSize, _batchSize, GrowValue(_batchSize, _maximumBatchSize),
+           statistics, packetsDropped, consumerLatency, fastConsumerReason);
+}
+
+void LivePacketCommunicatorTuner::Shrink(PacketTotalStatistics^ statistics, TimeSpan consumerLatency)
+{
+    String^ reason = "No packets received in the last " + _idleSamplesBeforeShrink.ToString(CultureInfo::InvariantCulture) + " samples";
+
+    Adjust(PacketCommunicatorTuningParameter::KernelBufferSize, _kernelBufferSize, ShrinkValue(_kernelBufferSize, _minimumKernelBufferSize),
+           statistics, 0, consumerLatency, reason);
+    Adjust(PacketCommunicatorTuningParameter::KernelMinimumBytesToCopy, _kernelMinimumBytesToCopy,
+           ShrinkValue(_kernelMinimumBytesToCopy, _minimumKernelMinimumBytesToCopy), statistics, 0, consumerLatency, reason);
+    Adjust(PacketCommunicatorTuningParameter::BatchSize, _batchSize, ShrinkValue(_batchSize, _minimumBatchSize),
+           statistics, 0, consumerLatency, reason);
+}
+
+void LivePacketCommunicatorTuner::ClampValue(PacketCommunicatorTuningParameter parameter, int% currentValue, int minimum, int maximum)
+{
+    int newValue = Math::Min(Math::Max(currentValue, minimum), maximum);
+    String^ reason = "Value moved into the new range [" + minimum.ToString(CultureInfo::InvariantCulture) + ", " + maximum.ToString(CultureInfo::InvariantCulture) + "]";
+    Adjust(parameter, currentValue, newValue, _lastStatistics, 0, TimeSpan::Zero, reason);
+}
+
+void LivePacketCommunicatorTuner::Adjust(PacketCommunicatorTuningParameter parameter, int% currentValue, int newValue, PacketTotalStatistics^ statistics,
+                                         unsigned int packetsDropped, TimeSpan consumerLatency, String^ reason)
+{
+    if (currentValue == newValue)
+        return;
+
+    ApplyValue(parameter, newValue);
+
+    int previousValue = currentValue;
+    currentValue = newValue;
+
+    Adjusted(this, gcnew PacketCommunicatorTuningEventArgs(parameter, previousValue, newValue, statistics, packetsDropped, consumerLatency, reason));
+}
+
+void LivePacketCommunicatorTuner::ApplyValue(PacketCommunicatorTuningParameter parameter, int value)
+{
+    switch (parameter)
+    {
+    case PacketCommunicatorTuningParameter::KernelBufferSize:
+        _communicator->SetKernelBufferSize(value);
+        break;
+    case PacketCommunicatorTuningParameter::KernelMinimumBytesToCopy:
+        _communicator->SetKernelMinimumBytesToCopy(value);
+        break;
+    case PacketCommunicatorTuningParameter::BatchSize:
+        // Used by the next ReceiveSomePackets() call.
+        break;
+    default:
+        throw gcnew InvalidOperationException("Invalid tuning parameter " + parameter.ToString());
+    }
+}
+
+// static
+int LivePacketCommunicatorTuner::GrowValue(int value, int maximum)
+{
+    return value > maximum / 2 ? maximum : value * 2;
+}
+
+// static
+int LivePacketCommunicatorTuner::ShrinkValue(int value, int minimum)
+{
+    return Math::Max(value / 2, minimum);
+}
+
+// static
+void LivePacketCommunicatorTuner::AssertRange(String^ name, int value, int minimum, int maximum)
+{
+    if (value < minimum || value > maximum)
+    {
+        throw gcnew ArgumentOutOfRangeException(name, value, "Must be between " + minimum.ToString(CultureInfo::InvariantCulture) + " and " +
+                                                             maximum.ToString(CultureInfo::InvariantCulture));
+    }
+}
+
+void LivePacketCommunicatorTuner::TimedPacketHandler::Handle(Packet^ packet)
+{
+    __int64 start = Stopwatch::GetTimestamp();
+    _callback->Invoke(packet);
+    _elapsedTicks += Stopwatch::GetTimestamp() - start;
+    ++_packetCounter;
+}
+
+__int64 LivePacketCommunicatorTuner::TimedPacketHandler::ElapsedTicks::get()
+{
+    return _elapsedTicks;
+}
+
+int LivePacketCommunicatorTuner::TimedPacketHandler::PacketCounter::get()
+{
+    return _packetCounter;
+}
@@ -0,0 +1,262 @@
+#pragma once
+
+#include "LivePacketCommunicator.h"
+#include "PacketCommunicatorTuningEventArgs.h"
+
+namespace PcapDotNet { namespace Core
+{
+    /// <summary>
+    /// Adapts the capture parameters of a live communicator to the traffic it sees.
+    /// Samples the communicator TotalStatistics and the consumer latency, grows the kernel buffer, the kernel minimum bytes to copy and the receive batch size when the driver starts dropping packets
+    /// and shrinks them back when the traffic is idle.
+    /// Every adjustment is reported using the Adjusted event.
+    /// </summary>
+    /// <remarks>
+    ///   <list type="bullet">
+    ///     <item>Changing the kernel buffer size discards the content of the current kernel buffer, so the tuner only grows it after drops were already seen or shrinks it after the traffic was idle.</item>
+    ///     <item>The tuner doesn't change the communicator until it adjusts a value, so it assumes the communicator was opened with the default values.</item>
+    ///     <item>The read timeout is given to LivePacketDevice.Open() and can't be changed on an open communicator, so it isn't tuned.</item>
+    ///     <item>The tuner is not thread safe and should be used by the thread receiving the packets.</item>
+    ///   </list>
+    /// </remarks>
+    public ref class LivePacketCommunicatorTuner sealed
+    {
+    public:
+        /// <summary>
+        /// The kernel buffer size the tuner starts with. This is the size LivePacketDevice.Open() creates by default.
+        /// </summary>
+        static const int DefaultKernelBufferSize = 1024 * 1024;
+
+        /// <summary>
+        /// The kernel minimum bytes to copy the tuner starts with. This is the WinPcap default.
+        /// </summary>
+        static const int DefaultKernelMinimumBytesToCopy = 16000;
+
+        /// <summary>
+        /// The receive batch size the tuner starts with.
+        /// </summary>
+        static const int DefaultBatchSize = 256;
+
+        /// <summary>
+        /// Attaches a tuner to the given communicator.
+        /// The communicator isn't changed until the tuner adjusts a value, so capturing continues without discarding the kernel buffer.
+        /// </summary>
+        /// <param name="communicator">The live communicator to tune.</param>
+        /// <exception cref="System::ArgumentNullException">The communicator is null.</exception>
+        LivePacketCommunicatorTuner(LivePacketCommunicator^ communicator);
+
+        /// <summary>
+        /// The communicator this tuner adjusts.
+        /// </summary>
+        property LivePacketCommunicator^ Communicator
+        {
+            LivePacketCommunicator^ get();
+        }
+
+        /// <summary>
+        /// The current kernel buffer size in bytes.
+        /// </summary>
+        property int KernelBufferSize
+        {
+            int get();
+        }
+
+        /// <summary>
+        /// The smallest kernel buffer size the tuner will shrink to.
+        /// If the current kernel buffer size is smaller, it is grown to the new minimum.
+        /// </summary>
+        /// <exception cref="System::ArgumentOutOfRangeException">The value is not positive or is bigger than the maximum.</exception>
+        property int MinimumKernelBufferSize
+        {
+            int get();
+            void set(int value);
+        }
+
+        /// <summary>
+        /// The biggest kernel buffer size the tuner will grow to.
+        /// If the current kernel buffer size is bigger, it is shrunk to the new maximum.
+        /// </summary>
+        /// <exception cref="System::ArgumentOutOfRangeException">The value is smaller than the minimum.</exception>
+        property int MaximumKernelBufferSize
+        {
+            int get();
+            void set(int value);
+        }
+
+        /// <summary>
+        /// The current kernel minimum bytes to copy.
+        /// </summary>
+        property int KernelMinimumBytesToCopy
+        {
+            int get();
+        }
+
+        /// <summary>
+        /// The smallest kernel minimum bytes to copy the tuner will shrink to.
+        /// If the current kernel minimum bytes to copy is smaller, it is grown to the new minimum.
+        /// </summary>
+        /// <exception cref="System::ArgumentOutOfRangeException">The value is not positive or is bigger than the maximum.</exception>
+        property int MinimumKernelMinimumBytesToCopy
+        {
+            int get();
+            void set(int value);
+        }
+
+        /// <summary>
+        /// The biggest kernel minimum bytes to copy the tuner will grow to.
+        /// If the current kernel minimum bytes to copy is bigger, it is shrunk to the new maximum.
+        /// </summary>
+        /// <exception cref="System::ArgumentOutOfRangeException">The value is smaller than the minimum.</exception>
+        property int MaximumKernelMinimumBytesToCopy
+        {
+            int get();
+            void set(int value);
+        }
+
+        /// <summary>
+        /// The current maximum number of packets to process in a single ReceiveSomePackets() call.
+        /// </summary>
+        property int BatchSize
+        {
+            int get();
+        }
+
+        /// <summary>
+        /// The smallest batch size the tuner will shrink to.
+        /// If the current batch size is smaller, it is grown to the new minimum.
+        /// </summary>
+        /// <exception cref="System::ArgumentOutOfRangeException">The value is not positive or is bigger than the maximum.</exception>
+        property int MinimumBatchSize
+        {
+            int get();
+            void set(int value);
+        }
+
+        /// <summary>
+        /// The biggest batch size the tuner will grow to.
+        /// If the current batch size is bigger, it is shrunk to the new maximum.
+        /// </summary>
+        /// <exception cref="System::ArgumentOutOfRangeException">The value is smaller than the minimum.</exception>
+        property int MaximumBatchSize
+        {
+            int get();
+            void set(int value);
+        }
+
+        /// <summary>
+        /// The minimum time between two statistics samples taken by ReceiveSomePackets().
+        /// </summary>
+        /// <exception cref="System::ArgumentOutOfRangeException">The value is negative.</exception>
+        property System::TimeSpan SampleInterval
+        {
+            System::TimeSpan get();
+            void set(System::TimeSpan value);
+        }
+
+        /// <summary>
+        /// The average time per packet the consumer may take for the tuner to consider it fast enough to benefit from bigger batches.
+        /// When the consumer is slower than this, only the kernel buffer is grown on drops.
+        /// </summary>
+        /// <exception cref="System::ArgumentOutOfRangeException">The value is negative.</exception>
+        property System::TimeSpan MaximumConsumerLatency
+        {
+            System::TimeSpan get();
+            void set(System::TimeSpan value);
+        }
+
+        /// <summary>
+        /// The number of consecutive samples with no received packets before the tuner shrinks the parameters.
+        /// </summary>
+        /// <exception cref="System::ArgumentOutOfRangeException">The value is not positive.</exception>
+        property int IdleSamplesBeforeShrink
+        {
+            int get();
+            void set(int value);
+        }
+
+        /// <summary>
+        /// Raised for every adjustment the tuner makes.
+        /// </summary>
+        event System::EventHandler<PacketCommunicatorTuningEventArgs^>^ Adjusted;
+
+        /// <summary>
+        /// Collect a group of packets using the current batch size, measuring the time the callback takes.
+        /// Samples the statistics and adjusts the parameters if SampleInterval has passed since the last sample.
+        /// <seealso cref="PacketCommunicator::ReceiveSomePackets"/>
+        /// </summary>
+        /// <param name="countGot">The number of packets read.</param>
+        /// <param name="callback">Specifies a routine to be called with one argument: the packet received.</param>
+        /// <returns>The result of the PacketCommunicator.ReceiveSomePackets() call.</returns>
+        /// <exception cref="System::InvalidOperationException">Thrown if the mode is not Capture or an error occurred.</exception>
+        PacketCommunicatorReceiveResult ReceiveSomePackets([System::Runtime::InteropServices::Out] int% countGot, HandlePacket^ callback);
+
+        /// <summary>
+        /// Samples the communicator statistics and adjusts the parameters.
+        /// Use this method when receiving packets without ReceiveSomePackets() of this class.
+        /// </summary>
+        /// <param name="consumerLatency">The average time the consumer spent on each packet since the previous sample.</param>
+        /// <exception cref="System::InvalidOperationException">Thrown if getting the statistics or adjusting a parameter fails.</exception>
+        void Sample(System::TimeSpan consumerLatency);
+
+    private:
+        void Grow(PacketTotalStatistics^ statistics, unsigned int packetsDropped, System::TimeSpan consumerLatency);
+        void Shrink(PacketTotalStatistics^ statistics, System::TimeSpan consumerLatency);
+        void ClampValue(PacketCommunicatorTuningParameter parameter, int% currentValue, int minimum, int maximum);
+        void Adjust(PacketCommunicatorTuningParameter parameter, int% currentValue, int newValue, PacketTotalStatistics^ statistics,
+                    unsigned int packetsDropped, System::TimeSpan consumerLatency, System::String^ reason);
+        void ApplyValue(PacketCommunicatorTuningParameter parameter, int value);
+
+        static int GrowValue(int value, int maximum);
+        static int ShrinkValue(int value, int minimum);
+        static void AssertRange(System::String^ name, int value, int minimum, int maximum);
+
+        ref class TimedPacketHandler
+        {
+        public:
+            TimedPacketHandler(HandlePacket^ callback)
+            {
+                _callback = callback;
+            }
+
+            void Handle(Packets::Packet^ packet);
+
+            property __int64 ElapsedTicks
+            {
+                __int64 get();
+            }
+
+            property int PacketCounter
+            {
+                int get();
+            }
+
+        private:
+            HandlePacket^ _callback;
+            __int64 _elapsedTicks;
+            int _packetCounter;
+        };
+
+    private:
+        LivePacketCommunicator^ _communicator;
+
+        int _kernelBufferSize;
+        int _minimumKernelBufferSize;
+        int _maximumKernelBufferSize;
+        int _kernelMinimumBytesToCopy;
+        int _minimumKernelMinimumBytesToCopy;
+        int _maximumKernelMinimumBytesToCopy;
+        int _batchSize;
+        int _minimumBatchSize;
+        int _maximumBatchSize;
+
+        System::TimeSpan _sampleInterval;
+        System::TimeSpan _maximumConsumerLatency;
+        int _idleSamplesBeforeShrink;
+
+        PacketTotalStatistics^ _lastStatistics;
+        int _idleSamples;
+        System::Diagnostics::Stopwatch^ _sinceLastSample;
+        __int64 _consumerTicks;
+        __int64 _consumerPackets;
+    };
+}}
@@ -23,7 +23,7 @@ OfflinePacketCommunicator::OfflinePacketCommunicator(String^ filename)
 {
 }
 
-// Private
+// Internal
 
 // static
 pcap_t* OfflinePacketCommunicator::OpenFile(String^ fileName)
@@ -27,7 +27,7 @@ namespace PcapDotNet { namespace Core
     internal:
         OfflinePacketCommunicator(System::String^ fileName);
 
-    private:
+        // The caller closes the returned descriptor with pcap_close().
         static pcap_t* OpenFile(System::String^ fileName);
     };
 }}
\ No newline at end of file
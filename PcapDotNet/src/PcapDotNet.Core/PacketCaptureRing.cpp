@@ -0,0 +1,178 @@
+#include "PacketCaptureRing.h"
+
+#include "MarshalingServices.h"
+#include "PacketCaptureRingStage.h"
+#include "PacketCommunicator.h"
+#include "Pcap.h"
+
+using namespace System;
+using namespace PcapDotNet::Base;
+using namespace PcapDotNet::Core;
+
+PacketCaptureRing::PacketCaptureRing(PacketCommunicator^ communicator, int capacity, String^ dumpFilePrefix)
+{
+    if (communicator == nullptr)
+        throw gcnew ArgumentNullException("communicator");
+    if (capacity <= 0)
+        throw gcnew ArgumentOutOfRangeException("capacity", capacity, "Must be positive");
+    if (dumpFilePrefix == nullptr)
+        throw gcnew ArgumentNullException("dumpFilePrefix");
+
+    std::string unmanagedDumpFilePrefix = MarshalingServices::ManagedToUnmanagedString(dumpFilePrefix);
+
+    _dumpFilePrefix = dumpFilePrefix;
+    _postTriggerDuration = TimeSpan::FromSeconds(10);
+    _deliversPackets = true;
+
+    _stage = new PacketCaptureRingStage(communicator->SnapshotLength, capacity, unmanagedDumpFilePrefix.c_str());
+    _stage->SetPostTriggerDuration(_postTriggerDuration.Ticks / TimeSpanExtensions::TicksPerMicrosecond);
+
+    _communicator = communicator;
+    _communicator->CaptureRing = this;
+}
+
+int PacketCaptureRing::Capacity::get()
+{
+    return _stage->Capacity();
+}
+
+int PacketCaptureRing::UsedBytes::get()
+{
+    return _stage->UsedBytes();
+}
+
+int PacketCaptureRing::PacketCount::get()
+{
+    return _stage->PacketCount();
+}
+
+String^ PacketCaptureRing::DumpFilePrefix::get()
+{
+    return _dumpFilePrefix;
+}
+
+TimeSpan PacketCaptureRing::MaximumAge::get()
+{
+    return _maximumAge;
+}
+
+void PacketCaptureRing::MaximumAge::set(TimeSpan value)
+{
+    if (value < TimeSpan::Zero)
+        throw gcnew ArgumentOutOfRangeException("value", value, "Must be non negative");
+    _maximumAge = value;
+    _stage->SetMaximumAge(value.Ticks / TimeSpanExtensions::TicksPerMicrosecond);
+}
+
+TimeSpan PacketCaptureRing::PostTriggerDuration::get()
+{
+    return _postTriggerDuration;
+}
+
+void PacketCaptureRing::PostTriggerDuration::set(TimeSpan value)
+{
+    if (value < TimeSpan::Zero)
+        throw gcnew ArgumentOutOfRangeException("value", value, "Must be non negative");
+    _postTriggerDuration = value;
+    _stage->SetPostTriggerDuration(value.Ticks / TimeSpanExtensions::TicksPerMicrosecond);
+}
+
+int PacketCaptureRing::PacketsPerSecondThreshold::get()
+{
+    return _packetsPerSecondThreshold;
+}
+
+void PacketCaptureRing::PacketsPerSecondThreshold::set(int value)
+{
+    if (value < 0)
+        throw gcnew ArgumentOutOfRangeException("value", value, "Must be non negative");
+    _packetsPerSecondThreshold = value;
+    _stage->SetPacketsPerSecondThreshold(value);
+}
+
+bool PacketCaptureRing::DeliversPackets::get()
+{
+    return _deliversPackets;
+}
+
+void PacketCaptureRing::DeliversPackets::set(bool value)
+{
+    _deliversPackets = value;
+    _stage->SetDeliversPackets(value);
+}
+
+void PacketCaptureRing::SetTriggerFilter(BerkeleyPacketFilter^ filter)
+{
+    if (filter == nullptr)
+    {
+        _stage->SetTriggerFilter(NULL, 0);
+        return;
+    }
+
+    bpf_program* program = filter->Program;
+    _stage->SetTriggerFilter(program->bf_insns, program->bf_len);
+}
+
+void PacketCaptureRing::Trigger()
+{
+    _stage->RequestTrigger();
+}
+
+bool PacketCaptureRing::IsDumping::get()
+{
+    return _stage->IsDumping();
+}
+
+int PacketCaptureRing::DumpCount::get()
+{
+    return _stage->DumpCount();
+}
+
+int PacketCaptureRing::DumpFailureCount::get()
+{
+    return _stage->DumpFailureCount();
+}
+
+int PacketCaptureRing::DumpDroppedPacketCount::get()
+{
+    return _stage->DumpDroppedPacketCount();
+}
+
+String^ PacketCaptureRing::LastDumpFileName::get()
+{
+    char lastDumpFileName[PacketCaptureRingStage::MaxFileNameLength];
+    _stage->GetLastDumpFileName(lastDumpFileName);
+    if (lastDumpFileName[0] == '\0')
+        return nullptr;
+    return gcnew String(lastDumpFileName);
+}
+
+PacketCaptureRing::~PacketCaptureRing()
+{
+    if (_communicator != nullptr && _communicator->CaptureRing == this)
+        _communicator->CaptureRing = nullptr;
+    _communicator = nullptr;
+
+    this->!PacketCaptureRing();
+}
+
+// Internal
+
+PacketStage* PacketCaptureRing::Stage::get()
+{
+    return _stage;
+}
+
+void PacketCaptureRing::Attach(int dataLink)
+{
+    _stage->Attach(dataLink);
+}
+
+// Protected
+
+PacketCaptureRing::!PacketCaptureRing()
+{
+    // Joins the writer thread and closes the dump file being written.
+    delete _stage;
+    _stage = NULL;
+}
@@ -0,0 +1,207 @@
+#pragma once
+
+#include "BerkeleyPacketFilter.h"
+#include "PacketStage.h"
+
+namespace PcapDotNet { namespace Core
+{
+    ref class PacketCommunicator;
+    class PacketCaptureRingStage;
+
+    /// <summary>
+    /// Keeps the most recent packets received by a communicator in a fixed size memory ring and writes them to a dump file when a trigger fires.
+    /// The dump file contains the packets in the ring when the trigger fired followed by the packets received during PostTriggerDuration.
+    /// </summary>
+    /// <remarks>
+    ///   <para>
+    ///   The ring is a single slab allocated when it is created. Recording a packet copies it into the slab natively and evicts the oldest packets that don't fit
+    ///   or are older than MaximumAge, so there is no allocation per packet and the ring can run continuously.
+    ///   </para>
+    ///   <para>
+    ///   The dump files are written by a writer thread the ring owns, so a trigger doesn't slow down the capture.
+    ///   When a trigger fires, the slab is handed to the writer thread as is and recording continues in a second slab, which starts empty.
+    ///   The packets received during PostTriggerDuration are queued for the writer thread, and the packets that don't fit in the queue are counted in DumpDroppedPacketCount.
+    ///   A trigger that fires while the writer thread is still writing the previous pre trigger window is counted in DumpFailureCount.
+    ///   </para>
+    ///   <para>
+    ///   A trigger fires when Trigger() is called, when a packet matches the trigger filter or when more than PacketsPerSecondThreshold packets are received in a second.
+    ///   Triggers while a dump is written extend it instead of starting a new one.
+    ///   If the dump file was already closed because no packet was received for PostTriggerDuration of real time, the rest of the dump goes to a new file named after the packet that extended it.
+    ///   Trigger() takes effect with the next received packet.
+    ///   The dump is closed by the first packet after PostTriggerDuration, measured using the packet timestamps,
+    ///   when no packet was received for PostTriggerDuration of real time, or by Dispose().
+    ///   </para>
+    ///   <para>
+    ///   The dump files are written natively in the same format PacketDumpFile writes, with the communicator data link and snapshot length.
+    ///   Each dump file name is the prefix followed by the UTC timestamp of the packet that fired the trigger.
+    ///   </para>
+    ///   <para>The ring records the packets in every ReceivePacket(), ReceiveSomePackets() and ReceivePackets() call of the communicator, before any other stage.</para>
+    /// </remarks>
+    public ref class PacketCaptureRing sealed : System::IDisposable
+    {
+    public:
+        /// <summary>
+        /// Creates a ring and attaches it to the communicator, replacing the previous ring attached to it.
+        /// </summary>
+        /// <param name="communicator">The communicator to record the packets of.</param>
+        /// <param name="capacity">
+        /// The size of the ring in bytes. Every packet takes 16 bytes more than its length, rounded up to 8 bytes.
+        /// The ring allocates two slabs of this size and a queue of this size rounded up to a power of 2.
+        /// </param>
+        /// <param name="dumpFilePrefix">The path and file name prefix of the dump files. Only ISO-8859-1 characters are supported.</param>
+        /// <exception cref="System::ArgumentNullException">The communicator or the prefix is null.</exception>
+        /// <exception cref="System::ArgumentOutOfRangeException">The capacity is not positive.</exception>
+        PacketCaptureRing(PacketCommunicator^ communicator, int capacity, System::String^ dumpFilePrefix);
+
+        /// <summary>
+        /// The size of the ring in bytes.
+        /// </summary>
+        property int Capacity
+        {
+            int get();
+        }
+
+        /// <summary>
+        /// The number of bytes of the ring used by the recorded packets.
+        /// </summary>
+        property int UsedBytes
+        {
+            int get();
+        }
+
+        /// <summary>
+        /// The number of packets in the ring.
+        /// </summary>
+        property int PacketCount
+        {
+            int get();
+        }
+
+        /// <summary>
+        /// The path and file name prefix of the dump files.
+        /// </summary>
+        property System::String^ DumpFilePrefix
+        {
+            System::String^ get();
+        }
+
+        /// <summary>
+        /// The maximum age of a packet in the ring relative to the newest packet. Zero means only the capacity limits the ring. Zero by default.
+        /// </summary>
+        /// <exception cref="System::ArgumentOutOfRangeException">The value is negative.</exception>
+        property System::TimeSpan MaximumAge
+        {
+            System::TimeSpan get();
+            void set(System::TimeSpan value);
+        }
+
+        /// <summary>
+        /// How long after the trigger the received packets are written to the dump file. 10 seconds by default.
+        /// </summary>
+        /// <exception cref="System::ArgumentOutOfRangeException">The value is negative.</exception>
+        property System::TimeSpan PostTriggerDuration
+        {
+            System::TimeSpan get();
+            void set(System::TimeSpan value);
+        }
+
+        /// <summary>
+        /// A trigger fires when more than this number of packets are received in a second. 0 means no threshold. 0 by default.
+        /// </summary>
+        /// <exception cref="System::ArgumentOutOfRangeException">The value is negative.</exception>
+        property int PacketsPerSecondThreshold
+        {
+            int get();
+            void set(int value);
+        }
+
+        /// <summary>
+        /// Whether the recorded packets are also delivered to the receive callbacks.
+        /// When false, the packets are only recorded and are never copied to managed memory. True by default.
+        /// </summary>
+        property bool DeliversPackets
+        {
+            bool get();
+            void set(bool value);
+        }
+
+        /// <summary>
+        /// Fires a trigger for every packet that matches the filter.
+        /// The filter is copied, so it can be disposed after this call.
+        /// </summary>
+        /// <param name="filter">The filter to match. null removes the trigger filter.</param>
+        void SetTriggerFilter(BerkeleyPacketFilter^ filter);
+
+        /// <summary>
+        /// Fires a trigger with the next received packet.
+        /// Can be called from any thread.
+        /// </summary>
+        void Trigger();
+
+        /// <summary>
+        /// Whether a dump file is being written or is about to be opened by the writer thread.
+        /// </summary>
+        property bool IsDumping
+        {
+            bool get();
+        }
+
+        /// <summary>
+        /// The number of dumps started, including the ones whose file failed to open.
+        /// </summary>
+        property int DumpCount
+        {
+            int get();
+        }
+
+        /// <summary>
+        /// The number of dump files that failed to open and of triggers that fired while the writer thread was still writing the previous pre trigger window.
+        /// </summary>
+        property int DumpFailureCount
+        {
+            int get();
+        }
+
+        /// <summary>
+        /// The number of packets received during PostTriggerDuration that were left out of the dump files because the writer thread fell behind.
+        /// </summary>
+        property int DumpDroppedPacketCount
+        {
+            int get();
+        }
+
+        /// <summary>
+        /// The name of the last dump file, or null if no trigger fired.
+        /// </summary>
+        property System::String^ LastDumpFileName
+        {
+            System::String^ get();
+        }
+
+        /// <summary>
+        /// Detaches the ring from the communicator, waits for the writer thread to write everything queued, closes the dump file being written and frees the ring.
+        /// Should not be called while the communicator is receiving packets.
+        /// </summary>
+        ~PacketCaptureRing();
+
+    internal:
+        property PacketStage* Stage
+        {
+            PacketStage* get();
+        }
+
+        void Attach(int dataLink);
+
+    protected:
+        !PacketCaptureRing();
+
+    private:
+        PacketCommunicator^ _communicator;
+        PacketCaptureRingStage* _stage;
+        System::String^ _dumpFilePrefix;
+        System::TimeSpan _maximumAge;
+        System::TimeSpan _postTriggerDuration;
+        int _packetsPerSecondThreshold;
+        bool _deliversPackets;
+    };
+}}
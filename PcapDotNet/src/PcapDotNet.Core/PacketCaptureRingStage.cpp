@@ -0,0 +1,609 @@
+#include "PacketCaptureRingStage.h"
+
+#include <string.h>
+#include <time.h>
+
+#include "Pcap.h"
+
+using namespace PcapDotNet::Core;
+
+#pragma managed(push, off)
+
+namespace
+{
+    // Leaves room in the queue for the entry that starts a dump, even with a small ring.
+    const unsigned int MinimumQueueCapacity = 4096;
+
+    unsigned int QueueCapacity(unsigned int capacity)
+    {
+        // A power of 2, so the ever growing positions stay consistent when they wrap around.
+        unsigned int queueCapacity = MinimumQueueCapacity;
+        while (queueCapacity < capacity)
+            queueCapacity <<= 1;
+        return queueCapacity;
+    }
+}
+
+PacketCaptureRingStage::PacketCaptureRingStage(int snapshotLength, unsigned int capacity, const char* dumpFilePrefix)
+    : _dataLink(0), _snapshotLength(snapshotLength), _capacity(capacity), _spareSlab(NULL),
+      _maximumAge(0), _postTriggerDuration(0), _packetsPerSecondThreshold(0), _triggerFilter(NULL), _deliversPackets(true),
+      _triggerRequested(0), _rateSecond(0), _rateCount(0),
+      _isDumping(false), _dumpEnd(0),
+      _queue(NULL), _queueCapacity(QueueCapacity(capacity)), _queueHead(0), _queueTail(0), _enqueueStart(0), _enqueueEnd(0),
+      _writerThread(NULL), _writerWakeEvent(NULL), _stopRequested(0), _deadDescriptor(NULL), _dumper(NULL), _lastWriteTick(0), _idleTimeout(0), _dumpDataLink(0), _isIdleClosed(false),
+      _pendingDumpCount(0), _isWriting(0), _dumpCount(0), _dumpFailureCount(0), _dumpDroppedPacketCount(0), _fileNameLock(0)
+{
+    strncpy_s(_dumpFilePrefix, dumpFilePrefix, _TRUNCATE);
+    _lastDumpFileName[0] = '\0';
+    ResetRing(_ring, new unsigned char[capacity]);
+    _spareSlab = new unsigned char[capacity];
+    _queue = new unsigned char[_queueCapacity];
+
+    _writerWakeEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
+    if (_writerWakeEvent != NULL)
+        _writerThread = CreateThread(NULL, 0, &PacketCaptureRingStage::WriterThread, this, 0, NULL);
+}
+
+PacketCaptureRingStage::~PacketCaptureRingStage()
+{
+    if (_writerThread != NULL)
+    {
+        InterlockedExchange(&_stopRequested, 1);
+        SetEvent(_writerWakeEvent);
+        WaitForSingleObject(_writerThread, INFINITE);
+        CloseHandle(_writerThread);
+    }
+    if (_writerWakeEvent != NULL)
+        CloseHandle(_writerWakeEvent);
+
+    // The writer thread returned the spare slab when it stopped.
+    delete[] _queue;
+    delete[] _spareSlab;
+    delete[] _ring.slab;
+
+    TriggerFilter* triggerFilter = _triggerFilter;
+    while (triggerFilter != NULL)
+    {
+        TriggerFilter* replaced = triggerFilter->replaced;
+        delete[] triggerFilter->instructions;
+        delete triggerFilter;
+        triggerFilter = replaced;
+    }
+}
+
+void PacketCaptureRingStage::Attach(int dataLink)
+{
+    _dataLink = dataLink;
+}
+
+unsigned int PacketCaptureRingStage::Capacity() const
+{
+    return _capacity;
+}
+
+unsigned int PacketCaptureRingStage::UsedBytes() const
+{
+    return _ring.usedBytes;
+}
+
+unsigned int PacketCaptureRingStage::PacketCount() const
+{
+    return _ring.count;
+}
+
+void PacketCaptureRingStage::SetMaximumAge(unsigned __int64 maximumAge)
+{
+    _maximumAge = maximumAge;
+}
+
+void PacketCaptureRingStage::SetPostTriggerDuration(unsigned __int64 postTriggerDuration)
+{
+    _postTriggerDuration = postTriggerDuration;
+}
+
+void PacketCaptureRingStage::SetPacketsPerSecondThreshold(unsigned int packetsPerSecondThreshold)
+{
+    _packetsPerSecondThreshold = packetsPerSecondThreshold;
+}
+
+void PacketCaptureRingStage::SetTriggerFilter(const bpf_insn* instructions, unsigned int length)
+{
+    TriggerFilter* triggerFilter = new TriggerFilter();
+    triggerFilter->instructions = NULL;
+    triggerFilter->length = 0;
+    if (instructions != NULL && length != 0)
+    {
+        triggerFilter->instructions = new bpf_insn[length];
+        triggerFilter->length = length;
+        memcpy(triggerFilter->instructions, instructions, sizeof(bpf_insn) * length);
+    }
+
+    // The capture thread reads the filter pointer once per packet, so it runs either the old filter or the new one.
+    triggerFilter->replaced = static_cast<TriggerFilter*>(InterlockedExchangePointer(reinterpret_cast<void* volatile*>(&_triggerFilter), triggerFilter));
+}
+
+void PacketCaptureRingStage::SetDeliversPackets(bool deliversPackets)
+{
+    _deliversPackets = deliversPackets;
+}
+
+void PacketCaptureRingStage::RequestTrigger()
+{
+    InterlockedExchange(&_triggerRequested, 1);
+}
+
+bool PacketCaptureRingStage::IsDumping() const
+{
+    return _pendingDumpCount != 0 || _isWriting != 0;
+}
+
+unsigned int PacketCaptureRingStage::DumpCount() const
+{
+    return _dumpCount;
+}
+
+unsigned int PacketCaptureRingStage::DumpFailureCount() const
+{
+    return _dumpFailureCount;
+}
+
+unsigned int PacketCaptureRingStage::DumpDroppedPacketCount() const
+{
+    return _dumpDroppedPacketCount;
+}
+
+void PacketCaptureRingStage::GetLastDumpFileName(char (&fileName)[MaxFileNameLength]) const
+{
+    LockFileName();
+    strcpy_s(fileName, _lastDumpFileName);
+    UnlockFileName();
+}
+
+bool PacketCaptureRingStage::Process(pcap_pkthdr& packetHeader, const unsigned char* packetData)
+{
+    __int64 timestamp = static_cast<__int64>(packetHeader.ts.tv_sec) * 1000000 + packetHeader.ts.tv_usec;
+
+    Record(timestamp, packetHeader, packetData);
+    bool trigger = ShouldTrigger(timestamp, packetHeader, packetData);
+
+    if (_isDumping)
+    {
+        if (timestamp > _dumpEnd && !trigger)
+        {
+            EndDump();
+        }
+        else
+        {
+            QueueEntry* entry = BeginEnqueue(EntryPacket, sizeof(QueueEntry) + sizeof(RecordHeader) + packetHeader.caplen);
+            if (entry != NULL)
+            {
+                RecordHeader* recordHeader = reinterpret_cast<RecordHeader*>(entry + 1);
+                recordHeader->timestamp = timestamp;
+                recordHeader->capturedLength = packetHeader.caplen;
+                recordHeader->originalLength = packetHeader.len;
+                memcpy(recordHeader + 1, packetData, packetHeader.caplen);
+                EndEnqueue();
+            }
+            else
+            {
+                // The writer thread fell behind.
+                InterlockedIncrement(&_dumpDroppedPacketCount);
+            }
+
+            // Another trigger while dumping extends the dump instead of starting a new one.
+            if (trigger)
+                _dumpEnd = timestamp + static_cast<__int64>(_postTriggerDuration);
+        }
+    }
+    else if (trigger)
+    {
+        StartDump(timestamp);
+    }
+
+    return _deliversPackets;
+}
+
+// Private
+
+// static
+unsigned int PacketCaptureRingStage::RecordSize(unsigned int capturedLength)
+{
+    return EntrySize(sizeof(RecordHeader) + capturedLength);
+}
+
+// static
+unsigned int PacketCaptureRingStage::EntrySize(unsigned int size)
+{
+    // Keep the records and the queue entries 8 bytes aligned.
+    return (size + 7) & ~7u;
+}
+
+// static
+void PacketCaptureRingStage::EvictOldest(Ring& ring)
+{
+    unsigned int size = RecordSize(Oldest(ring)->capturedLength);
+    ring.tail += size;
+    ring.usedBytes -= size;
+    --ring.count;
+
+    if (ring.isWrapped && ring.tail == ring.wrapOffset)
+    {
+        ring.tail = 0;
+        ring.isWrapped = false;
+    }
+}
+
+// static
+const PacketCaptureRingStage::RecordHeader* PacketCaptureRingStage::Oldest(const Ring& ring)
+{
+    return reinterpret_cast<const RecordHeader*>(ring.slab + ring.tail);
+}
+
+// static
+void PacketCaptureRingStage::ResetRing(Ring& ring, unsigned char* slab)
+{
+    ring.slab = slab;
+    ring.head = 0;
+    ring.tail = 0;
+    ring.wrapOffset = 0;
+    ring.isWrapped = false;
+    ring.count = 0;
+    ring.usedBytes = 0;
+}
+
+// static
+unsigned long __stdcall PacketCaptureRingStage::WriterThread(void* parameter)
+{
+    static_cast<PacketCaptureRingStage*>(parameter)->RunWriter();
+    return 0;
+}
+
+void PacketCaptureRingStage::Record(__int64 timestamp, const pcap_pkthdr& packetHeader, const unsigned char* packetData)
+{
+    if (_maximumAge != 0)
+    {
+        while (_ring.count != 0 && Oldest(_ring)->timestamp + static_cast<__int64>(_maximumAge) < timestamp)
+            EvictOldest(_ring);
+    }
+
+    unsigned int size = RecordSize(packetHeader.caplen);
+    if (size > _capacity)
+        return;
+
+    for (;;)
+    {
+        if (_ring.count == 0)
+        {
+            _ring.head = 0;
+            _ring.tail = 0;
+            _ring.isWrapped = false;
+            break;
+        }
+
+        if (!_ring.isWrapped)
+        {
+            if (_capacity - _ring.head >= size)
+                break;
+            _ring.wrapOffset = _ring.head;
+            _ring.head = 0;
+            _ring.isWrapped = true;
+        }
+
+        if (_ring.tail - _ring.head >= size)
+            break;
+        EvictOldest(_ring);
+    }
+
+    RecordHeader* recordHeader = reinterpret_cast<RecordHeader*>(_ring.slab + _ring.head);
+    recordHeader->timestamp = timestamp;
+    recordHeader->capturedLength = packetHeader.caplen;
+    recordHeader->originalLength = packetHeader.len;
+    memcpy(recordHeader + 1, packetData, packetHeader.caplen);
+
+    _ring.head += size;
+    _ring.usedBytes += size;
+    ++_ring.count;
+}
+
+bool PacketCaptureRingStage::ShouldTrigger(__int64 timestamp, const pcap_pkthdr& packetHeader, const unsigned char* packetData)
+{
+    bool trigger = InterlockedExchange(&_triggerRequested, 0) != 0;
+
+    if (_packetsPerSecondThreshold != 0)
+    {
+        __int64 second = timestamp / 1000000;
+        if (second != _rateSecond)
+        {
+            _rateSecond = second;
+            _rateCount = 0;
+        }
+
+        // Fire once when the threshold is passed in every second.
+        if (++_rateCount == _packetsPerSecondThreshold + 1)
+            trigger = true;
+    }
+
+    const TriggerFilter* triggerFilter = _triggerFilter;
+    if (triggerFilter != NULL && triggerFilter->instructions != NULL &&
+        bpf_filter(triggerFilter->instructions, const_cast<unsigned char*>(packetData), packetHeader.len, packetHeader.caplen) != 0)
+    {
+        trigger = true;
+    }
+
+    return trigger;
+}
+
+void PacketCaptureRingStage::StartDump(__int64 timestamp)
+{
+    // The writer thread is still writing the previous pre trigger window from the spare slab.
+    unsigned char* spareSlab = _spareSlab;
+    if (_writerThread == NULL || spareSlab == NULL)
+    {
+        InterlockedIncrement(&_dumpFailureCount);
+        return;
+    }
+
+    char fileName[MaxFileNameLength];
+    FormatDumpFileName(timestamp, fileName);
+    unsigned int fileNameSize = static_cast<unsigned int>(strlen(fileName)) + 1;
+
+    BeginEntry* beginEntry = reinterpret_cast<BeginEntry*>(BeginEnqueue(EntryBegin, sizeof(BeginEntry) + fileNameSize));
+    if (beginEntry == NULL)
+    {
+        InterlockedIncrement(&_dumpFailureCount);
+        return;
+    }
+
+    // The pre trigger window, including the packet that fired the trigger, goes to the writer thread as is.
+    beginEntry->ring = _ring;
+    beginEntry->dataLink = _dataLink;
+    unsigned __int64 idleTimeout = _postTriggerDuration / 1000;
+    beginEntry->idleTimeout = idleTimeout > 0xFFFFFFFF ? 0xFFFFFFFF : static_cast<unsigned int>(idleTimeout);
+    memcpy(beginEntry + 1, fileName, fileNameSize);
+
+    _spareSlab = NULL;
+    ResetRing(_ring, spareSlab);
+
+    LockFileName();
+    strcpy_s(_lastDumpFileName, fileName);
+    UnlockFileName();
+
+    InterlockedIncrement(&_pendingDumpCount);
+    InterlockedIncrement(&_dumpCount);
+    EndEnqueue();
+
+    _isDumping = true;
+    _dumpEnd = timestamp + static_cast<__int64>(_postTriggerDuration);
+}
+
+void PacketCaptureRingStage::FormatDumpFileName(__int64 timestamp, char (&fileName)[MaxFileNameLength]) const
+{
+    __time64_t seconds = timestamp / 1000000;
+    tm time;
+    if (_gmtime64_s(&time, &seconds) != 0)
+        memset(&time, 0, sizeof(time));
+    sprintf_s(fileName, "%s_%04d%02d%02d_%02d%02d%02d_%06d.pcap",
+              _dumpFilePrefix, time.tm_year + 1900, time.tm_mon + 1, time.tm_mday, time.tm_hour, time.tm_min, time.tm_sec,
+              static_cast<int>(timestamp % 1000000));
+}
+
+void PacketCaptureRingStage::EndDump()
+{
+    _isDumping = false;
+
+    // When the queue is full, the writer thread closes the file when it is idle or when the next dump starts.
+    QueueEntry* entry = BeginEnqueue(EntryEnd, sizeof(QueueEntry));
+    if (entry != NULL)
+        EndEnqueue();
+}
+
+PacketCaptureRingStage::QueueEntry* PacketCaptureRingStage::BeginEnqueue(unsigned int kind, unsigned int size)
+{
+    size = EntrySize(size);
+    unsigned int head = static_cast<unsigned int>(_queueHead);
+    unsigned int tail = static_cast<unsigned int>(_queueTail);
+
+    // An entry never wraps around the end of the queue.
+    unsigned int offset = head & (_queueCapacity - 1);
+    unsigned int padding = _queueCapacity - offset < size ? _queueCapacity - offset : 0;
+    if (size > _queueCapacity || head - tail + padding + size > _queueCapacity)
+        return NULL;
+
+    _enqueueStart = head;
+    _enqueueEnd = head + padding + size;
+    if (padding != 0)
+    {
+        QueueEntry* paddingEntry = reinterpret_cast<QueueEntry*>(_queue + offset);
+        paddingEntry->kind = EntryPadding;
+        paddingEntry->size = padding;
+        offset = 0;
+    }
+
+    QueueEntry* entry = reinterpret_cast<QueueEntry*>(_queue + offset);
+    entry->kind = kind;
+    entry->size = size;
+    return entry;
+}
+
+void PacketCaptureRingStage::EndEnqueue()
+{
+    InterlockedExchange(&_queueHead, static_cast<long>(_enqueueEnd));
+
+    // Wake the writer only if it may have found the queue empty and is waiting.
+    // Both threads publish their position before they read the other's, so this can't miss a writer that is about to wait.
+    if (static_cast<unsigned int>(_queueTail) == _enqueueStart)
+        SetEvent(_writerWakeEvent);
+}
+
+const PacketCaptureRingStage::QueueEntry* PacketCaptureRingStage::Peek()
+{
+    for (;;)
+    {
+        unsigned int tail = static_cast<unsigned int>(_queueTail);
+        if (tail == static_cast<unsigned int>(_queueHead))
+            return NULL;
+
+        const QueueEntry* entry = reinterpret_cast<const QueueEntry*>(_queue + (tail & (_queueCapacity - 1)));
+        if (entry->kind != EntryPadding)
+            return entry;
+        Dequeue(entry);
+    }
+}
+
+void PacketCaptureRingStage::Dequeue(const QueueEntry* entry)
+{
+    InterlockedExchange(&_queueTail, static_cast<long>(static_cast<unsigned int>(_queueTail) + entry->size));
+}
+
+void PacketCaptureRingStage::RunWriter()
+{
+    for (;;)
+    {
+        // Everything queued before the stop request is written.
+        bool stopRequested = _stopRequested != 0;
+
+        for (const QueueEntry* entry = Peek(); entry != NULL; entry = Peek())
+        {
+            switch (entry->kind)
+            {
+            case EntryBegin:
+                OpenDumpFile(reinterpret_cast<const BeginEntry*>(entry));
+                break;
+
+            case EntryPacket:
+                if (_isIdleClosed)
+                    ReopenDumpFile(reinterpret_cast<const RecordHeader*>(entry + 1)->timestamp);
+                if (_dumper != NULL)
+                {
+                    Dump(reinterpret_cast<const RecordHeader*>(entry + 1));
+                    _lastWriteTick = GetTickCount64();
+                }
+                break;
+
+            case EntryEnd:
+                CloseDumpFile();
+                _isIdleClosed = false;
+                break;
+            }
+            Dequeue(entry);
+        }
+
+        if (stopRequested)
+            break;
+
+        // The capture thread only ends the dump when a packet arrives after it, which may never happen on an idle link.
+        // A trigger that comes later extends the dump, and its packets go to a new file.
+        if (_dumper != NULL && GetTickCount64() - _lastWriteTick >= _idleTimeout)
+        {
+            CloseDumpFile();
+            _isIdleClosed = true;
+        }
+
+        WaitForSingleObject(_writerWakeEvent, WriterPollInterval);
+    }
+
+    CloseDumpFile();
+}
+
+void PacketCaptureRingStage::OpenDumpFile(const BeginEntry* beginEntry)
+{
+    _isIdleClosed = false;
+    if (CreateDumpFile(beginEntry->dataLink, reinterpret_cast<const char*>(beginEntry + 1)))
+    {
+        const Ring& ring = beginEntry->ring;
+        unsigned int offset = ring.tail;
+        bool isWrapped = ring.isWrapped;
+        for (unsigned int i = 0; i != ring.count; ++i)
+        {
+            if (isWrapped && offset == ring.wrapOffset)
+            {
+                offset = 0;
+                isWrapped = false;
+            }
+
+            const RecordHeader* recordHeader = reinterpret_cast<const RecordHeader*>(ring.slab + offset);
+            Dump(recordHeader);
+            offset += RecordSize(recordHeader->capturedLength);
+        }
+
+        _idleTimeout = beginEntry->idleTimeout;
+        _lastWriteTick = GetTickCount64();
+    }
+
+    // The next trigger can swap the slabs again.
+    _spareSlab = beginEntry->ring.slab;
+    InterlockedDecrement(&_pendingDumpCount);
+}
+
+void PacketCaptureRingStage::ReopenDumpFile(__int64 timestamp)
+{
+    _isIdleClosed = false;
+
+    char fileName[MaxFileNameLength];
+    FormatDumpFileName(timestamp, fileName);
+    LockFileName();
+    strcpy_s(_lastDumpFileName, fileName);
+    UnlockFileName();
+    InterlockedIncrement(&_dumpCount);
+
+    CreateDumpFile(_dumpDataLink, fileName);
+}
+
+bool PacketCaptureRingStage::CreateDumpFile(int dataLink, const char* fileName)
+{
+    // A new dump starts before the previous one ended when its end didn't fit in the queue.
+    CloseDumpFile();
+
+    _dumpDataLink = dataLink;
+    _deadDescriptor = pcap_open_dead(dataLink, _snapshotLength);
+    if (_deadDescriptor != NULL)
+        _dumper = pcap_dump_open(_deadDescriptor, fileName);
+
+    if (_dumper == NULL)
+    {
+        InterlockedIncrement(&_dumpFailureCount);
+        CloseDumpFile();
+        return false;
+    }
+
+    InterlockedExchange(&_isWriting, 1);
+    return true;
+}
+
+void PacketCaptureRingStage::CloseDumpFile()
+{
+    if (_dumper != NULL)
+    {
+        pcap_dump_close(_dumper);
+        _dumper = NULL;
+    }
+    if (_deadDescriptor != NULL)
+    {
+        pcap_close(_deadDescriptor);
+        _deadDescriptor = NULL;
+    }
+    InterlockedExchange(&_isWriting, 0);
+}
+
+void PacketCaptureRingStage::Dump(const RecordHeader* recordHeader)
+{
+    pcap_pkthdr header;
+    header.ts.tv_sec = static_cast<long>(recordHeader->timestamp / 1000000);
+    header.ts.tv_usec = static_cast<long>(recordHeader->timestamp % 1000000);
+    header.caplen = recordHeader->capturedLength;
+    header.len = recordHeader->originalLength;
+    pcap_dump(reinterpret_cast<unsigned char*>(_dumper), &header, reinterpret_cast<const unsigned char*>(recordHeader + 1));
+}
+
+void PacketCaptureRingStage::LockFileName() const
+{
+    while (InterlockedCompareExchange(&_fileNameLock, 1, 0) != 0)
+        YieldProcessor();
+}
+
+void PacketCaptureRingStage::UnlockFileName() const
+{
+    InterlockedExchange(&_fileNameLock, 0);
+}
+
+#pragma managed(pop)
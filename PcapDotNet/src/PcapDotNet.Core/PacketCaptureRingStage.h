@@ -0,0 +1,200 @@
+#pragma once
+
+#include "PacketStage.h"
+
+struct bpf_insn;
+
+namespace PcapDotNet { namespace Core 
+{
+    // The native part of PacketCaptureRing.
+    // Records every packet in a preallocated slab, evicting the oldest packets by size and age.
+    // When a trigger fires, the slab is swapped with a spare slab and handed to a writer thread,
+    // followed by the packets received until the dump ends, so the capture thread never writes to the dump file.
+    class PacketCaptureRingStage : public PacketStage
+    {
+    public:
+        static const int MaxFileNameLength = 260;
+
+        // Allocates the recording slab, the spare slab and the queue of the packets that follow a trigger,
+        // which is the capacity rounded up to a power of 2 and at least 4096 bytes.
+        // Starts the writer thread.
+        PacketCaptureRingStage(int snapshotLength, unsigned int capacity, const char* dumpFilePrefix);
+        // Stops the writer thread after it wrote everything that was queued.
+        virtual ~PacketCaptureRingStage();
+
+        // The data link of the dump files started from now on.
+        void Attach(int dataLink);
+
+        unsigned int Capacity() const;
+        unsigned int UsedBytes() const;
+        unsigned int PacketCount() const;
+
+        // Microseconds. 0 means only the capacity limits the ring.
+        void SetMaximumAge(unsigned __int64 maximumAge);
+        // Microseconds.
+        void SetPostTriggerDuration(unsigned __int64 postTriggerDuration);
+        // 0 means no threshold.
+        void SetPacketsPerSecondThreshold(unsigned int packetsPerSecondThreshold);
+        // Copies the instructions. NULL removes the filter.
+        // The replaced filter is kept until the stage is destroyed, since the capture thread may be running it.
+        void SetTriggerFilter(const bpf_insn* instructions, unsigned int length);
+        void SetDeliversPackets(bool deliversPackets);
+
+        // Can be called from any thread. The trigger fires with the next packet.
+        void RequestTrigger();
+
+        // The following can be called from any thread.
+        bool IsDumping() const;
+        unsigned int DumpCount() const;
+        unsigned int DumpFailureCount() const;
+        unsigned int DumpDroppedPacketCount() const;
+        // Empty if no dump was started.
+        void GetLastDumpFileName(char (&fileName)[MaxFileNameLength]) const;
+
+        virtual bool Process(pcap_pkthdr& packetHeader, const unsigned char* packetData) override;
+
+    private:
+        struct RecordHeader
+        {
+            __int64 timestamp;
+            unsigned int capturedLength;
+            unsigned int originalLength;
+        };
+
+        // The records are in [tail, head) or, when wrapped, in [tail, wrapOffset) and [0, head).
+        struct Ring
+        {
+            unsigned char* slab;
+            unsigned int head;
+            unsigned int tail;
+            // The end of the records at the top of the slab, when the records wrapped to its beginning.
+            unsigned int wrapOffset;
+            bool isWrapped;
+            unsigned int count;
+            unsigned int usedBytes;
+        };
+
+        // The entries the capture thread queues for the writer thread, 8 bytes aligned.
+        struct QueueEntry
+        {
+            unsigned int kind;
+            // The size of the entry including this header.
+            unsigned int size;
+        };
+
+        // Followed by the file name.
+        struct BeginEntry
+        {
+            QueueEntry entry;
+            Ring ring;
+            int dataLink;
+            // Milliseconds.
+            unsigned int idleTimeout;
+        };
+
+        // Published as a whole, so the capture thread never sees instructions with the length of another filter.
+        struct TriggerFilter
+        {
+            bpf_insn* instructions;
+            unsigned int length;
+            // The filter this one replaced, freed with it.
+            TriggerFilter* replaced;
+        };
+
+        static const unsigned int EntryBegin = 1;
+        static const unsigned int EntryPacket = 2;
+        static const unsigned int EntryEnd = 3;
+        // Fills the end of the queue when the next entry doesn't fit there.
+        static const unsigned int EntryPadding = 4;
+
+        // Milliseconds. Bounds the time the writer takes to notice an entry queued without waking it.
+        static const unsigned int WriterPollInterval = 50;
+
+        static unsigned int RecordSize(unsigned int capturedLength);
+        static unsigned int EntrySize(unsigned int size);
+        static void EvictOldest(Ring& ring);
+        static const RecordHeader* Oldest(const Ring& ring);
+        static void ResetRing(Ring& ring, unsigned char* slab);
+        static unsigned long __stdcall WriterThread(void* parameter);
+
+        void Record(__int64 timestamp, const pcap_pkthdr& packetHeader, const unsigned char* packetData);
+        bool ShouldTrigger(__int64 timestamp, const pcap_pkthdr& packetHeader, const unsigned char* packetData);
+        void StartDump(__int64 timestamp);
+        void FormatDumpFileName(__int64 timestamp, char (&fileName)[MaxFileNameLength]) const;
+        void EndDump();
+
+        // Capture thread. Returns NULL if the queue is full.
+        // The entry is visible to the writer thread after EndEnqueue().
+        QueueEntry* BeginEnqueue(unsigned int kind, unsigned int size);
+        void EndEnqueue();
+        // Writer thread. Returns NULL if the queue is empty.
+        const QueueEntry* Peek();
+        void Dequeue(const QueueEntry* entry);
+
+        void RunWriter();
+        void OpenDumpFile(const BeginEntry* beginEntry);
+        void ReopenDumpFile(__int64 timestamp);
+        bool CreateDumpFile(int dataLink, const char* fileName);
+        void CloseDumpFile();
+        void Dump(const RecordHeader* recordHeader);
+
+        void LockFileName() const;
+        void UnlockFileName() const;
+
+        char _dumpFilePrefix[MaxFileNameLength];
+        int _dataLink;
+        int _snapshotLength;
+        unsigned int _capacity;
+
+        // Owned by the capture thread.
+        Ring _ring;
+        // NULL while the writer thread is writing the previous pre trigger window from it.
+        unsigned char* volatile _spareSlab;
+
+        unsigned __int64 _maximumAge;
+        unsigned __int64 _postTriggerDuration;
+        unsigned int _packetsPerSecondThreshold;
+        TriggerFilter* volatile _triggerFilter;
+        bool _deliversPackets;
+
+        volatile long _triggerRequested;
+        __int64 _rateSecond;
+        unsigned int _rateCount;
+
+        // The capture thread view of the dump.
+        bool _isDumping;
+        __int64 _dumpEnd;
+
+        // The queue positions grow forever, the offset in the queue is the position modulo the capacity.
+        unsigned char* _queue;
+        unsigned int _queueCapacity;
+        volatile long _queueHead;
+        volatile long _queueTail;
+        unsigned int _enqueueStart;
+        unsigned int _enqueueEnd;
+
+        // Owned by the writer thread.
+        void* _writerThread;
+        void* _writerWakeEvent;
+        volatile long _stopRequested;
+        pcap_t* _deadDescriptor;
+        pcap_dumper_t* _dumper;
+        unsigned __int64 _lastWriteTick;
+        unsigned int _idleTimeout;
+        int _dumpDataLink;
+        // The dump file was closed because no packet came for the idle timeout, but the capture thread didn't end the dump.
+        bool _isIdleClosed;
+
+        // Begin entries queued and not yet handled by the writer thread.
+        volatile long _pendingDumpCount;
+        volatile long _isWriting;
+        volatile long _dumpCount;
+        volatile long _dumpFailureCount;
+        volatile long _dumpDroppedPacketCount;
+        mutable volatile long _fileNameLock;
+        char _lastDumpFileName[MaxFileNameLength];
+
+        PacketCaptureRingStage(const PacketCaptureRingStage&) = delete;
+        PacketCaptureRingStage& operator=(const PacketCaptureRingStage&) = delete;
+    };
+}}
@@ -0,0 +1,225 @@
+#include "PacketClassifier.h"
+#include "Pcap.h"
+
+using namespace System;
+using namespace System::Collections::Generic;
+using namespace System::Collections::ObjectModel;
+using namespace System::Runtime::InteropServices;
+using namespace PcapDotNet::Core;
+using namespace PcapDotNet::Packets;
+
+PacketClassifier::PacketClassifier(DataLinkKind kind, int snapshotLength)
+{
+    if (snapshotLength <= 0)
+        throw gcnew ArgumentOutOfRangeException("snapshotLength", snapshotLength, "Must be positive");
+
+    _kind = kind;
+    _snapshotLength = snapshotLength;
+    _subscriptions = gcnew List<PacketClassifierSubscription^>();
+    _root = gcnew CheckNode();
+}
+
+ReadOnlyCollection<PacketClassifierSubscription^>^ PacketClassifier::Subscriptions::get()
+{
+    return _subscriptions->AsReadOnly();
+}
+
+int PacketClassifier::SharedCheckCount::get()
+{
+    return _sharedCheckCount;
+}
+
+PacketClassifierSubscription^ PacketClassifier::Subscribe(String^ name, String^ filterValue, int queueCapacity)
+{
+    if (filterValue == nullptr)
+        throw gcnew ArgumentNullException("filterValue");
+    if (queueCapacity <= 0)
+        throw gcnew ArgumentOutOfRangeException("queueCapacity", queueCapacity, "Must be positive");
+    AssertNotDisposed();
+
+    BerkeleyPacketFilter^ filter = gcnew BerkeleyPacketFilter(filterValue, _snapshotLength, _kind);
+    PacketClassifierSubscription^ subscription = gcnew PacketClassifierSubscription(name, filterValue, filter, queueCapacity);
+    for each (List<Check>^ checks in GetLeadingChecks(filter->Program))
+        Add(_root, checks, 0, subscription);
+    _subscriptions->Add(subscription);
+    return subscription;
+}
+
+PacketClassifierSubscription^ PacketClassifier::Subscribe(String^ name, String^ filterValue)
+{
+    return Subscribe(name, filterValue, DefaultQueueCapacity);
+}
+
+int PacketClassifier::Classify(Packet^ packet)
+{
+    if (packet == nullptr)
+        throw gcnew ArgumentNullException("packet");
+    AssertNotDisposed();
+
+    return Classify(_root, packet);
+}
+
+PacketClassifier::~PacketClassifier()
+{
+    if (_disposed)
+        return;
+
+    _disposed = true;
+    for each (PacketClassifierSubscription^ subscription in _subscriptions)
+        subscription->Close();
+}
+
+// Private
+
+void PacketClassifier::AssertNotDisposed()
+{
+    if (_disposed)
+        throw gcnew ObjectDisposedException("PacketClassifier");
+}
+
+void PacketClassifier::Add(CheckNode^ node, List<Check>^ checks, int checkIndex, PacketClassifierSubscription^ subscription)
+{
+    if (checkIndex == checks->Count)
+    {
+        node->Subscriptions->Add(subscription);
+        return;
+    }
+
+    Check check = checks[checkIndex];
+    CheckGroup^ group = nullptr;
+    for each (CheckGroup^ existingGroup in node->Groups)
+    {
+        if (existingGroup->Offset == check.Offset && existingGroup->Size == check.Size)
+        {
+            group = existingGroup;
+            break;
+        }
+    }
+    if (group == nullptr)
+    {
+        group = gcnew CheckGroup(check.Offset, check.Size);
+        node->Groups->Add(group);
+    }
+
+    CheckNode^ child;
+    if (!group->Children->TryGetValue(check.Value, child))
+    {
+        child = gcnew CheckNode();
+        group->Children->Add(check.Value, child);
+        ++_sharedCheckCount;
+    }
+
+    Add(child, checks, checkIndex + 1, subscription);
+}
+
+int PacketClassifier::Classify(CheckNode^ node, Packet^ packet)
+{
+    int matches = 0;
+
+    // The packet passed all the leading checks of these subscriptions, so only now their whole filter is run.
+    List<PacketClassifierSubscription^>^ subscriptions = node->Subscriptions;
+    for (int i = 0; i != subscriptions->Count; ++i)
+    {
+        PacketClassifierSubscription^ subscription = subscriptions[i];
+        if (subscription->Filter->Test(packet))
+        {
+            subscription->Enqueue(packet);
+            ++matches;
+        }
+    }
+
+    // Every group loads its bytes once and at most one of its children can match the value.
+    List<CheckGroup^>^ groups = node->Groups;
+    for (int i = 0; i != groups->Count; ++i)
+    {
+        CheckGroup^ group = groups[i];
+        unsigned int value;
+        CheckNode^ child;
+        if (TryLoad(packet, group->Offset, group->Size, value) && group->Children->TryGetValue(value, child))
+            matches += Classify(child, packet);
+    }
+
+    return matches;
+}
+
+// static
+List<List<PacketClassifier::Check>^>^ PacketClassifier::GetLeadingChecks(const bpf_program* program)
+{
+    List<List<Check>^>^ paths = gcnew List<List<Check>^>();
+    AddLeadingChecks(program, 0, gcnew List<Check>(), paths);
+    return paths;
+}
+
+// static
+void PacketClassifier::AddLeadingChecks(const bpf_program* program, unsigned int pc, List<Check>^ checks, List<List<Check>^>^ paths)
+{
+    const bpf_insn* instructions = program->bf_insns;
+    unsigned int numInstructions = program->bf_len;
+
+    // A check is an absolute load followed by a chain of jeqs on the loaded value.
+    // Each jeq jumps to the rest of the program for its value or to the next jeq, and the last one jumps to return 0.
+    List<unsigned int>^ values = gcnew List<unsigned int>();
+    List<unsigned int>^ targets = gcnew List<unsigned int>();
+    const bpf_insn& load = instructions[pc];
+    if (BPF_CLASS(load.code) == BPF_LD && BPF_MODE(load.code) == BPF_ABS)
+    {
+        unsigned int testPc = pc + 1;
+        while (testPc < numInstructions && instructions[testPc].code == (BPF_JMP | BPF_JEQ | BPF_K))
+        {
+            const bpf_insn& test = instructions[testPc];
+            unsigned int target = testPc + 1 + test.jt;
+            bool isRejected = instructions[target].code == (BPF_RET | BPF_K) && instructions[target].k == 0;
+
+            // Only the first jeq of a value is ever taken.
+            if (!isRejected && !values->Contains(test.k))
+            {
+                values->Add(test.k);
+                targets->Add(target);
+            }
+            testPc = testPc + 1 + test.jf;
+        }
+
+        if (testPc >= numInstructions || instructions[testPc].code != (BPF_RET | BPF_K) || instructions[testPc].k != 0)
+            values->Clear();
+    }
+
+    // The rest of the program is left to the filter.
+    if (values->Count == 0 || paths->Count + values->Count > MaxLeadingCheckPaths)
+    {
+        paths->Add(checks);
+        return;
+    }
+
+    // The values are different, so a packet can follow at most one of the paths and the filter is run at most once.
+    for (int i = 0; i != values->Count; ++i)
+    {
+        Check check;
+        check.Offset = load.k;
+        check.Size = BPF_SIZE(load.code) == BPF_W ? 4 : BPF_SIZE(load.code) == BPF_H ? 2 : 1;
+        check.Value = values[i];
+
+        List<Check>^ valueChecks = gcnew List<Check>(checks);
+        valueChecks->Add(check);
+        AddLeadingChecks(program, targets[i], valueChecks, paths);
+    }
+}
+
+// static
+bool PacketClassifier::TryLoad(Packet^ packet, unsigned int offset, int size, [Out] unsigned int% value)
+{
+    // Like the filter program, a load beyond the captured bytes fails the check.
+    if (offset > static_cast<unsigned int>(packet->Length) || static_cast<unsigned int>(packet->Length) - offset < static_cast<unsigned int>(size))
+    {
+        value = 0;
+        return false;
+    }
+
+    array<Byte>^ buffer = packet->Buffer;
+    unsigned int startOffset = packet->StartOffset + offset;
+    unsigned int result = 0;
+    for (int i = 0; i != size; ++i)
+        result = (result << 8) | buffer[startOffset + i];
+
+    value = result;
+    return true;
+}
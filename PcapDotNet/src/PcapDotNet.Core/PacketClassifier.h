@@ -0,0 +1,155 @@
+#pragma once
+
+#include "PacketClassifierSubscription.h"
+
+namespace PcapDotNet { namespace Core 
+{
+    /// <summary>
+    /// Evaluates many filters on the same packets and dispatches every packet to the queues of the subscriptions it matches.
+    /// </summary>
+    /// <remarks>
+    ///   <para>
+    ///   Most compiled filter programs start with the same checks, like the ethernet type or the IP protocol.
+    ///   The classifier takes the leading equality checks every program must pass and merges them into a shared decision tree,
+    ///   so each of these checks is made once per packet and a filter is only run if the packet passed all of its leading checks.
+    ///   </para>
+    ///   <para>
+    ///   A leading check can accept a few values, like the IPv4 and IPv6 ethernet types of a plain tcp filter.
+    ///   Every value starts its own path of checks and the filter is added at the end of each of these paths.
+    ///   Only loads from constant offsets compared to constants are shared, so the checks after a variable offset load,
+    ///   like the ports after the IPv4 header, are made by the filter itself.
+    ///   </para>
+    ///   <para>Subscribing and classifying should be done by a single thread. The subscription queues can be consumed by any thread.</para>
+    ///   <para>The user must dispose instances of this class to deallocate the filters. Disposing also completes the subscription queues.</para>
+    /// </remarks>
+    public ref class PacketClassifier sealed : System::IDisposable
+    {
+    public:
+        /// <summary>
+        /// The queue capacity of subscriptions created without one.
+        /// </summary>
+        static const int DefaultQueueCapacity = 10000;
+
+        /// <summary>
+        /// Creates a classifier for packets of the given link layer.
+        /// </summary>
+        /// <param name="kind">The link layer of the packets that will be classified.</param>
+        /// <param name="snapshotLength">The snapshot length the filters are compiled with.</param>
+        /// <exception cref="System::ArgumentOutOfRangeException">The snapshot length is not positive.</exception>
+        PacketClassifier(Packets::DataLinkKind kind, int snapshotLength);
+
+        /// <summary>
+        /// The subscriptions in the order they were added.
+        /// </summary>
+        property System::Collections::ObjectModel::ReadOnlyCollection<PacketClassifierSubscription^>^ Subscriptions
+        {
+            System::Collections::ObjectModel::ReadOnlyCollection<PacketClassifierSubscription^>^ get();
+        }
+
+        /// <summary>
+        /// The number of distinct leading checks shared by the subscriptions.
+        /// Each of them is evaluated at most once per packet.
+        /// </summary>
+        property int SharedCheckCount
+        {
+            int get();
+        }
+
+        /// <summary>
+        /// Adds a subscription with the given filter.
+        /// </summary>
+        /// <param name="name">A name for the subscription.</param>
+        /// <param name="filterValue">A high level filtering expression (see <see href="http://www.winpcap.org/docs/docs_40_2/html/group__language.html">WinPcap Filtering expression syntax</see>).</param>
+        /// <param name="queueCapacity">The maximum number of packets waiting in the subscription queue.</param>
+        /// <returns>The new subscription.</returns>
+        /// <exception cref="System::ArgumentNullException">The filter value is null.</exception>
+        /// <exception cref="System::ArgumentOutOfRangeException">The queue capacity is not positive.</exception>
+        /// <exception cref="System::ArgumentException">The filter couldn't be compiled. Probably caused by bad syntax.</exception>
+        /// <exception cref="System::ObjectDisposedException">The classifier was disposed.</exception>
+        PacketClassifierSubscription^ Subscribe(System::String^ name, System::String^ filterValue, int queueCapacity);
+
+        /// <summary>
+        /// Adds a subscription with the given filter and the default queue capacity.
+        /// </summary>
+        /// <param name="name">A name for the subscription.</param>
+        /// <param name="filterValue">A high level filtering expression (see <see href="http://www.winpcap.org/docs/docs_40_2/html/group__language.html">WinPcap Filtering expression syntax</see>).</param>
+        /// <returns>The new subscription.</returns>
+        /// <exception cref="System::ArgumentNullException">The filter value is null.</exception>
+        /// <exception cref="System::ArgumentException">The filter couldn't be compiled. Probably caused by bad syntax.</exception>
+        /// <exception cref="System::ObjectDisposedException">The classifier was disposed.</exception>
+        PacketClassifierSubscription^ Subscribe(System::String^ name, System::String^ filterValue);
+
+        /// <summary>
+        /// Evaluates all the subscription filters on the packet and adds it to the queue of every subscription it matches.
+        /// </summary>
+        /// <param name="packet">The packet to classify.</param>
+        /// <returns>The number of subscriptions the packet matched.</returns>
+        /// <exception cref="System::ArgumentNullException">The packet is null.</exception>
+        /// <exception cref="System::ObjectDisposedException">The classifier was disposed.</exception>
+        int Classify(Packets::Packet^ packet);
+
+        /// <summary>
+        /// Disposes the filters and completes the subscription queues. Packets already queued can still be taken.
+        /// </summary>
+        ~PacketClassifier(); // IDisposable
+
+    private:
+        // A load from a constant offset followed by an equality test that rejects the packet when it fails.
+        value struct Check
+        {
+            unsigned int Offset;
+            int Size;
+            unsigned int Value;
+        };
+
+        ref class CheckNode;
+
+        // The children of a node that load the same bytes, keyed by the value they compare to.
+        ref class CheckGroup
+        {
+        public:
+            CheckGroup(unsigned int offset, int size)
+                : Offset(offset), Size(size), Children(gcnew System::Collections::Generic::Dictionary<unsigned int, CheckNode^>())
+            {
+            }
+
+            unsigned int Offset;
+            int Size;
+            System::Collections::Generic::Dictionary<unsigned int, CheckNode^>^ Children;
+        };
+
+        // The subscriptions whose leading checks end here and the checks that continue from here.
+        ref class CheckNode
+        {
+        public:
+            CheckNode()
+                : Subscriptions(gcnew System::Collections::Generic::List<PacketClassifierSubscription^>()),
+                  Groups(gcnew System::Collections::Generic::List<CheckGroup^>())
+            {
+            }
+
+            System::Collections::Generic::List<PacketClassifierSubscription^>^ Subscriptions;
+            System::Collections::Generic::List<CheckGroup^>^ Groups;
+        };
+
+        void AssertNotDisposed();
+        void Add(CheckNode^ node, System::Collections::Generic::List<Check>^ checks, int checkIndex, PacketClassifierSubscription^ subscription);
+        int Classify(CheckNode^ node, Packets::Packet^ packet);
+
+        static System::Collections::Generic::List<System::Collections::Generic::List<Check>^>^ GetLeadingChecks(const bpf_program* program);
+        static void AddLeadingChecks(const bpf_program* program, unsigned int pc, System::Collections::Generic::List<Check>^ checks,
+                                     System::Collections::Generic::List<System::Collections::Generic::List<Check>^>^ paths);
+        static bool TryLoad(Packets::Packet^ packet, unsigned int offset, int size, [System::Runtime::InteropServices::Out] unsigned int% value);
+
+    private:
+        // Bounds the number of paths a single filter is added to.
+        static const int MaxLeadingCheckPaths = 64;
+
+        Packets::DataLinkKind _kind;
+        int _snapshotLength;
+        System::Collections::Generic::List<PacketClassifierSubscription^>^ _subscriptions;
+        CheckNode^ _root;
+        int _sharedCheckCount;
+        bool _disposed;
+    };
+}}
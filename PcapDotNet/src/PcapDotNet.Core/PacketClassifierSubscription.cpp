@@ -0,0 +1,84 @@
+#include "PacketClassifierSubscription.h"
+
+using namespace System;
+using namespace System::Collections::Concurrent;
+using namespace System::Globalization;
+using namespace System::Runtime::InteropServices;
+using namespace System::Threading;
+using namespace PcapDotNet::Core;
+using namespace PcapDotNet::Packets;
+
+String^ PacketClassifierSubscription::Name::get()
+{
+    return _name;
+}
+
+String^ PacketClassifierSubscription::FilterValue::get()
+{
+    return _filterValue;
+}
+
+int PacketClassifierSubscription::QueueCapacity::get()
+{
+    return _queue->BoundedCapacity;
+}
+
+int PacketClassifierSubscription::QueuedPackets::get()
+{
+    return _queue->Count;
+}
+
+__int64 PacketClassifierSubscription::MatchedPackets::get()
+{
+    return Interlocked::Read(_matchedPackets);
+}
+
+__int64 PacketClassifierSubscription::DroppedPackets::get()
+{
+    return Interlocked::Read(_droppedPackets);
+}
+
+bool PacketClassifierSubscription::TryDequeue([Out] Packet^% packet)
+{
+    return _queue->TryTake(packet);
+}
+
+bool PacketClassifierSubscription::TryDequeue([Out] Packet^% packet, TimeSpan timeout)
+{
+    return _queue->TryTake(packet, timeout);
+}
+
+String^ PacketClassifierSubscription::ToString()
+{
+    return String::Format(CultureInfo::InvariantCulture, "{0} <{1}>: {2} matched, {3} dropped, {4} queued",
+                          _name, _filterValue, MatchedPackets, DroppedPackets, QueuedPackets);
+}
+
+// Internal
+
+PacketClassifierSubscription::PacketClassifierSubscription(String^ name, String^ filterValue, BerkeleyPacketFilter^ filter, int queueCapacity)
+    : _name(name), _filterValue(filterValue)
+{
+    _filter = gcnew CompiledBerkeleyPacketFilter(filter);
+    _queue = gcnew BlockingCollection<Packet^>(gcnew ConcurrentQueue<Packet^>(), queueCapacity);
+}
+
+CompiledBerkeleyPacketFilter^ PacketClassifierSubscription::Filter::get()
+{
+    return _filter;
+}
+
+void PacketClassifierSubscription::Enqueue(Packet^ packet)
+{
+    Interlocked::Increment(_matchedPackets);
+
+    // A slow subscriber loses packets instead of holding back the others.
+    if (!_queue->TryAdd(packet))
+        Interlocked::Increment(_droppedPackets);
+}
+
+void PacketClassifierSubscription::Close()
+{
+    _queue->CompleteAdding();
+    delete _filter->Filter;
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "CompiledBerkeleyPacketFilter.h"
+
+namespace PcapDotNet { namespace Core 
+{
+    /// <summary>
+    /// A filter registered in a PacketClassifier and the bounded queue of the packets that matched it.
+    /// The classifier adds packets to the queue and any thread can take them from it.
+    /// </summary>
+    public ref class PacketClassifierSubscription sealed
+    {
+    public:
+        /// <summary>
+        /// The name given to the subscription when it was created.
+        /// </summary>
+        property System::String^ Name
+        {
+            System::String^ get();
+        }
+
+        /// <summary>
+        /// The filtering expression of the subscription.
+        /// </summary>
+        property System::String^ FilterValue
+        {
+            System::String^ get();
+        }
+
+        /// <summary>
+        /// The maximum number of packets waiting in the queue. Matching packets that arrive when the queue is full are dropped.
+        /// </summary>
+        property int QueueCapacity
+        {
+            int get();
+        }
+
+        /// <summary>
+        /// The number of packets waiting in the queue.
+        /// </summary>
+        property int QueuedPackets
+        {
+            int get();
+        }
+
+        /// <summary>
+        /// The number of packets that matched the filter, including the dropped ones.
+        /// </summary>
+        property __int64 MatchedPackets
+        {
+            __int64 get();
+        }
+
+        /// <summary>
+        /// The number of packets that matched the filter but were dropped because the queue was full.
+        /// </summary>
+        property __int64 DroppedPackets
+        {
+            __int64 get();
+        }
+
+        /// <summary>
+        /// Takes the next packet from the queue if there is one.
+        /// </summary>
+        /// <param name="packet">The packet taken or null if the queue is empty.</param>
+        /// <returns>True iff a packet was taken.</returns>
+        bool TryDequeue([System::Runtime::InteropServices::Out] Packets::Packet^% packet);
+
+        /// <summary>
+        /// Takes the next packet from the queue, waiting for one to arrive if the queue is empty.
+        /// </summary>
+        /// <param name="packet">The packet taken or null if no packet arrived.</param>
+        /// <param name="timeout">The maximum time to wait.</param>
+        /// <returns>True iff a packet was taken. False if the timeout passed or the classifier was disposed and the queue is empty.</returns>
+        bool TryDequeue([System::Runtime::InteropServices::Out] Packets::Packet^% packet, System::TimeSpan timeout);
+
+        virtual System::String^ ToString() override;
+
+    internal:
+        PacketClassifierSubscription(System::String^ name, System::String^ filterValue, BerkeleyPacketFilter^ filter, int queueCapacity);
+
+        property CompiledBerkeleyPacketFilter^ Filter
+        {
+            CompiledBerkeleyPacketFilter^ get();
+        }
+
+        void Enqueue(Packets::Packet^ packet);
+        void Close();
+
+    private:
+        System::String^ _name;
+        System::String^ _filterValue;
+        CompiledBerkeleyPacketFilter^ _filter;
+        System::Collections::Concurrent::BlockingCollection<Packets::Packet^>^ _queue;
+        __int64 _matchedPackets;
+        __int64 _droppedPackets;
+    };
+}}
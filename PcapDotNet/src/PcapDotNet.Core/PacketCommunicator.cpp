@@ -1,7 +1,12 @@
 #include "PacketCommunicator.h"
 
+#include "BerkeleyPacketFilterCache.h"
 #include "MarshalingServices.h"
+#include "PacketCaptureRing.h"
 #include "PacketDumpFile.h"
+#include "PacketLoopBreaker.h"
+#include "PacketStageChainSlot.h"
+#include "PacketStatisticsCounter.h"
 #include "PacketTimestamp.h"
 #include "PcapError.h"
 #include "Pcap.h"
@@ -11,6 +16,7 @@ using namespace System::Globalization;
 using namespace System::Runtime::InteropServices;
 using namespace System::Collections::ObjectModel;
 using namespace System::Collections::Generic;
+using namespace System::Threading;
 using namespace PcapDotNet::Packets;
 using namespace PcapDotNet::Core;
 
@@ -23,6 +29,7 @@ void PacketCommunicator::DataLink::set(PcapDataLink value)
 {
     if (pcap_set_datalink(_pcapDescriptor, value.Value) == -1)
         throw BuildInvalidOperation("Failed setting datalink " + value.ToString());
+    RebuildStages(nullptr);
 }
 
 ReadOnlyCollection<PcapDataLink>^ PacketCommunicator::SupportedDataLinks::get()
@@ -77,11 +84,51 @@ PacketCommunicatorMode PacketCommunicator::Mode::get()
 
 void PacketCommunicator::Mode::set(PacketCommunicatorMode value)
 {
+    // When statistics mode is emulated the driver stays in capture mode.
+    if (_emulateStatisticsMode &&
+        (value == PacketCommunicatorMode::Statistics || (value == PacketCommunicatorMode::Capture && _mode == PacketCommunicatorMode::Statistics)))
+    {
+        _mode = value;
+        return;
+    }
+
     if (pcap_setmode(_pcapDescriptor, safe_cast<int>(value)) < 0)
-        throw BuildInvalidOperation("Error setting mode " + value.ToString());
+    {
+        if (value != PacketCommunicatorMode::Statistics || _mode != PacketCommunicatorMode::Capture || ReadTimeout <= 0)
+            throw BuildInvalidOperation("Error setting mode " + value.ToString());
+
+        // The driver doesn't support statistics mode, so count the packets ourselves.
+        _emulateStatisticsMode = true;
+        _statisticsDeadline = 0;
+    }
     _mode = value;
 }
 
+bool PacketCommunicator::EmulateStatisticsMode::get()
+{
+    return _emulateStatisticsMode;
+}
+
+void PacketCommunicator::EmulateStatisticsMode::set(bool value)
+{
+    if (value == _emulateStatisticsMode)
+        return;
+
+    if (value)
+    {
+        if (ReadTimeout <= 0)
+            throw gcnew InvalidOperationException("Statistics mode can only be emulated on a live communicator with a positive read timeout");
+        AssertMode(PacketCommunicatorMode::Capture);
+        _statisticsDeadline = 0;
+    }
+    else if (_mode == PacketCommunicatorMode::Statistics)
+    {
+        throw gcnew InvalidOperationException("Can't stop emulating statistics mode while in statistics mode");
+    }
+
+    _emulateStatisticsMode = value;
+}
+
 bool PacketCommunicator::NonBlocking::get()
 {
     char errorBuffer[PCAP_ERRBUF_SIZE];
@@ -115,9 +162,50 @@ void PacketCommunicator::SetSamplingMethod(SamplingMethod^ method)
 	if (method == nullptr) 
 		throw gcnew ArgumentNullException("method");
 
-	pcap_samp* pcapSamplingMethod = pcap_setsampling(_pcapDescriptor);
-    pcapSamplingMethod->method = method->Method;
-    pcapSamplingMethod->value = method->Value;
+    // Remote probes sample before sending the packets over the network, but they only get the method when the capture starts.
+    // The methods the probe doesn't know and the methods set after the capture started are applied locally.
+    bool isSampledByProbe = false;
+    if (IsRemote && !_loopBreaker->HasStarted())
+    {
+        pcap_samp* pcapSamplingMethod = pcap_setsampling(_pcapDescriptor);
+        pcapSamplingMethod->method = method->Method;
+        pcapSamplingMethod->value = method->Value;
+        isSampledByProbe = method->Method != PCAP_SAMP_NOSAMP;
+    }
+
+    // The stage is changed in place, since a capture thread may be running it.
+    // The chain only changes when sampling starts or stops.
+    bool wasSampling = _samplingStage->IsSampling();
+    if (isSampledByProbe)
+        _samplingStage->SetMethod(PacketSamplingStage::MethodNone, 0);
+    else
+        method->ConfigureStage(*_samplingStage);
+    if (_samplingStage->IsSampling() != wasSampling)
+        RebuildStages(nullptr);
+}
+
+PacketLoadShedder^ PacketCommunicator::LoadShedder::get()
+{
+    return _loadShedder;
+}
+
+void PacketCommunicator::LoadShedder::set(PacketLoadShedder^ value)
+{
+    PacketLoadShedder^ replaced = _loadShedder;
+    _loadShedder = value;
+    RebuildStages(replaced);
+}
+
+PacketFlowPayloadCutoff^ PacketCommunicator::PayloadCutoff::get()
+{
+    return _payloadCutoff;
+}
+
+void PacketCommunicator::PayloadCutoff::set(PacketFlowPayloadCutoff^ value)
+{
+    PacketFlowPayloadCutoff^ replaced = _payloadCutoff;
+    _payloadCutoff = value;
+    RebuildStages(replaced);
 }
 
 PacketCommunicatorReceiveResult PacketCommunicator::ReceivePacket([Out] Packet^% packet)
@@ -126,15 +214,30 @@ PacketCommunicatorReceiveResult PacketCommunicator::ReceivePacket([Out] Packet^%
 
     pcap_pkthdr* packetHeader;
     const unsigned char* packetData;
-    PacketCommunicatorReceiveResult result = RunPcapNextEx(&packetHeader, &packetData);
-
-    if (result != PacketCommunicatorReceiveResult::Ok)
+    pcap_pkthdr processedHeader;
+    PacketCommunicatorReceiveResult result;
+    _stages->BeginReceive();
+    try
+    {
+        do
+        {
+            result = RunPcapNextEx(&packetHeader, &packetData);
+            if (result != PacketCommunicatorReceiveResult::Ok)
+            {
+                packet = nullptr;
+                return result;
+            }
+
+            processedHeader = *packetHeader;
+        }
+        while (!_stages->Current().Process(processedHeader, packetData));
+    }
+    finally
     {
-        packet = nullptr;
-        return result;
+        EndReceive();
     }
 
-    packet = CreatePacket(*packetHeader, packetData, DataLink);
+    packet = CreatePacket(processedHeader, packetData, DataLink);
     return result;
 }
 
@@ -146,12 +249,41 @@ PacketCommunicatorReceiveResult PacketCommunicator::ReceiveSomePackets([Out] int
     HandlerDelegate^ packetHandlerDelegate = gcnew HandlerDelegate(packetHandler, &PacketHandler::Handle);
     pcap_handler functionPointer = (pcap_handler)Marshal::GetFunctionPointerForDelegate(packetHandlerDelegate).ToPointer();
 
-    countGot = pcap_dispatch(_pcapDescriptor, 
-                             maxPackets, 
-                             functionPointer,
-                             NULL);
+    countGot = -1;
+    bool isStaged = false;
+    _stages->BeginReceive();
+    _loopBreaker->BeginLoop();
+    try
+    {
+        // Stages set while the call runs apply to the following packets, unless there were no stages when it started.
+        isStaged = !_stages->Current().IsEmpty();
+        if (!isStaged)
+        {
+            countGot = pcap_dispatch(_pcapDescriptor, 
+                                     maxPackets, 
+                                     functionPointer,
+                                     NULL);
+        }
+        else
+        {
+            PacketStageChainSlot::Dispatcher dispatcher(*_stages, functionPointer, *_loopBreaker, 0);
+            countGot = pcap_dispatch(_pcapDescriptor,
+                                     maxPackets,
+                                     &PacketStageChainSlot::Dispatcher::Dispatch,
+                                     reinterpret_cast<unsigned char*>(&dispatcher));
+        }
+    }
+    finally
+    {
+        _loopBreaker->EndLoop(countGot);
+        EndReceive();
+    }
     GC::KeepAlive(packetHandlerDelegate);
 
+    // Don't count the packets discarded by the stages.
+    if (countGot > 0 && isStaged)
+        countGot = packetHandler->PacketCounter;
+
     switch (countGot)
     {
     case -2:
@@ -178,9 +310,34 @@ PacketCommunicatorReceiveResult PacketCommunicator::ReceivePackets(int count, Ha
     HandlerDelegate^ packetHandlerDelegate = gcnew HandlerDelegate(packetHandler, &PacketHandler::Handle);
     pcap_handler functionPointer = (pcap_handler)Marshal::GetFunctionPointerForDelegate(packetHandlerDelegate).ToPointer();
 
-    int result = pcap_loop(_pcapDescriptor, count, functionPointer, NULL);
+    int result = -1;
+    bool isLimitReached = false;
+    _stages->BeginReceive();
+    _loopBreaker->BeginLoop();
+    try
+    {
+        if (_stages->Current().IsEmpty())
+        {
+            result = pcap_loop(_pcapDescriptor, count, functionPointer, NULL);
+        }
+        else
+        {
+            // pcap_loop() counts the packets discarded by the stages, so the dispatcher breaks the loop after count packets were delivered.
+            PacketStageChainSlot::Dispatcher dispatcher(*_stages, functionPointer, *_loopBreaker, count);
+            result = pcap_loop(_pcapDescriptor, count > 0 ? -1 : count, &PacketStageChainSlot::Dispatcher::Dispatch, reinterpret_cast<unsigned char*>(&dispatcher));
+            isLimitReached = dispatcher.IsLimitReached();
+        }
+    }
+    finally
+    {
+        _loopBreaker->EndLoop(result);
+        EndReceive();
+    }
     GC::KeepAlive(packetHandlerDelegate);
 
+    if (result == -2 && isLimitReached)
+        result = 0;
+
     switch (result)
     {
     case -2:
@@ -199,15 +356,23 @@ PacketCommunicatorReceiveResult PacketCommunicator::ReceiveStatistics([Out] Pack
 {
     AssertMode(PacketCommunicatorMode::Statistics);
 
-    pcap_pkthdr* packetHeader;
-    const unsigned char* packetData;
-    PacketCommunicatorReceiveResult result = RunPcapNextEx(&packetHeader, &packetData);
+    PacketCommunicatorReceiveResult result;
+    if (_emulateStatisticsMode)
+    {
+        result = ReceiveEmulatedStatistics(statistics);
+    }
+    else
+    {
+        pcap_pkthdr* packetHeader;
+        const unsigned char* packetData;
+        result = RunPcapNextEx(&packetHeader, &packetData);
+        if (result == PacketCommunicatorReceiveResult::Ok)
+            statistics = gcnew PacketSampleStatistics(*packetHeader, packetData);
+    }
 
     if (result != PacketCommunicatorReceiveResult::Ok)
         throw gcnew InvalidOperationException("Got result " + result.ToString() + " in statistics mode");
 
-    statistics = gcnew PacketSampleStatistics(*packetHeader, packetData);
-
     return result;
 }
 
@@ -215,11 +380,33 @@ PacketCommunicatorReceiveResult PacketCommunicator::ReceiveStatistics(int count,
 {
     AssertMode(PacketCommunicatorMode::Statistics);
 
+    if (_emulateStatisticsMode)
+    {
+        for (int i = 0; count <= 0 || i != count; ++i)
+        {
+            PacketSampleStatistics^ statistics;
+            PacketCommunicatorReceiveResult result = ReceiveEmulatedStatistics(statistics);
+            if (result != PacketCommunicatorReceiveResult::Ok)
+                return result;
+            callBack->Invoke(statistics);
+        }
+        return PacketCommunicatorReceiveResult::Ok;
+    }
+
     StatisticsHandler^ statisticsHandler = gcnew StatisticsHandler(callBack);
     HandlerDelegate^ statisticsHandlerDelegate = gcnew HandlerDelegate(statisticsHandler, &StatisticsHandler::Handle);
     pcap_handler functionPointer = (pcap_handler)Marshal::GetFunctionPointerForDelegate(statisticsHandlerDelegate).ToPointer();
 
-    int result = pcap_loop(_pcapDescriptor, count, functionPointer, NULL);
+    int result = -1;
+    _loopBreaker->BeginLoop();
+    try
+    {
+        result = pcap_loop(_pcapDescriptor, count, functionPointer, NULL);
+    }
+    finally
+    {
+        _loopBreaker->EndLoop(result);
+    }
     GC::KeepAlive(statisticsHandlerDelegate);
 
     if (result == -1)
@@ -231,7 +418,7 @@ PacketCommunicatorReceiveResult PacketCommunicator::ReceiveStatistics(int count,
 
 void PacketCommunicator::Break()
 {
-    pcap_breakloop(_pcapDescriptor);
+    _loopBreaker->Break();
 }
 
 void PacketCommunicator::SendPacket(Packet^ packet)
@@ -241,7 +428,7 @@ void PacketCommunicator::SendPacket(Packet^ packet)
 
 	if (packet->Length == 0)
         return;
-    pin_ptr<Byte> unamangedPacketBytes = &packet->Buffer[0];
+    pin_ptr<Byte> unamangedPacketBytes = &packet->Buffer[packet->StartOffset];
     if (pcap_sendpacket(_pcapDescriptor, unamangedPacketBytes, packet->Length) != 0)
         throw BuildInvalidOperation("Failed writing to device. Packet length: " + packet->Length);
 }
@@ -261,7 +448,8 @@ void PacketCommunicator::SetFilter(BerkeleyPacketFilter^ filter)
 
 void PacketCommunicator::SetFilter(String^ filterValue)
 {
-    BerkeleyPacketFilter^ filter = CreateFilter(filterValue);
+    // pcap_setfilter() copies the program, so the filter can be disposed once it is set.
+    BerkeleyPacketFilter^ filter = BerkeleyPacketFilterCache::Default->GetFilter(_pcapDescriptor, filterValue, _ipV4Netmask);
     try
     {
         SetFilter(filter);
@@ -280,6 +468,12 @@ PacketDumpFile^ PacketCommunicator::OpenDump(System::String^ fileName)
 PacketCommunicator::~PacketCommunicator()
 {
     pcap_close(_pcapDescriptor);
+    delete _stages;
+    _stages = NULL;
+    delete _loopBreaker;
+    _loopBreaker = NULL;
+    delete _samplingStage;
+    _samplingStage = NULL;
 }
 
 // Internal
@@ -287,6 +481,32 @@ PacketCommunicator::~PacketCommunicator()
 PacketCommunicator::PacketCommunicator(pcap_t* pcapDescriptor, SocketAddress^ netmask)
     : _pcapDescriptor(pcapDescriptor), _ipV4Netmask(dynamic_cast<IpV4SocketAddress^>(netmask))
 {
+    _stages = new PacketStageChainSlot();
+    _retiredStageOwners = gcnew List<Object^>();
+    _loopBreaker = new PacketLoopBreaker(pcapDescriptor);
+    _samplingStage = new PacketSamplingStage();
+}
+
+bool PacketCommunicator::IsRemote::get()
+{
+    return false;
+}
+
+int PacketCommunicator::ReadTimeout::get()
+{
+    return 0;
+}
+
+PacketCaptureRing^ PacketCommunicator::CaptureRing::get()
+{
+    return _captureRing;
+}
+
+void PacketCommunicator::CaptureRing::set(PacketCaptureRing^ value)
+{
+    PacketCaptureRing^ replaced = _captureRing;
+    _captureRing = value;
+    RebuildStages(replaced);
 }
 
 // Protected
@@ -315,7 +535,16 @@ Packet^ PacketCommunicator::CreatePacket(const pcap_pkthdr& packetHeader, const
 
 PacketCommunicatorReceiveResult PacketCommunicator::RunPcapNextEx(pcap_pkthdr** packetHeader, const unsigned char** packetData)
 {
-    int result = pcap_next_ex(_pcapDescriptor, packetHeader, packetData);
+    int result = -1;
+    _loopBreaker->BeginLoop();
+    try
+    {
+        result = pcap_next_ex(_pcapDescriptor, packetHeader, packetData);
+    }
+    finally
+    {
+        _loopBreaker->EndLoop(result);
+    }
     switch (result)
     {
     case -2: 
@@ -337,6 +566,97 @@ void PacketCommunicator::AssertMode(PacketCommunicatorMode mode)
         throw gcnew InvalidOperationException("Wrong Mode. Must be in mode " + mode.ToString() + " and not in mode " + Mode.ToString());
 }
 
+void PacketCommunicator::RebuildStages(Object^ replacedStageOwner)
+{
+    // The communicator was disposed.
+    if (_stages == NULL)
+        return;
+
+    PacketStage* stages[PacketStageChain::MaxStages];
+    int count = 0;
+    int dataLink = pcap_datalink(_pcapDescriptor);
+
+    // The ring records the packets as captured.
+    if (_captureRing != nullptr)
+    {
+        _captureRing->Attach(dataLink);
+        stages[count++] = _captureRing->Stage;
+    }
+
+    if (_samplingStage->IsSampling())
+    {
+        _samplingStage->Attach(dataLink);
+        stages[count++] = _samplingStage;
+    }
+
+    // The cutoff comes first, so the shedder only sees the load that is left.
+    if (_payloadCutoff != nullptr)
+    {
+        _payloadCutoff->Attach(dataLink);
+        stages[count++] = _payloadCutoff->Stage;
+    }
+
+    if (_loadShedder != nullptr)
+    {
+        _loadShedder->Attach(dataLink);
+        stages[count++] = _loadShedder->Stage;
+    }
+
+    // A receive call may still be processing a packet with the replaced chain, so the owner of a replaced stage is kept alive until the chain is freed.
+    Monitor::Enter(_retiredStageOwners);
+    try
+    {
+        if (_stages->Publish(new PacketStageChain(stages, count)))
+            _retiredStageOwners->Clear();
+        else if (replacedStageOwner != nullptr)
+            _retiredStageOwners->Add(replacedStageOwner);
+    }
+    finally
+    {
+        Monitor::Exit(_retiredStageOwners);
+    }
+}
+
+void PacketCommunicator::EndReceive()
+{
+    if (!_stages->EndReceive())
+        return;
+
+    Monitor::Enter(_retiredStageOwners);
+    try
+    {
+        if (_stages->FreeRetired())
+            _retiredStageOwners->Clear();
+    }
+    finally
+    {
+        Monitor::Exit(_retiredStageOwners);
+    }
+}
+
+PacketCommunicatorReceiveResult PacketCommunicator::ReceiveEmulatedStatistics([Out] PacketSampleStatistics^% statistics)
+{
+    // Consecutive intervals follow each other unless the caller fell behind.
+    unsigned __int64 now = PacketStatisticsCounter::Now();
+    unsigned __int64 deadline = _statisticsDeadline + ReadTimeout;
+    if (deadline <= now)
+        deadline = now + ReadTimeout;
+    _statisticsDeadline = deadline;
+
+    unsigned __int64 acceptedPackets = 0;
+    unsigned __int64 acceptedBytes = 0;
+    _loopBreaker->BeginLoop();
+    int result = PacketStatisticsCounter::Count(_pcapDescriptor, deadline, acceptedPackets, acceptedBytes);
+    _loopBreaker->EndLoop(result);
+    if (result == -1)
+        throw BuildInvalidOperation("Failed reading from device");
+    if (result == -2)
+        return PacketCommunicatorReceiveResult::BreakLoop;
+
+    statistics = gcnew PacketSampleStatistics(DateTime::Now, acceptedPackets, acceptedBytes);
+    return PacketCommunicatorReceiveResult::Ok;
+}
+
 void PacketCommunicator::PacketHandler::Handle(unsigned char *, const struct pcap_pkthdr *packetHeader, const unsigned char *packetData)
 {
     ++_packetCounter;
@@ -10,10 +10,16 @@
 #include "PacketSendBuffer.h"
 #include "PacketCommunicatorMode.h"
 #include "PacketCommunicatorReceiveResult.h"
+#include "PacketFlowPayloadCutoff.h"
+#include "PacketLoadShedder.h"
 #include "SamplingMethod.h"
 
 namespace PcapDotNet { namespace Core 
 {
+    class PacketStageChainSlot;
+    class PacketLoopBreaker;
+    ref class PacketCaptureRing;
+
     public delegate void HandlePacket(Packets::Packet^ packet);
     public delegate void HandleStatistics(PacketSampleStatistics^ statistics);
 
@@ -103,6 +109,19 @@ namespace PcapDotNet { namespace Core
             void set(PacketCommunicatorMode value);
         }
 
+        /// <summary>
+        /// Whether Statistics mode is emulated by counting the packets accepted by the filter inside the native dispatch loop instead of by the driver.
+        /// The emulation is used automatically when a live communicator is set to Statistics mode and the driver doesn't support it.
+        /// Each statistics covers the readTimeout given in LivePacketDevice.Open() and might be longer by up to one readTimeout.
+        /// The accepted bytes are counted using the original length of the packets.
+        /// </summary>
+        /// <exception cref="System::InvalidOperationException">Thrown when setting to true if this is not a live communicator opened with a positive readTimeout or the mode is not Capture, or when setting to false in Statistics mode.</exception>
+        property bool EmulateStatisticsMode
+        {
+            bool get();
+            void set(bool value);
+        }
+
         /// <summary>
         /// Switch between blocking and nonblocking mode.
         /// Puts a live communicator into "non-blocking" mode, or takes it out of "non-blocking" mode.
@@ -143,14 +162,46 @@ namespace PcapDotNet { namespace Core
         /// Define a sampling method for packet capture.
         /// This function allows applying a sampling method to the packet capture process. 
         /// The mtthod will be applied as soon as the capture starts.
+        /// Applies to ReceivePacket(), ReceiveSomePackets() and ReceivePackets(), before the PayloadCutoff and the LoadShedder.
         /// </summary>
         /// <remarks>
-        /// Warning: Sampling parameters cannot be changed when a capture is active. These parameters must be applied before starting the capture. If they are applied when the capture is in progress, the new settings are ignored.
-        /// Warning: Sampling works only when capturing data on Win32 or reading from a file. It has not been implemented on other platforms. Sampling works on remote machines provided that the probe (i.e. the capturing device) is a Win32 workstation. 
+        /// Warning: Sampling parameters cannot be changed when a capture is active. These parameters must be applied before starting the capture.
+        /// Local captures and files are sampled in the native dispatch path, so the discarded packets are never copied to managed packets.
+        /// Remote captures are sampled by the probe when the method is set before the first receive call and the probe knows the method
+        /// (i.e. the capturing device is a Win32 workstation and the method isn't SamplingMethodFlowHash). Otherwise they are sampled locally.
+        /// Packets discarded by the sampling are not counted by countGot of ReceiveSomePackets() and by count of ReceivePackets().
         /// </remarks>
         /// <param name="method">The sampling method to be applied</param>
         void SetSamplingMethod(SamplingMethod^ method);
 
+        /// <summary>
+        /// Sheds received packets on purpose when the consumer can't keep up.
+        /// Applies to ReceivePacket(), ReceiveSomePackets() and ReceivePackets(). null by default.
+        /// <seealso cref="PacketLoadShedder"/>
+        /// </summary>
+        /// <remarks>
+        /// Packets discarded by the shedder are not counted by countGot of ReceiveSomePackets() and by count of ReceivePackets().
+        /// </remarks>
+        property PacketLoadShedder^ LoadShedder
+        {
+            PacketLoadShedder^ get();
+            void set(PacketLoadShedder^ value);
+        }
+
+        /// <summary>
+        /// Keeps only the first bytes of the payload of every flow, to capture all the headers of long bulk transfers for a fraction of the size.
+        /// Applies to ReceivePacket(), ReceiveSomePackets() and ReceivePackets(), before the LoadShedder. null by default.
+        /// <seealso cref="PacketFlowPayloadCutoff"/>
+        /// </summary>
+        /// <remarks>
+        /// Packets dropped by the cutoff are not counted by countGot of ReceiveSomePackets() and by count of ReceivePackets().
+        /// </remarks>
+        property PacketFlowPayloadCutoff^ PayloadCutoff
+        {
+            PacketFlowPayloadCutoff^ get();
+            void set(PacketFlowPayloadCutoff^ value);
+        }
+
         /// <summary>
         /// Read a packet from an interface or from an offline capture.
         /// This function is used to retrieve the next available packet, bypassing the callback method traditionally provided.
@@ -283,7 +334,7 @@ namespace PcapDotNet { namespace Core
         ///     <item>Note that if you are catching signals on UNIX systems that support restarting system calls after a signal, and calling Break() in the signal handler, you must specify, when catching those signals, that system calls should NOT be restarted by that signal. Otherwise, if the signal interrupted a call reading packets in a live capture, when your signal handler returns after calling Break(), the call will be restarted, and the loop will not terminate until more packets arrive and the call completes.</item>
         ///     <item>ReceivePacket() will, on some platforms, loop reading packets from the OS; that loop will not necessarily be terminated by a signal, so Break() should be used to terminate packet processing even if ReceivePacket() is being used.</item>
         ///     <item>Break() does not guarantee that no further packets/statistics will be processed by ReceiveSomePackets(), ReceivePackets() or ReceiveStatistics() after it is called; at most one more packet might be processed.</item>
-        ///     <item>If BreakLoop is returned from ReceiveSomePackets(), ReceivePackets() or ReceiveStatistics(), the flag is cleared, so a subsequent call will resume reading packets. If a different return value is returned, the flag is not cleared, so a subsequent call will return BreakLoop and clear the flag.</item>
+        ///     <item>If BreakLoop is returned from ReceiveSomePackets(), ReceivePackets() or ReceiveStatistics(), the flag is cleared, so a subsequent call will resume reading packets. If Break() is called while such a call is reading packets and a different return value is returned, the flag is cleared too. If Break() is called while no call is reading packets, the flag is not cleared, so a subsequent call will return BreakLoop and clear the flag.</item>
         ///   </list>
         /// </remarks>
         void Break();
@@ -341,9 +392,10 @@ namespace PcapDotNet { namespace Core
 
         /// <summary>
         /// Compile and associate a filter to a capture.
-        /// This method actually wraps a call to CreateFilter(), SetFilter() and Dispose().
+        /// The compiled filter is kept in BerkeleyPacketFilterCache.Default, so setting a recently used filter again doesn't compile it again.
         /// <seealso cref="CreateFilter"/>
         /// <seealso cref="BerkeleyPacketFilter"/>
+        /// <seealso cref="BerkeleyPacketFilterCache"/>
         /// </summary>
         /// <param name="filterValue">A high level filtering expression (see <see href="http://www.winpcap.org/docs/docs_40_2/html/group__language.html">WinPcap Filtering expression syntax</see>).</param>
         /// <exception cref="System::InvalidOperationException">Thrown on failure.</exception>
@@ -372,6 +424,24 @@ namespace PcapDotNet { namespace Core
     internal:
         PacketCommunicator(pcap_t* pcapDescriptor, SocketAddress^ netmask);
 
+        property PacketCaptureRing^ CaptureRing
+        {
+            PacketCaptureRing^ get();
+            void set(PacketCaptureRing^ value);
+        }
+
+        // Whether the packets are captured by a remote probe.
+        virtual property bool IsRemote
+        {
+            bool get();
+        }
+
+        // The read timeout in milliseconds, 0 if the communicator doesn't have one.
+        virtual property int ReadTimeout
+        {
+            int get();
+        }
+
 	protected:
         property pcap_t* PcapDescriptor
         {
@@ -390,6 +460,12 @@ namespace PcapDotNet { namespace Core
 
         void AssertMode(PacketCommunicatorMode mode);
 
+        // replacedStageOwner is the object that owns a stage of the replaced chain, or null.
+        void RebuildStages(System::Object^ replacedStageOwner);
+        void EndReceive();
+
+        PacketCommunicatorReceiveResult ReceiveEmulatedStatistics([System::Runtime::InteropServices::Out] PacketSampleStatistics^% statistics);
+
         ref class PacketHandler
         {
         public:
@@ -430,5 +506,14 @@ namespace PcapDotNet { namespace Core
         pcap_t* _pcapDescriptor;
         IpV4SocketAddress^ _ipV4Netmask;
         PacketCommunicatorMode _mode;
+        PacketStageChainSlot* _stages;
+        System::Collections::Generic::List<System::Object^>^ _retiredStageOwners;
+        PacketLoopBreaker* _loopBreaker;
+        PacketSamplingStage* _samplingStage;
+        PacketLoadShedder^ _loadShedder;
+        PacketFlowPayloadCutoff^ _payloadCutoff;
+        PacketCaptureRing^ _captureRing;
+        bool _emulateStatisticsMode;
+        unsigned __int64 _statisticsDeadline;
     };
 }}
\ No newline at end of file
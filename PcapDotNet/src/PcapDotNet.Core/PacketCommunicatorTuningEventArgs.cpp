@@ -0,0 +1,54 @@
+#include "PacketCommunicatorTuningEventArgs.h"
+
+using namespace System;
+using namespace System::Globalization;
+using namespace PcapDotNet::Core;
+
+PacketCommunicatorTuningParameter PacketCommunicatorTuningEventArgs::Parameter::get()
+{
+    return _parameter;
+}
+
+int PacketCommunicatorTuningEventArgs::PreviousValue::get()
+{
+    return _previousValue;
+}
+
+int PacketCommunicatorTuningEventArgs::NewValue::get()
+{
+    return _newValue;
+}
+
+PacketTotalStatistics^ PacketCommunicatorTuningEventArgs::Statistics::get()
+{
+    return _statistics;
+}
+
+unsigned int PacketCommunicatorTuningEventArgs::PacketsDroppedSinceLastSample::get()
+{
+    return _packetsDroppedSinceLastSample;
+}
+
+TimeSpan PacketCommunicatorTuningEventArgs::ConsumerLatency::get()
+{
+    return _consumerLatency;
+}
+
+String^ PacketCommunicatorTuningEventArgs::Reason::get()
+{
+    return _reason;
+}
+
+String^ PacketCommunicatorTuningEventArgs::ToString()
+{
+    return String::Format(CultureInfo::InvariantCulture, "{0}: {1} -> {2}. {3}", _parameter, _previousValue, _newValue, _reason);
+}
+
+// Internal
+
+PacketCommunicatorTuningEventArgs::PacketCommunicatorTuningEventArgs(PacketCommunicatorTuningParameter parameter, int previousValue, int newValue, PacketTotalStatistics^ statistics,
+                                                                     unsigned int packetsDroppedSinceLastSample, TimeSpan consumerLatency, String^ reason)
+    : _parameter(parameter), _previousValue(previousValue), _newValue(newValue), _statistics(statistics),
+      _packetsDroppedSinceLastSample(packetsDroppedSinceLastSample), _consumerLatency(consumerLatency), _reason(reason)
+{
+}
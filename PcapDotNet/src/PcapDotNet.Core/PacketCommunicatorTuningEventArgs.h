@@ -0,0 +1,86 @@
+#pragma once
+
+#include "PacketCommunicatorTuningParameter.h"
+#include "PacketTotalStatistics.h"
+
+namespace PcapDotNet { namespace Core
+{
+    /// <summary>
+    /// Describes a single adjustment made by a LivePacketCommunicatorTuner.
+    /// </summary>
+    public ref class PacketCommunicatorTuningEventArgs sealed : System::EventArgs
+    {
+    public:
+        /// <summary>
+        /// The parameter that was adjusted.
+        /// </summary>
+        property PacketCommunicatorTuningParameter Parameter
+        {
+            PacketCommunicatorTuningParameter get();
+        }
+
+        /// <summary>
+        /// The value of the parameter before the adjustment.
+        /// </summary>
+        property int PreviousValue
+        {
+            int get();
+        }
+
+        /// <summary>
+        /// The value of the parameter after the adjustment.
+        /// </summary>
+        property int NewValue
+        {
+            int get();
+        }
+
+        /// <summary>
+        /// The total statistics sample that caused the adjustment.
+        /// The last sample taken, or null if no sample was taken yet, when the adjustment was caused by changing the allowed range of the parameter.
+        /// </summary>
+        property PacketTotalStatistics^ Statistics
+        {
+            PacketTotalStatistics^ get();
+        }
+
+        /// <summary>
+        /// The number of packets dropped by the driver since the previous sample.
+        /// </summary>
+        property unsigned int PacketsDroppedSinceLastSample
+        {
+            unsigned int get();
+        }
+
+        /// <summary>
+        /// The average time the consumer spent on each packet since the previous sample.
+        /// </summary>
+        property System::TimeSpan ConsumerLatency
+        {
+            System::TimeSpan get();
+        }
+
+        /// <summary>
+        /// A human readable explanation of why the adjustment was made.
+        /// </summary>
+        property System::String^ Reason
+        {
+            System::String^ get();
+        }
+
+        virtual System::String^ ToString() override;
+
+    internal:
+        PacketCommunicatorTuningEventArgs(PacketCommunicatorTuningParameter parameter, int previousValue, int newValue, PacketTotalStatistics^ statistics,
+                                          unsigned int packetsDroppedSinceLastSample, System::TimeSpan consumerLatency, System::String^ reason);
+
+    private:
+        PacketCommunicatorTuningParameter _parameter;
+        int _previousValue;
+        int _newValue;
+        PacketTotalStatistics^ _statistics;
+        unsigned int _packetsDroppedSinceLastSample;
+        System::TimeSpan _consumerLatency;
+        System::String^ _reason;
+    };
+}}
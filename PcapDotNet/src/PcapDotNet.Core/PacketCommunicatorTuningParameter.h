@@ -0,0 +1,19 @@
+#pragma once
+
+namespace PcapDotNet { namespace Core
+{
+    /// <summary>
+    /// The capture parameters a LivePacketCommunicatorTuner can adjust.
+    /// </summary>
+    public enum class PacketCommunicatorTuningParameter : int
+    {
+        /// <summary>The size of the kernel buffer set by PacketCommunicator.SetKernelBufferSize().</summary>
+        KernelBufferSize,
+
+        /// <summary>The minimum amount of data copied by the kernel in a single call set by PacketCommunicator.SetKernelMinimumBytesToCopy().</summary>
+        KernelMinimumBytesToCopy,
+
+        /// <summary>The maximum number of packets processed by a single call to PacketCommunicator.ReceiveSomePackets().</summary>
+        BatchSize
+    };
+}}
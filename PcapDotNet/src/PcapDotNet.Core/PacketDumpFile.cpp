@@ -55,7 +55,10 @@ void PacketDumpFile::Dump(Packet^ packet)
     PacketHeader::GetPcapHeader(header, packet);
     std::string unmanagedFilename = MarshalingServices::ManagedToUnmanagedString(_filename);
 
-    pin_ptr<Byte> unamangedPacketBytes = &packet->Buffer[0];
+    // An empty packet can start at the end of its buffer, where there's no element to pin.
+    pin_ptr<Byte> unamangedPacketBytes = nullptr;
+    if (packet->Length != 0)
+        unamangedPacketBytes = &packet->Buffer[packet->StartOffset];
     pcap_dump(reinterpret_cast<unsigned char*>(_pcapDumper), &header, unamangedPacketBytes);
 }
 
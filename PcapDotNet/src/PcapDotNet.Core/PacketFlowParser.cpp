@@ -0,0 +1,265 @@
+#include "PacketFlowParser.h"
+
+#include "Pcap.h"
+
+using namespace PcapDotNet::Core;
+
+#pragma managed(push, off)
+
+namespace
+{
+    const unsigned int EthernetHeaderLength = 14;
+    const unsigned int VLanTagLength = 4;
+    const unsigned int IpV4MinimumHeaderLength = 20;
+    const unsigned int IpV6HeaderLength = 40;
+
+    const unsigned short EtherTypeIpV4 = 0x0800;
+    const unsigned short EtherTypeIpV6 = 0x86DD;
+    const unsigned short EtherTypeVLanTaggedFrame = 0x8100;
+    const unsigned short EtherTypeProviderBridging = 0x88A8;
+    const unsigned short EtherTypeQInQ = 0x9100;
+
+    const unsigned char IpV6HopByHopOptions = 0;
+    const unsigned char IpV6Routing = 43;
+    const unsigned char IpV6Fragment = 44;
+    const unsigned char IpV6AuthenticationHeader = 51;
+    const unsigned char IpV6DestinationOptions = 60;
+    const int MaxIpV6ExtensionHeaders = 8;
+
+    const unsigned char ProtocolIcmp = 1;
+    const unsigned char ProtocolTcp = 6;
+    const unsigned char ProtocolUdp = 17;
+    const unsigned char ProtocolIcmpV6 = 58;
+    const unsigned char ProtocolSctp = 132;
+
+    unsigned short ReadUShort(const unsigned char* data)
+    {
+        return static_cast<unsigned short>((data[0] << 8) | data[1]);
+    }
+
+    unsigned int Min(unsigned int value1, unsigned int value2)
+    {
+        return value1 < value2 ? value1 : value2;
+    }
+}
+
+// static
+bool PacketFlowParser::Parse(int dataLink, const unsigned char* packetData, unsigned int length, PacketFlowInfo& info)
+{
+    info.headersLength = length;
+    info.payloadLength = 0;
+    info.flowHash = 0;
+
+    switch (dataLink)
+    {
+    case DLT_EN10MB:
+    {
+        if (length < EthernetHeaderLength)
+            return false;
+
+        unsigned int offset = EthernetHeaderLength;
+        unsigned short etherType = ReadUShort(packetData + offset - 2);
+        while ((etherType == EtherTypeVLanTaggedFrame || etherType == EtherTypeProviderBridging || etherType == EtherTypeQInQ) &&
+               length >= offset + VLanTagLength)
+        {
+            etherType = ReadUShort(packetData + offset + 2);
+            offset += VLanTagLength;
+        }
+
+        switch (etherType)
+        {
+        case EtherTypeIpV4:
+            return ParseIpV4(packetData, offset, length, info);
+        case EtherTypeIpV6:
+            return ParseIpV6(packetData, offset, length, info);
+        default:
+            info.headersLength = Min(offset, length);
+            return false;
+        }
+    }
+
+    case DLT_RAW:
+        if (length == 0)
+            return false;
+        switch (packetData[0] >> 4)
+        {
+        case 4:
+            return ParseIpV4(packetData, 0, length, info);
+        case 6:
+            return ParseIpV6(packetData, 0, length, info);
+        default:
+            return false;
+        }
+
+    default:
+        return false;
+    }
+}
+
+// static
+bool PacketFlowParser::ParseIpV4(const unsigned char* packetData, unsigned int offset, unsigned int length, PacketFlowInfo& info)
+{
+    if (length < offset + IpV4MinimumHeaderLength)
+        return false;
+
+    const unsigned char* header = packetData + offset;
+    unsigned int headerLength = (header[0] & 0x0F) * 4;
+    if (headerLength < IpV4MinimumHeaderLength)
+        return false;
+
+    unsigned char protocol = header[9];
+    const unsigned char* source = header + 12;
+    const unsigned char* destination = header + 16;
+    unsigned short totalLength = ReadUShort(header + 2);
+    unsigned int networkEnd = totalLength == 0 ? 0 : offset + totalLength;
+    offset += headerLength;
+
+    // Only the first fragment contains the transport header.
+    bool isFirstFragment = (ReadUShort(header + 6) & 0x1FFF) == 0;
+    if (!isFirstFragment)
+        protocol = 0;
+
+    ParseTransport(protocol, packetData, offset, length, networkEnd, source, destination, 4, info);
+    return true;
+}
+
+// static
+bool PacketFlowParser::ParseIpV6(const unsigned char* packetData, unsigned int offset, unsigned int length, PacketFlowInfo& info)
+{
+    if (length < offset + IpV6HeaderLength)
+        return false;
+
+    const unsigned char* header = packetData + offset;
+    unsigned char nextHeader = header[6];
+    const unsigned char* source = header + 8;
+    const unsigned char* destination = header + 24;
+    // Jumbograms have a 0 payload length.
+    unsigned short payloadLength = ReadUShort(header + 4);
+    unsigned int networkEnd = payloadLength == 0 ? 0 : offset + IpV6HeaderLength + payloadLength;
+    offset += IpV6HeaderLength;
+
+    for (int i = 0; i != MaxIpV6ExtensionHeaders; ++i)
+    {
+        if (nextHeader != IpV6HopByHopOptions && nextHeader != IpV6Routing && nextHeader != IpV6DestinationOptions &&
+            nextHeader != IpV6Fragment && nextHeader != IpV6AuthenticationHeader)
+        {
+            break;
+        }
+
+        if (length < offset + 8)
+        {
+            nextHeader = 0;
+            break;
+        }
+
+        const unsigned char* extensionHeader = packetData + offset;
+        unsigned char currentHeader = nextHeader;
+        nextHeader = extensionHeader[0];
+
+        switch (currentHeader)
+        {
+        case IpV6Fragment:
+            offset += 8;
+            // Only the first fragment contains the transport header.
+            if ((ReadUShort(extensionHeader + 2) >> 3) != 0)
+                nextHeader = 0;
+            break;
+        case IpV6AuthenticationHeader:
+            offset += (extensionHeader[1] + 2) * 4;
+            break;
+        default:
+            offset += (extensionHeader[1] + 1) * 8;
+            break;
+        }
+    }
+
+    ParseTransport(nextHeader, packetData, offset, length, networkEnd, source, destination, 16, info);
+    return true;
+}
+
+// static
+void PacketFlowParser::ParseTransport(unsigned char protocol, const unsigned char* packetData, unsigned int offset, unsigned int length, unsigned int networkEnd,
+                                      const unsigned char* source, const unsigned char* destination, unsigned int addressLength, PacketFlowInfo& info)
+{
+    unsigned int transportHeaderLength = 0;
+    bool hasPorts = false;
+    switch (protocol)
+    {
+    case ProtocolTcp:
+        transportHeaderLength = 20;
+        if (length >= offset + 13 && (packetData[offset + 12] >> 4) * 4u > transportHeaderLength)
+            transportHeaderLength = (packetData[offset + 12] >> 4) * 4;
+        hasPorts = true;
+        break;
+    case ProtocolUdp:
+        transportHeaderLength = 8;
+        hasPorts = true;
+        break;
+    case ProtocolSctp:
+        transportHeaderLength = 12;
+        hasPorts = true;
+        break;
+    case ProtocolIcmp:
+    case ProtocolIcmpV6:
+        transportHeaderLength = 8;
+        break;
+    }
+
+    unsigned int sourcePort = 0;
+    unsigned int destinationPort = 0;
+    if (hasPorts && length >= offset + 4)
+    {
+        sourcePort = ReadUShort(packetData + offset);
+        destinationPort = ReadUShort(packetData + offset + 2);
+    }
+
+    unsigned int headersEnd = offset + transportHeaderLength;
+    info.headersLength = Min(headersEnd, length);
+
+    // The headers may be longer than what was captured, so the payload is measured from where the headers end and not from the captured length.
+    unsigned int payloadEnd = networkEnd == 0 ? length : networkEnd;
+    info.payloadLength = payloadEnd > headersEnd ? payloadEnd - headersEnd : 0;
+
+    // Adding the endpoint hashes makes the flow hash the same for both directions.
+    unsigned __int64 flowHash = Mix(HashEndpoint(source, addressLength, sourcePort) + HashEndpoint(destination, addressLength, destinationPort) + protocol);
+    info.flowHash = flowHash == 0 ? 1 : flowHash;
+}
+
+// static
+unsigned __int64 PacketFlowParser::LinkHash(int dataLink, const unsigned char* packetData, unsigned int length)
+{
+    if (dataLink != DLT_EN10MB || length < EthernetHeaderLength)
+        return 0;
+
+    unsigned __int64 linkHash = Mix(HashEndpoint(packetData, 6, 0) + HashEndpoint(packetData + 6, 6, 0) + ReadUShort(packetData + 12));
+    return linkHash == 0 ? 1 : linkHash;
+}
+
+// static
+unsigned __int64 PacketFlowParser::HashEndpoint(const unsigned char* address, unsigned int addressLength, unsigned int port)
+{
+    // FNV-1a
+    unsigned __int64 hash = 14695981039346656037ULL;
+    for (unsigned int i = 0; i != addressLength; ++i)
+    {
+        hash ^= address[i];
+        hash *= 1099511628211ULL;
+    }
+    hash ^= port;
+    hash *= 1099511628211ULL;
+    return Mix(hash);
+}
+
+// static
+unsigned __int64 PacketFlowParser::Mix(unsigned __int64 value)
+{
+    // The SplitMix64 finalizer.
+    value ^= value >> 30;
+    value *= 0xBF58476D1CE4E5B9ULL;
+    value ^= value >> 27;
+    value *= 0x94D049BB133111EBULL;
+    value ^= value >> 31;
+    return value;
+}
+
+#pragma managed(pop)
@@ -0,0 +1,41 @@
+#pragma once
+
+namespace PcapDotNet { namespace Core 
+{
+    // The layer 2 to layer 4 information the native stages need about a packet.
+    struct PacketFlowInfo
+    {
+        // The number of captured bytes that belong to the link, network and transport headers.
+        unsigned int headersLength;
+
+        // The length of the transport payload according to the IP header, including the bytes that weren't captured.
+        // If the IP header doesn't give the length, only the captured payload bytes are counted.
+        unsigned int payloadLength;
+
+        // A hash of the addresses, ports and protocol that is the same for both directions of the flow.
+        // 0 if the packet isn't IP.
+        unsigned __int64 flowHash;
+    };
+
+    // Parses Ethernet (with VLAN tags) and raw IP packets without allocating.
+    class PacketFlowParser
+    {
+    public:
+        // Returns false if the data link or the network protocol isn't supported.
+        // In this case headersLength is the captured length and flowHash is 0.
+        static bool Parse(int dataLink, const unsigned char* packetData, unsigned int length, PacketFlowInfo& info);
+
+        // A hash of the MAC addresses and the EtherType that is the same for both directions.
+        // 0 if the data link isn't Ethernet or the Ethernet header wasn't captured.
+        static unsigned __int64 LinkHash(int dataLink, const unsigned char* packetData, unsigned int length);
+
+    private:
+        static bool ParseIpV4(const unsigned char* packetData, unsigned int offset, unsigned int length, PacketFlowInfo& info);
+        static bool ParseIpV6(const unsigned char* packetData, unsigned int offset, unsigned int length, PacketFlowInfo& info);
+        // networkEnd is the offset where the IP packet ends according to its header. 0 if the header doesn't give the length.
+        static void ParseTransport(unsigned char protocol, const unsigned char* packetData, unsigned int offset, unsigned int length, unsigned int networkEnd,
+                                   const unsigned char* source, const unsigned char* destination, unsigned int addressLength, PacketFlowInfo& info);
+        static unsigned __int64 HashEndpoint(const unsigned char* address, unsigned int addressLength, unsigned int port);
+        static unsigned __int64 Mix(unsigned __int64 value);
+    };
+}}
@@ -0,0 +1,87 @@
+#include "PacketFlowPayloadCutoff.h"
+
+#include "PacketFlowPayloadCutoffStage.h"
+
+using namespace System;
+using namespace PcapDotNet::Base;
+using namespace PcapDotNet::Core;
+
+PacketFlowPayloadCutoff::PacketFlowPayloadCutoff(__int64 cutoffBytes, PacketFlowPayloadCutoffAction action)
+{
+    Initialize(cutoffBytes, action, DefaultFlowTableCapacity, TimeSpan::FromMinutes(5));
+}
+
+PacketFlowPayloadCutoff::PacketFlowPayloadCutoff(__int64 cutoffBytes, PacketFlowPayloadCutoffAction action, int flowTableCapacity, TimeSpan flowIdleTimeout)
+{
+    Initialize(cutoffBytes, action, flowTableCapacity, flowIdleTimeout);
+}
+
+__int64 PacketFlowPayloadCutoff::CutoffBytes::get()
+{
+    return _cutoffBytes;
+}
+
+PacketFlowPayloadCutoffAction PacketFlowPayloadCutoff::Action::get()
+{
+    return _action;
+}
+
+int PacketFlowPayloadCutoff::FlowTableCapacity::get()
+{
+    return _flowTableCapacity;
+}
+
+TimeSpan PacketFlowPayloadCutoff::FlowIdleTimeout::get()
+{
+    return _flowIdleTimeout;
+}
+
+PacketFlowPayloadCutoffStatistics^ PacketFlowPayloadCutoff::Statistics::get()
+{
+    return gcnew PacketFlowPayloadCutoffStatistics(_stage->Counters());
+}
+
+void PacketFlowPayloadCutoff::Reset()
+{
+    _stage->Reset();
+}
+
+// Internal
+
+PacketStage* PacketFlowPayloadCutoff::Stage::get()
+{
+    return _stage;
+}
+
+void PacketFlowPayloadCutoff::Attach(int dataLink)
+{
+    _stage->SetDataLink(dataLink);
+}
+
+// Protected
+
+PacketFlowPayloadCutoff::!PacketFlowPayloadCutoff()
+{
+    // Not IDisposable, so the stage can't be freed while a communicator that references this cutoff may still use it.
+    delete _stage;
+    _stage = NULL;
+}
+
+// Private
+
+void PacketFlowPayloadCutoff::Initialize(__int64 cutoffBytes, PacketFlowPayloadCutoffAction action, int flowTableCapacity, TimeSpan flowIdleTimeout)
+{
+    if (cutoffBytes < 0)
+        throw gcnew ArgumentOutOfRangeException("cutoffBytes", cutoffBytes, "Must be non negative");
+    if (flowTableCapacity <= 0)
+        throw gcnew ArgumentOutOfRangeException("flowTableCapacity", flowTableCapacity, "Must be positive");
+    if (flowIdleTimeout <= TimeSpan::Zero)
+        throw gcnew ArgumentOutOfRangeException("flowIdleTimeout", flowIdleTimeout, "Must be positive");
+
+    _cutoffBytes = cutoffBytes;
+    _action = action;
+    _flowTableCapacity = flowTableCapacity;
+    _flowIdleTimeout = flowIdleTimeout;
+    _stage = new PacketFlowPayloadCutoffStage(cutoffBytes, action == PacketFlowPayloadCutoffAction::Drop, flowTableCapacity,
+                                              flowIdleTimeout.Ticks / TimeSpanExtensions::TicksPerMicrosecond);
+}
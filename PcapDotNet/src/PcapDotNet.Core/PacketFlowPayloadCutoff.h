@@ -0,0 +1,122 @@
+#pragma once
+
+#include "PacketFlowPayloadCutoffAction.h"
+#include "PacketFlowPayloadCutoffStatistics.h"
+#include "PacketStage.h"
+
+namespace PcapDotNet { namespace Core
+{
+    class PacketFlowPayloadCutoffStage;
+
+    /// <summary>
+    /// Keeps only the first bytes of the payload of every flow, together with all the headers.
+    /// Set it as the PacketCommunicator.PayloadCutoff.
+    /// </summary>
+    /// <remarks>
+    ///   <para>
+    ///   Flows are identified by their addresses, ports and protocol in both directions and are tracked natively in a fixed size table.
+    ///   Once a flow passed its cutoff, its packets are truncated to their link, network and transport headers or dropped before they are copied to managed memory,
+    ///   so they never reach the callback or a PacketDumpFile.
+    ///   The packet that crosses the cutoff keeps the payload up to the cutoff.
+    ///   The payload length is taken from the IP header, so payload bytes that weren't captured are counted, while headers that weren't captured and link padding aren't.
+    ///   </para>
+    ///   <para>
+    ///   A flow that wasn't seen for FlowIdleTimeout starts counting again.
+    ///   When more flows are active than the flow table capacity, the least recently seen flows are forgotten and start counting again too.
+    ///   Packets that aren't IP over Ethernet or raw IP are delivered as is.
+    ///   </para>
+    ///   <para>A cutoff should be set on a single communicator and used by the receiving thread.</para>
+    /// </remarks>
+    public ref class PacketFlowPayloadCutoff sealed
+    {
+    public:
+        /// <summary>
+        /// The number of flows tracked by default.
+        /// </summary>
+        static const int DefaultFlowTableCapacity = 64 * 1024;
+
+        /// <summary>
+        /// Creates a cutoff that tracks DefaultFlowTableCapacity flows with an idle timeout of 5 minutes.
+        /// </summary>
+        /// <param name="cutoffBytes">The number of payload bytes kept for every flow.</param>
+        /// <param name="action">What to do with the packets of a flow that passed the cutoff.</param>
+        /// <exception cref="System::ArgumentOutOfRangeException">The cutoff is negative.</exception>
+        PacketFlowPayloadCutoff(__int64 cutoffBytes, PacketFlowPayloadCutoffAction action);
+
+        /// <summary>
+        /// Creates a cutoff.
+        /// </summary>
+        /// <param name="cutoffBytes">The number of payload bytes kept for every flow.</param>
+        /// <param name="action">What to do with the packets of a flow that passed the cutoff.</param>
+        /// <param name="flowTableCapacity">The number of flows to track.</param>
+        /// <param name="flowIdleTimeout">The time without packets after which a flow is considered new.</param>
+        /// <exception cref="System::ArgumentOutOfRangeException">The cutoff is negative, the capacity is not positive or the idle timeout is not positive.</exception>
+        PacketFlowPayloadCutoff(__int64 cutoffBytes, PacketFlowPayloadCutoffAction action, int flowTableCapacity, System::TimeSpan flowIdleTimeout);
+
+        /// <summary>
+        /// The number of payload bytes kept for every flow.
+        /// </summary>
+        property __int64 CutoffBytes
+        {
+            __int64 get();
+        }
+
+        /// <summary>
+        /// What is done with the packets of a flow that passed the cutoff.
+        /// </summary>
+        property PacketFlowPayloadCutoffAction Action
+        {
+            PacketFlowPayloadCutoffAction get();
+        }
+
+        /// <summary>
+        /// The number of flows tracked.
+        /// </summary>
+        property int FlowTableCapacity
+        {
+            int get();
+        }
+
+        /// <summary>
+        /// The time without packets after which a flow is considered new.
+        /// </summary>
+        property System::TimeSpan FlowIdleTimeout
+        {
+            System::TimeSpan get();
+        }
+
+        /// <summary>
+        /// What the cutoff did since it was created or since the last call to Reset().
+        /// </summary>
+        property PacketFlowPayloadCutoffStatistics^ Statistics
+        {
+            PacketFlowPayloadCutoffStatistics^ get();
+        }
+
+        /// <summary>
+        /// Clears the statistics and forgets all the flows.
+        /// </summary>
+        void Reset();
+
+    internal:
+        property PacketStage* Stage
+        {
+            PacketStage* get();
+        }
+
+        void Attach(int dataLink);
+
+    protected:
+        !PacketFlowPayloadCutoff();
+
+    private:
+        void Initialize(__int64 cutoffBytes, PacketFlowPayloadCutoffAction action, int flowTableCapacity, System::TimeSpan flowIdleTimeout);
+
+    private:
+        PacketFlowPayloadCutoffStage* _stage;
+        __int64 _cutoffBytes;
+        PacketFlowPayloadCutoffAction _action;
+        int _flowTableCapacity;
+        System::TimeSpan _flowIdleTimeout;
+    };
+}}
@@ -0,0 +1,16 @@
+#pragma once
+
+namespace PcapDotNet { namespace Core
+{
+    /// <summary>
+    /// What a PacketFlowPayloadCutoff does with the packets of a flow that passed its payload cutoff.
+    /// </summary>
+    public enum class PacketFlowPayloadCutoffAction : int
+    {
+        /// <summary>The packets are truncated to their link, network and transport headers.</summary>
+        TruncateToHeaders,
+
+        /// <summary>The packets are dropped.</summary>
+        Drop
+    };
+}}
@@ -0,0 +1,79 @@
+#include "PacketFlowPayloadCutoffStage.h"
+
+#include <string.h>
+
+#include "PacketFlowParser.h"
+#include "Pcap.h"
+
+using namespace PcapDotNet::Core;
+
+#pragma managed(push, off)
+
+PacketFlowPayloadCutoffStage::PacketFlowPayloadCutoffStage(unsigned __int64 cutoffBytes, bool drop, unsigned int flowTableCapacity, unsigned __int64 flowIdleTimeout)
+    : _dataLink(0), _cutoffBytes(cutoffBytes), _drop(drop), _flows(flowTableCapacity, flowIdleTimeout)
+{
+    memset(&_counters, 0, sizeof(_counters));
+}
+
+void PacketFlowPayloadCutoffStage::SetDataLink(int dataLink)
+{
+    _dataLink = dataLink;
+}
+
+PacketFlowPayloadCutoffCounters PacketFlowPayloadCutoffStage::Counters() const
+{
+    return _counters;
+}
+
+void PacketFlowPayloadCutoffStage::Reset()
+{
+    memset(&_counters, 0, sizeof(_counters));
+    _flows.Clear();
+}
+
+bool PacketFlowPayloadCutoffStage::Process(pcap_pkthdr& packetHeader, const unsigned char* packetData)
+{
+    PacketFlowInfo info;
+    PacketFlowParser::Parse(_dataLink, packetData, packetHeader.caplen, info);
+    if (info.flowHash == 0)
+    {
+        ++_counters.packetsPassed;
+        return true;
+    }
+
+    unsigned __int64 packetTimestamp = static_cast<unsigned __int64>(packetHeader.ts.tv_sec) * 1000000 + packetHeader.ts.tv_usec;
+    PacketFlowTable::Entry& flow = _flows.Find(info.flowHash, packetTimestamp);
+    unsigned __int64 previousBytes = flow.bytes;
+    unsigned int payloadLength = info.payloadLength;
+    ++flow.packets;
+    flow.bytes += payloadLength;
+
+    if (previousBytes + payloadLength <= _cutoffBytes)
+    {
+        ++_counters.packetsPassed;
+        return true;
+    }
+
+    if (previousBytes >= _cutoffBytes && _drop)
+    {
+        ++_counters.packetsDropped;
+        _counters.bytesDropped += packetHeader.len;
+        return false;
+    }
+
+    // The packet that crosses the cutoff keeps the payload up to the cutoff.
+    unsigned __int64 allowedPayload = previousBytes >= _cutoffBytes ? 0 : _cutoffBytes - previousBytes;
+    unsigned __int64 allowedLength = info.headersLength + allowedPayload;
+    if (allowedLength >= packetHeader.caplen)
+    {
+        ++_counters.packetsPassed;
+        return true;
+    }
+
+    ++_counters.packetsTruncated;
+    _counters.bytesTruncated += packetHeader.caplen - allowedLength;
+    packetHeader.caplen = static_cast<unsigned int>(allowedLength);
+    return true;
+}
+
+#pragma managed(pop)
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "PacketStage.h"
+#include "PacketFlowTable.h"
+
+namespace PcapDotNet { namespace Core 
+{
+    // What the payload cutoff stage did to the packets it processed.
+    // Every packet is counted exactly once.
+    struct PacketFlowPayloadCutoffCounters
+    {
+        unsigned __int64 packetsPassed;
+        unsigned __int64 packetsTruncated;
+        unsigned __int64 bytesTruncated;
+        unsigned __int64 packetsDropped;
+        unsigned __int64 bytesDropped;
+    };
+
+    // The native part of PacketFlowPayloadCutoff.
+    // Counts the payload bytes of every flow and cuts the packets after the cutoff.
+    class PacketFlowPayloadCutoffStage : public PacketStage
+    {
+    public:
+        PacketFlowPayloadCutoffStage(unsigned __int64 cutoffBytes, bool drop, unsigned int flowTableCapacity, unsigned __int64 flowIdleTimeout);
+
+        void SetDataLink(int dataLink);
+
+        PacketFlowPayloadCutoffCounters Counters() const;
+        void Reset();
+
+        virtual bool Process(pcap_pkthdr& packetHeader, const unsigned char* packetData) override;
+
+    private:
+        int _dataLink;
+        unsigned __int64 _cutoffBytes;
+        bool _drop;
+        PacketFlowTable _flows;
+        PacketFlowPayloadCutoffCounters _counters;
+    };
+}}
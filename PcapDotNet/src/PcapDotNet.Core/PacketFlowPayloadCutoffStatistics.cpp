@@ -0,0 +1,52 @@
+#include "PacketFlowPayloadCutoffStatistics.h"
+
+#include "PacketFlowPayloadCutoffStage.h"
+
+using namespace System;
+using namespace System::Globalization;
+using namespace PcapDotNet::Core;
+
+unsigned __int64 PacketFlowPayloadCutoffStatistics::PacketsPassed::get()
+{
+    return _packetsPassed;
+}
+
+unsigned __int64 PacketFlowPayloadCutoffStatistics::PacketsTruncated::get()
+{
+    return _packetsTruncated;
+}
+
+unsigned __int64 PacketFlowPayloadCutoffStatistics::BytesTruncated::get()
+{
+    return _bytesTruncated;
+}
+
+unsigned __int64 PacketFlowPayloadCutoffStatistics::PacketsDropped::get()
+{
+    return _packetsDropped;
+}
+
+unsigned __int64 PacketFlowPayloadCutoffStatistics::BytesDropped::get()
+{
+    return _bytesDropped;
+}
+
+unsigned __int64 PacketFlowPayloadCutoffStatistics::TotalPackets::get()
+{
+    return _packetsPassed + _packetsTruncated + _packetsDropped;
+}
+
+String^ PacketFlowPayloadCutoffStatistics::ToString()
+{
+    return String::Format(CultureInfo::InvariantCulture, "Passed {0}. Truncated {1} ({2} bytes). Dropped {3} ({4} bytes).",
+                          _packetsPassed, _packetsTruncated, _bytesTruncated, _packetsDropped, _bytesDropped);
+}
+
+// Internal
+
+PacketFlowPayloadCutoffStatistics::PacketFlowPayloadCutoffStatistics(const PacketFlowPayloadCutoffCounters& counters)
+    : _packetsPassed(counters.packetsPassed),
+      _packetsTruncated(counters.packetsTruncated), _bytesTruncated(counters.bytesTruncated),
+      _packetsDropped(counters.packetsDropped), _bytesDropped(counters.bytesDropped)
+{
+}
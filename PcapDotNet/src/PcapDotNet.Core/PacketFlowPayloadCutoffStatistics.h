@@ -0,0 +1,74 @@
+#pragma once
+
+namespace PcapDotNet { namespace Core
+{
+    struct PacketFlowPayloadCutoffCounters;
+
+    /// <summary>
+    /// What a PacketFlowPayloadCutoff did to the packets it processed.
+    /// Every packet is counted by exactly one of the packets properties.
+    /// </summary>
+    public ref class PacketFlowPayloadCutoffStatistics sealed
+    {
+    public:
+        /// <summary>
+        /// The number of packets delivered without a change.
+        /// </summary>
+        property unsigned __int64 PacketsPassed
+        {
+            unsigned __int64 get();
+        }
+
+        /// <summary>
+        /// The number of packets delivered truncated because their flow passed the cutoff.
+        /// </summary>
+        property unsigned __int64 PacketsTruncated
+        {
+            unsigned __int64 get();
+        }
+
+        /// <summary>
+        /// The number of payload bytes removed by truncation.
+        /// </summary>
+        property unsigned __int64 BytesTruncated
+        {
+            unsigned __int64 get();
+        }
+
+        /// <summary>
+        /// The number of packets dropped because their flow passed the cutoff.
+        /// </summary>
+        property unsigned __int64 PacketsDropped
+        {
+            unsigned __int64 get();
+        }
+
+        /// <summary>
+        /// The original length in bytes of the dropped packets.
+        /// </summary>
+        property unsigned __int64 BytesDropped
+        {
+            unsigned __int64 get();
+        }
+
+        /// <summary>
+        /// The number of packets that were processed.
+        /// </summary>
+        property unsigned __int64 TotalPackets
+        {
+            unsigned __int64 get();
+        }
+
+        virtual System::String^ ToString() override;
+
+    internal:
+        PacketFlowPayloadCutoffStatistics(const PacketFlowPayloadCutoffCounters& counters);
+
+    private:
+        unsigned __int64 _packetsPassed;
+        unsigned __int64 _packetsTruncated;
+        unsigned __int64 _bytesTruncated;
+        unsigned __int64 _packetsDropped;
+        unsigned __int64 _bytesDropped;
+    };
+}}
@@ -0,0 +1,76 @@
+#include "PacketFlowTable.h"
+
+#include <string.h>
+
+using namespace PcapDotNet::Core;
+
+#pragma managed(push, off)
+
+PacketFlowTable::PacketFlowTable(unsigned int capacity, unsigned __int64 idleTimeout)
+    : _idleTimeout(idleTimeout)
+{
+    unsigned int roundedCapacity = MaxProbes;
+    while (roundedCapacity < capacity && roundedCapacity < 0x80000000)
+        roundedCapacity <<= 1;
+
+    _entries = new Entry[roundedCapacity];
+    _mask = roundedCapacity - 1;
+    Clear();
+}
+
+PacketFlowTable::~PacketFlowTable()
+{
+    delete[] _entries;
+}
+
+unsigned int PacketFlowTable::Capacity() const
+{
+    return _mask + 1;
+}
+
+unsigned __int64 PacketFlowTable::IdleTimeout() const
+{
+    return _idleTimeout;
+}
+
+PacketFlowTable::Entry& PacketFlowTable::Find(unsigned __int64 flowHash, unsigned __int64 now)
+{
+    Entry* replaced = NULL;
+    for (unsigned int i = 0; i != MaxProbes; ++i)
+    {
+        Entry& entry = _entries[(static_cast<unsigned int>(flowHash) + i) & _mask];
+        if (entry.flowHash == flowHash)
+        {
+            if (now > entry.lastSeen && now - entry.lastSeen > _idleTimeout)
+            {
+                entry.packets = 0;
+                entry.bytes = 0;
+            }
+            entry.lastSeen = now;
+            return entry;
+        }
+
+        // Entries are never removed, so the flow can't be after an empty slot.
+        if (entry.flowHash == 0)
+        {
+            replaced = &entry;
+            break;
+        }
+
+        if (replaced == NULL || entry.lastSeen < replaced->lastSeen)
+            replaced = &entry;
+    }
+
+    replaced->flowHash = flowHash;
+    replaced->packets = 0;
+    replaced->bytes = 0;
+    replaced->lastSeen = now;
+    return *replaced;
+}
+
+void PacketFlowTable::Clear()
+{
+    memset(_entries, 0, sizeof(Entry) * Capacity());
+}
+
+#pragma managed(pop)
@@ -0,0 +1,43 @@
+#pragma once
+
+namespace PcapDotNet { namespace Core 
+{
+    // A fixed size open addressing table of per flow counters keyed by PacketFlowInfo.flowHash.
+    // When the probed slots are full, the least recently seen flow is replaced, so memory never grows while capturing.
+    class PacketFlowTable
+    {
+    public:
+        struct Entry
+        {
+            unsigned __int64 flowHash;
+            unsigned __int64 packets;
+            unsigned __int64 bytes;
+            // Microseconds since the epoch of the last packet of the flow.
+            unsigned __int64 lastSeen;
+        };
+
+        // The capacity is rounded up to a power of 2.
+        // Flows that weren't seen for idleTimeout microseconds are considered new.
+        PacketFlowTable(unsigned int capacity, unsigned __int64 idleTimeout);
+        ~PacketFlowTable();
+
+        unsigned int Capacity() const;
+        unsigned __int64 IdleTimeout() const;
+
+        // Returns the entry of the flow, resetting it if the flow is new.
+        // flowHash must not be 0.
+        Entry& Find(unsigned __int64 flowHash, unsigned __int64 now);
+
+        void Clear();
+
+    private:
+        static const unsigned int MaxProbes = 8;
+
+        Entry* _entries;
+        unsigned int _mask;
+        unsigned __int64 _idleTimeout;
+
+        PacketFlowTable(const PacketFlowTable&) = delete;
+        PacketFlowTable& operator=(const PacketFlowTable&) = delete;
+    };
+}}
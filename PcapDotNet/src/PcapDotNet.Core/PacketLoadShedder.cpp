@@ -0,0 +1,201 @@
+#include "PacketLoadShedder.h"
+
+#include "PacketLoadSheddingStage.h"
+
+using namespace System;
+using namespace System::Globalization;
+using namespace PcapDotNet::Base;
+using namespace PcapDotNet::Core;
+
+PacketLoadShedder::PacketLoadShedder()
+{
+    Initialize(DefaultFlowTableCapacity);
+}
+
+PacketLoadShedder::PacketLoadShedder(int flowTableCapacity)
+{
+    if (flowTableCapacity <= 0)
+        throw gcnew ArgumentOutOfRangeException("flowTableCapacity", flowTableCapacity, "Must be positive");
+    Initialize(flowTableCapacity);
+}
+
+int PacketLoadShedder::QueueDepth::get()
+{
+    return _queueDepth;
+}
+
+void PacketLoadShedder::QueueDepth::set(int value)
+{
+    if (value < 0)
+        throw gcnew ArgumentOutOfRangeException("value", value, "Must be non negative");
+    _queueDepth = value;
+    _stage->SetQueueDepth(value);
+}
+
+int PacketLoadShedder::QueueCapacity::get()
+{
+    return _queueCapacity;
+}
+
+void PacketLoadShedder::QueueCapacity::set(int value)
+{
+    if (value < 0)
+        throw gcnew ArgumentOutOfRangeException("value", value, "Must be non negative");
+    _queueCapacity = value;
+    UpdateSettings();
+}
+
+TimeSpan PacketLoadShedder::MaximumLag::get()
+{
+    return _maximumLag;
+}
+
+void PacketLoadShedder::MaximumLag::set(TimeSpan value)
+{
+    if (value < TimeSpan::Zero)
+        throw gcnew ArgumentOutOfRangeException("value", value, "Must be non negative");
+    _maximumLag = value;
+    UpdateSettings();
+}
+
+double PacketLoadShedder::TruncatePayloadsPressure::get()
+{
+    return _truncatePayloadsPressure;
+}
+
+double PacketLoadShedder::SampleFlowsPressure::get()
+{
+    return _sampleFlowsPressure;
+}
+
+double PacketLoadShedder::DropBulkFlowsPressure::get()
+{
+    return _dropBulkFlowsPressure;
+}
+
+void PacketLoadShedder::SetPressureThresholds(double truncatePayloads, double sampleFlows, double dropBulkFlows)
+{
+    AssertFraction("truncatePayloads", truncatePayloads);
+    AssertFraction("sampleFlows", sampleFlows);
+    AssertFraction("dropBulkFlows", dropBulkFlows);
+    if (sampleFlows < truncatePayloads)
+        throw gcnew ArgumentOutOfRangeException("sampleFlows", sampleFlows, "Must not be smaller than truncatePayloads " + truncatePayloads.ToString(CultureInfo::InvariantCulture));
+    if (dropBulkFlows < sampleFlows)
+        throw gcnew ArgumentOutOfRangeException("dropBulkFlows", dropBulkFlows, "Must not be smaller than sampleFlows " + sampleFlows.ToString(CultureInfo::InvariantCulture));
+
+    _truncatePayloadsPressure = truncatePayloads;
+    _sampleFlowsPressure = sampleFlows;
+    _dropBulkFlowsPressure = dropBulkFlows;
+    UpdateSettings();
+}
+
+double PacketLoadShedder::SampledFlowsFraction::get()
+{
+    return _sampledFlowsFraction;
+}
+
+void PacketLoadShedder::SampledFlowsFraction::set(double value)
+{
+    AssertFraction("value", value);
+    _sampledFlowsFraction = value;
+    UpdateSettings();
+}
+
+__int64 PacketLoadShedder::BulkFlowBytes::get()
+{
+    return _bulkFlowBytes;
+}
+
+void PacketLoadShedder::BulkFlowBytes::set(__int64 value)
+{
+    if (value <= 0)
+        throw gcnew ArgumentOutOfRangeException("value", value, "Must be positive");
+    _bulkFlowBytes = value;
+    UpdateSettings();
+}
+
+int PacketLoadShedder::FlowTableCapacity::get()
+{
+    return _flowTableCapacity;
+}
+
+PacketLoadSheddingLevel PacketLoadShedder::Level::get()
+{
+    return static_cast<PacketLoadSheddingLevel>(_stage->Level());
+}
+
+PacketLoadSheddingStatistics^ PacketLoadShedder::Statistics::get()
+{
+    return gcnew PacketLoadSheddingStatistics(Level, _stage->Counters());
+}
+
+void PacketLoadShedder::Reset()
+{
+    _stage->Reset();
+}
+
+// Internal
+
+PacketStage* PacketLoadShedder::Stage::get()
+{
+    return _stage;
+}
+
+void PacketLoadShedder::Attach(int dataLink)
+{
+    _dataLink = dataLink;
+    UpdateSettings();
+}
+
+// Protected
+
+PacketLoadShedder::!PacketLoadShedder()
+{
+    // Not IDisposable, so the stage can't be freed while a communicator that references this shedder may still use it.
+    delete _stage;
+    _stage = NULL;
+}
+
+// Private
+
+void PacketLoadShedder::Initialize(int flowTableCapacity)
+{
+    _flowTableCapacity = flowTableCapacity;
+    _maximumLag = TimeSpan::FromMilliseconds(100);
+    _truncatePayloadsPressure = 0.5;
+    _sampleFlowsPressure = 0.75;
+    _dropBulkFlowsPressure = 0.9;
+    _sampledFlowsFraction = 0.25;
+    _bulkFlowBytes = 1024 * 1024;
+
+    // Flows idle for 30 seconds are considered new.
+    _stage = new PacketLoadSheddingStage(flowTableCapacity, 30 * 1000 * 1000);
+    UpdateSettings();
+}
+
+void PacketLoadShedder::UpdateSettings()
+{
+    PacketLoadSheddingStage::Settings settings;
+    settings.dataLink = _dataLink;
+    settings.queueCapacity = _queueCapacity;
+    settings.maximumLag = _maximumLag.Ticks / TimeSpanExtensions::TicksPerMicrosecond;
+    settings.truncatePayloadsPressure = ToPermille(_truncatePayloadsPressure);
+    settings.sampleFlowsPressure = ToPermille(_sampleFlowsPressure);
+    settings.dropBulkFlowsPressure = ToPermille(_dropBulkFlowsPressure);
+    settings.sampledFlowsPermille = ToPermille(_sampledFlowsFraction);
+    settings.bulkFlowBytes = _bulkFlowBytes;
+    _stage->SetSettings(settings);
+}
+
+// static
+void PacketLoadShedder::AssertFraction(String^ name, double value)
+{
+    if (!(value > 0 && value <= 1))
+        throw gcnew ArgumentOutOfRangeException(name, value, "Must be bigger than 0 and at most 1");
+}
+
+// static
+unsigned int PacketLoadShedder::ToPermille(double value)
+{
+    return static_cast<unsigned int>(Math::Round(value * 1000));
+}
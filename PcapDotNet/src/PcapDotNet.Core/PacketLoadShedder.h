@@ -0,0 +1,195 @@
+#pragma once
+
+#include "PacketLoadSheddingLevel.h"
+#include "PacketLoadSheddingStatistics.h"
+#include "PacketStage.h"
+
+namespace PcapDotNet { namespace Core
+{
+    class PacketLoadSheddingStage;
+
+    /// <summary>
+    /// Sheds received packets on purpose when the consumer can't keep up, instead of letting the driver drop arbitrary packets.
+    /// Set it as the PacketCommunicator.LoadShedder and keep QueueDepth updated from the consumer.
+    /// </summary>
+    /// <remarks>
+    ///   <para>
+    ///   The pressure is the maximum of QueueDepth / QueueCapacity and of the consumer lag / MaximumLag.
+    ///   The consumer lag is how much the time between the receive calls and the packet timestamps grew since the consumer was least behind.
+    ///   </para>
+    ///   <para>
+    ///   As the pressure grows the shedder escalates: first it truncates payloads to headers, then it keeps only a fraction of the flows by hash, then it also drops flows that passed the bulk flow size.
+    ///   The level is lowered only after the pressure drops a little below the level threshold, to avoid flapping.
+    ///   </para>
+    ///   <para>
+    ///   The policies are applied in native code before the packets are copied to managed memory, so shed packets cost almost nothing.
+    ///   Packets that aren't Ethernet or raw IP can only be truncated to their link header, if it is known.
+    ///   </para>
+    ///   <para>A shedder should be set on a single communicator. Its properties can be changed from any thread while packets are received. Reset() and Statistics should be used by the receiving thread.</para>
+    /// </remarks>
+    public ref class PacketLoadShedder sealed
+    {
+    public:
+        /// <summary>
+        /// The number of flows tracked by default.
+        /// </summary>
+        static const int DefaultFlowTableCapacity = 64 * 1024;
+
+        /// <summary>
+        /// Creates a load shedder that tracks DefaultFlowTableCapacity flows.
+        /// </summary>
+        PacketLoadShedder();
+
+        /// <summary>
+        /// Creates a load shedder that tracks the given number of flows.
+        /// When more flows are active, the least recently seen flows are forgotten.
+        /// </summary>
+        /// <param name="flowTableCapacity">The number of flows to track.</param>
+        /// <exception cref="System::ArgumentOutOfRangeException">The capacity is not positive.</exception>
+        PacketLoadShedder(int flowTableCapacity);
+
+        /// <summary>
+        /// The number of packets waiting for the consumer.
+        /// Should be updated by the consumer, from any thread.
+        /// </summary>
+        /// <exception cref="System::ArgumentOutOfRangeException">The value is negative.</exception>
+        property int QueueDepth
+        {
+            int get();
+            void set(int value);
+        }
+
+        /// <summary>
+        /// The queue depth that means full pressure. 0 means the queue depth isn't used. 0 by default.
+        /// </summary>
+        /// <exception cref="System::ArgumentOutOfRangeException">The value is negative.</exception>
+        property int QueueCapacity
+        {
+            int get();
+            void set(int value);
+        }
+
+        /// <summary>
+        /// The consumer lag that means full pressure. Zero means the lag isn't used. 100 milliseconds by default.
+        /// </summary>
+        /// <exception cref="System::ArgumentOutOfRangeException">The value is negative.</exception>
+        property System::TimeSpan MaximumLag
+        {
+            System::TimeSpan get();
+            void set(System::TimeSpan value);
+        }
+
+        /// <summary>
+        /// The pressure, between 0 and 1, from which payloads are truncated. 0.5 by default.
+        /// </summary>
+        property double TruncatePayloadsPressure
+        {
+            double get();
+        }
+
+        /// <summary>
+        /// The pressure, between 0 and 1, from which flows are sampled. 0.75 by default.
+        /// </summary>
+        property double SampleFlowsPressure
+        {
+            double get();
+        }
+
+        /// <summary>
+        /// The pressure, between 0 and 1, from which bulk flows are dropped. 0.9 by default.
+        /// </summary>
+        property double DropBulkFlowsPressure
+        {
+            double get();
+        }
+
+        /// <summary>
+        /// Sets the pressure from which every level starts.
+        /// </summary>
+        /// <param name="truncatePayloads">The pressure from which payloads are truncated.</param>
+        /// <param name="sampleFlows">The pressure from which flows are sampled.</param>
+        /// <param name="dropBulkFlows">The pressure from which bulk flows are dropped.</param>
+        /// <exception cref="System::ArgumentOutOfRangeException">A pressure is not bigger than 0 and at most 1 or a pressure is smaller than the pressure of the previous level.</exception>
+        void SetPressureThresholds(double truncatePayloads, double sampleFlows, double dropBulkFlows);
+
+        /// <summary>
+        /// The fraction of the flows kept when sampling flows. 0.25 by default.
+        /// </summary>
+        /// <exception cref="System::ArgumentOutOfRangeException">The value is not bigger than 0 and at most 1.</exception>
+        property double SampledFlowsFraction
+        {
+            double get();
+            void set(double value);
+        }
+
+        /// <summary>
+        /// The number of bytes after which a flow is considered bulk. 1 MByte by default.
+        /// </summary>
+        /// <exception cref="System::ArgumentOutOfRangeException">The value is not positive.</exception>
+        property __int64 BulkFlowBytes
+        {
+            __int64 get();
+            void set(__int64 value);
+        }
+
+        /// <summary>
+        /// The number of flows tracked.
+        /// </summary>
+        property int FlowTableCapacity
+        {
+            int get();
+        }
+
+        /// <summary>
+        /// The current level.
+        /// </summary>
+        property PacketLoadSheddingLevel Level
+        {
+            PacketLoadSheddingLevel get();
+        }
+
+        /// <summary>
+        /// What the shedder did since it was created or since the last call to Reset().
+        /// </summary>
+        property PacketLoadSheddingStatistics^ Statistics
+        {
+            PacketLoadSheddingStatistics^ get();
+        }
+
+        /// <summary>
+        /// Clears the statistics, the tracked flows and the lag reference and returns to level None.
+        /// </summary>
+        void Reset();
+
+    internal:
+        property PacketStage* Stage
+        {
+            PacketStage* get();
+        }
+
+        void Attach(int dataLink);
+
+    protected:
+        !PacketLoadShedder();
+
+    private:
+        void Initialize(int flowTableCapacity);
+        void UpdateSettings();
+
+        static void AssertFraction(System::String^ name, double value);
+        static unsigned int ToPermille(double value);
+
+    private:
+        PacketLoadSheddingStage* _stage;
+        int _flowTableCapacity;
+        int _dataLink;
+        int _queueDepth;
+        int _queueCapacity;
+        System::TimeSpan _maximumLag;
+        double _truncatePayloadsPressure;
+        double _sampleFlowsPressure;
+        double _dropBulkFlowsPressure;
+        double _sampledFlowsFraction;
+        __int64 _bulkFlowBytes;
+    };
+}}
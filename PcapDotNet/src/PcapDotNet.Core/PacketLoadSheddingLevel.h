@@ -0,0 +1,23 @@
+#pragma once
+
+namespace PcapDotNet { namespace Core
+{
+    /// <summary>
+    /// How aggressively a PacketLoadShedder sheds packets.
+    /// Every level also applies the policies of the lower levels.
+    /// </summary>
+    public enum class PacketLoadSheddingLevel : int
+    {
+        /// <summary>All packets are delivered as captured.</summary>
+        None = 0,
+
+        /// <summary>Packets are truncated to their link, network and transport headers.</summary>
+        TruncatePayloads = 1,
+
+        /// <summary>Only a fraction of the IP flows, selected by the flow hash, is delivered.</summary>
+        SampleFlows = 2,
+
+        /// <summary>Packets of flows that already passed the bulk flow size are dropped.</summary>
+        DropBulkFlows = 3
+    };
+}}
@@ -0,0 +1,186 @@
+#include "PacketLoadSheddingStage.h"
+
+#include <string.h>
+
+#include "PacketFlowParser.h"
+#include "Pcap.h"
+
+using namespace PcapDotNet::Core;
+
+#pragma managed(push, off)
+
+PacketLoadSheddingStage::PacketLoadSheddingStage(unsigned int flowTableCapacity, unsigned __int64 flowIdleTimeout)
+    : _settingsVersion(0), _queueDepth(0), _level(LevelNone), _hasLagBaseline(false), _lagBaseline(0), _flows(flowTableCapacity, flowIdleTimeout)
+{
+    memset(&_settings, 0, sizeof(_settings));
+    memset(&_counters, 0, sizeof(_counters));
+}
+
+void PacketLoadSheddingStage::SetSettings(const Settings& settings)
+{
+    // Making the version odd also keeps other writers out.
+    long version;
+    do
+    {
+        version = _settingsVersion & ~1L;
+    }
+    while (InterlockedCompareExchange(&_settingsVersion, version + 1, version) != version);
+
+    _settings = settings;
+    InterlockedExchange(&_settingsVersion, version + 2);
+}
+
+void PacketLoadSheddingStage::SetQueueDepth(int queueDepth)
+{
+    _queueDepth = queueDepth;
+}
+
+int PacketLoadSheddingStage::Level() const
+{
+    return _level;
+}
+
+PacketLoadSheddingCounters PacketLoadSheddingStage::Counters() const
+{
+    return _counters;
+}
+
+void PacketLoadSheddingStage::Reset()
+{
+    memset(&_counters, 0, sizeof(_counters));
+    _flows.Clear();
+    _hasLagBaseline = false;
+    _level = LevelNone;
+}
+
+bool PacketLoadSheddingStage::Process(pcap_pkthdr& packetHeader, const unsigned char* packetData)
+{
+    Settings settings = LoadSettings();
+    __int64 packetTimestamp = static_cast<__int64>(packetHeader.ts.tv_sec) * 1000000 + packetHeader.ts.tv_usec;
+    int level = UpdateLevel(settings, packetTimestamp);
+
+    PacketFlowInfo info;
+    PacketFlowParser::Parse(settings.dataLink, packetData, packetHeader.caplen, info);
+
+    // Flows are tracked at every level so bulk flows are already known when the pressure gets high.
+    PacketFlowTable::Entry* flow = NULL;
+    if (info.flowHash != 0)
+    {
+        flow = &_flows.Find(info.flowHash, static_cast<unsigned __int64>(packetTimestamp));
+        ++flow->packets;
+        flow->bytes += packetHeader.len;
+    }
+
+    if (level >= LevelDropBulkFlows && flow != NULL && flow->bytes > settings.bulkFlowBytes)
+    {
+        ++_counters.packetsDroppedAsBulk;
+        _counters.bytesDroppedAsBulk += packetHeader.len;
+        return false;
+    }
+
+    // The high bits of the hash decide, so the same flows are kept for as long as the level stays.
+    if (level >= LevelSampleFlows && info.flowHash != 0 && (info.flowHash >> 32) % 1000 >= settings.sampledFlowsPermille)
+    {
+        ++_counters.packetsSampledOut;
+        _counters.bytesSampledOut += packetHeader.len;
+        return false;
+    }
+
+    if (level >= LevelTruncatePayloads && packetHeader.caplen > info.headersLength)
+    {
+        ++_counters.packetsTruncated;
+        _counters.bytesTruncated += packetHeader.caplen - info.headersLength;
+        packetHeader.caplen = info.headersLength;
+        return true;
+    }
+
+    ++_counters.packetsPassed;
+    return true;
+}
+
+// Private
+
+PacketLoadSheddingStage::Settings PacketLoadSheddingStage::LoadSettings() const
+{
+    // Copy again if the settings were written during the copy.
+    for (;;)
+    {
+        long version = _settingsVersion;
+        if ((version & 1) == 0)
+        {
+            Settings settings = _settings;
+            MemoryBarrier();
+            if (_settingsVersion == version)
+                return settings;
+        }
+        YieldProcessor();
+    }
+}
+
+int PacketLoadSheddingStage::UpdateLevel(const Settings& settings, __int64 packetTimestamp)
+{
+    // The lag is how much further behind the capture clock the consumer is compared to the least it has been behind.
+    // This works for offline captures too, where the timestamps are far in the past.
+    __int64 offset = Now() - packetTimestamp;
+    if (!_hasLagBaseline || offset < _lagBaseline)
+    {
+        _lagBaseline = offset;
+        _hasLagBaseline = true;
+    }
+    unsigned __int64 lag = static_cast<unsigned __int64>(offset - _lagBaseline);
+
+    unsigned __int64 pressure = 0;
+    int queueDepth = _queueDepth;
+    if (settings.queueCapacity != 0 && queueDepth > 0)
+        pressure = static_cast<unsigned __int64>(queueDepth) * 1000 / settings.queueCapacity;
+    if (settings.maximumLag != 0)
+    {
+        unsigned __int64 lagPressure = lag * 1000 / settings.maximumLag;
+        if (lagPressure > pressure)
+            pressure = lagPressure;
+    }
+
+    int targetLevel = LevelNone;
+    if (pressure >= settings.dropBulkFlowsPressure)
+        targetLevel = LevelDropBulkFlows;
+    else if (pressure >= settings.sampleFlowsPressure)
+        targetLevel = LevelSampleFlows;
+    else if (pressure >= settings.truncatePayloadsPressure)
+        targetLevel = LevelTruncatePayloads;
+
+    int level = _level;
+    if (targetLevel > level || pressure + HysteresisPressure < LevelPressure(settings, level))
+        _level = level = targetLevel;
+
+    return level;
+}
+
+// static
+unsigned int PacketLoadSheddingStage::LevelPressure(const Settings& settings, int level)
+{
+    switch (level)
+    {
+    case LevelTruncatePayloads:
+        return settings.truncatePayloadsPressure;
+    case LevelSampleFlows:
+        return settings.sampleFlowsPressure;
+    case LevelDropBulkFlows:
+        return settings.dropBulkFlowsPressure;
+    default:
+        return 0;
+    }
+}
+
+// static
+__int64 PacketLoadSheddingStage::Now()
+{
+    // FILETIME counts 100 nanoseconds since 1601.
+    const __int64 EpochFileTime = 116444736000000000LL;
+
+    FILETIME fileTime;
+    GetSystemTimeAsFileTime(&fileTime);
+    __int64 now = (static_cast<__int64>(fileTime.dwHighDateTime) << 32) | fileTime.dwLowDateTime;
+    return (now - EpochFileTime) / 10;
+}
+
+#pragma managed(pop)
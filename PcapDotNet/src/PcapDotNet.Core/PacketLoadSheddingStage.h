@@ -0,0 +1,81 @@
+#pragma once
+
+#include "PacketStage.h"
+#include "PacketFlowTable.h"
+
+namespace PcapDotNet { namespace Core 
+{
+    // What the load shedding stage did to the packets it processed.
+    // Every packet is counted exactly once.
+    struct PacketLoadSheddingCounters
+    {
+        unsigned __int64 packetsPassed;
+        unsigned __int64 packetsTruncated;
+        unsigned __int64 bytesTruncated;
+        unsigned __int64 packetsSampledOut;
+        unsigned __int64 bytesSampledOut;
+        unsigned __int64 packetsDroppedAsBulk;
+        unsigned __int64 bytesDroppedAsBulk;
+    };
+
+    // The native part of PacketLoadShedder.
+    // Computes the pressure from the consumer queue depth and lag and applies the policies of the matching level.
+    class PacketLoadSheddingStage : public PacketStage
+    {
+    public:
+        // The same values as PacketLoadSheddingLevel.
+        static const int LevelNone = 0;
+        static const int LevelTruncatePayloads = 1;
+        static const int LevelSampleFlows = 2;
+        static const int LevelDropBulkFlows = 3;
+
+        // The pressure is in permille. 1000 means a full queue or the maximum lag.
+        struct Settings
+        {
+            int dataLink;
+            unsigned int queueCapacity;
+            // Microseconds. 0 means lag isn't used.
+            unsigned __int64 maximumLag;
+            unsigned int truncatePayloadsPressure;
+            unsigned int sampleFlowsPressure;
+            unsigned int dropBulkFlowsPressure;
+            // The permille of the flows kept when sampling flows.
+            unsigned int sampledFlowsPermille;
+            unsigned __int64 bulkFlowBytes;
+        };
+
+        // The pressure must drop this much below a level threshold before the level is lowered.
+        static const unsigned int HysteresisPressure = 50;
+
+        PacketLoadSheddingStage(unsigned int flowTableCapacity, unsigned __int64 flowIdleTimeout);
+
+        // Can be called from any thread while the stage is processing packets.
+        void SetSettings(const Settings& settings);
+
+        // Called by the consumer thread.
+        void SetQueueDepth(int queueDepth);
+
+        int Level() const;
+        PacketLoadSheddingCounters Counters() const;
+        void Reset();
+
+        virtual bool Process(pcap_pkthdr& packetHeader, const unsigned char* packetData) override;
+
+    private:
+        Settings LoadSettings() const;
+        int UpdateLevel(const Settings& settings, __int64 packetTimestamp);
+        static unsigned int LevelPressure(const Settings& settings, int level);
+
+        static __int64 Now();
+
+        // Odd while the settings are being written.
+        volatile long _settingsVersion;
+        Settings _settings;
+        volatile int _queueDepth;
+        volatile int _level;
+        bool _hasLagBaseline;
+        __int64 _lagBaseline;
+        PacketFlowTable _flows;
+        PacketLoadSheddingCounters _counters;
+    };
+}}
@@ -0,0 +1,70 @@
+#include "PacketLoadSheddingStatistics.h"
+
+#include "PacketLoadSheddingStage.h"
+
+using namespace System;
+using namespace System::Globalization;
+using namespace PcapDotNet::Core;
+
+PacketLoadSheddingLevel PacketLoadSheddingStatistics::Level::get()
+{
+    return _level;
+}
+
+unsigned __int64 PacketLoadSheddingStatistics::PacketsPassed::get()
+{
+    return _packetsPassed;
+}
+
+unsigned __int64 PacketLoadSheddingStatistics::PacketsTruncated::get()
+{
+    return _packetsTruncated;
+}
+
+unsigned __int64 PacketLoadSheddingStatistics::BytesTruncated::get()
+{
+    return _bytesTruncated;
+}
+
+unsigned __int64 PacketLoadSheddingStatistics::PacketsSampledOut::get()
+{
+    return _packetsSampledOut;
+}
+
+unsigned __int64 PacketLoadSheddingStatistics::BytesSampledOut::get()
+{
+    return _bytesSampledOut;
+}
+
+unsigned __int64 PacketLoadSheddingStatistics::PacketsDroppedAsBulk::get()
+{
+    return _packetsDroppedAsBulk;
+}
+
+unsigned __int64 PacketLoadSheddingStatistics::BytesDroppedAsBulk::get()
+{
+    return _bytesDroppedAsBulk;
+}
+
+unsigned __int64 PacketLoadSheddingStatistics::TotalPackets::get()
+{
+    return _packetsPassed + _packetsTruncated + _packetsSampledOut + _packetsDroppedAsBulk;
+}
+
+String^ PacketLoadSheddingStatistics::ToString()
+{
+    return String::Format(CultureInfo::InvariantCulture,
+                          "{0}: Passed {1}. Truncated {2} ({3} bytes). Sampled out {4} ({5} bytes). Dropped as bulk {6} ({7} bytes).",
+                          _level, _packetsPassed, _packetsTruncated, _bytesTruncated, _packetsSampledOut, _bytesSampledOut, _packetsDroppedAsBulk, _bytesDroppedAsBulk);
+}
+
+// Internal
+
+PacketLoadSheddingStatistics::PacketLoadSheddingStatistics(PacketLoadSheddingLevel level, const PacketLoadSheddingCounters& counters)
+    : _level(level),
+      _packetsPassed(counters.packetsPassed),
+      _packetsTruncated(counters.packetsTruncated), _bytesTruncated(counters.bytesTruncated),
+      _packetsSampledOut(counters.packetsSampledOut), _bytesSampledOut(counters.bytesSampledOut),
+      _packetsDroppedAsBulk(counters.packetsDroppedAsBulk), _bytesDroppedAsBulk(counters.bytesDroppedAsBulk)
+{
+}
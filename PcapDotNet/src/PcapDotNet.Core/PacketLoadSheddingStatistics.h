@@ -0,0 +1,103 @@
+#pragma once
+
+#include "PacketLoadSheddingLevel.h"
+
+namespace PcapDotNet { namespace Core
+{
+    struct PacketLoadSheddingCounters;
+
+    /// <summary>
+    /// What a PacketLoadShedder did to the packets it processed.
+    /// Every packet is counted by exactly one of the packets properties.
+    /// </summary>
+    public ref class PacketLoadSheddingStatistics sealed
+    {
+    public:
+        /// <summary>
+        /// The level when the statistics were taken.
+        /// </summary>
+        property PacketLoadSheddingLevel Level
+        {
+            PacketLoadSheddingLevel get();
+        }
+
+        /// <summary>
+        /// The number of packets delivered without a change.
+        /// </summary>
+        property unsigned __int64 PacketsPassed
+        {
+            unsigned __int64 get();
+        }
+
+        /// <summary>
+        /// The number of packets delivered truncated to their headers.
+        /// </summary>
+        property unsigned __int64 PacketsTruncated
+        {
+            unsigned __int64 get();
+        }
+
+        /// <summary>
+        /// The number of payload bytes removed by truncation.
+        /// </summary>
+        property unsigned __int64 BytesTruncated
+        {
+            unsigned __int64 get();
+        }
+
+        /// <summary>
+        /// The number of packets dropped because their flow wasn't sampled.
+        /// </summary>
+        property unsigned __int64 PacketsSampledOut
+        {
+            unsigned __int64 get();
+        }
+
+        /// <summary>
+        /// The original length in bytes of the packets dropped because their flow wasn't sampled.
+        /// </summary>
+        property unsigned __int64 BytesSampledOut
+        {
+            unsigned __int64 get();
+        }
+
+        /// <summary>
+        /// The number of packets dropped because they belong to a bulk flow.
+        /// </summary>
+        property unsigned __int64 PacketsDroppedAsBulk
+        {
+            unsigned __int64 get();
+        }
+
+        /// <summary>
+        /// The original length in bytes of the packets dropped because they belong to a bulk flow.
+        /// </summary>
+        property unsigned __int64 BytesDroppedAsBulk
+        {
+            unsigned __int64 get();
+        }
+
+        /// <summary>
+        /// The number of packets that were processed.
+        /// </summary>
+        property unsigned __int64 TotalPackets
+        {
+            unsigned __int64 get();
+        }
+
+        virtual System::String^ ToString() override;
+
+    internal:
+        PacketLoadSheddingStatistics(PacketLoadSheddingLevel level, const PacketLoadSheddingCounters& counters);
+
+    private:
+        PacketLoadSheddingLevel _level;
+        unsigned __int64 _packetsPassed;
+        unsigned __int64 _packetsTruncated;
+        unsigned __int64 _bytesTruncated;
+        unsigned __int64 _packetsSampledOut;
+        unsigned __int64 _bytesSampledOut;
+        unsigned __int64 _packetsDroppedAsBulk;
+        unsigned __int64 _bytesDroppedAsBulk;
+    };
+}}
@@ -0,0 +1,74 @@
+#include "PacketLoopBreaker.h"
+
+#include "Pcap.h"
+
+using namespace PcapDotNet::Core;
+
+#pragma managed(push, off)
+
+PacketLoopBreaker::PacketLoopBreaker(pcap_t* pcapDescriptor)
+    : _pcapDescriptor(pcapDescriptor), _state(Idle), _hasStarted(false)
+{
+}
+
+void PacketLoopBreaker::BeginLoop()
+{
+    _hasStarted = true;
+
+    long state;
+    while ((state = InterlockedCompareExchange(&_state, Receiving, Idle)) == Breaking)
+        YieldProcessor();
+
+    // A break requested before the call set the flag, so the call returns -2 before reading any packet.
+    if (state == BreakPending)
+        InterlockedExchange(&_state, BreakRequested);
+}
+
+void PacketLoopBreaker::EndLoop(int result)
+{
+    // Wait for a Break() that is between marking the break and calling pcap_breakloop().
+    long state;
+    while ((state = InterlockedCompareExchange(&_state, Idle, Receiving)) == Breaking)
+        YieldProcessor();
+
+    if (state != BreakRequested)
+        return;
+
+    InterlockedExchange(&_state, Idle);
+
+    // pcap_breakloop() was called exactly once during this call, and -2 means the call consumed the flag.
+    // Otherwise the flag is still set, and a pcap call clears it and returns -2 before reading any packet.
+    if (result != -2)
+        pcap_dispatch(_pcapDescriptor, 1, &PacketLoopBreaker::IgnorePacket, NULL);
+}
+
+void PacketLoopBreaker::Break()
+{
+    for (;;)
+    {
+        long state = _state;
+
+        // The flag is already set or being set.
+        if (state != Receiving && state != Idle)
+            return;
+
+        if (InterlockedCompareExchange(&_state, Breaking, state) != state)
+            continue;
+
+        pcap_breakloop(_pcapDescriptor);
+        InterlockedExchange(&_state, state == Receiving ? BreakRequested : BreakPending);
+        return;
+    }
+}
+
+bool PacketLoopBreaker::HasStarted() const
+{
+    return _hasStarted;
+}
+
+// static
+void PacketLoopBreaker::IgnorePacket(unsigned char*, const pcap_pkthdr*, const unsigned char*)
+{
+}
+
+#pragma managed(pop)
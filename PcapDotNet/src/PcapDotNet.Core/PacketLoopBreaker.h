@@ -0,0 +1,43 @@
+#pragma once
+
+#include "PcapDeclarations.h"
+
+namespace PcapDotNet { namespace Core
+{
+    // Keeps a pcap_breakloop() that arrives while a pcap call is reading packets from leaking into the next call.
+    // pcap_breakloop() sets a flag that is only cleared by a call that returns -2 because of it.
+    // If the call returns for another reason, like the end of the file or the packets count, the flag stays set and the next call returns -2 immediately.
+    // A break requested when no call is reading packets still makes the next call return -2, like pcap_breakloop() does.
+    class PacketLoopBreaker
+    {
+    public:
+        explicit PacketLoopBreaker(pcap_t* pcapDescriptor);
+
+        // Called by the receiving thread around every pcap call that reads packets.
+        // result is the value returned by the pcap call.
+        void BeginLoop();
+        void EndLoop(int result);
+
+        // Can be called from any thread.
+        void Break();
+
+        // Whether a pcap call read packets from the descriptor, which starts the capture of remote sources.
+        bool HasStarted() const;
+
+    private:
+        static const long Idle = 0;
+        static const long Receiving = 1;
+        static const long Breaking = 2;
+        static const long BreakRequested = 3;
+        static const long BreakPending = 4;
+
+        static void IgnorePacket(unsigned char* user, const pcap_pkthdr* packetHeader, const unsigned char* packetData);
+
+        pcap_t* _pcapDescriptor;
+        volatile long _state;
+        volatile bool _hasStarted;
+
+        PacketLoopBreaker(const PacketLoopBreaker&) = delete;
+        PacketLoopBreaker& operator=(const PacketLoopBreaker&) = delete;
+    };
+}}
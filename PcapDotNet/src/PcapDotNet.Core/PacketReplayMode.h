@@ -0,0 +1,25 @@
+#pragma once
+
+namespace PcapDotNet { namespace Core
+{
+    /// <summary>
+    /// How a PacketReplayer schedules the packets it sends.
+    /// </summary>
+    public enum class PacketReplayMode : int
+    {
+        /// <summary>The packets are sent with the same intervals they have in the file.</summary>
+        OriginalTiming = 0,
+
+        /// <summary>The intervals of the file are divided by PacketReplayer.Multiplier.</summary>
+        Multiplier = 1,
+
+        /// <summary>The packets are sent at a fixed rate of PacketReplayer.PacketsPerSecond.</summary>
+        PacketsPerSecond = 2,
+
+        /// <summary>The packets are sent at a fixed rate of PacketReplayer.BitsPerSecond, counting the bytes of every packet.</summary>
+        BitsPerSecond = 3,
+
+        /// <summary>The packets are sent as fast as possible.</summary>
+        AsFastAsPossible = 4
+    };
+}}
@@ -0,0 +1,62 @@
+#include "PacketReplayStatistics.h"
+
+using namespace System;
+using namespace System::Globalization;
+using namespace PcapDotNet::Core;
+
+unsigned __int64 PacketReplayStatistics::PacketsSent::get()
+{
+    return _packetsSent;
+}
+
+unsigned __int64 PacketReplayStatistics::BytesSent::get()
+{
+    return _bytesSent;
+}
+
+unsigned __int64 PacketReplayStatistics::BatchesSent::get()
+{
+    return _batchesSent;
+}
+
+TimeSpan PacketReplayStatistics::Elapsed::get()
+{
+    return _elapsed;
+}
+
+double PacketReplayStatistics::PacketsPerSecond::get()
+{
+    double seconds = _elapsed.TotalSeconds;
+    return seconds == 0 ? 0 : _packetsSent / seconds;
+}
+
+double PacketReplayStatistics::BitsPerSecond::get()
+{
+    double seconds = _elapsed.TotalSeconds;
+    return seconds == 0 ? 0 : _bytesSent * 8 / seconds;
+}
+
+TimeSpan PacketReplayStatistics::AveragePacingError::get()
+{
+    return _batchesSent == 0 ? TimeSpan::Zero : TimeSpan::FromTicks(_totalPacingError.Ticks / static_cast<__int64>(_batchesSent));
+}
+
+TimeSpan PacketReplayStatistics::MaximumPacingError::get()
+{
+    return _maximumPacingError;
+}
+
+String^ PacketReplayStatistics::ToString()
+{
+    return String::Format(CultureInfo::InvariantCulture, "{0} packets, {1} bytes in {2}. {3:F0} pps, {4:F0} bps. Pacing error average {5} maximum {6}",
+                          _packetsSent, _bytesSent, _elapsed, PacketsPerSecond, BitsPerSecond, AveragePacingError, _maximumPacingError);
+}
+
+// Internal
+
+PacketReplayStatistics::PacketReplayStatistics(unsigned __int64 packetsSent, unsigned __int64 bytesSent, unsigned __int64 batchesSent, TimeSpan elapsed,
+                                               TimeSpan totalPacingError, TimeSpan maximumPacingError)
+    : _packetsSent(packetsSent), _bytesSent(bytesSent), _batchesSent(batchesSent), _elapsed(elapsed),
+      _totalPacingError(totalPacingError), _maximumPacingError(maximumPacingError)
+{
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+namespace PcapDotNet { namespace Core
+{
+    /// <summary>
+    /// What a PacketReplayer sent and how well it kept the schedule.
+    /// </summary>
+    public ref class PacketReplayStatistics sealed
+    {
+    public:
+        /// <summary>
+        /// The number of packets sent.
+        /// </summary>
+        property unsigned __int64 PacketsSent
+        {
+            unsigned __int64 get();
+        }
+
+        /// <summary>
+        /// The number of bytes sent, not including the pcap headers.
+        /// </summary>
+        property unsigned __int64 BytesSent
+        {
+            unsigned __int64 get();
+        }
+
+        /// <summary>
+        /// The number of send buffers transmitted.
+        /// </summary>
+        property unsigned __int64 BatchesSent
+        {
+            unsigned __int64 get();
+        }
+
+        /// <summary>
+        /// The time since the replay started.
+        /// </summary>
+        property System::TimeSpan Elapsed
+        {
+            System::TimeSpan get();
+        }
+
+        /// <summary>
+        /// The achieved rate in packets per second.
+        /// </summary>
+        property double PacketsPerSecond
+        {
+            double get();
+        }
+
+        /// <summary>
+        /// The achieved rate in bits per second.
+        /// </summary>
+        property double BitsPerSecond
+        {
+            double get();
+        }
+
+        /// <summary>
+        /// The average time the batches started after they were due.
+        /// </summary>
+        property System::TimeSpan AveragePacingError
+        {
+            System::TimeSpan get();
+        }
+
+        /// <summary>
+        /// The longest time a batch started after it was due.
+        /// </summary>
+        property System::TimeSpan MaximumPacingError
+        {
+            System::TimeSpan get();
+        }
+
+        virtual System::String^ ToString() override;
+
+    internal:
+        PacketReplayStatistics(unsigned __int64 packetsSent, unsigned __int64 bytesSent, unsigned __int64 batchesSent, System::TimeSpan elapsed,
+                               System::TimeSpan totalPacingError, System::TimeSpan maximumPacingError);
+
+    private:
+        unsigned __int64 _packetsSent;
+        unsigned __int64 _bytesSent;
+        unsigned __int64 _batchesSent;
+        System::TimeSpan _elapsed;
+        System::TimeSpan _totalPacingError;
+        System::TimeSpan _maximumPacingError;
+    };
+}}
@@ -0,0 +1,361 @@
+#include "PacketReplayer.h"
+
+#include "OfflinePacketCommunicator.h"
+#include "PcapError.h"
+#include "Pcap.h"
+
+using namespace System;
+using namespace System::Collections::Concurrent;
+using namespace System::Diagnostics;
+using namespace System::Runtime::ExceptionServices;
+using namespace System::Threading;
+using namespace PcapDotNet::Core;
+
+PacketReplayer::PacketReplayer(LivePacketCommunicator^ communicator, String^ fileName)
+{
+    if (communicator == nullptr)
+        throw gcnew ArgumentNullException("communicator");
+    if (fileName == nullptr)
+        throw gcnew ArgumentNullException("fileName");
+
+    _communicator = communicator;
+    _fileName = fileName;
+    _mode = PacketReplayMode::OriginalTiming;
+    _multiplier = 1;
+    _packetsPerSecond = 1000;
+    _bitsPerSecond = 100 * 1000 * 1000;
+    _loopCount = 1;
+    _batchSize = DefaultBatchSize;
+}
+
+LivePacketCommunicator^ PacketReplayer::Communicator::get()
+{
+    return _communicator;
+}
+
+String^ PacketReplayer::FileName::get()
+{
+    return _fileName;
+}
+
+PacketReplayMode PacketReplayer::Mode::get()
+{
+    return _mode;
+}
+
+void PacketReplayer::Mode::set(PacketReplayMode value)
+{
+    _mode = value;
+}
+
+double PacketReplayer::Multiplier::get()
+{
+    return _multiplier;
+}
+
+void PacketReplayer::Multiplier::set(double value)
+{
+    AssertPositive("value", value);
+    _multiplier = value;
+}
+
+double PacketReplayer::PacketsPerSecond::get()
+{
+    return _packetsPerSecond;
+}
+
+void PacketReplayer::PacketsPerSecond::set(double value)
+{
+    AssertPositive("value", value);
+    _packetsPerSecond = value;
+}
+
+double PacketReplayer::BitsPerSecond::get()
+{
+    return _bitsPerSecond;
+}
+
+void PacketReplayer::BitsPerSecond::set(double value)
+{
+    AssertPositive("value", value);
+    _bitsPerSecond = value;
+}
+
+int PacketReplayer::LoopCount::get()
+{
+    return _loopCount;
+}
+
+void PacketReplayer::LoopCount::set(int value)
+{
+    if (value < 0)
+        throw gcnew ArgumentOutOfRangeException("value", value, "Must be non negative");
+    _loopCount = value;
+}
+
+int PacketReplayer::BatchSize::get()
+{
+    return _batchSize;
+}
+
+void PacketReplayer::BatchSize::set(int value)
+{
+    if (value <= 0)
+        throw gcnew ArgumentOutOfRangeException("value", value, "Must be positive");
+    _batchSize = value;
+}
+
+PacketReplayStatistics^ PacketReplayer::Statistics::get()
+{
+    TimeSpan elapsed = _stopwatch == nullptr ? TimeSpan::Zero : _stopwatch->Elapsed;
+    return gcnew PacketReplayStatistics(_packetsSent, _bytesSent, _batchesSent, elapsed,
+                                        TimeSpan::FromSeconds(static_cast<double>(_totalPacingErrorTicks) / Stopwatch::Frequency),
+                                        TimeSpan::FromSeconds(static_cast<double>(_maximumPacingErrorTicks) / Stopwatch::Frequency));
+}
+
+PacketReplayStatistics^ PacketReplayer::Replay()
+{
+    _stopRequested = false;
+    _cancellation = gcnew CancellationTokenSource();
+    _readException = nullptr;
+    _batch = nullptr;
+    _scheduledPackets = 0;
+    _scheduledBits = 0;
+    _packetsSent = 0;
+    _bytesSent = 0;
+    _batchesSent = 0;
+    _totalPacingErrorTicks = 0;
+    _maximumPacingErrorTicks = 0;
+
+    array<Batch^>^ batches = gcnew array<Batch^>(NumBatches);
+    _freeBatches = gcnew BlockingCollection<Batch^>();
+    _fullBatches = gcnew BlockingCollection<Batch^>();
+    Thread^ readThread = nullptr;
+    try
+    {
+        for (int i = 0; i != NumBatches; ++i)
+        {
+            batches[i] = gcnew Batch(_batchSize);
+            _freeBatches->Add(batches[i]);
+        }
+
+        _stopwatch = Stopwatch::StartNew();
+        readThread = gcnew Thread(gcnew ThreadStart(this, &PacketReplayer::ReadBatches));
+        readThread->IsBackground = true;
+        readThread->Start();
+
+        for each (Batch^ batch in _fullBatches->GetConsumingEnumerable())
+        {
+            // After Stop() the batches that were already read are discarded.
+            if (!_stopRequested)
+                TransmitBatch(batch);
+            batch->Buffer->Clear();
+            batch->Bytes = 0;
+            batch->PayloadBytes = 0;
+            _freeBatches->Add(batch);
+        }
+        _stopwatch->Stop();
+    }
+    finally
+    {
+        // Releases the reading thread if sending failed.
+        _cancellation->Cancel();
+        if (readThread != nullptr)
+            readThread->Join();
+
+        for each (Batch^ batch in batches)
+        {
+            if (batch != nullptr)
+                delete batch->Buffer;
+        }
+    }
+
+    if (_readException != nullptr)
+        _readException->Throw();
+
+    return Statistics;
+}
+
+void PacketReplayer::Stop()
+{
+    _stopRequested = true;
+
+    CancellationTokenSource^ cancellation = _cancellation;
+    if (cancellation != nullptr)
+        cancellation->Cancel();
+}
+
+// Private
+
+PacketReplayer::Batch::Batch(int size)
+{
+    Buffer = gcnew PacketSendBuffer(size);
+}
+
+void PacketReplayer::ReadBatches()
+{
+    try
+    {
+        unsigned __int64 passOffset = 0;
+        for (int pass = 0; (_loopCount == 0 || pass != _loopCount) && !_stopRequested; ++pass)
+        {
+            unsigned __int64 passPackets = 0;
+            passOffset = ReadFile(passOffset, passPackets);
+
+            // Another pass over a file without packets would read it again forever.
+            if (passPackets == 0)
+                break;
+        }
+
+        if (_batch != nullptr && _batch->Bytes != 0)
+            CompleteBatch();
+    }
+    catch (OperationCanceledException^)
+    {
+        // Stop() was called or sending failed.
+    }
+    catch (Exception^ exception)
+    {
+        _readException = ExceptionDispatchInfo::Capture(exception);
+    }
+    finally
+    {
+        _fullBatches->CompleteAdding();
+    }
+}
+
+unsigned __int64 PacketReplayer::ReadFile(unsigned __int64 passOffset, unsigned __int64% passPackets)
+{
+    pcap_t* pcapDescriptor = OfflinePacketCommunicator::OpenFile(_fileName);
+    try
+    {
+        bool hasFirstTimestamp = false;
+        __int64 firstTimestamp = 0;
+        unsigned __int64 offset = passOffset;
+        while (!_stopRequested)
+        {
+            pcap_pkthdr* packetHeader;
+            const unsigned char* packetData;
+            int result = pcap_next_ex(pcapDescriptor, &packetHeader, &packetData);
+            if (result == -2)
+                break;
+            if (result != 1)
+                throw PcapError::BuildInvalidOperation("Failed reading from file " + _fileName, pcapDescriptor);
+            ++passPackets;
+
+            __int64 timestamp = static_cast<__int64>(packetHeader->ts.tv_sec) * 1000000 + packetHeader->ts.tv_usec;
+            if (!hasFirstTimestamp)
+            {
+                firstTimestamp = timestamp;
+                hasFirstTimestamp = true;
+            }
+            offset = ScheduleOffset(passOffset, timestamp - firstTimestamp, packetHeader->caplen);
+
+            int packetBytes = static_cast<int>(sizeof(pcap_pkthdr) + packetHeader->caplen);
+            if (_batch != nullptr && (_batch->Bytes > _batchSize - packetBytes || offset - _batch->StartOffset >= MaximumBatchSpan))
+                CompleteBatch();
+            if (_batch == nullptr)
+            {
+                // Waits for the sending thread to free a batch.
+                _batch = _freeBatches->Take(_cancellation->Token);
+                _batch->StartOffset = offset;
+            }
+
+            // Only the differences between the timestamps matter to a synchronized transmit.
+            pcap_pkthdr sendHeader;
+            sendHeader.ts.tv_sec = static_cast<long>(offset / 1000000);
+            sendHeader.ts.tv_usec = static_cast<long>(offset % 1000000);
+            sendHeader.caplen = packetHeader->caplen;
+            sendHeader.len = packetHeader->caplen;
+            _batch->Buffer->Append(sendHeader, packetData);
+
+            _batch->Bytes += packetBytes;
+            _batch->PayloadBytes += packetHeader->caplen;
+        }
+
+        return offset;
+    }
+    finally
+    {
+        pcap_close(pcapDescriptor);
+    }
+}
+
+unsigned __int64 PacketReplayer::ScheduleOffset(unsigned __int64 passOffset, __int64 fileOffset, unsigned int packetLength)
+{
+    // Packets out of order in the file are sent right away.
+    if (fileOffset < 0)
+        fileOffset = 0;
+
+    unsigned __int64 offset;
+    switch (_mode)
+    {
+    case PacketReplayMode::OriginalTiming:
+        offset = passOffset + fileOffset;
+        break;
+    case PacketReplayMode::Multiplier:
+        offset = passOffset + static_cast<unsigned __int64>(fileOffset / _multiplier);
+        break;
+    case PacketReplayMode::PacketsPerSecond:
+        offset = static_cast<unsigned __int64>(_scheduledPackets * 1000000.0 / _packetsPerSecond);
+        break;
+    case PacketReplayMode::BitsPerSecond:
+        offset = static_cast<unsigned __int64>(_scheduledBits * 1000000.0 / _bitsPerSecond);
+        break;
+    default:
+        offset = 0;
+        break;
+    }
+
+    ++_scheduledPackets;
+    _scheduledBits += packetLength * 8;
+    return offset;
+}
+
+void PacketReplayer::CompleteBatch()
+{
+    _fullBatches->Add(_batch);
+    _batch = nullptr;
+}
+
+void PacketReplayer::TransmitBatch(Batch^ batch)
+{
+    bool isSync = _mode != PacketReplayMode::AsFastAsPossible;
+    if (!isSync || WaitUntil(batch->StartOffset))
+    {
+        _communicator->Transmit(batch->Buffer, isSync);
+        _packetsSent += batch->Buffer->Length;
+        _bytesSent += batch->PayloadBytes;
+        ++_batchesSent;
+    }
+}
+
+bool PacketReplayer::WaitUntil(unsigned __int64 offset)
+{
+    __int64 dueTicks = static_cast<__int64>(offset / 1000000.0 * Stopwatch::Frequency);
+
+    // Sleeping is only accurate to a few milliseconds, so spin for the rest.
+    __int64 sleepThresholdTicks = Stopwatch::Frequency / 500;
+    __int64 remainingTicks;
+    while ((remainingTicks = dueTicks - _stopwatch->ElapsedTicks) > 0)
+    {
+        if (_stopRequested)
+            return false;
+        if (remainingTicks > sleepThresholdTicks)
+            Thread::Sleep(1);
+        else
+            Thread::SpinWait(20);
+    }
+
+    __int64 pacingErrorTicks = -remainingTicks;
+    _totalPacingErrorTicks += pacingErrorTicks;
+    _maximumPacingErrorTicks = Math::Max(_maximumPacingErrorTicks, pacingErrorTicks);
+    return !_stopRequested;
+}
+
+// static
+void PacketReplayer::AssertPositive(String^ name, double value)
+{
+    if (!(value > 0))
+        throw gcnew ArgumentOutOfRangeException(name, value, "Must be positive");
+}
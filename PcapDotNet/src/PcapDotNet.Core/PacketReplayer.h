@@ -0,0 +1,198 @@
+#pragma once
+
+#include "LivePacketCommunicator.h"
+#include "PacketReplayMode.h"
+#include "PacketReplayStatistics.h"
+
+namespace PcapDotNet { namespace Core
+{
+    /// <summary>
+    /// Sends the packets of a dump file to the network, keeping their original timing or a given rate.
+    /// </summary>
+    /// <remarks>
+    ///   <para>
+    ///   The file is read natively ahead of the schedule into send buffers of BatchSize bytes, and every buffer is transmitted with a single synchronized Transmit() call,
+    ///   so the driver paces the packets inside a batch.
+    ///   The file is read on a separate thread into one buffer while the previous buffer is sent, so reading never delays the sending.
+    ///   Before transmitting a batch the replayer sleeps until it is almost due and then spins until the first packet of the batch is due.
+    ///   A batch never covers more than a second of the schedule, so Stop() takes effect within about a second.
+    ///   </para>
+    ///   <para>The pacing error is the time each batch started after it was due.</para>
+    /// </remarks>
+    public ref class PacketReplayer sealed
+    {
+    public:
+        /// <summary>
+        /// The default number of bytes read ahead into a single send buffer.
+        /// </summary>
+        static const int DefaultBatchSize = 1024 * 1024;
+
+        /// <summary>
+        /// Creates a replayer that sends the packets of the given file using the given communicator.
+        /// The file is opened when Replay() is called.
+        /// </summary>
+        /// <param name="communicator">The communicator to send the packets with.</param>
+        /// <param name="fileName">The dump file to replay.</param>
+        /// <exception cref="System::ArgumentNullException">The communicator or the file name is null.</exception>
+        PacketReplayer(LivePacketCommunicator^ communicator, System::String^ fileName);
+
+        /// <summary>
+        /// The communicator the packets are sent with.
+        /// </summary>
+        property LivePacketCommunicator^ Communicator
+        {
+            LivePacketCommunicator^ get();
+        }
+
+        /// <summary>
+        /// The dump file to replay.
+        /// </summary>
+        property System::String^ FileName
+        {
+            System::String^ get();
+        }
+
+        /// <summary>
+        /// How the packets are scheduled. OriginalTiming by default.
+        /// </summary>
+        property PacketReplayMode Mode
+        {
+            PacketReplayMode get();
+            void set(PacketReplayMode value);
+        }
+
+        /// <summary>
+        /// The speed up of the file timing used in Multiplier mode. 1 by default.
+        /// </summary>
+        /// <exception cref="System::ArgumentOutOfRangeException">The value is not positive.</exception>
+        property double Multiplier
+        {
+            double get();
+            void set(double value);
+        }
+
+        /// <summary>
+        /// The rate used in PacketsPerSecond mode. 1000 by default.
+        /// </summary>
+        /// <exception cref="System::ArgumentOutOfRangeException">The value is not positive.</exception>
+        property double PacketsPerSecond
+        {
+            double get();
+            void set(double value);
+        }
+
+        /// <summary>
+        /// The rate used in BitsPerSecond mode. 100Mbps by default.
+        /// </summary>
+        /// <exception cref="System::ArgumentOutOfRangeException">The value is not positive.</exception>
+        property double BitsPerSecond
+        {
+            double get();
+            void set(double value);
+        }
+
+        /// <summary>
+        /// The number of times the file is replayed. 0 replays it until Stop() is called. 1 by default.
+        /// In OriginalTiming and Multiplier modes every pass starts right after the last packet of the previous pass.
+        /// The replay ends after a pass without packets, so a file without packets is replayed once.
+        /// </summary>
+        /// <exception cref="System::ArgumentOutOfRangeException">The value is negative.</exception>
+        property int LoopCount
+        {
+            int get();
+            void set(int value);
+        }
+
+        /// <summary>
+        /// The number of bytes read ahead into a single send buffer. Every packet takes its length plus the size of a pcap header.
+        /// The replay uses two send buffers.
+        /// </summary>
+        /// <exception cref="System::ArgumentOutOfRangeException">The value is not positive.</exception>
+        property int BatchSize
+        {
+            int get();
+            void set(int value);
+        }
+
+        /// <summary>
+        /// The statistics of the current or last replay.
+        /// While Replay() runs on another thread the values are approximate.
+        /// </summary>
+        property PacketReplayStatistics^ Statistics
+        {
+            PacketReplayStatistics^ get();
+        }
+
+        /// <summary>
+        /// Replays the file. Returns when all the passes were sent or Stop() was called.
+        /// </summary>
+        /// <returns>The statistics of the replay.</returns>
+        /// <exception cref="System::InvalidOperationException">Failed opening or reading the file or sending the packets.</exception>
+        PacketReplayStatistics^ Replay();
+
+        /// <summary>
+        /// Makes Replay() return. Can be called from any thread. The batch that wasn't transmitted yet is discarded.
+        /// </summary>
+        void Stop();
+
+    private:
+        // A send buffer and the schedule of its packets, passed from the reading thread to the sending thread.
+        ref class Batch sealed
+        {
+        public:
+            Batch(int size);
+
+            PacketSendBuffer^ Buffer;
+            int Bytes;
+            unsigned __int64 PayloadBytes;
+            unsigned __int64 StartOffset;
+        };
+
+        // The reading thread.
+        void ReadBatches();
+        unsigned __int64 ReadFile(unsigned __int64 passOffset, unsigned __int64% passPackets);
+        unsigned __int64 ScheduleOffset(unsigned __int64 passOffset, __int64 fileOffset, unsigned int packetLength);
+        void CompleteBatch();
+
+        // The sending thread.
+        void TransmitBatch(Batch^ batch);
+        bool WaitUntil(unsigned __int64 offset);
+
+        static void AssertPositive(System::String^ name, double value);
+
+        // A batch never covers more than this many microseconds of the schedule.
+        static const int MaximumBatchSpan = 1000 * 1000;
+
+        // One batch is read while the other is sent.
+        static const int NumBatches = 2;
+
+    private:
+        LivePacketCommunicator^ _communicator;
+        System::String^ _fileName;
+        PacketReplayMode _mode;
+        double _multiplier;
+        double _packetsPerSecond;
+        double _bitsPerSecond;
+        int _loopCount;
+        int _batchSize;
+
+        volatile bool _stopRequested;
+        System::Threading::CancellationTokenSource^ _cancellation;
+        System::Diagnostics::Stopwatch^ _stopwatch;
+
+        System::Collections::Concurrent::BlockingCollection<Batch^>^ _freeBatches;
+        System::Collections::Concurrent::BlockingCollection<Batch^>^ _fullBatches;
+        System::Runtime::ExceptionServices::ExceptionDispatchInfo^ _readException;
+
+        // Owned by the reading thread.
+        Batch^ _batch;
+        unsigned __int64 _scheduledPackets;
+        unsigned __int64 _scheduledBits;
+
+        unsigned __int64 _packetsSent;
+        unsigned __int64 _bytesSent;
+        unsigned __int64 _batchesSent;
+        __int64 _totalPacingErrorTicks;
+        __int64 _maximumPacingErrorTicks;
+    };
+}}
@@ -32,4 +32,9 @@ PacketSampleStatistics::PacketSampleStatistics(const pcap_pkthdr& packetHeader,
 
     _acceptedPackets = *reinterpret_cast<const unsigned __int64*>(packetData);
     _acceptedBytes = *reinterpret_cast<const unsigned __int64*>(packetData + 8);
+}
+
+PacketSampleStatistics::PacketSampleStatistics(DateTime timestamp, unsigned __int64 acceptedPackets, unsigned __int64 acceptedBytes)
+    : _timestamp(timestamp), _acceptedPackets(acceptedPackets), _acceptedBytes(acceptedBytes)
+{
 }
\ No newline at end of file
@@ -38,6 +38,7 @@ namespace PcapDotNet { namespace Core
 
     internal:
         PacketSampleStatistics(const pcap_pkthdr& packetHeader, const unsigned char* packetData);
+        PacketSampleStatistics(System::DateTime timestamp, unsigned __int64 acceptedPackets, unsigned __int64 acceptedBytes);
 
     private:
         System::DateTime _timestamp;
@@ -0,0 +1,108 @@
+#include "PacketSamplingStage.h"
+
+#include "PacketFlowParser.h"
+#include "Pcap.h"
+
+using namespace PcapDotNet::Core;
+
+#pragma managed(push, off)
+
+PacketSamplingStage::PacketSamplingStage()
+    : _settingsVersion(0), _dataLink(0), _appliedVersion(0), _packetCounter(0), _hasSampled(false), _lastSampledTimestamp(0)
+{
+    _settings.method = MethodNone;
+    _settings.value = 0;
+}
+
+void PacketSamplingStage::SetMethod(int method, unsigned int value)
+{
+    // Making the version odd also keeps other writers out.
+    long version;
+    do
+    {
+        version = _settingsVersion & ~1L;
+    }
+    while (InterlockedCompareExchange(&_settingsVersion, version + 1, version) != version);
+
+    _settings.method = method;
+    _settings.value = value;
+    InterlockedExchange(&_settingsVersion, version + 2);
+}
+
+bool PacketSamplingStage::IsSampling() const
+{
+    long version;
+    return LoadSettings(version).method != MethodNone;
+}
+
+void PacketSamplingStage::Attach(int dataLink)
+{
+    _dataLink = dataLink;
+}
+
+bool PacketSamplingStage::Process(pcap_pkthdr& packetHeader, const unsigned char* packetData)
+{
+    long version;
+    Settings settings = LoadSettings(version);
+    if (version != _appliedVersion)
+    {
+        _appliedVersion = version;
+        _packetCounter = 0;
+        _hasSampled = false;
+    }
+
+    switch (settings.method)
+    {
+    case MethodOneEveryCount:
+        // Like WinPcap, the first count - 1 packets are discarded.
+        if (++_packetCounter < settings.value)
+            return false;
+        _packetCounter = 0;
+        return true;
+
+    case MethodFirstAfterInterval:
+    {
+        unsigned __int64 packetTimestamp = static_cast<unsigned __int64>(packetHeader.ts.tv_sec) * 1000000 + packetHeader.ts.tv_usec;
+        if (_hasSampled && packetTimestamp - _lastSampledTimestamp < static_cast<unsigned __int64>(settings.value) * 1000)
+            return false;
+        _hasSampled = true;
+        _lastSampledTimestamp = packetTimestamp;
+        return true;
+    }
+
+    case MethodFlowHash:
+    {
+        // The hash is the same for both directions and in every capture, so the same flows are kept everywhere.
+        // Ethernet packets that aren't IP are sampled by their MAC addresses and EtherType instead.
+        // Other packets have a 0 hash and are always kept.
+        PacketFlowInfo info;
+        PacketFlowParser::Parse(_dataLink, packetData, packetHeader.caplen, info);
+        unsigned __int64 hash = info.flowHash != 0 ? info.flowHash : PacketFlowParser::LinkHash(_dataLink, packetData, packetHeader.caplen);
+        return hash % settings.value == 0;
+    }
+
+    default:
+        return true;
+    }
+}
+
+// Private
+
+PacketSamplingStage::Settings PacketSamplingStage::LoadSettings(long& version) const
+{
+    // Copy again if the settings were written during the copy.
+    for (;;)
+    {
+        version = _settingsVersion;
+        if ((version & 1) == 0)
+        {
+            Settings settings = _settings;
+            MemoryBarrier();
+            if (_settingsVersion == version)
+                return settings;
+        }
+        YieldProcessor();
+    }
+}
+
+#pragma managed(pop)
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "PacketStage.h"
+
+namespace PcapDotNet { namespace Core 
+{
+    // The native part of the sampling methods applied by PacketCommunicator.SetSamplingMethod().
+    // A communicator keeps a single stage for its lifetime and changes its method, so a capture thread never runs a freed stage.
+    class PacketSamplingStage : public PacketStage
+    {
+    public:
+        // Keeps every packet.
+        static const int MethodNone = 0;
+
+        // Keeps the last packet of every count packets.
+        static const int MethodOneEveryCount = 1;
+
+        // Keeps the first packet that arrives after the interval since the last kept packet.
+        static const int MethodFirstAfterInterval = 2;
+
+        // Keeps every packet of one out of count flows.
+        static const int MethodFlowHash = 3;
+
+        PacketSamplingStage();
+
+        // Can be called from any thread. The sampling starts over with the next packet.
+        // value is the count for MethodOneEveryCount and MethodFlowHash and the interval in milliseconds for MethodFirstAfterInterval.
+        void SetMethod(int method, unsigned int value);
+        bool IsSampling() const;
+
+        void Attach(int dataLink);
+
+        virtual bool Process(pcap_pkthdr& packetHeader, const unsigned char* packetData) override;
+
+    private:
+        struct Settings
+        {
+            int method;
+            unsigned int value;
+        };
+
+        // version identifies the returned settings.
+        Settings LoadSettings(long& version) const;
+
+        volatile long _settingsVersion;
+        Settings _settings;
+        int _dataLink;
+
+        // Owned by the capture thread.
+        long _appliedVersion;
+        unsigned int _packetCounter;
+        bool _hasSampled;
+        unsigned __int64 _lastSampledTimestamp;
+
+        PacketSamplingStage(const PacketSamplingStage&) = delete;
+        PacketSamplingStage& operator=(const PacketSamplingStage&) = delete;
+    };
+}}
@@ -1,15 +1,25 @@
 #include "PacketSendBuffer.h"
+
+#include <string.h>
+
 #include "PacketHeader.h"
+#include "PacketTimestamp.h"
 #include "PcapError.h"
 #include "Pcap.h"
 
 using namespace System;
+using namespace System::Collections::Generic;
+using namespace System::Runtime::InteropServices;
 using namespace PcapDotNet::Core;
 using namespace PcapDotNet::Packets;
 
 PacketSendBuffer::PacketSendBuffer(unsigned int capacity)
 {
-    _pcapSendQueue = pcap_sendqueue_alloc(capacity);
+    if (capacity > static_cast<unsigned int>(Int32::MaxValue))
+        throw gcnew ArgumentOutOfRangeException("capacity", capacity, "Must not exceed " + Int32::MaxValue.ToString());
+
+    _pcapSendQueue = new pcap_send_queue();
+    Allocate(capacity);
 }
 
 int PacketSendBuffer::Length::get()
@@ -17,6 +27,11 @@ int PacketSendBuffer::Length::get()
     return _length;
 }
 
+unsigned int PacketSendBuffer::Capacity::get()
+{
+    return _pcapSendQueue->maxlen;
+}
+
 void PacketSendBuffer::Enqueue(Packet^ packet)
 {
 	if (packet == nullptr) 
@@ -24,16 +39,71 @@ void PacketSendBuffer::Enqueue(Packet^ packet)
 
 	pcap_pkthdr pcapHeader;
     PacketHeader::GetPcapHeader(pcapHeader, packet);
-    pin_ptr<Byte> unmanagedPacketBytes = &packet->Buffer[0];
-    if (pcap_sendqueue_queue(_pcapSendQueue, &pcapHeader, unmanagedPacketBytes) != 0)
-        throw gcnew InvalidOperationException("Failed enqueueing to queue");
+    // An empty packet can start at the end of its buffer, where there's no element to pin.
+    pin_ptr<Byte> unmanagedPacketBytes = nullptr;
+    if (packet->Length != 0)
+        unmanagedPacketBytes = &packet->Buffer[packet->StartOffset];
+    Append(pcapHeader, unmanagedPacketBytes);
+}
 
-	++_length;
+void PacketSendBuffer::Enqueue(array<Byte>^ data, int offset, int count, DateTime timestamp)
+{
+    if (data == nullptr)
+        throw gcnew ArgumentNullException("data");
+    if (offset < 0)
+        throw gcnew ArgumentOutOfRangeException("offset", offset, "Must be non negative");
+    if (count <= 0)
+        throw gcnew ArgumentOutOfRangeException("count", count, "Must be positive");
+    if (offset > data->Length - count)
+        throw gcnew ArgumentOutOfRangeException("count", count, "Offset plus count must not exceed the data length " + data->Length.ToString());
+
+    pcap_pkthdr pcapHeader;
+    PacketTimestamp::DateTimeToPcapTimestamp(timestamp, pcapHeader.ts);
+    pcapHeader.caplen = count;
+    pcapHeader.len = count;
+    pin_ptr<Byte> unmanagedPacketBytes = &data[offset];
+    Append(pcapHeader, unmanagedPacketBytes);
+}
+
+void PacketSendBuffer::Enqueue(CompiledPacketBuilder^ builder, DateTime timestamp)
+{
+    if (builder == nullptr)
+        throw gcnew ArgumentNullException("builder");
+
+    int packetLength = builder->Length;
+    builder->BuildInto(_buffer, BeginEnqueue(packetLength));
+    EndEnqueue(packetLength, timestamp);
+}
+
+void PacketSendBuffer::Enqueue(PacketTemplate^ packetTemplate, DateTime timestamp)
+{
+    if (packetTemplate == nullptr)
+        throw gcnew ArgumentNullException("packetTemplate");
+
+    int packetLength = packetTemplate->Length;
+    packetTemplate->Write(_buffer, BeginEnqueue(packetLength));
+    EndEnqueue(packetLength, timestamp);
+}
+
+void PacketSendBuffer::EnqueueRange(IEnumerable<Packet^>^ packets)
+{
+    if (packets == nullptr)
+        throw gcnew ArgumentNullException("packets");
+
+    for each (Packet^ packet in packets)
+        Enqueue(packet);
+}
+
+void PacketSendBuffer::Clear()
+{
+    _pcapSendQueue->len = 0;
+    _length = 0;
 }
 
 PacketSendBuffer::~PacketSendBuffer()
 {
-    pcap_sendqueue_destroy(_pcapSendQueue);
+    Free();
+    delete _pcapSendQueue;
 }
 
 void PacketSendBuffer::Transmit(pcap_t* pcapDescriptor, bool isSync)
@@ -42,3 +112,88 @@ void PacketSendBuffer::Transmit(pcap_t* pcapDescriptor, bool isSync)
     if (numBytesTransmitted < _pcapSendQueue->len)
         throw PcapError::BuildInvalidOperation("Failed transmiting packets from queue", pcapDescriptor);
 }
+
+// Internal
+
+void PacketSendBuffer::Append(const pcap_pkthdr& pcapHeader, const unsigned char* packetData)
+{
+    Reserve(pcapHeader.caplen);
+    if (pcap_sendqueue_queue(_pcapSendQueue, &pcapHeader, packetData) != 0)
+        throw gcnew InvalidOperationException("Failed enqueueing to queue");
+
+	++_length;
+}
+
+// Private
+
+void PacketSendBuffer::Reserve(unsigned int packetLength)
+{
+    unsigned __int64 requiredCapacity = static_cast<unsigned __int64>(_pcapSendQueue->len) + sizeof(pcap_pkthdr) + packetLength;
+    if (requiredCapacity <= _pcapSendQueue->maxlen)
+        return;
+
+    // Doubling keeps the number of copies logarithmic in the number of packets.
+    // The buffer is a managed array, so it can't grow beyond the maximum array length.
+    const unsigned __int64 maximumCapacity = Int32::MaxValue;
+    unsigned __int64 newCapacity = Math::Max(requiredCapacity, 2 * static_cast<unsigned __int64>(_pcapSendQueue->maxlen));
+    if (newCapacity > maximumCapacity)
+    {
+        if (requiredCapacity > maximumCapacity)
+            throw gcnew InvalidOperationException("Send buffer can't grow beyond " + maximumCapacity.ToString() + " bytes");
+        newCapacity = maximumCapacity;
+    }
+
+    array<Byte>^ oldBuffer = _buffer;
+    unsigned int length = _pcapSendQueue->len;
+    Free();
+    try
+    {
+        Allocate(static_cast<unsigned int>(newCapacity));
+    }
+    catch (OutOfMemoryException^)
+    {
+        Allocate(oldBuffer);
+        throw gcnew OutOfMemoryException("Failed growing send buffer to " + newCapacity.ToString() + " bytes");
+    }
+    Buffer::BlockCopy(oldBuffer, 0, _buffer, 0, length);
+}
+
+// Reserves space for a packet and returns the offset in the buffer to write the packet to.
+int PacketSendBuffer::BeginEnqueue(int packetLength)
+{
+    Reserve(packetLength);
+    return static_cast<int>(_pcapSendQueue->len + sizeof(pcap_pkthdr));
+}
+
+// Writes the header of a packet that was written to the offset returned by BeginEnqueue() and adds the packet to the queue.
+void PacketSendBuffer::EndEnqueue(int packetLength, DateTime timestamp)
+{
+    pcap_pkthdr pcapHeader;
+    PacketTimestamp::DateTimeToPcapTimestamp(timestamp, pcapHeader.ts);
+    pcapHeader.caplen = packetLength;
+    pcapHeader.len = packetLength;
+    memcpy(_pcapSendQueue->buffer + _pcapSendQueue->len, &pcapHeader, sizeof(pcapHeader));
+    _pcapSendQueue->len += sizeof(pcap_pkthdr) + packetLength;
+
+	++_length;
+}
+
+void PacketSendBuffer::Allocate(unsigned int capacity)
+{
+    Allocate(gcnew array<Byte>(capacity));
+}
+
+void PacketSendBuffer::Allocate(array<Byte>^ buffer)
+{
+    _buffer = buffer;
+    _bufferHandle = GCHandle::Alloc(_buffer, GCHandleType::Pinned);
+    _pcapSendQueue->buffer = static_cast<char*>(_bufferHandle.AddrOfPinnedObject().ToPointer());
+    _pcapSendQueue->maxlen = _buffer->Length;
+}
+
+void PacketSendBuffer::Free()
+{
+    if (_bufferHandle.IsAllocated)
+        _bufferHandle.Free();
+    _pcapSendQueue->buffer = NULL;
+}
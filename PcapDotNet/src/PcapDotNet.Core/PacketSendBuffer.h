@@ -7,6 +7,7 @@ namespace PcapDotNet { namespace Core
     /// <summary>
     /// Represents a buffer of packets to be sent.
     /// Note that transmitting a send buffer is much more efficient than performing a series of Send(), because the send buffer is buffered at kernel level drastically decreasing the number of context switches.
+    /// The packets are kept in a pinned managed array, so packet builders and templates can write packets directly into the buffer.
     /// </summary>
     public ref class PacketSendBuffer : System::IDisposable
     {
@@ -14,14 +15,27 @@ namespace PcapDotNet { namespace Core
         /// <summary>
         /// This function allocates a send buffer, i.e. a buffer containing a set of raw packets that will be transimtted on the network with PacketCommunicator.Transmit().
         /// </summary>
-        /// <param name="capacity">The size, in bytes, of the buffer, therefore it determines the maximum amount of data that the buffer will contain.</param>
+        /// <param name="capacity">The initial size, in bytes, of the buffer. The buffer grows when more data is enqueued.</param>
+        /// <exception cref="System::ArgumentOutOfRangeException">The capacity is bigger than the maximum length of a managed array.</exception>
         PacketSendBuffer(unsigned int capacity);
 
+        /// <summary>
+        /// The number of packets in the buffer.
+        /// </summary>
         property int Length
         {
             int get();
         }
 
+        /// <summary>
+        /// The size, in bytes, of the allocated buffer.
+        /// Every packet takes its length plus the size of a pcap header.
+        /// </summary>
+        property unsigned int Capacity
+        {
+            unsigned int get();
+        }
+
         /// <summary>
         /// Adds a raw packet at the end of the send buffer.
         /// 'Raw packet' means that the sending application will have to include the protocol headers, since every packet is sent to the network 'as is'. The CRC of the packets needs not to be calculated, because it will be transparently added by the network interface.
@@ -30,6 +44,51 @@ namespace PcapDotNet { namespace Core
         /// <exception cref="System::InvalidOperationException">Thrown on failure.</exception>
         void Enqueue(Packets::Packet^ packet);
 
+        /// <summary>
+        /// Adds a raw packet given as a segment of a byte array at the end of the send buffer.
+        /// The bytes are copied, so the array can be reused once this method returns.
+        /// </summary>
+        /// <param name="data">The array that contains the packet bytes.</param>
+        /// <param name="offset">The offset in the array of the first byte of the packet.</param>
+        /// <param name="count">The number of bytes in the packet.</param>
+        /// <param name="timestamp">The timestamp used to synchronize the packet when transmitting with isSync.</param>
+        /// <exception cref="System::ArgumentNullException">The data is null.</exception>
+        /// <exception cref="System::ArgumentOutOfRangeException">The offset is negative, the count is not positive or they exceed the array.</exception>
+        /// <exception cref="System::InvalidOperationException">Thrown on failure.</exception>
+        void Enqueue(array<System::Byte>^ data, int offset, int count, System::DateTime timestamp);
+
+        /// <summary>
+        /// Builds a packet directly into the send buffer.
+        /// Space for the packet is reserved at the end of the buffer and the layers are written into it, so the packet bytes are written once.
+        /// </summary>
+        /// <param name="builder">The builder to build the packet with.</param>
+        /// <param name="timestamp">The timestamp used to synchronize the packet when transmitting with isSync.</param>
+        /// <exception cref="System::ArgumentNullException">The builder is null.</exception>
+        /// <exception cref="System::InvalidOperationException">Thrown on failure.</exception>
+        void Enqueue(Packets::CompiledPacketBuilder^ builder, System::DateTime timestamp);
+
+        /// <summary>
+        /// Writes the current packet of a template directly into the send buffer.
+        /// </summary>
+        /// <param name="packetTemplate">The template to write the packet of.</param>
+        /// <param name="timestamp">The timestamp used to synchronize the packet when transmitting with isSync.</param>
+        /// <exception cref="System::ArgumentNullException">The template is null.</exception>
+        /// <exception cref="System::InvalidOperationException">Thrown on failure.</exception>
+        void Enqueue(Packets::PacketTemplate^ packetTemplate, System::DateTime timestamp);
+
+        /// <summary>
+        /// Adds the given packets at the end of the send buffer, in order.
+        /// </summary>
+        /// <param name="packets">The packets to be added to the buffer.</param>
+        /// <exception cref="System::ArgumentNullException">The packets or one of them is null.</exception>
+        /// <exception cref="System::InvalidOperationException">Thrown on failure.</exception>
+        void EnqueueRange(System::Collections::Generic::IEnumerable<Packets::Packet^>^ packets);
+
+        /// <summary>
+        /// Removes all the packets from the buffer, keeping the allocated memory so the buffer can be filled again without allocating.
+        /// </summary>
+        void Clear();
+
         /// <summary>
         /// Deletes a send buffer and frees all the memory associated with it.
         /// </summary>
@@ -37,9 +96,20 @@ namespace PcapDotNet { namespace Core
 
     internal:
         void Transmit(pcap_t* pcapDescriptor, bool isSync);
+        void Append(const pcap_pkthdr& pcapHeader, const unsigned char* packetData);
+
+    private:
+        void Reserve(unsigned int packetLength);
+        int BeginEnqueue(int packetLength);
+        void EndEnqueue(int packetLength, System::DateTime timestamp);
+        void Allocate(unsigned int capacity);
+        void Allocate(array<System::Byte>^ buffer);
+        void Free();
 
     private:
         pcap_send_queue *_pcapSendQueue;
+        array<System::Byte>^ _buffer;
+        System::Runtime::InteropServices::GCHandle _bufferHandle;
 		int _length;
     };
 }}
\ No newline at end of file
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "PcapDeclarations.h"
+
+namespace PcapDotNet { namespace Core 
+{
+    // A native step every received packet goes through before it is copied to a managed Packet.
+    // Stages run inside the pcap callback, so they must not call managed code.
+    class PacketStage
+    {
+    public:
+        virtual ~PacketStage() {}
+
+        // Returns false to discard the packet.
+        // A stage may reduce packetHeader.caplen to truncate the packet. packetHeader.len keeps the original length.
+        virtual bool Process(pcap_pkthdr& packetHeader, const unsigned char* packetData) = 0;
+    };
+}}
@@ -0,0 +1,33 @@
+#include "PacketStageChain.h"
+
+#include "Pcap.h"
+
+using namespace PcapDotNet::Core;
+
+// The stages run for every packet inside the pcap callback, so they are compiled as native code to avoid managed transitions.
+#pragma managed(push, off)
+
+PacketStageChain::PacketStageChain(PacketStage* const* stages, int count)
+    : _count(count < MaxStages ? count : MaxStages)
+{
+    for (int i = 0; i != _count; ++i)
+        _stages[i] = stages[i];
+}
+
+bool PacketStageChain::IsEmpty() const
+{
+    return _count == 0;
+}
+
+bool PacketStageChain::Process(pcap_pkthdr& packetHeader, const unsigned char* packetData) const
+{
+    for (int i = 0; i != _count; ++i)
+    {
+        if (!_stages[i]->Process(packetHeader, packetData))
+            return false;
+    }
+
+    return true;
+}
+
+#pragma managed(pop)
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "PacketStage.h"
+
+namespace PcapDotNet { namespace Core 
+{
+    // An ordered list of stages applied by PacketCommunicator to every received packet.
+    // The chain doesn't own the stages and can't be changed once built, so the receiving thread can use it while a new chain is built.
+    class PacketStageChain
+    {
+    public:
+        static const int MaxStages = 8;
+
+        // Takes the first count stages, up to MaxStages.
+        PacketStageChain(PacketStage* const* stages, int count);
+
+        bool IsEmpty() const;
+
+        // Runs the stages in order until one of them discards the packet.
+        bool Process(pcap_pkthdr& packetHeader, const unsigned char* packetData) const;
+
+    private:
+        PacketStage* _stages[MaxStages];
+        int _count;
+
+        PacketStageChain(const PacketStageChain&) = delete;
+        PacketStageChain& operator=(const PacketStageChain&) = delete;
+    };
+}}
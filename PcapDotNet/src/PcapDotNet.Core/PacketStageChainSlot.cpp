@@ -0,0 +1,103 @@
+#include "PacketStageChainSlot.h"
+
+#include "Pcap.h"
+
+using namespace PcapDotNet::Core;
+
+#pragma managed(push, off)
+
+PacketStageChainSlot::PacketStageChainSlot()
+    : _current(new PacketStageChain(NULL, 0)), _receivers(0), _retired(NULL)
+{
+}
+
+PacketStageChainSlot::~PacketStageChainSlot()
+{
+    while (_retired != NULL)
+    {
+        RetiredChain* retired = _retired;
+        _retired = retired->next;
+        delete retired->chain;
+        delete retired;
+    }
+
+    delete _current;
+}
+
+void PacketStageChainSlot::BeginReceive()
+{
+    // A full barrier before the chains are read, so Publish() either sees this receiver or replaced the chain before it was read.
+    InterlockedIncrement(&_receivers);
+}
+
+bool PacketStageChainSlot::EndReceive()
+{
+    return InterlockedDecrement(&_receivers) == 0 && _retired != NULL;
+}
+
+const PacketStageChain& PacketStageChainSlot::Current() const
+{
+    return *_current;
+}
+
+bool PacketStageChainSlot::Publish(PacketStageChain* chain)
+{
+    PacketStageChain* replaced = static_cast<PacketStageChain*>(InterlockedExchangePointer(reinterpret_cast<void* volatile*>(&_current), chain));
+
+    RetiredChain* retired = new RetiredChain();
+    retired->chain = replaced;
+    retired->next = _retired;
+    _retired = retired;
+
+    return FreeRetired();
+}
+
+bool PacketStageChainSlot::FreeRetired()
+{
+    // A full barrier between adding the retired chain and reading the receivers count.
+    // Either this call sees the receiver, or the receiver's EndReceive() sees the retired chain.
+    if (InterlockedCompareExchange(&_receivers, 0, 0) != 0)
+        return false;
+
+    while (_retired != NULL)
+    {
+        RetiredChain* retired = _retired;
+        _retired = retired->next;
+        delete retired->chain;
+        delete retired;
+    }
+
+    return true;
+}
+
+PacketStageChainSlot::Dispatcher::Dispatcher(const PacketStageChainSlot& slot, Handler handler, PacketLoopBreaker& loopBreaker, int limit)
+    : _slot(slot), _handler(handler), _loopBreaker(loopBreaker), _limit(limit), _delivered(0)
+{
+}
+
+bool PacketStageChainSlot::Dispatcher::IsLimitReached() const
+{
+    return _limit > 0 && _delivered >= _limit;
+}
+
+// static
+void PacketStageChainSlot::Dispatcher::Dispatch(unsigned char* user, const pcap_pkthdr* packetHeader, const unsigned char* packetData)
+{
+    Dispatcher* dispatcher = reinterpret_cast<Dispatcher*>(user);
+
+    // Don't deliver the rest of the buffer after the limit was reached and the loop was asked to break.
+    if (dispatcher->IsLimitReached())
+        return;
+
+    pcap_pkthdr header = *packetHeader;
+    if (!dispatcher->_slot.Current().Process(header, packetData))
+        return;
+
+    ++dispatcher->_delivered;
+    dispatcher->_handler(NULL, &header, packetData);
+
+    if (dispatcher->IsLimitReached())
+        dispatcher->_loopBreaker.Break();
+}
+
+#pragma managed(pop)
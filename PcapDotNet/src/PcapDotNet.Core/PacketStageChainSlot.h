@@ -0,0 +1,72 @@
+#pragma once
+
+#include "PacketLoopBreaker.h"
+#include "PacketStageChain.h"
+
+namespace PcapDotNet { namespace Core 
+{
+    // Holds the stage chain PacketCommunicator applies to the received packets, and replaces it while packets are being received.
+    // The receiving thread reads the current chain for every packet, and a replaced chain is only freed once no receive call is running.
+    class PacketStageChainSlot
+    {
+    public:
+        PacketStageChainSlot();
+        ~PacketStageChainSlot();
+
+        // Called by the receiving thread around every receive call.
+        // EndReceive() returns whether the call was the last one running and replaced chains are waiting to be freed.
+        void BeginReceive();
+        bool EndReceive();
+
+        // The chain to process the next packet with.
+        const PacketStageChain& Current() const;
+
+        // Takes ownership of the chain and makes it the current one.
+        // The replaced chain is freed right away if no receive call is running. Returns whether it was freed.
+        bool Publish(PacketStageChain* chain);
+
+        // Frees the replaced chains if no receive call is running. Returns whether they were freed.
+        // Publish() and FreeRetired() must not be called concurrently.
+        bool FreeRetired();
+
+        // Forwards the packets accepted by the current chain to the managed handler.
+        // Passed as the user argument of pcap_dispatch() and pcap_loop() together with Dispatch().
+        class Dispatcher
+        {
+        public:
+            typedef void (*Handler)(unsigned char* user, const pcap_pkthdr* packetHeader, const unsigned char* packetData);
+
+            // limit is the number of packets to deliver before breaking the loop. Non positive means no limit.
+            Dispatcher(const PacketStageChainSlot& slot, Handler handler, PacketLoopBreaker& loopBreaker, int limit);
+
+            bool IsLimitReached() const;
+
+            static void Dispatch(unsigned char* user, const pcap_pkthdr* packetHeader, const unsigned char* packetData);
+
+        private:
+            const PacketStageChainSlot& _slot;
+            Handler _handler;
+            PacketLoopBreaker& _loopBreaker;
+            int _limit;
+            int _delivered;
+
+            Dispatcher(const Dispatcher&) = delete;
+            Dispatcher& operator=(const Dispatcher&) = delete;
+        };
+
+    private:
+        // A replaced chain that a running receive call may still be processing a packet with.
+        struct RetiredChain
+        {
+            PacketStageChain* chain;
+            RetiredChain* next;
+        };
+
+        PacketStageChain* volatile _current;
+        volatile long _receivers;
+        RetiredChain* volatile _retired;
+
+        PacketStageChainSlot(const PacketStageChainSlot&) = delete;
+        PacketStageChainSlot& operator=(const PacketStageChainSlot&) = delete;
+    };
+}}
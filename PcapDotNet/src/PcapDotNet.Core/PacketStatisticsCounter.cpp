@@ -0,0 +1,44 @@
+#include "PacketStatisticsCounter.h"
+
+#include "Pcap.h"
+
+using namespace PcapDotNet::Core;
+
+// The whole loop is native so no packet crosses into managed code.
+#pragma managed(push, off)
+
+// static
+unsigned __int64 PacketStatisticsCounter::Now()
+{
+    return GetTickCount64();
+}
+
+// static
+int PacketStatisticsCounter::Count(pcap_t* pcapDescriptor, unsigned __int64 deadline, unsigned __int64& packets, unsigned __int64& bytes)
+{
+    Counters counters = {0, 0};
+    int result = 0;
+
+    // pcap_dispatch() returns at least every read timeout, so the interval can be longer by up to one read timeout.
+    while (Now() < deadline)
+    {
+        result = pcap_dispatch(pcapDescriptor, -1, &PacketStatisticsCounter::Handle, reinterpret_cast<unsigned char*>(&counters));
+        if (result < 0)
+            break;
+        result = 0;
+    }
+
+    packets += counters.packets;
+    bytes += counters.bytes;
+    return result;
+}
+
+// static
+void PacketStatisticsCounter::Handle(unsigned char* user, const pcap_pkthdr* packetHeader, const unsigned char*)
+{
+    Counters* counters = reinterpret_cast<Counters*>(user);
+    ++counters->packets;
+    counters->bytes += packetHeader->len;
+}
+
+#pragma managed(pop)
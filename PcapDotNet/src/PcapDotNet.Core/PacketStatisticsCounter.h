@@ -0,0 +1,28 @@
+#pragma once
+
+#include "PcapDeclarations.h"
+
+namespace PcapDotNet { namespace Core 
+{
+    // Counts the packets accepted by the filter of a live capture inside the dispatch loop.
+    // Used to emulate statistics mode when the driver doesn't support it.
+    class PacketStatisticsCounter
+    {
+    public:
+        // Milliseconds from an arbitrary point.
+        static unsigned __int64 Now();
+
+        // Runs pcap_dispatch() until the deadline passes and adds the packets and bytes read.
+        // Returns 0 when the deadline passed, -1 on error and -2 if the loop was broken.
+        static int Count(pcap_t* pcapDescriptor, unsigned __int64 deadline, unsigned __int64& packets, unsigned __int64& bytes);
+
+    private:
+        struct Counters
+        {
+            unsigned __int64 packets;
+            unsigned __int64 bytes;
+        };
+
+        static void Handle(unsigned char* user, const pcap_pkthdr* packetHeader, const unsigned char* packetData);
+    };
+}}
@@ -1,5 +1,6 @@
 #pragma once
 
+struct bpf_insn;
 struct bpf_program;
 struct pcap_pkthdr;
 struct pcap_rmtauth;
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "PacketSamplingStage.h"
+
 namespace PcapDotNet { namespace Core 
 {
     /// <summary>
@@ -19,6 +21,9 @@ namespace PcapDotNet { namespace Core
             int get() = 0;
         }
 
+        // Sets this method on the stage that samples the packets locally.
+        virtual void ConfigureStage(PacketSamplingStage& stage) = 0;
+
     protected:
         SamplingMethod(){}
     };
@@ -31,3 +31,8 @@ int SamplingMethodFirstAfterInterval::Value::get()
 {
     return _intervalInMilliseconds;
 }
+
+void SamplingMethodFirstAfterInterval::ConfigureStage(PacketSamplingStage& stage)
+{
+    stage.SetMethod(PacketSamplingStage::MethodFirstAfterInterval, _intervalInMilliseconds);
+}
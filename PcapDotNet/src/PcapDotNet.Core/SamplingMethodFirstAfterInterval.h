@@ -40,6 +40,8 @@ namespace PcapDotNet { namespace Core
             int get() override;
         }
 
+        virtual void ConfigureStage(PacketSamplingStage& stage) override;
+
     private:
         int _intervalInMilliseconds;
     };
@@ -0,0 +1,28 @@
+#include "SamplingMethodFlowHash.h"
+#include "Pcap.h"
+
+using namespace System;
+using namespace PcapDotNet::Core;
+
+SamplingMethodFlowHash::SamplingMethodFlowHash(int count)
+{
+    if (count <= 0)
+        throw gcnew ArgumentOutOfRangeException("count", count, "Must be positive");
+    _count = count;
+}
+
+int SamplingMethodFlowHash::Method::get()
+{
+    // Remote probes don't know this method.
+    return PCAP_SAMP_NOSAMP;
+}
+
+int SamplingMethodFlowHash::Value::get()
+{
+    return 0;
+}
+
+void SamplingMethodFlowHash::ConfigureStage(PacketSamplingStage& stage)
+{
+    stage.SetMethod(PacketSamplingStage::MethodFlowHash, _count);
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "SamplingMethod.h"
+
+namespace PcapDotNet { namespace Core 
+{
+    /// <summary>
+    /// Defines that only the packets of 1 out of count flows must be returned to the user.
+    /// A flow is identified by the IP addresses, the ports and the protocol of its packets, in both directions.
+    /// The flows are selected using a hash, so every packet of a selected flow is returned and the same flows are selected by every capture.
+    /// </summary>
+    /// <remarks>
+    /// Ethernet packets that are not IP are sampled by their MAC addresses and EtherType instead, so both directions are still sampled together.
+    /// Other packets that are not IP are always returned.
+    /// Remote probes don't support this method, so when capturing from a remote source all the packets are sent and the sampling is done locally.
+    /// </remarks>
+    public ref class SamplingMethodFlowHash sealed : SamplingMethod
+    {
+    public:
+        /// <summary>
+        /// Constructs by giving a count.
+        /// </summary>
+        /// <param name="count">The packets of 1 flow out of count flows will be sampled.</param>
+        /// <exception cref="System::ArgumentOutOfRangeException">The given count is non-positive.</exception>
+        SamplingMethodFlowHash(int count);
+
+    internal:
+        virtual property int Method
+        {
+            int get() override;
+        }
+
+        virtual property int Value
+        {
+            int get() override;
+        }
+
+        virtual void ConfigureStage(PacketSamplingStage& stage) override;
+
+    private:
+        int _count;
+    };
+}}
@@ -12,3 +12,8 @@ int SamplingMethodNone::Value::get()
 {
     return 0;
 }
+
+void SamplingMethodNone::ConfigureStage(PacketSamplingStage& stage)
+{
+    stage.SetMethod(PacketSamplingStage::MethodNone, 0);
+}
@@ -20,5 +20,7 @@ namespace PcapDotNet { namespace Core
         {
             int get() override;
         }
+
+        virtual void ConfigureStage(PacketSamplingStage& stage) override;
     };
 }}
\ No newline at end of file
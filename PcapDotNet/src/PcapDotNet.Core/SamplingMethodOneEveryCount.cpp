@@ -20,3 +20,8 @@ int SamplingMethodOneEveryCount::Value::get()
 {
     return _count;
 }
+
+void SamplingMethodOneEveryCount::ConfigureStage(PacketSamplingStage& stage)
+{
+    stage.SetMethod(PacketSamplingStage::MethodOneEveryCount, _count);
+}
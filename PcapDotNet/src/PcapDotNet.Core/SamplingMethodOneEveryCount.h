@@ -33,6 +33,8 @@ namespace PcapDotNet { namespace Core
             int get() override;
         }
 
+        virtual void ConfigureStage(PacketSamplingStage& stage) override;
+
     private:
         int _count;
     };
@@ -3,6 +3,7 @@ using System.Collections.Generic;
 using System.Diagnostics.CodeAnalysis;
 using System.Numerics;
 using Microsoft.VisualStudio.TestTools.UnitTesting;
+using PcapDotNet.Base;
 
 namespace PcapDotNet.Packets.Test
 {
@@ -214,5 +215,47 @@ namespace PcapDotNet.Packets.Test
             ulong actualValue = buffer.ReadULong(0, Endianity.Big);
             Assert.AreEqual(expectedValue, actualValue);
         }
+
+        [TestMethod]
+        public void ByteArrayEndianityTest()
+        {
+            byte[] bigEndianBytes = new byte[] {0, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0x10};
+            byte[] littleEndianBytes = new byte[bigEndianBytes.Length];
+
+            // Reads and writes at an odd offset to check unaligned access.
+            const int Offset = 1;
+            Assert.AreEqual((ushort)0x0102, bigEndianBytes.ReadUShort(Offset, Endianity.Big));
+            Assert.AreEqual((ushort)0x0201, bigEndianBytes.ReadUShort(Offset, Endianity.Small));
+            Assert.AreEqual((short)0x0102, bigEndianBytes.ReadShort(Offset, Endianity.Big));
+            Assert.AreEqual((UInt24)0x010203, bigEndianBytes.ReadUInt24(Offset, Endianity.Big));
+            Assert.AreEqual((UInt24)0x030201, bigEndianBytes.ReadUInt24(Offset, Endianity.Small));
+            Assert.AreEqual(0x01020304u, bigEndianBytes.ReadUInt(Offset, Endianity.Big));
+            Assert.AreEqual(0x04030201u, bigEndianBytes.ReadUInt(Offset, Endianity.Small));
+            Assert.AreEqual(0x01020304, bigEndianBytes.ReadInt(Offset, Endianity.Big));
+            Assert.AreEqual((UInt48)0x010203040506, bigEndianBytes.ReadUInt48(Offset, Endianity.Big));
+            Assert.AreEqual((UInt48)0x060504030201, bigEndianBytes.ReadUInt48(Offset, Endianity.Small));
+            Assert.AreEqual(0x0102030405060708UL, bigEndianBytes.ReadULong(Offset, Endianity.Big));
+            Assert.AreEqual(0x0807060504030201UL, bigEndianBytes.ReadULong(Offset, Endianity.Small));
+            Assert.AreEqual(0x0102030405060708L, bigEndianBytes.ReadLong(Offset, Endianity.Big));
+            Assert.AreEqual(new UInt128(0x0102030405060708UL, 0x090A0B0C0D0E0F10UL), bigEndianBytes.ReadUInt128(Offset, Endianity.Big));
+            Assert.AreEqual(new UInt128(0x100F0E0D0C0B0A09UL, 0x0807060504030201UL), bigEndianBytes.ReadUInt128(Offset, Endianity.Small));
+
+            littleEndianBytes.Write(Offset, new UInt128(0x0102030405060708UL, 0x090A0B0C0D0E0F10UL), Endianity.Small);
+            for (int i = 0; i != UInt128.SizeOf; ++i)
+                Assert.AreEqual(bigEndianBytes[bigEndianBytes.Length - 1 - i], littleEndianBytes[Offset + i]);
+
+            byte[] buffer = new byte[bigEndianBytes.Length];
+            buffer.Write(Offset, (ushort)0x0102, Endianity.Big);
+            buffer.Write(Offset + sizeof(ushort), (ushort)0x0403, Endianity.Small);
+            buffer.Write(Offset + 2 * sizeof(ushort), (UInt24)0x050607, Endianity.Big);
+            buffer.Write(Offset + 7, (UInt48)0x0D0C0B0A0908, Endianity.Small);
+            buffer.Write(Offset + 13, (UInt24)0x100F0E, Endianity.Small);
+            CollectionAssert.AreEqual(bigEndianBytes, buffer);
+
+            buffer.Write(Offset, 0x01020304u, Endianity.Big);
+            buffer.Write(Offset + sizeof(uint), 0x08070605u, Endianity.Small);
+            buffer.Write(Offset + 2 * sizeof(uint), 0x100F0E0D0C0B0A09UL, Endianity.Small);
+            CollectionAssert.AreEqual(bigEndianBytes, buffer);
+        }
     }
 }
\ No newline at end of file
@@ -5,10 +5,12 @@ using System.Diagnostics.CodeAnalysis;
 using System.IO;
 using Microsoft.VisualStudio.TestTools.UnitTesting;
 using PcapDotNet.Base;
+using PcapDotNet.Packets.Dns;
 using PcapDotNet.Packets.Ethernet;
 using PcapDotNet.Packets.IpV4;
 using PcapDotNet.Packets.TestUtils;
 using PcapDotNet.Packets.Transport;
+using PcapDotNet.TestUtils;
 
 namespace PcapDotNet.Packets.Test
 {
@@ -61,5 +63,58 @@ namespace PcapDotNet.Packets.Test
             Assert.IsNotNull(new DataSegment(new byte[1]).Decode(null));
             Assert.Fail();
         }
+
+        [TestMethod]
+        public void Sum16BitsTest()
+        {
+            Random random = new Random();
+            for (int i = 0; i != 1000; ++i)
+            {
+                byte[] buffer = random.NextBytes(random.Next(5000));
+                int offset = random.Next(buffer.Length + 1);
+                int length = random.Next(buffer.Length - offset + 1);
+                if (i % 10 == 0)
+                {
+                    for (int j = 0; j != buffer.Length; ++j)
+                        buffer[j] = byte.MaxValue;
+                }
+
+                // The DNS key tag sums the public key 16 bits values without folding the carry more than once.
+                DnsResourceDataDnsKey dnsKey = new DnsResourceDataDnsKey(false, false, false, 3, DnsAlgorithm.RsaSha1, new DataSegment(buffer, offset, length));
+                uint sum = (uint)(BitSequence.Merge(3, (byte)DnsAlgorithm.RsaSha1) + Sum16Bits(buffer, offset, length));
+                Assert.AreEqual((ushort)(sum + (sum >> 16)), dnsKey.KeyTag, "Offset " + offset + " Length " + length);
+            }
+        }
+
+        [TestMethod]
+        public void Sum16BitsJumboFrameTest()
+        {
+            Random random = new Random();
+            for (int i = 0; i != 10; ++i)
+            {
+                // Odd and even payload lengths around a 9000 bytes MTU.
+                Packet packet = PacketBuilder.Build(DateTime.Now, new EthernetLayer(), new IpV4Layer(),
+                                                    new UdpLayer {SourcePort = random.NextUShort(), DestinationPort = random.NextUShort(), CalculateChecksumValue = true},
+                                                    random.NextPayloadLayer(9000 - 20 - 8 + i % 2));
+                Assert.IsTrue(packet.Ethernet.IpV4.IsTransportChecksumCorrect);
+
+                // A changed byte anywhere in the payload must be noticed.
+                byte[] buffer = new byte[packet.Length];
+                packet.CopyTo(buffer, 0);
+                int changedOffset = random.Next(EthernetDatagram.HeaderLengthValue + IpV4Datagram.HeaderMinimumLength + 8, buffer.Length);
+                buffer[changedOffset] ^= (byte)random.Next(1, 256);
+                Assert.IsFalse(new Packet(buffer, packet.Timestamp, DataLinkKind.Ethernet).Ethernet.IpV4.IsTransportChecksumCorrect, "Offset " + changedOffset);
+            }
+        }
+
+        private static uint Sum16Bits(byte[] buffer, int offset, int length)
+        {
+            uint sum = 0;
+            for (int i = 0; i < length - 1; i += 2)
+                sum += (uint)((buffer[offset + i] << 8) + buffer[offset + i + 1]);
+            if (length % 2 == 1)
+                sum += (uint)(buffer[offset + length - 1] << 8);
+            return sum;
+        }
    }
 }
\ No newline at end of file
@@ -0,0 +1,183 @@
+﻿using System;
+using System.Diagnostics.CodeAnalysis;
+using System.Linq;
+using Microsoft.VisualStudio.TestTools.UnitTesting;
+using PcapDotNet.Packets.Ethernet;
+using PcapDotNet.Packets.Filtering;
+using PcapDotNet.Packets.Http;
+using PcapDotNet.Packets.IpV4;
+using PcapDotNet.Packets.IpV6;
+using PcapDotNet.Packets.Transport;
+
+namespace PcapDotNet.Packets.Test
+{
+    /// <summary>
+    /// Summary description for DisplayFilterTests
+    /// </summary>
+    [TestClass]
+    [ExcludeFromCodeCoverage]
+    public class DisplayFilterTests
+    {
+        /// <summary>
+        /// Gets or sets the test context which provides
+        /// information about and functionality for the current test run.
+        /// </summary>
+        public TestContext TestContext { get; set; }
+
+        [TestMethod]
+        public void DisplayFilterTest()
+        {
+            Packet postPacket = BuildHttpRequest("POST", 500);
+            Packet getPacket = BuildHttpRequest("GET", 2000);
+            Packet udpPacket = PacketBuilder.Build(DateTime.Now,
+                                                   new EthernetLayer {Source = new MacAddress("11:22:33:44:55:66")},
+                                                   new IpV4Layer {Source = new IpV4Address("192.168.0.2"), Ttl = 1},
+                                                   new UdpLayer {SourcePort = 5000, DestinationPort = 5353},
+                                                   new PayloadLayer {Data = new Datagram(new byte[100])});
+            Packet ipV6Packet = PacketBuilder.Build(DateTime.Now,
+                                                    new EthernetLayer(),
+                                                    new IpV6Layer {Source = new IpV6Address("fe80::1"), HopLimit = 255},
+                                                    new UdpLayer {SourcePort = 53, DestinationPort = 1000},
+                                                    new PayloadLayer {Data = new Datagram(new byte[12])});
+            Packet truncatedPacket = new Packet(postPacket.Buffer.Take(EthernetDatagram.HeaderLengthValue + 10).ToArray(), DateTime.Now, DataLinkKind.Ethernet);
+
+            Packet[] packets = {postPacket, getPacket, udpPacket, ipV6Packet, truncatedPacket};
+            TestFilter(packets, "eth", true, true, true, true, true);
+            TestFilter(packets, "ip", true, true, true, false, false);
+            TestFilter(packets, "ipv6", false, false, false, true, false);
+            TestFilter(packets, "tcp", true, true, false, false, false);
+            TestFilter(packets, "udp || ipv6", false, false, true, true, false);
+            TestFilter(packets, "http.request.method == \"POST\"", true, false, false, false, false);
+            TestFilter(packets, "tcp.window_size < 1000 && http.request.method == \"POST\"", true, false, false, false, false);
+            TestFilter(packets, "tcp.window_size ge 1000", false, true, false, false, false);
+            TestFilter(packets, "http.request.uri contains \"load\"", true, true, false, false, false);
+            TestFilter(packets, "http.request and not http.response", true, true, false, false, false);
+            TestFilter(packets, "tcp.port == 80", true, true, false, false, false);
+            TestFilter(packets, "tcp.port != 80", true, true, false, false, false);
+            TestFilter(packets, "!(tcp.port == 80)", false, false, true, true, true);
+            TestFilter(packets, "tcp.flags.syn == true && tcp.flags.ack == 0", true, true, false, false, false);
+            TestFilter(packets, "tcp.flags == 0x2", true, true, false, false, false);
+            TestFilter(packets, "ip.src == 10.0.0.0/8", true, true, false, false, false);
+            TestFilter(packets, "ip.addr == 192.168.0.1", true, true, false, false, false);
+            TestFilter(packets, "ip.src > 10.0.0.0 and ip.src < 11.0.0.0", true, true, false, false, false);
+            TestFilter(packets, "ip.proto == udp", false, false, true, false, false);
+            TestFilter(packets, "ip.ttl lt 2", false, false, true, false, false);
+            TestFilter(packets, "eth.src == 11:22:33:44:55:66", false, false, true, false, false);
+            TestFilter(packets, "ipv6.src == fe80::1 && ipv6.hlim == 255 && udp.port == 53", false, false, false, true, false);
+            TestFilter(packets, "udp.length > 50", false, false, true, false, false);
+            TestFilter(packets, "dns", false, false, false, true, false);
+        }
+
+        [TestMethod]
+        public void DisplayFilterRegisterFieldTest()
+        {
+            DisplayFilterFieldRegistry registry = new DisplayFilterFieldRegistry();
+            registry.RegisterProtocol("udp", packet => DisplayFilterLayers.GetUdp(packet));
+            DisplayFilterField field = registry.Register("udp.payload_length", packet => DisplayFilterLayers.GetUdp(packet), udp => udp.Payload.Length);
+            Assert.AreEqual("udp.payload_length", field.Name);
+            Assert.AreEqual(typeof(int), field.ValueType);
+            Assert.IsFalse(field.IsProtocol);
+            Assert.AreEqual(2, registry.Fields.Count);
+
+            DisplayFilter filter = new DisplayFilter("udp and udp.payload_length == 10", registry);
+            Assert.AreEqual("udp and udp.payload_length == 10", filter.ToString());
+            Assert.IsTrue(filter.Test(PacketBuilder.Build(DateTime.Now, new EthernetLayer(), new IpV4Layer(), new UdpLayer(), new PayloadLayer {Data = new Datagram(new byte[10])})));
+            Assert.IsFalse(filter.Test(PacketBuilder.Build(DateTime.Now, new EthernetLayer(), new IpV4Layer(), new UdpLayer(), new PayloadLayer {Data = new Datagram(new byte[11])})));
+
+            // Fields of other registries are unknown.
+            AssertInvalid("tcp", registry);
+        }
+
+        [TestMethod]
+        [ExpectedException(typeof(ArgumentException), AllowDerivedTypes = false)]
+        public void DisplayFilterRegisterFieldTwiceTest()
+        {
+            DisplayFilterFieldRegistry registry = new DisplayFilterFieldRegistry();
+            registry.RegisterProtocol("udp", packet => DisplayFilterLayers.GetUdp(packet));
+            registry.RegisterProtocol("udp", packet => DisplayFilterLayers.GetUdp(packet));
+        }
+
+        [TestMethod]
+        public void DisplayFilterErrorTest()
+        {
+            string[] invalidExpressions =
+            {
+                "", "tcp.port ==", "no.such.field == 1", "tcp == 1", "(tcp", "tcp)", "tcp.port == \"80", "tcp.port == abc", "tcp.flags.syn > 0",
+                "ip.src == 10.0.0/8", "ip.src > 10.0.0.0/8", "tcp.port contains 80", "tcp.port = 80", "tcp && && udp"
+            };
+
+            foreach (string expression in invalidExpressions)
+                AssertInvalid(expression, DisplayFilterFieldRegistry.Default);
+        }
+
+        [TestMethod]
+        public void DisplayFilterUnsignedLongFieldTest()
+        {
+            DisplayFilterFieldRegistry registry = new DisplayFilterFieldRegistry();
+            registry.Register("udp.payload_complement", packet => DisplayFilterLayers.GetUdp(packet), udp => ulong.MaxValue - (ulong)udp.Payload.Length);
+            Packet packet = PacketBuilder.Build(DateTime.Now, new EthernetLayer(), new IpV4Layer(), new UdpLayer(), new PayloadLayer {Data = new Datagram(new byte[10])});
+
+            Assert.IsTrue(new DisplayFilter("udp.payload_complement == 0xFFFFFFFFFFFFFFF5", registry).Test(packet));
+            Assert.IsTrue(new DisplayFilter("udp.payload_complement == 18446744073709551605", registry).Test(packet));
+            Assert.IsTrue(new DisplayFilter("udp.payload_complement > 9223372036854775807", registry).Test(packet));
+            Assert.IsFalse(new DisplayFilter("udp.payload_complement < 1", registry).Test(packet));
+            AssertInvalid("udp.payload_complement > -1", registry);
+        }
+
+        [TestMethod]
+        public void DisplayFilterTruncatedFieldTest()
+        {
+            DisplayFilterFieldRegistry registry = new DisplayFilterFieldRegistry();
+            registry.RegisterProtocol("udp", packet => DisplayFilterLayers.GetUdp(packet));
+            registry.Register("udp.payload_byte_20", packet => DisplayFilterLayers.GetUdp(packet), udp => udp.Payload[20]);
+
+            // The payload ends with the packet, so reading the field goes beyond the buffer.
+            Packet packet = PacketBuilder.Build(DateTime.Now, new EthernetLayer(), new IpV4Layer(), new UdpLayer(), new PayloadLayer {Data = new Datagram(new byte[10])});
+
+            // Only the comparison that reads the field is false.
+            Assert.IsFalse(new DisplayFilter("udp.payload_byte_20 == 0", registry).Test(packet));
+            Assert.IsFalse(new DisplayFilter("udp && udp.payload_byte_20 == 0", registry).Test(packet));
+            Assert.IsTrue(new DisplayFilter("udp.payload_byte_20 == 0 || udp", registry).Test(packet));
+            Assert.IsTrue(new DisplayFilter("udp || udp.payload_byte_20 == 0", registry).Test(packet));
+            Assert.IsTrue(new DisplayFilter("!(udp.payload_byte_20 == 0)", registry).Test(packet));
+            Assert.IsTrue(new DisplayFilter("not udp.payload_byte_20 > 0 && udp", registry).Test(packet));
+        }
+
+        private static Packet BuildHttpRequest(string method, ushort window)
+        {
+            return PacketBuilder.Build(DateTime.Now,
+                                       new EthernetLayer(),
+                                       new IpV4Layer {Source = new IpV4Address("10.1.2.3"), CurrentDestination = new IpV4Address("192.168.0.1"), Ttl = 64},
+                                       new TcpLayer {SourcePort = 1234, DestinationPort = 80, Window = window, ControlBits = TcpControlBits.Synchronize},
+                                       new HttpRequestLayer
+                                       {
+                                           Method = new HttpRequestMethod(method),
+                                           Uri = "/upload",
+                                           Version = HttpVersion.Version11,
+                                           Header = new HttpHeader(),
+                                       });
+        }
+
+        private static void AssertInvalid(string expression, DisplayFilterFieldRegistry registry)
+        {
+            try
+            {
+                new DisplayFilter(expression, registry);
+            }
+            catch (ArgumentException exception)
+            {
+                Assert.AreEqual("expression", exception.ParamName, expression);
+                return;
+            }
+            Assert.Fail("Display filter <" + expression + "> should be invalid");
+        }
+
+        private static void TestFilter(Packet[] packets, string expression, params bool[] expectedResults)
+        {
+            DisplayFilter filter = new DisplayFilter(expression);
+            Assert.AreEqual(expression, filter.Expression);
+            for (int i = 0; i != packets.Length; ++i)
+                Assert.AreEqual(expectedResults[i], filter.Test(packets[i]), expression + " packet " + i);
+        }
+    }
+}
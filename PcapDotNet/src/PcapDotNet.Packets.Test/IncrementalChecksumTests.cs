@@ -0,0 +1,164 @@
+﻿using System;
+using System.Diagnostics.CodeAnalysis;
+using System.Linq;
+using Microsoft.VisualStudio.TestTools.UnitTesting;
+using PcapDotNet.Packets.Ethernet;
+using PcapDotNet.Packets.IpV4;
+using PcapDotNet.Packets.IpV6;
+using PcapDotNet.Packets.TestUtils;
+using PcapDotNet.Packets.Transport;
+using PcapDotNet.TestUtils;
+
+namespace PcapDotNet.Packets.Test
+{
+    /// <summary>
+    /// Summary description for IncrementalChecksumTests
+    /// </summary>
+    [TestClass]
+    [ExcludeFromCodeCoverage]
+    public class IncrementalChecksumTests
+    {
+        /// <summary>
+        /// Gets or sets the test context which provides
+        /// information about and functionality for the current test run.
+        /// </summary>
+        public TestContext TestContext { get; set; }
+
+        [TestMethod]
+        public void IncrementalChecksumRewriteTest()
+        {
+            Random random = new Random();
+            for (int i = 0; i != 1000; ++i)
+            {
+                EthernetLayer ethernetLayer = random.NextEthernetLayer(EthernetType.None);
+                IpV4Layer ipV4Layer = random.NextIpV4Layer(null);
+                ipV4Layer.HeaderChecksum = null;
+                ipV4Layer.Fragmentation = IpV4Fragmentation.None;
+                TransportLayer transportLayer = random.NextBool() ? (TransportLayer)random.NextTcpLayer() : new UdpLayer {SourcePort = random.NextUShort(), DestinationPort = random.NextUShort(), CalculateChecksumValue = true};
+                PayloadLayer payloadLayer = random.NextPayloadLayer(random.Next(100));
+
+                Packet originalPacket = PacketBuilder.Build(DateTime.Now, ethernetLayer, ipV4Layer, transportLayer, payloadLayer);
+                byte[] buffer = new byte[originalPacket.Length];
+                originalPacket.CopyTo(buffer, 0);
+
+                ipV4Layer.Source = random.NextIpV4Address();
+                ipV4Layer.CurrentDestination = random.NextIpV4Address();
+                transportLayer.SourcePort = random.NextUShort();
+                transportLayer.DestinationPort = random.NextUShort();
+                IncrementalChecksum.RewriteIpV4Source(buffer, 0, buffer.Length, DataLinkKind.Ethernet, ipV4Layer.Source);
+                IncrementalChecksum.RewriteIpV4Destination(buffer, 0, buffer.Length, DataLinkKind.Ethernet, ipV4Layer.CurrentDestination);
+                IncrementalChecksum.RewriteTransportSourcePort(buffer, 0, buffer.Length, DataLinkKind.Ethernet, transportLayer.SourcePort);
+                IncrementalChecksum.RewriteTransportDestinationPort(buffer, 0, buffer.Length, DataLinkKind.Ethernet, transportLayer.DestinationPort);
+
+                Packet packet = new Packet(buffer, originalPacket.Timestamp, DataLinkKind.Ethernet);
+                Packet expectedPacket = PacketBuilder.Build(packet.Timestamp, ethernetLayer, ipV4Layer, transportLayer, payloadLayer);
+                Assert.AreEqual(expectedPacket, packet, "Packet " + i);
+                Assert.AreEqual(ipV4Layer.Source, packet.Ethernet.IpV4.Source);
+                Assert.IsTrue(packet.Ethernet.IpV4.IsHeaderChecksumCorrect);
+                Assert.IsTrue(packet.Ethernet.IpV4.IsTransportChecksumCorrect);
+            }
+        }
+
+        [TestMethod]
+        public void IncrementalChecksumUpdateTest()
+        {
+            Random random = new Random();
+            for (int i = 0; i != 1000; ++i)
+            {
+                // The next layer is a payload, so the protocol can't be determined automatically.
+                IpV4Layer ipV4Layer = random.NextIpV4Layer(IpV4Protocol.Udp);
+                ipV4Layer.HeaderChecksum = null;
+                IpV6Layer ipV6Layer = new IpV6Layer {Source = random.NextIpV6Address(), CurrentDestination = random.NextIpV6Address()};
+                UdpLayer udpLayer = new UdpLayer {SourcePort = random.NextUShort(), DestinationPort = random.NextUShort(), CalculateChecksumValue = true};
+                PayloadLayer payloadLayer = random.NextPayloadLayer(random.Next(100));
+
+                IpV4Datagram ipV4 = PacketBuilder.Build(DateTime.Now, new EthernetLayer(), ipV4Layer, payloadLayer).Ethernet.IpV4;
+                ushort oldTtl = ipV4Layer.Ttl;
+                IpV4Address oldSource = ipV4Layer.Source;
+                ipV4Layer.Ttl = random.NextByte();
+                ipV4Layer.Source = random.NextIpV4Address();
+                IpV4Datagram expectedIpV4 = PacketBuilder.Build(DateTime.Now, new EthernetLayer(), ipV4Layer, payloadLayer).Ethernet.IpV4;
+
+                // The TTL is the most significant byte of its 16 bits word.
+                ushort headerChecksum = IncrementalChecksum.Update(ipV4.HeaderChecksum, (ushort)(oldTtl << 8), (ushort)(ipV4Layer.Ttl << 8));
+                headerChecksum = IncrementalChecksum.Update(headerChecksum, oldSource, ipV4Layer.Source);
+                Assert.AreEqual(expectedIpV4.HeaderChecksum, headerChecksum);
+
+                UdpDatagram udp = PacketBuilder.Build(DateTime.Now, new EthernetLayer(), ipV6Layer, udpLayer, payloadLayer).Ethernet.IpV6.Udp;
+                IpV6Address oldIpV6Source = ipV6Layer.Source;
+                ushort oldPort = udpLayer.SourcePort;
+                ipV6Layer.Source = random.NextIpV6Address();
+                udpLayer.SourcePort = random.NextUShort();
+                UdpDatagram expectedUdp = PacketBuilder.Build(DateTime.Now, new EthernetLayer(), ipV6Layer, udpLayer, payloadLayer).Ethernet.IpV6.Udp;
+
+                ushort udpChecksum = IncrementalChecksum.UpdateOptional(udp.Checksum, oldPort, udpLayer.SourcePort);
+                udpChecksum = IncrementalChecksum.UpdateOptional(udpChecksum, oldIpV6Source, ipV6Layer.Source);
+                Assert.AreEqual(expectedUdp.Checksum, udpChecksum);
+            }
+        }
+
+        [TestMethod]
+        public void IncrementalChecksumOptionalTest()
+        {
+            // No checksum stays no checksum.
+            Assert.AreEqual(0, IncrementalChecksum.UpdateOptional(0, 1, 2));
+            Assert.AreEqual(0, IncrementalChecksum.UpdateOptional(0, 1u, 2u));
+            Assert.AreEqual(0, IncrementalChecksum.UpdateOptional(0, new IpV4Address("1.2.3.4"), new IpV4Address("5.6.7.8")));
+
+            // A calculated zero is sent as 0xFFFF.
+            Assert.AreEqual(0, IncrementalChecksum.Update(0x0001, 0x0000, 0x0001));
+            Assert.AreEqual(0xFFFF, IncrementalChecksum.UpdateOptional(0x0001, 0x0000, 0x0001));
+
+            // Unchanged value keeps the checksum.
+            Assert.AreEqual(0x1234, IncrementalChecksum.Update(0x1234, 0xABCDu, 0xABCDu));
+
+            byte[] buffer = PacketBuilder.Build(DateTime.Now, new EthernetLayer(), new IpV4Layer(), new UdpLayer {CalculateChecksumValue = false},
+                                                new PayloadLayer {Data = new Datagram(new byte[10])}).ToArray();
+            IncrementalChecksum.RewriteIpV4Source(buffer, 0, buffer.Length, DataLinkKind.Ethernet, new IpV4Address("1.2.3.4"));
+            IncrementalChecksum.RewriteTransportDestinationPort(buffer, 0, buffer.Length, DataLinkKind.Ethernet, 53);
+            Packet parsedPacket = new Packet(buffer, DateTime.Now, DataLinkKind.Ethernet);
+            Assert.AreEqual(0, parsedPacket.Ethernet.IpV4.Udp.Checksum);
+            Assert.AreEqual(53, parsedPacket.Ethernet.IpV4.Udp.DestinationPort);
+            Assert.IsTrue(parsedPacket.IsValid);
+        }
+
+        [TestMethod]
+        public void IncrementalChecksumRewriteSegmentTest()
+        {
+            IpV4Layer ipV4Layer = new IpV4Layer {Source = new IpV4Address("1.2.3.4"), CurrentDestination = new IpV4Address("5.6.7.8")};
+            TcpLayer tcpLayer = new TcpLayer {SourcePort = 1000, DestinationPort = 80};
+            PayloadLayer payloadLayer = new PayloadLayer {Data = new Datagram(new byte[] {1, 2, 3})};
+            Packet packet = PacketBuilder.Build(DateTime.Now, new EthernetLayer(), ipV4Layer, tcpLayer, payloadLayer);
+
+            // The rewritten packet is in the middle of a bigger buffer.
+            const int Offset = 7;
+            byte[] buffer = new byte[Offset + packet.Length + 5];
+            packet.CopyTo(buffer, Offset);
+            IncrementalChecksum.RewriteIpV4Source(buffer, Offset, packet.Length, DataLinkKind.Ethernet, new IpV4Address("9.10.11.12"));
+            IncrementalChecksum.RewriteTransportDestinationPort(buffer, Offset, packet.Length, DataLinkKind.Ethernet, 443);
+            Packet segmentPacket = new Packet(buffer, Offset, packet.Length, packet.Timestamp, packet.DataLink);
+
+            ipV4Layer.Source = new IpV4Address("9.10.11.12");
+            tcpLayer.DestinationPort = 443;
+            Assert.AreEqual(PacketBuilder.Build(packet.Timestamp, new EthernetLayer(), ipV4Layer, tcpLayer, payloadLayer), segmentPacket);
+            Assert.AreEqual(0, buffer[Offset - 1]);
+            Assert.AreEqual(0, buffer[Offset + packet.Length]);
+        }
+
+        [TestMethod]
+        [ExpectedException(typeof(ArgumentException), AllowDerivedTypes = false)]
+        public void IncrementalChecksumRewriteWithoutTransportTest()
+        {
+            byte[] buffer = PacketBuilder.Build(DateTime.Now, new EthernetLayer(), new IpV4Layer {Protocol = IpV4Protocol.InternetControlMessageProtocol},
+                                                new PayloadLayer {Data = new Datagram(new byte[10])}).ToArray();
+            IncrementalChecksum.RewriteTransportSourcePort(buffer, 0, buffer.Length, DataLinkKind.Ethernet, 80);
+        }
+
+        [TestMethod]
+        [ExpectedException(typeof(ArgumentNullException), AllowDerivedTypes = false)]
+        public void IncrementalChecksumRewriteNullTest()
+        {
+            IncrementalChecksum.RewriteIpV4Source(null, 0, 0, DataLinkKind.Ethernet, IpV4Address.Zero);
+        }
+    }
+}
@@ -1,7 +1,12 @@
 using System;
 using System.Diagnostics.CodeAnalysis;
+using System.Linq;
 using Microsoft.VisualStudio.TestTools.UnitTesting;
+using PcapDotNet.Packets.Ethernet;
+using PcapDotNet.Packets.IpV4;
+using PcapDotNet.Packets.TestUtils;
 using PcapDotNet.Packets.Transport;
+using PcapDotNet.TestUtils;
 
 namespace PcapDotNet.Packets.Test
 {
@@ -64,5 +69,86 @@ namespace PcapDotNet.Packets.Test
             Assert.IsNotNull(new PacketBuilder(layers));
             Assert.Fail();
         }
+
+        [TestMethod]
+        public void CompiledPacketBuilderTest()
+        {
+            Random random = new Random();
+            for (int i = 0; i != 100; ++i)
+            {
+                EthernetLayer ethernetLayer = random.NextEthernetLayer(EthernetType.None);
+                IpV4Layer ipV4Layer = random.NextIpV4Layer(null);
+                TcpLayer tcpLayer = random.NextTcpLayer();
+                PayloadLayer payloadLayer = random.NextPayloadLayer(random.Next(100));
+                PacketBuilder packetBuilder = new PacketBuilder(ethernetLayer, ipV4Layer, tcpLayer, payloadLayer);
+                CompiledPacketBuilder compiledBuilder = packetBuilder.Compile();
+
+                Packet expectedPacket = packetBuilder.Build(DateTime.Now);
+                Assert.AreEqual(expectedPacket.Length, compiledBuilder.Length);
+                Assert.AreEqual(expectedPacket.DataLink, compiledBuilder.DataLink);
+
+                // A reused buffer contains garbage.
+                const int Offset = 7;
+                byte[] buffer = random.NextBytes(Offset + compiledBuilder.Length + 3);
+                Assert.AreEqual(compiledBuilder.Length, compiledBuilder.BuildInto(buffer, Offset));
+                Assert.AreEqual(expectedPacket, new Packet(buffer.Skip(Offset).Take(compiledBuilder.Length).ToArray(), DateTime.Now, DataLinkKind.Ethernet));
+
+                const int NumPackets = 10;
+                ushort[] sourcePorts = Enumerable.Range(0, NumPackets).Select(j => random.NextUShort()).ToArray();
+                int[] offsets = new int[NumPackets];
+                int[] lengths = new int[NumPackets];
+                buffer = random.NextBytes(Offset + NumPackets * compiledBuilder.Length);
+                Assert.AreEqual(NumPackets * compiledBuilder.Length,
+                                compiledBuilder.BuildMany(buffer, Offset, NumPackets, j => tcpLayer.SourcePort = sourcePorts[j], offsets, lengths));
+
+                for (int j = 0; j != NumPackets; ++j)
+                {
+                    Assert.AreEqual(Offset + j * compiledBuilder.Length, offsets[j]);
+                    Assert.AreEqual(compiledBuilder.Length, lengths[j]);
+                    tcpLayer.SourcePort = sourcePorts[j];
+                    Assert.AreEqual(packetBuilder.Build(DateTime.Now), new Packet(buffer.Skip(offsets[j]).Take(lengths[j]).ToArray(), DateTime.Now, DataLinkKind.Ethernet));
+                }
+            }
+        }
+
+        [TestMethod]
+        [ExpectedException(typeof(ArgumentOutOfRangeException), AllowDerivedTypes = false)]
+        public void CompiledPacketBuilderBuildIntoTooSmallBufferTest()
+        {
+            CompiledPacketBuilder builder = new PacketBuilder(new EthernetLayer(), new IpV4Layer(), new UdpLayer()).Compile();
+            builder.BuildInto(new byte[builder.Length], 1);
+        }
+
+        [TestMethod]
+        [ExpectedException(typeof(ArgumentOutOfRangeException), AllowDerivedTypes = false)]
+        public void CompiledPacketBuilderBuildManyTooSmallBufferTest()
+        {
+            CompiledPacketBuilder builder = new PacketBuilder(new EthernetLayer(), new IpV4Layer(), new UdpLayer()).Compile();
+            builder.BuildMany(new byte[2 * builder.Length - 1], 0, 2, null, new int[2], new int[2]);
+        }
+
+        [TestMethod]
+        public void CompiledPacketBuilderUdpChecksumTest()
+        {
+            const int NumPackets = 100;
+
+            UdpLayer udpLayer = new UdpLayer {CalculateChecksumValue = true};
+            PacketBuilder packetBuilder = new PacketBuilder(new EthernetLayer(), new IpV4Layer(), udpLayer, new PayloadLayer {Data = new Datagram(new byte[100])});
+            CompiledPacketBuilder compiledBuilder = packetBuilder.Compile();
+
+            byte[] buffer = new byte[NumPackets * compiledBuilder.Length];
+            int[] offsets = new int[NumPackets];
+            int[] lengths = new int[NumPackets];
+            compiledBuilder.BuildMany(buffer, 0, NumPackets, i => udpLayer.SourcePort = (ushort)(i * 500), offsets, lengths);
+
+            // Only the source port changes, so the UDP checksum must follow it in every packet.
+            for (int i = 0; i != NumPackets; ++i)
+            {
+                udpLayer.SourcePort = (ushort)(i * 500);
+                Packet packet = new Packet(buffer.Skip(offsets[i]).Take(lengths[i]).ToArray(), DateTime.Now, DataLinkKind.Ethernet);
+                Assert.AreEqual(packetBuilder.Build(DateTime.Now), packet);
+                Assert.IsTrue(packet.Ethernet.IpV4.IsTransportChecksumCorrect);
+            }
+        }
     }
 }
\ No newline at end of file
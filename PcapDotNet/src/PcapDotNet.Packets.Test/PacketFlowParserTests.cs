@@ -0,0 +1,230 @@
+﻿using System;
+using System.Diagnostics.CodeAnalysis;
+using Microsoft.VisualStudio.TestTools.UnitTesting;
+using PcapDotNet.Packets.Ethernet;
+using PcapDotNet.Packets.Gre;
+using PcapDotNet.Packets.IpV4;
+using PcapDotNet.Packets.IpV6;
+using PcapDotNet.Packets.TestUtils;
+using PcapDotNet.Packets.Transport;
+using PcapDotNet.TestUtils;
+
+namespace PcapDotNet.Packets.Test
+{
+    /// <summary>
+    /// Summary description for PacketFlowParserTests
+    /// </summary>
+    [TestClass]
+    [ExcludeFromCodeCoverage]
+    public class PacketFlowParserTests
+    {
+        /// <summary>
+        /// Gets or sets the test context which provides
+        /// information about and functionality for the current test run.
+        /// </summary>
+        public TestContext TestContext { get; set; }
+
+        [TestMethod]
+        public void PacketFlowParserRandomTest()
+        {
+            Random random = new Random();
+            for (int i = 0; i != 1000; ++i)
+            {
+                EthernetLayer ethernetLayer = random.NextEthernetLayer(EthernetType.None);
+                VLanTaggedFrameLayer vLanTaggedFrameLayer = random.NextBool() ? random.NextVLanTaggedFrameLayer(EthernetType.None) : null;
+                IpV4Layer ipV4Layer = random.NextIpV4Layer(null);
+                ipV4Layer.Fragmentation = IpV4Fragmentation.None;
+                IpV6Layer ipV6Layer = new IpV6Layer {Source = random.NextIpV6Address(), CurrentDestination = random.NextIpV6Address(), HopLimit = random.NextByte()};
+                bool isIpV6 = random.NextBool();
+                Layer ipLayer = isIpV6 ? (Layer)ipV6Layer : ipV4Layer;
+                TransportLayer transportLayer = random.NextBool() ? (TransportLayer)random.NextTcpLayer() : random.NextUdpLayer();
+                PayloadLayer payloadLayer = random.NextPayloadLayer(random.Next(100));
+                Packet packet = vLanTaggedFrameLayer == null
+                                    ? PacketBuilder.Build(DateTime.Now, ethernetLayer, ipLayer, transportLayer, payloadLayer)
+                                    : PacketBuilder.Build(DateTime.Now, ethernetLayer, vLanTaggedFrameLayer, ipLayer, transportLayer, payloadLayer);
+
+                PacketFlowInfo info;
+                Assert.IsTrue(PacketFlowParser.TryParse(packet, out info));
+                int networkOffset = ethernetLayer.Length + (vLanTaggedFrameLayer == null ? 0 : vLanTaggedFrameLayer.Length);
+                int transportOffset = networkOffset + ipLayer.Length;
+                Assert.AreEqual(vLanTaggedFrameLayer == null ? 0 : 1, info.VLanTagCount);
+                Assert.AreEqual(isIpV6 ? EthernetType.IpV6 : EthernetType.IpV4, info.NetworkType);
+                Assert.AreEqual(networkOffset, info.NetworkOffset);
+                Assert.AreEqual(transportOffset, info.TransportOffset);
+                Assert.AreEqual(transportLayer.PreviousLayerProtocol, info.TransportProtocol);
+                Assert.AreEqual(transportOffset + transportLayer.Length, info.HeadersLength);
+                Assert.IsFalse(info.IsFragment);
+                Assert.AreEqual(EthernetType.None, info.GreProtocolType);
+                Assert.IsTrue(info.HasFlowKey);
+
+                PacketFlowKey expectedKey = isIpV6
+                                                ? new PacketFlowKey(true, ipV6Layer.Source.ToValue(), ipV6Layer.CurrentDestination.ToValue(), transportLayer.PreviousLayerProtocol,
+                                                                    transportLayer.SourcePort, transportLayer.DestinationPort)
+                                                : new PacketFlowKey(false, ipV4Layer.Source.ToValue(), ipV4Layer.CurrentDestination.ToValue(), transportLayer.PreviousLayerProtocol,
+                                                                    transportLayer.SourcePort, transportLayer.DestinationPort);
+                Assert.AreEqual(expectedKey, info.FlowKey);
+                Assert.AreEqual(expectedKey.GetHashCode(), info.FlowKey.GetHashCode());
+                Assert.AreEqual(expectedKey, info.FlowKey.Reverse().Reverse());
+
+                PacketFlowKey reverseKey = info.FlowKey.Reverse();
+                Assert.AreEqual(expectedKey.Destination, reverseKey.Source);
+                Assert.AreEqual(expectedKey.Source, reverseKey.Destination);
+                Assert.AreEqual(expectedKey.DestinationPort, reverseKey.SourcePort);
+                Assert.AreEqual(expectedKey.SourcePort, reverseKey.DestinationPort);
+                Assert.AreEqual(expectedKey, reverseKey.Reverse());
+            }
+        }
+
+        [TestMethod]
+        public void PacketFlowParserIpV6ExtensionHeadersTest()
+        {
+            IpV6Layer ipV6Layer = new IpV6Layer
+                                  {
+                                      Source = new IpV6Address("2001:db8::1"),
+                                      CurrentDestination = new IpV6Address("2001:db8::2"),
+                                      HopLimit = 64,
+                                      ExtensionHeaders = new IpV6ExtensionHeaders(
+                                          new IpV6ExtensionHeaderHopByHopOptions(null, new IpV6Options(new IpV6OptionPadN(4))),
+                                          new IpV6ExtensionHeaderDestinationOptions(null, new IpV6Options(new IpV6OptionPadN(12))),
+                                          new IpV6ExtensionHeaderFragmentData(null, 0, true, 1234)),
+                                  };
+            UdpLayer udpLayer = new UdpLayer {SourcePort = 53, DestinationPort = 5353};
+            Packet packet = PacketBuilder.Build(DateTime.Now, new EthernetLayer(), ipV6Layer, udpLayer, new PayloadLayer {Data = new Datagram(new byte[10])});
+
+            PacketFlowInfo info;
+            Assert.IsTrue(PacketFlowParser.TryParse(packet, out info));
+            Assert.AreEqual(EthernetDatagram.HeaderLengthValue, info.NetworkOffset);
+            Assert.AreEqual(EthernetDatagram.HeaderLengthValue + ipV6Layer.Length, info.TransportOffset);
+            Assert.AreEqual(IpV4Protocol.Udp, info.TransportProtocol);
+            Assert.AreEqual(EthernetDatagram.HeaderLengthValue + ipV6Layer.Length + UdpDatagram.HeaderLength, info.HeadersLength);
+            Assert.IsFalse(info.IsFragment);
+            Assert.AreEqual((ushort)53, info.FlowKey.SourcePort);
+            Assert.AreEqual((ushort)5353, info.FlowKey.DestinationPort);
+            Assert.AreEqual(ipV6Layer.CurrentDestination.ToValue(), info.FlowKey.Destination);
+        }
+
+        [TestMethod]
+        public void PacketFlowParserFragmentTest()
+        {
+            IpV4Layer ipV4Layer = new IpV4Layer
+                                  {
+                                      Source = new IpV4Address("1.2.3.4"),
+                                      CurrentDestination = new IpV4Address("5.6.7.8"),
+                                      Fragmentation = new IpV4Fragmentation(IpV4FragmentationOptions.None, 8),
+                                      Ttl = 64,
+                                  };
+            Packet packet = PacketBuilder.Build(DateTime.Now, new EthernetLayer(), ipV4Layer, new TcpLayer {SourcePort = 1, DestinationPort = 2});
+
+            PacketFlowInfo info;
+            Assert.IsTrue(PacketFlowParser.TryParse(packet, out info));
+            Assert.IsTrue(info.IsFragment);
+            Assert.AreEqual(IpV4Protocol.Tcp, info.TransportProtocol);
+            Assert.AreEqual(-1, info.TransportOffset);
+            Assert.AreEqual(EthernetDatagram.HeaderLengthValue + IpV4Datagram.HeaderMinimumLength, info.HeadersLength);
+            Assert.AreEqual(new PacketFlowKey(false, new IpV4Address("1.2.3.4").ToValue(), new IpV4Address("5.6.7.8").ToValue(), 0, 0, 0), info.FlowKey);
+
+            IpV6Layer ipV6Layer = new IpV6Layer
+                                  {
+                                      Source = new IpV6Address("2001:db8::1"),
+                                      CurrentDestination = new IpV6Address("2001:db8::2"),
+                                      ExtensionHeaders = new IpV6ExtensionHeaders(new IpV6ExtensionHeaderFragmentData(null, 100, false, 1234)),
+                                  };
+            packet = PacketBuilder.Build(DateTime.Now, new EthernetLayer(), ipV6Layer, new UdpLayer {SourcePort = 1, DestinationPort = 2});
+            Assert.IsTrue(PacketFlowParser.TryParse(packet, out info));
+            Assert.IsTrue(info.IsFragment);
+            Assert.AreEqual(IpV4Protocol.Udp, info.TransportProtocol);
+            Assert.AreEqual(-1, info.TransportOffset);
+            Assert.AreEqual((IpV4Protocol)0, info.FlowKey.Protocol);
+            Assert.AreEqual((ushort)0, info.FlowKey.SourcePort);
+            Assert.AreEqual((ushort)0, info.FlowKey.DestinationPort);
+        }
+
+        [TestMethod]
+        public void PacketFlowParserGreTest()
+        {
+            Random random = new Random();
+            for (int i = 0; i != 200; ++i)
+            {
+                EthernetLayer ethernetLayer = random.NextEthernetLayer(EthernetType.None);
+                IpV4Layer ipV4Layer = random.NextIpV4Layer(null);
+                ipV4Layer.Fragmentation = IpV4Fragmentation.None;
+                GreLayer greLayer = random.NextGreLayer();
+                Packet packet = PacketBuilder.Build(DateTime.Now, ethernetLayer, ipV4Layer, greLayer, random.NextPayloadLayer(random.Next(100)));
+
+                PacketFlowInfo info;
+                Assert.IsTrue(PacketFlowParser.TryParse(packet, out info));
+                Assert.AreEqual(IpV4Protocol.Gre, info.TransportProtocol);
+                Assert.AreEqual(ethernetLayer.Length + ipV4Layer.Length, info.TransportOffset);
+                Assert.AreEqual(ethernetLayer.Length + ipV4Layer.Length + greLayer.Length, info.HeadersLength);
+                Assert.AreEqual(greLayer.ProtocolType, info.GreProtocolType);
+                Assert.AreEqual((ushort)0, info.FlowKey.SourcePort);
+                Assert.AreEqual((ushort)0, info.FlowKey.DestinationPort);
+            }
+        }
+
+        [TestMethod]
+        public void PacketFlowParserIpV4DataLinkTest()
+        {
+            IpV4Layer ipV4Layer = new IpV4Layer {Source = new IpV4Address("1.2.3.4"), CurrentDestination = new IpV4Address("5.6.7.8"), Ttl = 64};
+            Packet packet = PacketBuilder.Build(DateTime.Now, ipV4Layer, new UdpLayer {SourcePort = 1000, DestinationPort = 2000});
+            Assert.AreEqual(DataLinkKind.IpV4, packet.DataLink.Kind);
+
+            PacketFlowInfo info;
+            Assert.IsTrue(PacketFlowParser.TryParse(packet, out info));
+            Assert.AreEqual(0, info.NetworkOffset);
+            Assert.AreEqual(IpV4Datagram.HeaderMinimumLength, info.TransportOffset);
+            Assert.AreEqual(new PacketFlowKey(false, ipV4Layer.Source.ToValue(), ipV4Layer.CurrentDestination.ToValue(), IpV4Protocol.Udp, 1000, 2000), info.FlowKey);
+
+            // A packet in the middle of a larger buffer.
+            byte[] buffer = new byte[packet.Length + 20];
+            packet.CopyTo(buffer, 7);
+            Assert.IsTrue(PacketFlowParser.TryParse(buffer, 7, packet.Length, DataLinkKind.IpV4, out info));
+            Assert.AreEqual(0, info.NetworkOffset);
+            Assert.AreEqual(IpV4Datagram.HeaderMinimumLength, info.TransportOffset);
+            Assert.AreEqual(IpV4Datagram.HeaderMinimumLength + UdpDatagram.HeaderLength, info.HeadersLength);
+        }
+
+        [TestMethod]
+        public void PacketFlowParserNoFlowTest()
+        {
+            PacketFlowInfo info;
+
+            // Not IP.
+            Packet packet = PacketBuilder.Build(DateTime.Now, new EthernetLayer {EtherType = EthernetType.Arp}, new PayloadLayer {Data = new Datagram(new byte[28])});
+            Assert.IsFalse(PacketFlowParser.TryParse(packet, out info));
+            Assert.IsFalse(info.HasFlowKey);
+            Assert.AreEqual(-1, info.NetworkOffset);
+            Assert.AreEqual(EthernetDatagram.HeaderLengthValue, info.HeadersLength);
+
+            // Truncated IP.
+            packet = PacketBuilder.Build(DateTime.Now, new EthernetLayer(), new IpV4Layer(), new TcpLayer());
+            Assert.IsFalse(PacketFlowParser.TryParse(packet.Buffer, 0, EthernetDatagram.HeaderLengthValue + 10, DataLinkKind.Ethernet, out info));
+            Assert.IsFalse(info.HasFlowKey);
+
+            // Truncated transport.
+            Assert.IsTrue(PacketFlowParser.TryParse(packet.Buffer, 0, EthernetDatagram.HeaderLengthValue + IpV4Datagram.HeaderMinimumLength + 2, DataLinkKind.Ethernet, out info));
+            Assert.AreEqual(EthernetDatagram.HeaderLengthValue + IpV4Datagram.HeaderMinimumLength, info.TransportOffset);
+            Assert.AreEqual(EthernetDatagram.HeaderLengthValue + IpV4Datagram.HeaderMinimumLength + 2, info.HeadersLength);
+            Assert.AreEqual((ushort)0, info.FlowKey.SourcePort);
+
+            // Too short for Ethernet.
+            Assert.IsFalse(PacketFlowParser.TryParse(new byte[5], 0, 5, DataLinkKind.Ethernet, out info));
+        }
+
+        [TestMethod]
+        [ExpectedException(typeof(ArgumentNullException), AllowDerivedTypes = false)]
+        public void PacketFlowParserNullPacketTest()
+        {
+            PacketFlowInfo info;
+            Assert.IsFalse(PacketFlowParser.TryParse(null, out info));
+        }
+
+        [TestMethod]
+        [ExpectedException(typeof(ArgumentOutOfRangeException), AllowDerivedTypes = false)]
+        public void PacketFlowParserLengthOutOfRangeTest()
+        {
+            PacketFlowInfo info;
+            Assert.IsFalse(PacketFlowParser.TryParse(new byte[10], 5, 6, DataLinkKind.Ethernet, out info));
+        }
+    }
+}
@@ -0,0 +1,226 @@
+﻿using System;
+using System.Diagnostics.CodeAnalysis;
+using System.Linq;
+using Microsoft.VisualStudio.TestTools.UnitTesting;
+using PcapDotNet.Packets.Dns;
+using PcapDotNet.Packets.Ethernet;
+using PcapDotNet.Packets.IpV4;
+using PcapDotNet.Packets.IpV6;
+using PcapDotNet.Packets.TestUtils;
+using PcapDotNet.Packets.Transport;
+using PcapDotNet.TestUtils;
+
+namespace PcapDotNet.Packets.Test
+{
+    /// <summary>
+    /// Summary description for PacketTemplateTests
+    /// </summary>
+    [TestClass]
+    [ExcludeFromCodeCoverage]
+    public class PacketTemplateTests
+    {
+        /// <summary>
+        /// Gets or sets the test context which provides
+        /// information about and functionality for the current test run.
+        /// </summary>
+        public TestContext TestContext { get; set; }
+
+        [TestMethod]
+        public void PacketTemplateTcpTest()
+        {
+            Random random = new Random();
+            for (int i = 0; i != 100; ++i)
+            {
+                EthernetLayer ethernetLayer = random.NextEthernetLayer(EthernetType.None);
+                IpV4Layer ipV4Layer = random.NextIpV4Layer(null);
+                ipV4Layer.HeaderChecksum = null;
+                ipV4Layer.Fragmentation = IpV4Fragmentation.None;
+                TcpLayer tcpLayer = random.NextTcpLayer();
+                PayloadLayer payloadLayer = random.NextPayloadLayer(random.Next(100));
+
+                PacketTemplate template = new PacketTemplate(ethernetLayer, ipV4Layer, tcpLayer, payloadLayer);
+                PacketTemplateField source = template.DeclareField(PacketTemplateFieldKind.IpV4Source);
+                PacketTemplateField destination = template.DeclareField(PacketTemplateFieldKind.IpV4Destination);
+                PacketTemplateField identification = template.DeclareField(PacketTemplateFieldKind.IpV4Identification);
+                PacketTemplateField sourcePort = template.DeclareField(PacketTemplateFieldKind.TransportSourcePort);
+                PacketTemplateField destinationPort = template.DeclareField(PacketTemplateFieldKind.TransportDestinationPort);
+                PacketTemplateField sequenceNumber = template.DeclareField(PacketTemplateFieldKind.TcpSequenceNumber);
+                PacketTemplateField acknowledgmentNumber = template.DeclareField(PacketTemplateFieldKind.TcpAcknowledgmentNumber);
+                Assert.AreSame(source, template.DeclareField(PacketTemplateFieldKind.IpV4Source));
+                Assert.AreEqual(7, template.Fields.Count);
+                Assert.AreEqual(ipV4Layer.Source.ToValue(), source.Value);
+                Assert.AreEqual(tcpLayer.SequenceNumber, sequenceNumber.Value);
+
+                for (int j = 0; j != 10; ++j)
+                {
+                    ipV4Layer.Source = random.NextIpV4Address();
+                    ipV4Layer.CurrentDestination = random.NextIpV4Address();
+                    ipV4Layer.Identification = random.NextUShort();
+                    tcpLayer.SourcePort = random.NextUShort();
+                    tcpLayer.DestinationPort = random.NextUShort();
+                    tcpLayer.SequenceNumber = random.NextUInt();
+                    tcpLayer.AcknowledgmentNumber = random.NextUInt();
+
+                    source.Value = ipV4Layer.Source.ToValue();
+                    destination.Value = ipV4Layer.CurrentDestination.ToValue();
+                    identification.Value = ipV4Layer.Identification;
+                    sourcePort.Value = tcpLayer.SourcePort;
+                    destinationPort.Value = tcpLayer.DestinationPort;
+                    sequenceNumber.Value = tcpLayer.SequenceNumber;
+                    acknowledgmentNumber.Value = tcpLayer.AcknowledgmentNumber;
+
+                    Packet expectedPacket = PacketBuilder.Build(DateTime.Now, ethernetLayer, ipV4Layer, tcpLayer, payloadLayer);
+                    Packet packet = template.CreatePacket(expectedPacket.Timestamp);
+                    Assert.AreEqual(expectedPacket, packet, "Packet " + i + " variant " + j);
+                    Assert.IsTrue(packet.Ethernet.IpV4.IsHeaderChecksumCorrect);
+                    Assert.IsTrue(packet.Ethernet.IpV4.IsTransportChecksumCorrect);
+                }
+
+                template.Reset();
+                Assert.AreEqual(template.Packet, template.CreatePacket(template.Packet.Timestamp));
+            }
+        }
+
+        [TestMethod]
+        public void PacketTemplateUdpTest()
+        {
+            Random random = new Random();
+            for (int i = 0; i != 100; ++i)
+            {
+                EthernetLayer ethernetLayer = random.NextEthernetLayer(EthernetType.None);
+                IpV6Layer ipV6Layer = new IpV6Layer
+                                      {
+                                          Source = random.NextIpV6Address(),
+                                          CurrentDestination = random.NextIpV6Address(),
+                                          HopLimit = random.NextByte(),
+                                      };
+                UdpLayer udpLayer = new UdpLayer {SourcePort = random.NextUShort(), DestinationPort = 53, CalculateChecksumValue = true};
+                DnsLayer dnsLayer = random.NextDnsLayer();
+
+                PacketTemplate template = new PacketTemplate(ethernetLayer, ipV6Layer, udpLayer, dnsLayer);
+                PacketTemplateField sourcePort = template.DeclareField(PacketTemplateFieldKind.TransportSourcePort);
+                PacketTemplateField id = template.DeclareField(PacketTemplateFieldKind.DnsId);
+
+                for (int j = 0; j != 10; ++j)
+                {
+                    udpLayer.SourcePort = random.NextUShort();
+                    dnsLayer.Id = random.NextUShort();
+                    sourcePort.Value = udpLayer.SourcePort;
+                    id.Value = dnsLayer.Id;
+
+                    Packet expectedPacket = PacketBuilder.Build(DateTime.Now, ethernetLayer, ipV6Layer, udpLayer, dnsLayer);
+                    Packet packet = template.CreatePacket(expectedPacket.Timestamp);
+                    Assert.AreEqual(expectedPacket, packet, "Packet " + i + " variant " + j);
+                    Assert.IsTrue(packet.Ethernet.IpV6.IsTransportChecksumCorrect);
+                }
+            }
+        }
+
+        [TestMethod]
+        public void PacketTemplateUdpWithoutChecksumTest()
+        {
+            PacketTemplate template = new PacketTemplate(new EthernetLayer(),
+                                                         new IpV4Layer(),
+                                                         new UdpLayer {CalculateChecksumValue = false},
+                                                         new PayloadLayer {Data = new Datagram(new byte[10])});
+            Assert.AreEqual(0, template.Packet.Ethernet.IpV4.Udp.Checksum);
+
+            template.DeclareField(PacketTemplateFieldKind.IpV4Source).Value = 0x01020304;
+            template.DeclareField(PacketTemplateFieldKind.TransportDestinationPort).Value = 80;
+            Packet packet = template.CreatePacket(DateTime.Now);
+            Assert.AreEqual(new IpV4Address("1.2.3.4"), packet.Ethernet.IpV4.Source);
+            Assert.AreEqual(80, packet.Ethernet.IpV4.Udp.DestinationPort);
+            Assert.AreEqual(0, packet.Ethernet.IpV4.Udp.Checksum);
+            Assert.IsTrue(packet.Ethernet.IpV4.IsHeaderChecksumCorrect);
+            Assert.IsTrue(packet.IsValid);
+        }
+
+        [TestMethod]
+        public void PacketTemplateVLanTaggedFrameTest()
+        {
+            PacketTemplate template = new PacketTemplate(new EthernetLayer(),
+                                                         new VLanTaggedFrameLayer(),
+                                                         new IpV4Layer(),
+                                                         new TcpLayer());
+            PacketTemplateField sequenceNumber = template.DeclareField(PacketTemplateFieldKind.TcpSequenceNumber);
+            Assert.AreEqual(EthernetDatagram.HeaderLengthValue + VLanTaggedFrameDatagram.HeaderLengthValue + IpV4Datagram.HeaderMinimumLength + 4, sequenceNumber.Offset);
+            Assert.AreEqual(sizeof(uint), sequenceNumber.Length);
+
+            sequenceNumber.Value = uint.MaxValue;
+            byte[] buffer = new byte[10 + template.Length];
+            template.Write(buffer, 10);
+            Packet packet = new Packet(buffer.Skip(10).ToArray(), DateTime.Now, DataLinkKind.Ethernet);
+            Assert.AreEqual(uint.MaxValue, packet.Ethernet.VLanTaggedFrame.IpV4.Tcp.SequenceNumber);
+            Assert.IsTrue(packet.IsValid);
+        }
+
+        [TestMethod]
+        public void PacketTemplateErrorsTest()
+        {
+            PacketTemplate template = new PacketTemplate(new EthernetLayer(), new IpV4Layer(), new UdpLayer());
+            foreach (PacketTemplateFieldKind kind in new[] {PacketTemplateFieldKind.TcpSequenceNumber, PacketTemplateFieldKind.TcpAcknowledgmentNumber, PacketTemplateFieldKind.DnsId})
+            {
+                try
+                {
+                    template.DeclareField(kind);
+                    Assert.Fail(kind.ToString());
+                }
+                catch (ArgumentException)
+                {
+                }
+            }
+
+            template = new PacketTemplate(new EthernetLayer(), new IpV4Layer {Fragmentation = new IpV4Fragmentation(IpV4FragmentationOptions.None, 8)}, new UdpLayer());
+            template.DeclareField(PacketTemplateFieldKind.IpV4Source);
+            try
+            {
+                template.DeclareField(PacketTemplateFieldKind.TransportSourcePort);
+                Assert.Fail();
+            }
+            catch (ArgumentException)
+            {
+            }
+
+            PacketTemplateField port = new PacketTemplate(new EthernetLayer(), new IpV4Layer(), new TcpLayer()).DeclareField(PacketTemplateFieldKind.TransportSourcePort);
+            try
+            {
+                port.Value = ushort.MaxValue + 1;
+                Assert.Fail();
+            }
+            catch (ArgumentOutOfRangeException)
+            {
+            }
+        }
+
+        [TestMethod]
+        public void PacketTemplateWriteManyTest()
+        {
+            const int NumPackets = 100;
+
+            PacketTemplate template = new PacketTemplate(new EthernetLayer(),
+                                                         new IpV4Layer {Source = new IpV4Address("10.0.0.1"), Ttl = 64},
+                                                         new TcpLayer {ControlBits = TcpControlBits.Synchronize},
+                                                         new PayloadLayer {Data = new Datagram(new byte[1000])});
+            PacketTemplateField source = template.DeclareField(PacketTemplateFieldKind.IpV4Source);
+            PacketTemplateField port = template.DeclareField(PacketTemplateFieldKind.TransportSourcePort);
+
+            // Every write only touches its own packet, and the checksums follow the fields.
+            byte[] buffer = new byte[template.Length * NumPackets];
+            for (int i = 0; i != NumPackets; ++i)
+            {
+                source.Value = (uint)i;
+                port.Value = (uint)(i * 1000);
+                template.Write(buffer, i * template.Length);
+            }
+
+            for (int i = 0; i != NumPackets; ++i)
+            {
+                Packet packet = new Packet(buffer.Skip(i * template.Length).Take(template.Length).ToArray(), DateTime.Now, DataLinkKind.Ethernet);
+                Assert.AreEqual(new IpV4Address((uint)i), packet.Ethernet.IpV4.Source);
+                Assert.AreEqual(i * 1000, packet.Ethernet.IpV4.Tcp.SourcePort);
+                Assert.IsTrue(packet.Ethernet.IpV4.IsHeaderChecksumCorrect);
+                Assert.IsTrue(packet.Ethernet.IpV4.IsTransportChecksumCorrect);
+            }
+        }
+    }
+}
@@ -4,8 +4,14 @@ using System.Collections.Generic;
 using System.Diagnostics.CodeAnalysis;
 using System.Linq;
 using System.Reflection;
+using System.Threading;
 using Microsoft.VisualStudio.TestTools.UnitTesting;
+using PcapDotNet.Packets.Ethernet;
+using PcapDotNet.Packets.Ip;
+using PcapDotNet.Packets.IpV4;
 using PcapDotNet.Packets.TestUtils;
+using PcapDotNet.Packets.Transport;
+using PcapDotNet.TestUtils;
 
 namespace PcapDotNet.Packets.Test
 {
@@ -144,5 +150,232 @@ namespace PcapDotNet.Packets.Test
             Assert.IsNotNull(Packet.FromHexadecimalString(null, DateTime.MinValue, DataLinkKind.Ethernet));
             Assert.Fail();
         }
+
+        [TestMethod]
+        public void PacketSegmentTest()
+        {
+            Random random = new Random();
+            for (int i = 0; i != 100; ++i)
+            {
+                Packet packet = random.NextPacket(random.Next(100, 1000));
+                int offset = random.Next(100);
+                byte[] buffer = new byte[offset + packet.Length + random.Next(100)];
+                random.NextBytes(buffer);
+                packet.CopyTo(buffer, offset);
+
+                DisposeCounter owner = new DisposeCounter();
+                using (Packet segmentPacket = new Packet(buffer, offset, packet.Length, packet.Timestamp, packet.DataLink, packet.OriginalLength, owner))
+                {
+                    Assert.AreEqual(packet, segmentPacket);
+                    Assert.AreEqual(packet.GetHashCode(), segmentPacket.GetHashCode());
+                    Assert.AreEqual(offset, segmentPacket.StartOffset);
+                    Assert.AreEqual(packet.Length, segmentPacket.Count);
+                    Assert.AreEqual(packet.OriginalLength, segmentPacket.OriginalLength);
+                    Assert.IsTrue(packet.SequenceEqual(segmentPacket));
+                    Assert.AreEqual(packet.IndexOf(packet[packet.Length / 2]), segmentPacket.IndexOf(packet[packet.Length / 2]));
+                    Assert.AreEqual(packet.Ethernet, segmentPacket.Ethernet);
+                    Assert.AreEqual(packet.Ethernet.Payload, segmentPacket.Ethernet.Payload);
+                    Assert.AreEqual(packet.IsValid, segmentPacket.IsValid);
+
+                    byte[] copy = new byte[packet.Length];
+                    segmentPacket.CopyTo(copy, 0);
+                    Assert.AreEqual(packet, new Packet(copy, packet.Timestamp, packet.DataLink));
+
+                    segmentPacket.Dispose();
+                    Assert.AreEqual(1, owner.DisposeCount);
+                }
+
+                // Disposing twice releases the owner once.
+                Assert.AreEqual(1, owner.DisposeCount);
+            }
+        }
+
+        [TestMethod]
+        [ExpectedException(typeof(ArgumentOutOfRangeException), AllowDerivedTypes = false)]
+        public void PacketSegmentLengthOutOfRangeTest()
+        {
+            Assert.IsNotNull(new Packet(new byte[10], 5, 6, DateTime.Now, new DataLink(DataLinkKind.Ethernet)));
+            Assert.Fail();
+        }
+
+        [TestMethod]
+        [ExpectedException(typeof(ArgumentOutOfRangeException), AllowDerivedTypes = false)]
+        public void PacketSegmentIndexOutOfRangeTest()
+        {
+            Packet packet = new Packet(new byte[10], 5, 4, DateTime.Now, new DataLink(DataLinkKind.Ethernet));
+            Assert.AreEqual(0, packet[4]);
+            Assert.Fail();
+        }
+
+        [TestMethod]
+        public void PacketRebindTest()
+        {
+            Random random = new Random();
+            Packet rebindablePacket = Packet.CreateRebindable(DataLinkKind.Ethernet);
+            Assert.IsTrue(rebindablePacket.IsRebindable);
+            Assert.AreEqual(0, rebindablePacket.Length);
+            EthernetDatagram ethernet = rebindablePacket.Ethernet;
+
+            DisposeCounter previousOwner = null;
+            for (int i = 0; i != 300; ++i)
+            {
+                Packet packet;
+                if (random.NextBool())
+                {
+                    // The rebindable packet is Ethernet, so random bytes are expected to parse as Ethernet too.
+                    packet = new Packet(random.NextBytes(random.Next(100, 1000)), DateTime.Now, DataLinkKind.Ethernet);
+                }
+                else
+                {
+                    IpV4Layer ipV4Layer = random.NextIpV4Layer(null);
+                    ipV4Layer.HeaderChecksum = null;
+                    Layer ipLayer = random.NextBool() ? (Layer)ipV4Layer : random.NextIpV6Layer(true);
+                    TransportLayer transportLayer = random.NextBool() ? (TransportLayer)random.NextTcpLayer() : random.NextUdpLayer();
+                    transportLayer.Checksum = null;
+                    packet = PacketBuilder.Build(DateTime.Now, random.NextEthernetLayer(EthernetType.None), ipLayer, transportLayer,
+                                                 random.NextPayloadLayer(random.Next(100)));
+                }
+                int offset = random.Next(100);
+                byte[] buffer = new byte[offset + packet.Length + random.Next(100)];
+                random.NextBytes(buffer);
+                packet.CopyTo(buffer, offset);
+
+                DisposeCounter owner = new DisposeCounter();
+                rebindablePacket.Rebind(buffer, offset, packet.Length, packet.Timestamp, packet.OriginalLength, owner);
+                if (previousOwner != null)
+                    Assert.AreEqual(1, previousOwner.DisposeCount);
+                Assert.AreEqual(0, owner.DisposeCount);
+                previousOwner = owner;
+
+                Assert.AreSame(ethernet, rebindablePacket.Ethernet);
+                Assert.AreEqual(packet, rebindablePacket);
+                Assert.AreEqual(packet.Timestamp, rebindablePacket.Timestamp);
+                Assert.AreEqual(packet.OriginalLength, rebindablePacket.OriginalLength);
+                Assert.AreEqual(offset, rebindablePacket.StartOffset);
+                Assert.AreEqual(packet.IsValid, rebindablePacket.IsValid, "Packet " + i);
+                Assert.AreEqual(packet.Ethernet, rebindablePacket.Ethernet);
+                Assert.AreEqual(packet.Ethernet.EtherType, rebindablePacket.Ethernet.EtherType);
+                Assert.AreEqual(packet.Ethernet.Payload, rebindablePacket.Ethernet.Payload);
+
+                IpDatagram expectedIp = packet.Ethernet.Ip;
+                IpDatagram ip = rebindablePacket.Ethernet.Ip;
+                Assert.AreEqual(expectedIp, ip);
+                if (expectedIp == null)
+                    continue;
+
+                Assert.AreEqual(expectedIp.IsValid, ip.IsValid, "Packet " + i);
+                Assert.AreEqual(expectedIp.Payload, ip.Payload);
+                Assert.AreEqual(expectedIp.Transport, ip.Transport);
+                if (expectedIp.Transport == null)
+                    continue;
+
+                Assert.AreEqual(expectedIp.Transport.IsValid, ip.Transport.IsValid);
+                Assert.AreEqual(expectedIp.Transport.SourcePort, ip.Transport.SourcePort);
+                Assert.AreEqual(expectedIp.Transport.Payload, ip.Transport.Payload);
+            }
+
+            rebindablePacket.Dispose();
+            Assert.AreEqual(1, previousOwner.DisposeCount);
+        }
+
+        [TestMethod]
+        [ExpectedException(typeof(InvalidOperationException), AllowDerivedTypes = false)]
+        public void PacketRebindNotRebindableTest()
+        {
+            Packet packet = new Packet(new byte[10], DateTime.Now, DataLinkKind.Ethernet);
+            Assert.IsFalse(packet.IsRebindable);
+            packet.Rebind(new byte[20], 0, 20, DateTime.Now);
+            Assert.Fail();
+        }
+
+        [TestMethod]
+        public void PacketParallelReadTest()
+        {
+            const int ThreadCount = 4;
+            Random random = new Random();
+            for (int i = 0; i != 100; ++i)
+            {
+                Packet expectedPacket;
+                if (random.NextBool())
+                {
+                    expectedPacket = random.NextPacket(random.Next(100, 1000));
+                }
+                else
+                {
+                    Layer ipLayer = random.NextBool() ? (Layer)random.NextIpV4Layer(null) : random.NextIpV6Layer(true);
+                    TransportLayer transportLayer = random.NextBool() ? (TransportLayer)random.NextTcpLayer() : random.NextUdpLayer();
+                    expectedPacket = PacketBuilder.Build(DateTime.Now, random.NextEthernetLayer(EthernetType.None), ipLayer, transportLayer,
+                                                         random.NextPayloadLayer(random.Next(100)));
+                }
+                Packet packet = new Packet(expectedPacket.Buffer, expectedPacket.StartOffset, expectedPacket.Length, expectedPacket.Timestamp, expectedPacket.DataLink);
+
+                bool[] isValid = new bool[ThreadCount];
+                EthernetDatagram[] ethernets = new EthernetDatagram[ThreadCount];
+                IpDatagram[] ips = new IpDatagram[ThreadCount];
+                TransportDatagram[] transports = new TransportDatagram[ThreadCount];
+                bool[] isIpValid = new bool[ThreadCount];
+                Exception[] exceptions = new Exception[ThreadCount];
+                using (Barrier barrier = new Barrier(ThreadCount))
+                {
+                    // Every participant of the barrier needs its own thread, or the first ones wait forever for the rest.
+                    Thread[] threads = new Thread[ThreadCount];
+                    for (int thread = 0; thread != ThreadCount; ++thread)
+                    {
+                        int index = thread;
+                        threads[thread] = new Thread(delegate()
+                        {
+                            barrier.SignalAndWait();
+                            try
+                            {
+                                isValid[index] = packet.IsValid;
+                                ethernets[index] = packet.Ethernet;
+                                ips[index] = packet.Ethernet.Ip;
+                                if (ips[index] == null)
+                                    return;
+                                isIpValid[index] = ips[index].IsValid;
+                                transports[index] = ips[index].Transport;
+                            }
+                            catch (Exception exception)
+                            {
+                                exceptions[index] = exception;
+                            }
+                        });
+                        threads[thread].Start();
+                    }
+
+                    foreach (Thread thread in threads)
+                        thread.Join();
+                }
+
+                foreach (Exception exception in exceptions)
+                    Assert.IsNull(exception, "Packet " + i + ": " + exception);
+
+                IpDatagram expectedIp = expectedPacket.Ethernet.Ip;
+                for (int thread = 0; thread != ThreadCount; ++thread)
+                {
+                    Assert.AreEqual(expectedPacket.IsValid, isValid[thread], "Packet " + i);
+                    Assert.AreSame(ethernets[0], ethernets[thread]);
+                    Assert.AreSame(ips[0], ips[thread]);
+                    Assert.AreSame(transports[0], transports[thread]);
+                    Assert.AreEqual(expectedIp, ips[thread]);
+                    if (expectedIp == null)
+                        continue;
+
+                    Assert.AreEqual(expectedIp.IsValid, isIpValid[thread], "Packet " + i);
+                    Assert.AreEqual(expectedIp.Transport, transports[thread]);
+                }
+            }
+        }
+
+        [ExcludeFromCodeCoverage]
+        private sealed class DisposeCounter : IDisposable
+        {
+            public int DisposeCount { get; private set; }
+
+            public void Dispose()
+            {
+                ++DisposeCount;
+            }
+        }
     }
 }
\ No newline at end of file
@@ -0,0 +1,146 @@
+﻿using System;
+using System.Collections.ObjectModel;
+using System.Diagnostics.CodeAnalysis;
+using Microsoft.VisualStudio.TestTools.UnitTesting;
+using PcapDotNet.Packets.Ethernet;
+using PcapDotNet.Packets.IpV4;
+using PcapDotNet.Packets.IpV6;
+using PcapDotNet.Packets.TestUtils;
+using PcapDotNet.Packets.Transport;
+using PcapDotNet.TestUtils;
+
+namespace PcapDotNet.Packets.Test
+{
+    /// <summary>
+    /// Summary description for TcpSegmenterTests
+    /// </summary>
+    [TestClass]
+    [ExcludeFromCodeCoverage]
+    public class TcpSegmenterTests
+    {
+        /// <summary>
+        /// Gets or sets the test context which provides
+        /// information about and functionality for the current test run.
+        /// </summary>
+        public TestContext TestContext { get; set; }
+
+        [TestMethod]
+        public void TcpSegmenterTest()
+        {
+            Random random = new Random();
+            for (int i = 0; i != 300; ++i)
+            {
+                EthernetLayer ethernetLayer = random.NextEthernetLayer(EthernetType.None);
+                VLanTaggedFrameLayer vLanTaggedFrameLayer = random.NextBool() ? random.NextVLanTaggedFrameLayer(EthernetType.None) : null;
+                IpV4Layer ipV4Layer = random.NextIpV4Layer(null);
+                ipV4Layer.HeaderChecksum = null;
+                ipV4Layer.Fragmentation = IpV4Fragmentation.None;
+                IpV6Layer ipV6Layer = new IpV6Layer {Source = random.NextIpV6Address(), CurrentDestination = random.NextIpV6Address(), HopLimit = random.NextByte()};
+                Layer ipLayer = random.NextBool() ? (Layer)ipV4Layer : ipV6Layer;
+                TcpLayer tcpLayer = random.NextTcpLayer();
+                ILayer[] layers = vLanTaggedFrameLayer == null
+                                      ? new ILayer[] {ethernetLayer, ipLayer, tcpLayer}
+                                      : new ILayer[] {ethernetLayer, vLanTaggedFrameLayer, ipLayer, tcpLayer};
+
+                TcpSegmenter segmenter = new TcpSegmenter(layers);
+                byte[] payload = random.NextBytes(random.Next(10000));
+                int maximumSegmentSize = random.Next(1, 1500);
+                DateTime timestamp = DateTime.Now;
+                ReadOnlyCollection<Packet> segments = segmenter.Segment(timestamp, payload, maximumSegmentSize);
+
+                Assert.AreEqual(Math.Max(1, (payload.Length + maximumSegmentSize - 1) / maximumSegmentSize), segments.Count);
+                ushort identification = ipV4Layer.Identification;
+                uint sequenceNumber = tcpLayer.SequenceNumber;
+                TcpControlBits controlBits = tcpLayer.ControlBits;
+                for (int segmentIndex = 0; segmentIndex != segments.Count; ++segmentIndex)
+                {
+                    int payloadOffset = segmentIndex * maximumSegmentSize;
+                    int payloadLength = Math.Min(maximumSegmentSize, payload.Length - payloadOffset);
+                    byte[] segmentPayload = new byte[payloadLength];
+                    Buffer.BlockCopy(payload, payloadOffset, segmentPayload, 0, payloadLength);
+
+                    ipV4Layer.Identification = (ushort)(identification + segmentIndex);
+                    tcpLayer.SequenceNumber = sequenceNumber + (uint)payloadOffset;
+                    tcpLayer.ControlBits = segmentIndex == segments.Count - 1 ? controlBits : controlBits & ~(TcpControlBits.Push | TcpControlBits.Fin);
+                    ILayer[] expectedLayers = new ILayer[layers.Length + 1];
+                    layers.CopyTo(expectedLayers, 0);
+                    expectedLayers[layers.Length] = new PayloadLayer {Data = new Datagram(segmentPayload)};
+                    Packet expectedPacket = PacketBuilder.Build(timestamp, expectedLayers);
+
+                    Assert.AreEqual(expectedPacket, segments[segmentIndex], "Packet " + i + " Segment " + segmentIndex);
+                }
+            }
+        }
+
+        [TestMethod]
+        public void TcpSegmenterEmptyPayloadTest()
+        {
+            TcpSegmenter segmenter = new TcpSegmenter(new EthernetLayer(), new IpV4Layer(), new TcpLayer {ControlBits = TcpControlBits.Fin});
+            ReadOnlyCollection<Packet> segments = segmenter.Segment(DateTime.Now, new byte[0], 1460);
+            Assert.AreEqual(1, segments.Count);
+            Assert.AreEqual(segmenter.HeaderLength, segments[0].Length);
+            Assert.AreEqual(TcpControlBits.Fin, segments[0].Ethernet.IpV4.Tcp.ControlBits);
+            Assert.IsTrue(segments[0].IsValid);
+        }
+
+        [TestMethod]
+        [ExpectedException(typeof(ArgumentException), AllowDerivedTypes = false)]
+        public void TcpSegmenterNoTcpTest()
+        {
+            Assert.IsNotNull(new TcpSegmenter(new EthernetLayer(), new IpV4Layer(), new UdpLayer()));
+        }
+
+        [TestMethod]
+        [ExpectedException(typeof(ArgumentNullException), AllowDerivedTypes = false)]
+        public void TcpSegmenterNullLayersTest()
+        {
+            Assert.IsNotNull(new TcpSegmenter(null));
+        }
+
+        [TestMethod]
+        [ExpectedException(typeof(ArgumentNullException), AllowDerivedTypes = false)]
+        public void TcpSegmenterNullPayloadTest()
+        {
+            new TcpSegmenter(new EthernetLayer(), new IpV4Layer(), new TcpLayer()).Segment(DateTime.Now, null, 1460);
+        }
+
+        [TestMethod]
+        [ExpectedException(typeof(ArgumentOutOfRangeException), AllowDerivedTypes = false)]
+        public void TcpSegmenterZeroMaximumSegmentSizeTest()
+        {
+            new TcpSegmenter(new EthernetLayer(), new IpV4Layer(), new TcpLayer()).Segment(DateTime.Now, new byte[10], 0);
+        }
+
+        [TestMethod]
+        [ExpectedException(typeof(ArgumentOutOfRangeException), AllowDerivedTypes = false)]
+        public void TcpSegmenterTooBigSegmentTest()
+        {
+            new TcpSegmenter(new EthernetLayer(), new IpV4Layer(), new TcpLayer()).Segment(DateTime.Now, new byte[ushort.MaxValue], ushort.MaxValue);
+        }
+
+        [TestMethod]
+        public void TcpSegmenterLargePayloadTest()
+        {
+            const uint SequenceNumber = uint.MaxValue - 1000;
+            const int MaximumSegmentSize = 1460;
+
+            TcpSegmenter segmenter = new TcpSegmenter(new EthernetLayer(), new IpV4Layer(),
+                                                      new TcpLayer {SequenceNumber = SequenceNumber, ControlBits = TcpControlBits.Acknowledgment});
+            byte[] payload = new Random().NextBytes(1024 * 1024);
+            ReadOnlyCollection<Packet> segments = segmenter.Segment(DateTime.Now, payload, MaximumSegmentSize);
+            Assert.AreEqual((payload.Length + MaximumSegmentSize - 1) / MaximumSegmentSize, segments.Count);
+
+            // The sequence numbers wrap around and the segments put together give back the payload.
+            byte[] reassembledPayload = new byte[payload.Length];
+            for (int i = 0; i != segments.Count; ++i)
+            {
+                IpV4Datagram ipV4 = segments[i].Ethernet.IpV4;
+                Assert.IsTrue(ipV4.IsHeaderChecksumCorrect, "Segment " + i);
+                Assert.IsTrue(ipV4.IsTransportChecksumCorrect, "Segment " + i);
+                Assert.AreEqual(unchecked(SequenceNumber + (uint)(i * MaximumSegmentSize)), ipV4.Tcp.SequenceNumber, "Segment " + i);
+                ipV4.Tcp.Payload.ToMemoryStream().Read(reassembledPayload, i * MaximumSegmentSize, ipV4.Tcp.Payload.Length);
+            }
+            CollectionAssert.AreEqual(payload, reassembledPayload);
+        }
+    }
+}
@@ -2,7 +2,6 @@ using System;
 using System.Collections.Generic;
 using System.Globalization;
 using System.Linq;
-using System.Net;
 using System.Numerics;
 using System.Text;
 using PcapDotNet.Base;
@@ -196,10 +195,7 @@ namespace PcapDotNet.Packets
         [System.Diagnostics.CodeAnalysis.SuppressMessage("Microsoft.Naming", "CA1720:IdentifiersShouldNotContainTypeNames", MessageId = "short")]
         public static short ReadShort(this byte[] buffer, int offset, Endianity endianity)
         {
-            short value = ReadShort(buffer, offset);
-            if (IsWrongEndianity(endianity))
-                value = value.ReverseEndianity();
-            return value;
+            return (short)ReadUShort(buffer, offset, endianity);
         }
 
         /// <summary>
@@ -212,7 +208,10 @@ namespace PcapDotNet.Packets
         [System.Diagnostics.CodeAnalysis.SuppressMessage("Microsoft.Naming", "CA1720:IdentifiersShouldNotContainTypeNames", MessageId = "ushort")]
         public static ushort ReadUShort(this byte[] buffer, int offset, Endianity endianity)
         {
-            return (ushort)ReadShort(buffer, offset, endianity);
+            ushort value = ReadUShort(buffer, offset);
+            if (IsWrongEndianity(endianity))
+                value = ReverseBytes(value);
+            return value;
         }
 
         /// <summary>
@@ -241,7 +240,7 @@ namespace PcapDotNet.Packets
         {
             UInt24 value = ReadUInt24(buffer, offset);
             if (IsWrongEndianity(endianity))
-                value = HostToNetworkOrder(value);
+                value = ReverseBytes(value);
             return value;
         }
 
@@ -269,10 +268,7 @@ namespace PcapDotNet.Packets
         [System.Diagnostics.CodeAnalysis.SuppressMessage("Microsoft.Naming", "CA1720:IdentifiersShouldNotContainTypeNames", MessageId = "int")]
         public static int ReadInt(this byte[] buffer, int offset, Endianity endianity)
         {
-            int value = ReadInt(buffer, offset);
-            if (IsWrongEndianity(endianity))
-                value = IPAddress.HostToNetworkOrder(value);
-            return value;
+            return (int)ReadUInt(buffer, offset, endianity);
         }
 
         /// <summary>
@@ -285,7 +281,10 @@ namespace PcapDotNet.Packets
         [System.Diagnostics.CodeAnalysis.SuppressMessage("Microsoft.Naming", "CA1720:IdentifiersShouldNotContainTypeNames", MessageId = "uint")]
         public static uint ReadUInt(this byte[] buffer, int offset, Endianity endianity)
         {
-            return (uint)ReadInt(buffer, offset, endianity);
+            uint value = ReadUInt(buffer, offset);
+            if (IsWrongEndianity(endianity))
+                value = ReverseBytes(value);
+            return value;
         }
 
         /// <summary>
@@ -314,7 +313,7 @@ namespace PcapDotNet.Packets
         {
             UInt48 value = ReadUInt48(buffer, offset);
             if (IsWrongEndianity(endianity))
-                value = HostToNetworkOrder(value);
+                value = ReverseBytes(value);
             return value;
         }
 
@@ -342,10 +341,7 @@ namespace PcapDotNet.Packets
         [System.Diagnostics.CodeAnalysis.SuppressMessage("Microsoft.Naming", "CA1720:IdentifiersShouldNotContainTypeNames", MessageId = "long")]
         public static long ReadLong(this byte[] buffer, int offset, Endianity endianity)
         {
-            long value = ReadLong(buffer, offset);
-            if (IsWrongEndianity(endianity))
-                value = IPAddress.HostToNetworkOrder(value);
-            return value;
+            return (long)buffer.ReadULong(offset, endianity);
         }
 
         /// <summary>
@@ -358,7 +354,10 @@ namespace PcapDotNet.Packets
         [System.Diagnostics.CodeAnalysis.SuppressMessage("Microsoft.Naming", "CA1720:IdentifiersShouldNotContainTypeNames", MessageId = "ulong")]
         public static ulong ReadULong(this byte[] buffer, int offset, Endianity endianity)
         {
-            return (ulong)buffer.ReadLong(offset, endianity);
+            ulong value = ReadULong(buffer, offset);
+            if (IsWrongEndianity(endianity))
+                value = ReverseBytes(value);
+            return value;
         }
 
         /// <summary>
@@ -372,7 +371,7 @@ namespace PcapDotNet.Packets
         {
             UInt128 value = ReadUInt128(buffer, offset);
             if (IsWrongEndianity(endianity))
-                value = HostToNetworkOrder(value);
+                value = ReverseBytes(value);
             return value;
         }
 
@@ -537,9 +536,7 @@ namespace PcapDotNet.Packets
         /// <param name="endianity">The endianity to use when converting the value to bytes.</param>
         public static void Write(this byte[] buffer, int offset, short value, Endianity endianity)
         {
-            if (IsWrongEndianity(endianity))
-                value = value.ReverseEndianity();
-            Write(buffer, offset, value);
+            Write(buffer, offset, (ushort)value, endianity);
         }
 
         /// <summary>
@@ -551,7 +548,9 @@ namespace PcapDotNet.Packets
         /// <param name="endianity">The endianity to use when converting the value to bytes.</param>
         public static void Write(this byte[] buffer, int offset, ushort value, Endianity endianity)
         {
-            Write(buffer, offset, (short)value, endianity);
+            if (IsWrongEndianity(endianity))
+                value = ReverseBytes(value);
+            Write(buffer, offset, value);
         }
 
         /// <summary>
@@ -577,7 +576,7 @@ namespace PcapDotNet.Packets
         public static void Write(this byte[] buffer, int offset, UInt24 value, Endianity endianity)
         {
             if (IsWrongEndianity(endianity))
-                value = HostToNetworkOrder(value);
+                value = ReverseBytes(value);
             Write(buffer, offset, value);
         }
 
@@ -603,9 +602,7 @@ namespace PcapDotNet.Packets
         /// <param name="endianity">The endianity to use when converting the value to bytes.</param>
         public static void Write(this byte[] buffer, int offset, int value, Endianity endianity)
         {
-            if (IsWrongEndianity(endianity))
-                value = IPAddress.HostToNetworkOrder(value);
-            Write(buffer, offset, value);
+            Write(buffer, offset, (uint)value, endianity);
         }
 
         /// <summary>
@@ -630,7 +627,9 @@ namespace PcapDotNet.Packets
         /// <param name="endianity">The endianity to use when converting the value to bytes.</param>
         public static void Write(this byte[] buffer, int offset, uint value, Endianity endianity)
         {
-            Write(buffer, offset, (int)value, endianity);
+            if (IsWrongEndianity(endianity))
+                value = ReverseBytes(value);
+            Write(buffer, offset, value);
         }
 
         /// <summary>
@@ -656,7 +655,7 @@ namespace PcapDotNet.Packets
         public static void Write(this byte[] buffer, int offset, UInt48 value, Endianity endianity)
         {
             if (IsWrongEndianity(endianity))
-                value = HostToNetworkOrder(value);
+                value = ReverseBytes(value);
             Write(buffer, offset, value);
         }
 
@@ -682,9 +681,7 @@ namespace PcapDotNet.Packets
         /// <param name="endianity">The endianity to use when converting the value to bytes.</param>
         public static void Write(this byte[] buffer, int offset, long value, Endianity endianity)
         {
-            if (IsWrongEndianity(endianity))
-                value = IPAddress.HostToNetworkOrder(value);
-            Write(buffer, offset, value);
+            buffer.Write(offset, (ulong)value, endianity);
         }
 
         /// <summary>
@@ -696,7 +693,9 @@ namespace PcapDotNet.Packets
         /// <param name="endianity">The endianity to use when converting the value to bytes.</param>
         public static void Write(this byte[] buffer, int offset, ulong value, Endianity endianity)
         {
-            buffer.Write(offset, (long)value, endianity);
+            if (IsWrongEndianity(endianity))
+                value = ReverseBytes(value);
+            Write(buffer, offset, value);
         }
 
         /// <summary>
@@ -722,7 +721,7 @@ namespace PcapDotNet.Packets
         public static void Write(this byte[] buffer, int offset, UInt128 value, Endianity endianity)
         {
             if (IsWrongEndianity(endianity))
-                value = HostToNetworkOrder(value);
+                value = ReverseBytes(value);
             Write(buffer, offset, value);
         }
 
@@ -938,75 +937,45 @@ namespace PcapDotNet.Packets
             return (BitConverter.IsLittleEndian == (endianity == Endianity.Big));
         }
 
-        private static UInt24 HostToNetworkOrder(UInt24 value)
-        {
-            UInt24 result;
-
-            unsafe
-            {
-                UInt24* resultPtr = &result;
-                byte* resultBytePtr = (byte*)resultPtr;
-
-                UInt24* valuePtr = &value;
-                byte* valueBytePtr = (byte*)valuePtr;
+        // The bytes are reversed using shifts on the value instead of copying bytes, so the JIT can keep the value in a register.
 
-                resultBytePtr[0] = valueBytePtr[2];
-                resultBytePtr[1] = valueBytePtr[1];
-                resultBytePtr[2] = valueBytePtr[0];
-            }
-
-            return result;
+        private static ushort ReverseBytes(ushort value)
+        {
+            return (ushort)((value >> 8) | (value << 8));
         }
 
-        private static UInt48 HostToNetworkOrder(UInt48 value)
+        private static uint ReverseBytes(uint value)
         {
-            UInt48 result;
-
-            unsafe
-            {
-                UInt48* resultPtr = &result;
-                byte* resultBytePtr = (byte*)resultPtr;
-                
-                UInt48* valuePtr = &value;
-                byte* valueBytePtr = (byte*)valuePtr;
-
-                resultBytePtr[0] = valueBytePtr[5];
-                resultBytePtr[1] = valueBytePtr[4];
-                resultBytePtr[2] = valueBytePtr[3];
-                resultBytePtr[3] = valueBytePtr[2];
-                resultBytePtr[4] = valueBytePtr[1];
-                resultBytePtr[5] = valueBytePtr[0];
-            }
-
-            return result;
+            return (value >> 24) | ((value >> 8) & 0x0000FF00) | ((value << 8) & 0x00FF0000) | (value << 24);
         }
 
-        private static UInt128 HostToNetworkOrder(UInt128 value)
+        private static ulong ReverseBytes(ulong value)
         {
-            UInt128 result;
-
-            unsafe
-            {
-                UInt128* resultPtr = &result;
-                byte* resultBytePtr = (byte*)resultPtr;
+            return ((ulong)ReverseBytes((uint)value) << 32) | ReverseBytes((uint)(value >> 32));
+        }
 
-                UInt128* valuePtr = &value;
-                byte* valueBytePtr = (byte*)valuePtr;
+        private static UInt24 ReverseBytes(UInt24 value)
+        {
+            return (UInt24)(ReverseBytes((uint)(int)value) >> 8);
+        }
 
-                for (int i = 0; i != UInt128.SizeOf; ++i)
-                    resultBytePtr[i] = valueBytePtr[UInt128.SizeOf - i - 1];
-            }
+        private static UInt48 ReverseBytes(UInt48 value)
+        {
+            return (UInt48)(ReverseBytes((ulong)value) >> 16);
+        }
 
-            return result;
+        private static UInt128 ReverseBytes(UInt128 value)
+        {
+            return new UInt128(ReverseBytes((ulong)value), ReverseBytes((ulong)(value >> 64)));
         }
 
-        private static short ReadShort(byte[] buffer, int offset)
+        private static ushort ReadUShort(byte[] buffer, int offset)
         {
             unsafe
             {
                 fixed (byte* ptr = &buffer[offset])
                 {
-                    return *((short*)ptr);
+                    return *((ushort*)ptr);
                 }
             }
         }
@@ -1022,13 +991,13 @@ namespace PcapDotNet.Packets
             }
         }
 
-        private static int ReadInt(byte[] buffer, int offset)
+        private static uint ReadUInt(byte[] buffer, int offset)
         {
             unsafe
             {
                 fixed (byte* ptr = &buffer[offset])
                 {
-                    return *((int*)ptr);
+                    return *((uint*)ptr);
                 }
             }
         }
@@ -1044,13 +1013,13 @@ namespace PcapDotNet.Packets
             }
         }
 
-        private static long ReadLong(byte[] buffer, int offset)
+        private static ulong ReadULong(byte[] buffer, int offset)
         {
             unsafe
             {
                 fixed (byte* ptr = &buffer[offset])
                 {
-                    return *((long*)ptr);
+                    return *((ulong*)ptr);
                 }
             }
         }
@@ -1066,13 +1035,13 @@ namespace PcapDotNet.Packets
             }
         }
 
-        private static void Write(byte[] buffer, int offset, short value)
+        private static void Write(byte[] buffer, int offset, ushort value)
         {
             unsafe
             {
                 fixed (byte* ptr = &buffer[offset])
                 {
-                    *((short*)ptr) = value;
+                    *((ushort*)ptr) = value;
                 }
             }
         }
@@ -1088,13 +1057,13 @@ namespace PcapDotNet.Packets
             }
         }
         
-        private static void Write(byte[] buffer, int offset, int value)
+        private static void Write(byte[] buffer, int offset, uint value)
         {
             unsafe
             {
                 fixed (byte* ptr = &buffer[offset])
                 {
-                    *((int*)ptr) = value;
+                    *((uint*)ptr) = value;
                 }
             }
         }
@@ -1110,13 +1079,13 @@ namespace PcapDotNet.Packets
             }
         }
 
-        private static void Write(byte[] buffer, int offset, long value)
+        private static void Write(byte[] buffer, int offset, ulong value)
         {
             unsafe
             {
                 fixed (byte* ptr = &buffer[offset])
                 {
-                    *((long*)ptr) = value;
+                    *((ulong*)ptr) = value;
                 }
             }
         }
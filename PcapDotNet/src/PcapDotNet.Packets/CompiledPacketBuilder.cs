@@ -0,0 +1,121 @@
+﻿using System;
+using System.Linq;
+
+namespace PcapDotNet.Packets
+{
+    /// <summary>
+    /// Builds packets with a fixed layout into given buffers.
+    /// Created using PacketBuilder.Compile(), which computes the layers' lengths once.
+    /// The layers' properties can be modified between builds as long as the layers' lengths don't change.
+    /// <example>This sample shows how to build 1000 UDP packets with different source ports into a single buffer.
+    /// <code>
+    ///   UdpLayer udpLayer = new UdpLayer();
+    ///   CompiledPacketBuilder builder = new PacketBuilder(new EthernetLayer(), new IpV4Layer(), udpLayer).Compile();
+    ///
+    ///   byte[] buffer = new byte[1000 * builder.Length];
+    ///   int[] offsets = new int[1000];
+    ///   int[] lengths = new int[1000];
+    ///   builder.BuildMany(buffer, 0, 1000, i => udpLayer.SourcePort = (ushort)i, offsets, lengths);
+    /// </code>
+    /// </example>
+    /// </summary>
+    public sealed class CompiledPacketBuilder
+    {
+        /// <summary>
+        /// The length of every packet built, in bytes.
+        /// </summary>
+        public int Length { get; private set; }
+
+        /// <summary>
+        /// The datalink of the packets built.
+        /// </summary>
+        public DataLink DataLink { get; private set; }
+
+        /// <summary>
+        /// Builds a single packet into the given buffer.
+        /// </summary>
+        /// <param name="buffer">The buffer to write the packet to.</param>
+        /// <param name="offset">The offset in the buffer to start writing the packet at.</param>
+        /// <returns>The number of bytes written, which is Length.</returns>
+        /// <exception cref="ArgumentNullException">The buffer is null.</exception>
+        /// <exception cref="ArgumentOutOfRangeException">The offset is negative or the packet doesn't fit in the buffer after the offset.</exception>
+        public int BuildInto(byte[] buffer, int offset)
+        {
+            if (buffer == null)
+                throw new ArgumentNullException("buffer");
+            if (offset < 0 || offset > buffer.Length - Length)
+                throw new ArgumentOutOfRangeException("offset", offset, "The packet of " + Length + " bytes must fit in the buffer of " + buffer.Length + " bytes");
+
+            Write(buffer, offset);
+            return Length;
+        }
+
+        /// <summary>
+        /// Builds packets back to back into the given buffer.
+        /// </summary>
+        /// <param name="buffer">The buffer to write the packets to.</param>
+        /// <param name="offset">The offset in the buffer to start writing the first packet at.</param>
+        /// <param name="count">The number of packets to build.</param>
+        /// <param name="prepareLayers">
+        /// Called with the index of the packet before building each packet, to modify the layers' properties for that packet.
+        /// Can be null to build the same packet count times.
+        /// </param>
+        /// <param name="offsets">Filled with the offset of each packet in the buffer. Must have at least count elements.</param>
+        /// <param name="lengths">Filled with the length of each packet. Must have at least count elements.</param>
+        /// <returns>The total number of bytes written.</returns>
+        /// <exception cref="ArgumentNullException">The buffer, the offsets or the lengths are null.</exception>
+        /// <exception cref="ArgumentOutOfRangeException">The offset or the count is negative, the packets don't fit in the buffer or the offsets or lengths are too short.</exception>
+        public int BuildMany(byte[] buffer, int offset, int count, Action<int> prepareLayers, int[] offsets, int[] lengths)
+        {
+            if (buffer == null)
+                throw new ArgumentNullException("buffer");
+            if (offsets == null)
+                throw new ArgumentNullException("offsets");
+            if (lengths == null)
+                throw new ArgumentNullException("lengths");
+            if (offset < 0)
+                throw new ArgumentOutOfRangeException("offset", offset, "Must be non negative");
+            if (count < 0)
+                throw new ArgumentOutOfRangeException("count", count, "Must be non negative");
+            if (offsets.Length < count)
+                throw new ArgumentOutOfRangeException("offsets", offsets.Length, "Must have at least " + count + " elements");
+            if (lengths.Length < count)
+                throw new ArgumentOutOfRangeException("lengths", lengths.Length, "Must have at least " + count + " elements");
+            long totalLength = (long)count * Length;
+            if (offset > buffer.Length - totalLength)
+                throw new ArgumentOutOfRangeException("count", count, count + " packets of " + Length + " bytes must fit in the buffer of " + buffer.Length + " bytes");
+
+            for (int i = 0; i != count; ++i)
+            {
+                if (prepareLayers != null)
+                    prepareLayers(i);
+
+                Write(buffer, offset);
+                offsets[i] = offset;
+                lengths[i] = Length;
+                offset += Length;
+            }
+
+            return (int)totalLength;
+        }
+
+        internal CompiledPacketBuilder(ILayer[] layers, int[] layersLength, DataLink dataLink)
+        {
+            _layers = layers;
+            _layersLength = layersLength;
+            Length = layersLength.Sum();
+            DataLink = dataLink;
+        }
+
+        // Layers don't write the bytes they leave zero, so a reused buffer is cleared first.
+        private void Write(byte[] buffer, int offset)
+        {
+            Array.Clear(buffer, offset, Length);
+            PacketBuilder.WriteLayers(_layers, _layersLength, buffer, offset, Length);
+            PacketBuilder.FinalizeLayers(_layers, _layersLength, buffer, offset, Length);
+        }
+
+        private readonly ILayer[] _layers;
+        private readonly int[] _layersLength;
+    }
+}
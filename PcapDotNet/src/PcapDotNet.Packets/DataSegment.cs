@@ -192,6 +192,26 @@ namespace PcapDotNet.Packets
         /// </summary>
         internal int StartOffset { get; private set; }
 
+        /// <summary>
+        /// Points the segment to different bytes and resets everything that was calculated from the previous bytes.
+        /// Only used for the datagrams of a rebindable packet.
+        /// </summary>
+        internal void Rebind(byte[] buffer, int offset, int length)
+        {
+            Buffer = buffer;
+            StartOffset = offset;
+            Length = length;
+            ResetCache();
+        }
+
+        /// <summary>
+        /// Called after the segment was rebound to different bytes.
+        /// Derived classes should reset their cached values and rebind the cached datagrams they want to reuse.
+        /// </summary>
+        internal virtual void ResetCache()
+        {
+        }
+
         /// <summary>
         /// Reads a requested number of bytes from a specific offset in the segment.
         /// </summary>
@@ -361,13 +381,21 @@ namespace PcapDotNet.Packets
         /// <param name="offset">The offset in the buffer to start reading the bytes.</param>
         /// <param name="length">The number of bytes to read.</param>
         /// <returns>A value equals to the sum of all 16 bits big endian values of the given bytes.</returns>
-        protected static uint Sum16Bits(byte[] buffer, int offset, int length)
+        protected internal static uint Sum16Bits(byte[] buffer, int offset, int length)
         {
             if (buffer == null) 
                 throw new ArgumentNullException("buffer");
 
-            int endOffset = offset + length;
             uint sum = 0;
+            if (offset >= 0 && length >= Sum16BitsBlockSize && length <= buffer.Length - offset)
+            {
+                int blocksLength = length - length % Sum16BitsBlockSize;
+                sum = Sum16BitsBlocks(buffer, offset, blocksLength);
+                offset += blocksLength;
+                length -= blocksLength;
+            }
+
+            int endOffset = offset + length;
             while (offset < endOffset - 1)
                 sum += buffer.ReadUShort(ref offset, Endianity.Big);
             if (offset < endOffset)
@@ -375,6 +403,55 @@ namespace PcapDotNet.Packets
             return sum;
         }
 
+        /// <summary>
+        /// Sums 8 bytes blocks as 16 bits big endian values, reading 64 bits at a time.
+        /// The bytes in even positions are the most significant bytes of the 16 bits values, so the sum is 256 times the sum of these bytes plus the sum of the other bytes.
+        /// Each 64 bits value accumulates four bytes in four 16 bits lanes, which are added up before they can overflow.
+        /// The result is exact and doesn't depend on the alignment of the offset.
+        /// </summary>
+        private static uint Sum16BitsBlocks(byte[] buffer, int offset, int length)
+        {
+            const ulong LowBytesMask = 0x00FF00FF00FF00FF;
+
+            ulong lowBytesSum = 0;
+            ulong highBytesSum = 0;
+            unsafe
+            {
+                fixed (byte* bufferPtr = &buffer[offset])
+                {
+                    ulong* blockPtr = (ulong*)bufferPtr;
+                    int blocksLeft = length / Sum16BitsBlockSize;
+                    while (blocksLeft > 0)
+                    {
+                        int laneBlocks = Math.Min(blocksLeft, Sum16BitsMaxBlocksPerLane);
+                        blocksLeft -= laneBlocks;
+
+                        ulong lowBytesLanes = 0;
+                        ulong highBytesLanes = 0;
+                        for (ulong* endPtr = blockPtr + laneBlocks; blockPtr != endPtr; ++blockPtr)
+                        {
+                            ulong block = *blockPtr;
+                            lowBytesLanes += block & LowBytesMask;
+                            highBytesLanes += (block >> 8) & LowBytesMask;
+                        }
+
+                        lowBytesSum += SumLanes(lowBytesLanes);
+                        highBytesSum += SumLanes(highBytesLanes);
+                    }
+                }
+            }
+
+            // In little endian the low bytes of the lanes are the bytes in even positions.
+            ulong evenBytesSum = BitConverter.IsLittleEndian ? lowBytesSum : highBytesSum;
+            ulong oddBytesSum = BitConverter.IsLittleEndian ? highBytesSum : lowBytesSum;
+            return (uint)((evenBytesSum << 8) + oddBytesSum);
+        }
+
+        private static ulong SumLanes(ulong lanes)
+        {
+            return (lanes & 0xFFFF) + ((lanes >> 16) & 0xFFFF) + ((lanes >> 32) & 0xFFFF) + (lanes >> 48);
+        }
+
         internal static uint Sum16Bits(IpV6Address address)
         {
             return Sum16Bits(address.ToValue());
@@ -401,6 +478,11 @@ namespace PcapDotNet.Packets
             return (value >> 16) + (value & 0xFFFF);
         }
 
+        private const int Sum16BitsBlockSize = sizeof(ulong);
+
+        // A 16 bits lane can accumulate 256 bytes of value 255 without overflowing.
+        private const int Sum16BitsMaxBlocksPerLane = 256;
+
         private static readonly DataSegment _empty = new DataSegment(new byte[0]);
     }
 }
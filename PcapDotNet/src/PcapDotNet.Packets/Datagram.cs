@@ -6,6 +6,7 @@ namespace PcapDotNet.Packets
     /// Represents a packet datagram.
     /// A datagram is part of the packet bytes that can be treated as a specific protocol data (usually header + payload).
     /// Never copies the given buffer.
+    /// Can be read by several threads at the same time, since the parsed values are cached without locks in a way that is safe for concurrent readers.
     /// </summary>
     public class Datagram : DataSegment
     {
@@ -45,9 +46,10 @@ namespace PcapDotNet.Packets
         {
             get
             {
-                if (_isValid == null)
-                    _isValid = CalculateIsValid();
-                return _isValid.Value;
+                bool isValid;
+                if (!LazyCache.TryGet(ref _isValid, out isValid))
+                    isValid = LazyCache.Publish(ref _isValid, CalculateIsValid());
+                return isValid;
             }
         }
 
@@ -70,7 +72,34 @@ namespace PcapDotNet.Packets
             return true;
         }
 
+        internal override void ResetCache()
+        {
+            _isValid = LazyCache.Unknown;
+        }
+
+        /// <summary>
+        /// Rebinds a cached datagram to the given segment so it can be reused instead of creating a new one.
+        /// </summary>
+        /// <returns>The rebound datagram or null if the datagram wasn't created yet or there's no segment.</returns>
+        internal static T Reuse<T>(T datagram, DataSegment segment) where T : Datagram
+        {
+            if (segment == null)
+                return null;
+            return Reuse(datagram, segment.Buffer, segment.StartOffset, segment.Length);
+        }
+
+        /// <summary>
+        /// Rebinds a cached datagram to the given bytes so it can be reused instead of creating a new one.
+        /// </summary>
+        /// <returns>The rebound datagram or null if the datagram wasn't created yet.</returns>
+        internal static T Reuse<T>(T datagram, byte[] buffer, int offset, int length) where T : Datagram
+        {
+            if (datagram != null)
+                datagram.Rebind(buffer, offset, length);
+            return datagram;
+        }
+
         private static readonly Datagram _empty = new Datagram(new byte[0]);
-        private bool? _isValid;
+        private byte _isValid;
     }
 }
\ No newline at end of file
@@ -2,6 +2,7 @@ using System;
 using System.Collections.Generic;
 using System.Collections.ObjectModel;
 using System.Linq;
+using System.Threading;
 
 namespace PcapDotNet.Packets.Dns
 {
@@ -46,7 +47,7 @@ namespace PcapDotNet.Packets.Dns
     /// </summary>
     public sealed class DnsDatagram : Datagram
     {
-        private static class Offset
+        internal static class Offset
         {
             public const int Id = 0;
             public const int IsResponse = 2;
@@ -370,15 +371,12 @@ namespace PcapDotNet.Packets.Dns
         /// </summary>
         protected override bool CalculateIsValid()
         {
-            if (_isValid == null)
-            {
-                _isValid = Length >= HeaderLength &&
-                           QueryCount == Queries.Count &&
-                           AnswerCount == Answers.Count &&
-                           AuthorityCount == Authorities.Count &&
-                           AdditionalCount == Additionals.Count;
-            }
-            return _isValid.Value;
+            // Cached by IsValid.
+            return Length >= HeaderLength &&
+                   QueryCount == Queries.Count &&
+                   AnswerCount == Answers.Count &&
+                   AuthorityCount == Authorities.Count &&
+                   AdditionalCount == Additionals.Count;
         }
 
         internal DnsDatagram(byte[] buffer, int offset, int length)
@@ -501,12 +499,18 @@ namespace PcapDotNet.Packets.Dns
 
         private void ParseAdditionals()
         {
+            if (Volatile.Read(ref _additionals) != null)
+                return;
+
+            // The additionals are parsed to a local and the options are written before the additionals are published,
+            // so a thread that sees the additionals also sees the options.
+            ReadOnlyCollection<DnsDataResourceRecord> additionals = null;
             int nextOffset = 0;
-            if (ParseRecords(AdditionalsOffset, () => AdditionalCount, DnsDataResourceRecord.Parse, ref _additionals, ref nextOffset) &&
-                _additionals != null)
-            {
-                _options = (DnsOptResourceRecord)_additionals.FirstOrDefault(additional => additional.DnsType == DnsType.Opt);
-            }
+            if (!ParseRecords(AdditionalsOffset, () => AdditionalCount, DnsDataResourceRecord.Parse, ref additionals, ref nextOffset))
+                return;
+
+            _options = (DnsOptResourceRecord)additionals.FirstOrDefault(additional => additional.DnsType == DnsType.Opt);
+            LazyCache.Publish(ref _additionals, additionals);
         }
 
         private delegate TRecord ParseRecord<out TRecord>(DnsDatagram dns, int offset, out int numBytesRead);
@@ -514,7 +518,7 @@ namespace PcapDotNet.Packets.Dns
         private bool ParseRecords<TRecord>(int offset, Func<ushort> countDelegate, ParseRecord<TRecord> parseRecord,
                                            ref ReadOnlyCollection<TRecord> parsedRecords, ref int nextOffset) where TRecord : DnsResourceRecord
         {
-            if (parsedRecords == null && Length >= offset)
+            if (Volatile.Read(ref parsedRecords) == null && Length >= offset)
             {
                 ushort count = countDelegate();
                 List<TRecord> records = new List<TRecord>(count);
@@ -530,8 +534,9 @@ namespace PcapDotNet.Packets.Dns
                     records.Add(record);
                     offset += numBytesRead;
                 }
-                parsedRecords = new ReadOnlyCollection<TRecord>(records.ToArray());
+                // The next offset is written before the records are published, so a thread that sees the records also sees the next offset.
                 nextOffset = offset;
+                LazyCache.Publish(ref parsedRecords, new ReadOnlyCollection<TRecord>(records.ToArray()));
 
                 return true;
             }
@@ -547,7 +552,5 @@ namespace PcapDotNet.Packets.Dns
         private int _answersOffset;
         private int _authoritiesOffset;
         private int _additionalsOffset;
-
-        private bool? _isValid;
     }
 }
@@ -177,14 +177,27 @@ namespace PcapDotNet.Packets.Ethernet
         {
         }
 
+        internal override void ResetCache()
+        {
+            if (_payloadDatagrams != null)
+            {
+                if (Length >= HeaderLength && _payloadDatagrams.Payload != null)
+                    _payloadDatagrams.Rebind(Buffer, StartOffset + HeaderLength, Length - HeaderLength);
+                else
+                    _payloadDatagrams = null;
+            }
+            base.ResetCache();
+        }
+
         private EthernetPayloadDatagrams PayloadDatagrams
         {
             get
             {
-                return _payloadDatagrams ?? (_payloadDatagrams = new EthernetPayloadDatagrams(Length >= HeaderLength
-                                                                                                  ? new Datagram(Buffer, StartOffset + HeaderLength,
-                                                                                                                 Length - HeaderLength)
-                                                                                                  : null));
+                return _payloadDatagrams ??
+                       LazyCache.Publish(ref _payloadDatagrams, new EthernetPayloadDatagrams(Length >= HeaderLength
+                                                                                                 ? new Datagram(Buffer, StartOffset + HeaderLength,
+                                                                                                                Length - HeaderLength)
+                                                                                                 : null));
             }
         }
 
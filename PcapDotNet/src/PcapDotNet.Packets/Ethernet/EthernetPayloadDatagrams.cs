@@ -11,6 +11,19 @@ namespace PcapDotNet.Packets.Ethernet
             _payload = payload;
         }
 
+        /// <summary>
+        /// Rebinds the payload and the payload datagrams that were already created to the given bytes.
+        /// Should only be called when there's a payload.
+        /// </summary>
+        public void Rebind(byte[] buffer, int offset, int length)
+        {
+            _payload.Rebind(buffer, offset, length);
+            _ipV4 = Datagram.Reuse(_ipV4, buffer, offset, IpV4Datagram.GetTotalLength(_payload));
+            _ipV6 = Datagram.Reuse(_ipV6, buffer, offset, IpV6Datagram.GetTotalLength(_payload));
+            _arp = null;
+            _vLanTaggedFrame = Datagram.Reuse(_vLanTaggedFrame, buffer, offset, length);
+        }
+
         public Datagram Get(EthernetType ethernetType)
         {
             switch (ethernetType)
@@ -40,7 +53,7 @@ namespace PcapDotNet.Packets.Ethernet
             get
             {
                 if (_ipV4 == null && _payload != null)
-                    _ipV4 = new IpV4Datagram(_payload.Buffer, _payload.StartOffset, IpV4Datagram.GetTotalLength(_payload));
+                    LazyCache.Publish(ref _ipV4, new IpV4Datagram(_payload.Buffer, _payload.StartOffset, IpV4Datagram.GetTotalLength(_payload)));
                 return _ipV4;
             }
         }
@@ -53,7 +66,7 @@ namespace PcapDotNet.Packets.Ethernet
             get
             {
                 if (_ipV6 == null && _payload != null)
-                    _ipV6 = new IpV6Datagram(_payload.Buffer, _payload.StartOffset, IpV6Datagram.GetTotalLength(_payload));
+                    LazyCache.Publish(ref _ipV6, new IpV6Datagram(_payload.Buffer, _payload.StartOffset, IpV6Datagram.GetTotalLength(_payload)));
                 return _ipV6;
             }
         }
@@ -66,7 +79,7 @@ namespace PcapDotNet.Packets.Ethernet
             get
             {
                 if (_arp == null && _payload != null)
-                    _arp = ArpDatagram.CreateInstance(_payload.Buffer, _payload.StartOffset, _payload.Length);
+                    LazyCache.Publish(ref _arp, ArpDatagram.CreateInstance(_payload.Buffer, _payload.StartOffset, _payload.Length));
                 return _arp;
             }
         }
@@ -76,7 +89,7 @@ namespace PcapDotNet.Packets.Ethernet
             get
             {
                 if (_vLanTaggedFrame == null && _payload != null)
-                    _vLanTaggedFrame = new VLanTaggedFrameDatagram(_payload.Buffer, _payload.StartOffset, _payload.Length);
+                    LazyCache.Publish(ref _vLanTaggedFrame, new VLanTaggedFrameDatagram(_payload.Buffer, _payload.StartOffset, _payload.Length));
                 return _vLanTaggedFrame;
             }
         }
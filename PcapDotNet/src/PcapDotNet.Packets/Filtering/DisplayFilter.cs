@@ -0,0 +1,81 @@
+﻿using System;
+
+namespace PcapDotNet.Packets.Filtering
+{
+    /// <summary>
+    /// A Wireshark style display filter over the parsed layers of a packet.
+    /// For example: <c>tcp.window_size &lt; 1000 &amp;&amp; http.request.method == "POST"</c>.
+    /// </summary>
+    /// <remarks>
+    ///   <list type="bullet">
+    ///     <item>The expression is compiled once to a delegate, testing a packet doesn't parse the expression.</item>
+    ///     <item>Only the layers the expression refers to are parsed, using the lazy datagram properties.</item>
+    ///     <item>A comparison on a field the packet doesn't contain is false, so <c>tcp.port != 80</c> doesn't match UDP packets.</item>
+    ///     <item>A comparison on a field with more than one value, like <c>tcp.port</c> or <c>ip.addr</c>, is true if it is true for any of the values.</item>
+    ///     <item>IPv4 addresses can be compared to subnets, for example: <c>ip.src == 10.0.0.0/8</c>.</item>
+    ///   </list>
+    /// </remarks>
+    public sealed class DisplayFilter
+    {
+        /// <summary>
+        /// Compiles the expression using the default field registry.
+        /// </summary>
+        /// <param name="expression">The display filter expression.</param>
+        /// <exception cref="ArgumentNullException">The expression is null.</exception>
+        /// <exception cref="ArgumentException">The expression is invalid or uses an unknown field.</exception>
+        public DisplayFilter(string expression)
+            : this(expression, DisplayFilterFieldRegistry.Default)
+        {
+        }
+
+        /// <summary>
+        /// Compiles the expression using the fields of the given registry.
+        /// </summary>
+        /// <param name="expression">The display filter expression.</param>
+        /// <param name="registry">The fields the expression can use.</param>
+        /// <exception cref="ArgumentNullException">The expression or the registry is null.</exception>
+        /// <exception cref="ArgumentException">The expression is invalid or uses an unknown field.</exception>
+        public DisplayFilter(string expression, DisplayFilterFieldRegistry registry)
+        {
+            if (expression == null)
+                throw new ArgumentNullException("expression");
+            if (registry == null)
+                throw new ArgumentNullException("registry");
+
+            Expression = expression;
+            Predicate = new DisplayFilterParser(expression, registry).Parse().Compile();
+        }
+
+        /// <summary>
+        /// The display filter expression.
+        /// </summary>
+        public string Expression { get; private set; }
+
+        /// <summary>
+        /// The compiled filter. Can be used directly as a LINQ predicate.
+        /// </summary>
+        public Func<Packet, bool> Predicate { get; private set; }
+
+        /// <summary>
+        /// Returns whether the filter matches the packet.
+        /// </summary>
+        /// <param name="packet">The packet to test.</param>
+        /// <returns>True iff the packet matches the filter.</returns>
+        /// <exception cref="ArgumentNullException">The packet is null.</exception>
+        public bool Test(Packet packet)
+        {
+            if (packet == null)
+                throw new ArgumentNullException("packet");
+
+            return Predicate(packet);
+        }
+
+        /// <summary>
+        /// The display filter expression.
+        /// </summary>
+        public override string ToString()
+        {
+            return Expression;
+        }
+    }
+}
@@ -0,0 +1,56 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Collections.ObjectModel;
+using System.Linq;
+using System.Linq.Expressions;
+
+namespace PcapDotNet.Packets.Filtering
+{
+    /// <summary>
+    /// A name that can be used in a display filter expression.
+    /// A field reads a layer of the packet and then one or more values from that layer.
+    /// A protocol field has no values and only tests whether the packet contains the layer.
+    /// </summary>
+    public sealed class DisplayFilterField
+    {
+        /// <summary>
+        /// The name used in expressions. For example: tcp.window_size.
+        /// </summary>
+        public string Name { get; private set; }
+
+        /// <summary>
+        /// The type of the field values or null if this is a protocol field.
+        /// </summary>
+        public Type ValueType { get; private set; }
+
+        /// <summary>
+        /// True iff the field has no values and only tests whether the packet contains the layer.
+        /// </summary>
+        public bool IsProtocol
+        {
+            get { return ValueType == null; }
+        }
+
+        /// <summary>
+        /// The field name.
+        /// </summary>
+        public override string ToString()
+        {
+            return Name;
+        }
+
+        internal DisplayFilterField(string name, LambdaExpression layer, Type valueType, IEnumerable<LambdaExpression> values)
+        {
+            Name = name;
+            Layer = layer;
+            ValueType = valueType;
+            Values = values.ToList().AsReadOnly();
+        }
+
+        // Packet => layer, returns null when the packet doesn't contain the layer.
+        internal LambdaExpression Layer { get; private set; }
+
+        // Layer => value, a comparison is true if it is true for any of the values.
+        internal ReadOnlyCollection<LambdaExpression> Values { get; private set; }
+    }
+}
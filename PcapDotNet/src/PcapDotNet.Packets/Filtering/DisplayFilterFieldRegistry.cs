@@ -0,0 +1,206 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Collections.ObjectModel;
+using System.Linq;
+using System.Linq.Expressions;
+using PcapDotNet.Packets.Transport;
+
+namespace PcapDotNet.Packets.Filtering
+{
+    /// <summary>
+    /// The fields display filter expressions can use.
+    /// The default registry contains the common Wireshark field names of the protocols Pcap.Net parses, more fields can be registered.
+    /// </summary>
+    /// <remarks>
+    /// Registering and looking up fields is thread safe.
+    /// Filters that were already compiled aren't affected by fields registered later.
+    /// </remarks>
+    public sealed class DisplayFilterFieldRegistry
+    {
+        /// <summary>
+        /// Creates an empty registry.
+        /// </summary>
+        public DisplayFilterFieldRegistry()
+        {
+        }
+
+        /// <summary>
+        /// The registry used by filters created without a registry.
+        /// Contains the built in fields.
+        /// </summary>
+        public static DisplayFilterFieldRegistry Default
+        {
+            get { return _default; }
+        }
+
+        /// <summary>
+        /// All the registered fields.
+        /// </summary>
+        public ReadOnlyCollection<DisplayFilterField> Fields
+        {
+            get
+            {
+                lock (_fields)
+                {
+                    return _fields.Values.ToList().AsReadOnly();
+                }
+            }
+        }
+
+        /// <summary>
+        /// Registers a protocol field that is true iff the packet contains the layer.
+        /// </summary>
+        /// <typeparam name="TLayer">The type of the layer.</typeparam>
+        /// <param name="name">The field name.</param>
+        /// <param name="layer">Returns the layer of a packet or null if the packet doesn't contain it.</param>
+        /// <returns>The registered field.</returns>
+        /// <exception cref="ArgumentNullException">The name or the layer is null.</exception>
+        /// <exception cref="ArgumentException">A field with the same name is already registered.</exception>
+        public DisplayFilterField RegisterProtocol<TLayer>(string name, Expression<Func<Packet, TLayer>> layer) where TLayer : class
+        {
+            if (layer == null)
+                throw new ArgumentNullException("layer");
+
+            return Register(new DisplayFilterField(name, layer, null, Enumerable.Empty<LambdaExpression>()));
+        }
+
+        /// <summary>
+        /// Registers a field with one or more values read from a layer.
+        /// A comparison on the field is true iff the packet contains the layer and the comparison is true for any of the values.
+        /// A value that is null is ignored.
+        /// </summary>
+        /// <typeparam name="TLayer">The type of the layer.</typeparam>
+        /// <typeparam name="TValue">The type of the field values.</typeparam>
+        /// <param name="name">The field name.</param>
+        /// <param name="layer">Returns the layer of a packet or null if the packet doesn't contain it.</param>
+        /// <param name="values">Return the field values from the layer.</param>
+        /// <returns>The registered field.</returns>
+        /// <exception cref="ArgumentNullException">The name, the layer or the values are null.</exception>
+        /// <exception cref="ArgumentException">No values were given or a field with the same name is already registered.</exception>
+        public DisplayFilterField Register<TLayer, TValue>(string name, Expression<Func<Packet, TLayer>> layer, params Expression<Func<TLayer, TValue>>[] values)
+            where TLayer : class
+        {
+            if (layer == null)
+                throw new ArgumentNullException("layer");
+            if (values == null)
+                throw new ArgumentNullException("values");
+            if (values.Length == 0 || values.Any(value => value == null))
+                throw new ArgumentException("At least one value must be given and values can't be null", "values");
+
+            return Register(new DisplayFilterField(name, layer, typeof(TValue), values));
+        }
+
+        /// <summary>
+        /// Finds the field with the given name.
+        /// </summary>
+        /// <param name="name">The field name.</param>
+        /// <param name="field">The field or null if there's no field with that name.</param>
+        /// <returns>True iff the field was found.</returns>
+        public bool TryGetField(string name, out DisplayFilterField field)
+        {
+            lock (_fields)
+            {
+                return _fields.TryGetValue(name, out field);
+            }
+        }
+
+        private DisplayFilterField Register(DisplayFilterField field)
+        {
+            if (field.Name == null)
+                throw new ArgumentNullException("name");
+
+            lock (_fields)
+            {
+                if (_fields.ContainsKey(field.Name))
+                    throw new ArgumentException("Field " + field.Name + " is already registered", "name");
+                _fields.Add(field.Name, field);
+            }
+            return field;
+        }
+
+        private static DisplayFilterFieldRegistry CreateDefault()
+        {
+            DisplayFilterFieldRegistry registry = new DisplayFilterFieldRegistry();
+
+            registry.RegisterProtocol("eth", packet => DisplayFilterLayers.GetEthernet(packet));
+            registry.Register("eth.src", packet => DisplayFilterLayers.GetEthernet(packet), eth => eth.Source);
+            registry.Register("eth.dst", packet => DisplayFilterLayers.GetEthernet(packet), eth => eth.Destination);
+            registry.Register("eth.addr", packet => DisplayFilterLayers.GetEthernet(packet), eth => eth.Source, eth => eth.Destination);
+            registry.Register("eth.type", packet => DisplayFilterLayers.GetEthernet(packet), eth => eth.EtherType);
+
+            registry.RegisterProtocol("arp", packet => DisplayFilterLayers.GetArp(packet));
+            registry.Register("arp.opcode", packet => DisplayFilterLayers.GetArp(packet), arp => arp.Operation);
+
+            registry.RegisterProtocol("ip", packet => DisplayFilterLayers.GetIpV4(packet));
+            registry.Register("ip.version", packet => DisplayFilterLayers.GetIpV4(packet), ip => ip.Version);
+            registry.Register("ip.hdr_len", packet => DisplayFilterLayers.GetIpV4(packet), ip => ip.HeaderLength);
+            registry.Register("ip.dsfield", packet => DisplayFilterLayers.GetIpV4(packet), ip => ip.TypeOfService);
+            registry.Register("ip.len", packet => DisplayFilterLayers.GetIpV4(packet), ip => ip.TotalLength);
+            registry.Register("ip.id", packet => DisplayFilterLayers.GetIpV4(packet), ip => ip.Identification);
+            registry.Register("ip.ttl", packet => DisplayFilterLayers.GetIpV4(packet), ip => ip.Ttl);
+            registry.Register("ip.proto", packet => DisplayFilterLayers.GetIpV4(packet), ip => ip.Protocol);
+            registry.Register("ip.src", packet => DisplayFilterLayers.GetIpV4(packet), ip => ip.Source);
+            registry.Register("ip.dst", packet => DisplayFilterLayers.GetIpV4(packet), ip => ip.Destination);
+            registry.Register("ip.addr", packet => DisplayFilterLayers.GetIpV4(packet), ip => ip.Source, ip => ip.Destination);
+
+            registry.RegisterProtocol("ipv6", packet => DisplayFilterLayers.GetIpV6(packet));
+            registry.Register("ipv6.flow", packet => DisplayFilterLayers.GetIpV6(packet), ip => ip.FlowLabel);
+            registry.Register("ipv6.plen", packet => DisplayFilterLayers.GetIpV6(packet), ip => ip.PayloadLength);
+            registry.Register("ipv6.nxt", packet => DisplayFilterLayers.GetIpV6(packet), ip => ip.NextHeader);
+            registry.Register("ipv6.hlim", packet => DisplayFilterLayers.GetIpV6(packet), ip => ip.HopLimit);
+            registry.Register("ipv6.src", packet => DisplayFilterLayers.GetIpV6(packet), ip => ip.Source);
+            registry.Register("ipv6.dst", packet => DisplayFilterLayers.GetIpV6(packet), ip => ip.CurrentDestination);
+            registry.Register("ipv6.addr", packet => DisplayFilterLayers.GetIpV6(packet), ip => ip.Source, ip => ip.CurrentDestination);
+
+            registry.RegisterProtocol("icmp", packet => DisplayFilterLayers.GetIcmp(packet));
+            registry.Register("icmp.type", packet => DisplayFilterLayers.GetIcmp(packet), icmp => icmp.MessageType);
+            registry.Register("icmp.code", packet => DisplayFilterLayers.GetIcmp(packet), icmp => icmp.Code);
+
+            registry.RegisterProtocol("tcp", packet => DisplayFilterLayers.GetTcp(packet));
+            registry.Register("tcp.srcport", packet => DisplayFilterLayers.GetTcp(packet), tcp => tcp.SourcePort);
+            registry.Register("tcp.dstport", packet => DisplayFilterLayers.GetTcp(packet), tcp => tcp.DestinationPort);
+            registry.Register("tcp.port", packet => DisplayFilterLayers.GetTcp(packet), tcp => tcp.SourcePort, tcp => tcp.DestinationPort);
+            registry.Register("tcp.seq", packet => DisplayFilterLayers.GetTcp(packet), tcp => tcp.SequenceNumber);
+            registry.Register("tcp.ack", packet => DisplayFilterLayers.GetTcp(packet), tcp => tcp.AcknowledgmentNumber);
+            registry.Register("tcp.hdr_len", packet => DisplayFilterLayers.GetTcp(packet), tcp => tcp.HeaderLength);
+            registry.Register("tcp.len", packet => DisplayFilterLayers.GetTcp(packet), tcp => tcp.PayloadLength);
+            // Window scaling isn't known from a single packet, so the window size is the raw value.
+            registry.Register("tcp.window_size", packet => DisplayFilterLayers.GetTcp(packet), tcp => tcp.Window);
+            registry.Register("tcp.window_size_value", packet => DisplayFilterLayers.GetTcp(packet), tcp => tcp.Window);
+            registry.Register("tcp.flags", packet => DisplayFilterLayers.GetTcp(packet), tcp => tcp.ControlBits);
+            registry.Register("tcp.flags.fin", packet => DisplayFilterLayers.GetTcp(packet), tcp => (tcp.ControlBits & TcpControlBits.Fin) != 0);
+            registry.Register("tcp.flags.syn", packet => DisplayFilterLayers.GetTcp(packet), tcp => (tcp.ControlBits & TcpControlBits.Synchronize) != 0);
+            registry.Register("tcp.flags.reset", packet => DisplayFilterLayers.GetTcp(packet), tcp => (tcp.ControlBits & TcpControlBits.Reset) != 0);
+            registry.Register("tcp.flags.push", packet => DisplayFilterLayers.GetTcp(packet), tcp => (tcp.ControlBits & TcpControlBits.Push) != 0);
+            registry.Register("tcp.flags.ack", packet => DisplayFilterLayers.GetTcp(packet), tcp => (tcp.ControlBits & TcpControlBits.Acknowledgment) != 0);
+            registry.Register("tcp.flags.urg", packet => DisplayFilterLayers.GetTcp(packet), tcp => (tcp.ControlBits & TcpControlBits.Urgent) != 0);
+
+            registry.RegisterProtocol("udp", packet => DisplayFilterLayers.GetUdp(packet));
+            registry.Register("udp.srcport", packet => DisplayFilterLayers.GetUdp(packet), udp => udp.SourcePort);
+            registry.Register("udp.dstport", packet => DisplayFilterLayers.GetUdp(packet), udp => udp.DestinationPort);
+            registry.Register("udp.port", packet => DisplayFilterLayers.GetUdp(packet), udp => udp.SourcePort, udp => udp.DestinationPort);
+            registry.Register("udp.length", packet => DisplayFilterLayers.GetUdp(packet), udp => udp.TotalLength);
+
+            registry.RegisterProtocol("http", packet => DisplayFilterLayers.GetHttp(packet));
+            registry.RegisterProtocol("http.request", packet => DisplayFilterLayers.GetHttpRequest(packet));
+            registry.RegisterProtocol("http.response", packet => DisplayFilterLayers.GetHttpResponse(packet));
+            registry.Register("http.request.method", packet => DisplayFilterLayers.GetHttpRequest(packet),
+                              http => http.Method == null ? null : http.Method.Method);
+            registry.Register("http.request.uri", packet => DisplayFilterLayers.GetHttpRequest(packet), http => http.Uri);
+            registry.Register("http.response.code", packet => DisplayFilterLayers.GetHttpResponse(packet), http => http.StatusCode);
+
+            registry.RegisterProtocol("dns", packet => DisplayFilterLayers.GetDns(packet));
+            registry.Register("dns.id", packet => DisplayFilterLayers.GetDns(packet), dns => dns.Id);
+            registry.Register("dns.flags.response", packet => DisplayFilterLayers.GetDns(packet), dns => dns.IsResponse);
+            registry.Register("dns.flags.rcode", packet => DisplayFilterLayers.GetDns(packet), dns => dns.ResponseCode);
+            registry.Register("dns.count.queries", packet => DisplayFilterLayers.GetDns(packet), dns => dns.QueryCount);
+            registry.Register("dns.count.answers", packet => DisplayFilterLayers.GetDns(packet), dns => dns.AnswerCount);
+
+            return registry;
+        }
+
+        private static readonly DisplayFilterFieldRegistry _default = CreateDefault();
+
+        private readonly Dictionary<string, DisplayFilterField> _fields = new Dictionary<string, DisplayFilterField>();
+    }
+}
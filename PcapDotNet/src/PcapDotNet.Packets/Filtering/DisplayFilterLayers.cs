@@ -0,0 +1,169 @@
+﻿using PcapDotNet.Packets.Arp;
+using PcapDotNet.Packets.Dns;
+using PcapDotNet.Packets.Ethernet;
+using PcapDotNet.Packets.Http;
+using PcapDotNet.Packets.Icmp;
+using PcapDotNet.Packets.Ip;
+using PcapDotNet.Packets.IpV4;
+using PcapDotNet.Packets.IpV6;
+using PcapDotNet.Packets.Transport;
+
+namespace PcapDotNet.Packets.Filtering
+{
+    /// <summary>
+    /// Returns the layers of a packet that display filter fields read from.
+    /// Every method returns null if the packet doesn't contain the layer or the layer is too short to read its header.
+    /// Only the layers on the way to the requested layer are parsed.
+    /// </summary>
+    public static class DisplayFilterLayers
+    {
+        /// <summary>
+        /// The Ethernet layer of an Ethernet packet.
+        /// </summary>
+        public static EthernetDatagram GetEthernet(Packet packet)
+        {
+            if (packet.DataLink.Kind != DataLinkKind.Ethernet || packet.Length < EthernetDatagram.HeaderLengthValue)
+                return null;
+            return packet.Ethernet;
+        }
+
+        /// <summary>
+        /// The IPv4 or IPv6 layer of an Ethernet packet or the IPv4 layer of an IPv4 packet.
+        /// </summary>
+        public static IpDatagram GetIp(Packet packet)
+        {
+            if (packet.DataLink.Kind == DataLinkKind.IpV4)
+                return packet.Length < IpV4Datagram.HeaderMinimumLength ? null : packet.IpV4;
+
+            EthernetDatagram ethernet = GetEthernet(packet);
+            if (ethernet == null)
+                return null;
+
+            switch (ethernet.EtherType)
+            {
+                case EthernetType.IpV4:
+                    IpV4Datagram ipV4 = ethernet.IpV4;
+                    return ipV4.Length < IpV4Datagram.HeaderMinimumLength ? null : ipV4;
+
+                case EthernetType.IpV6:
+                    IpV6Datagram ipV6 = ethernet.IpV6;
+                    return ipV6.Length < IpV6Datagram.HeaderLength ? null : ipV6;
+
+                default:
+                    return null;
+            }
+        }
+
+        /// <summary>
+        /// The IPv4 layer.
+        /// </summary>
+        public static IpV4Datagram GetIpV4(Packet packet)
+        {
+            return GetIp(packet) as IpV4Datagram;
+        }
+
+        /// <summary>
+        /// The IPv6 layer.
+        /// </summary>
+        public static IpV6Datagram GetIpV6(Packet packet)
+        {
+            return GetIp(packet) as IpV6Datagram;
+        }
+
+        /// <summary>
+        /// The ARP layer of an Ethernet packet.
+        /// </summary>
+        public static ArpDatagram GetArp(Packet packet)
+        {
+            EthernetDatagram ethernet = GetEthernet(packet);
+            if (ethernet == null || ethernet.EtherType != EthernetType.Arp)
+                return null;
+
+            ArpDatagram arp = ethernet.Arp;
+            return arp.Length < ArpDatagram.HeaderBaseLength ? null : arp;
+        }
+
+        /// <summary>
+        /// The ICMP layer over IPv4.
+        /// </summary>
+        public static IcmpDatagram GetIcmp(Packet packet)
+        {
+            IpV4Datagram ip = GetIpV4(packet);
+            if (ip == null || ip.PayloadProtocol != IpV4Protocol.InternetControlMessageProtocol)
+                return null;
+
+            IcmpDatagram icmp = ip.Icmp;
+            return icmp == null || icmp.Length < IcmpDatagram.HeaderLength ? null : icmp;
+        }
+
+        /// <summary>
+        /// The TCP layer over IPv4 or IPv6.
+        /// </summary>
+        public static TcpDatagram GetTcp(Packet packet)
+        {
+            IpDatagram ip = GetIp(packet);
+            if (ip == null || ip.PayloadProtocol != IpV4Protocol.Tcp)
+                return null;
+
+            TcpDatagram tcp = ip.Tcp;
+            return tcp == null || tcp.Length < TcpDatagram.HeaderMinimumLength ? null : tcp;
+        }
+
+        /// <summary>
+        /// The UDP layer over IPv4 or IPv6.
+        /// </summary>
+        public static UdpDatagram GetUdp(Packet packet)
+        {
+            IpDatagram ip = GetIp(packet);
+            if (ip == null || ip.PayloadProtocol != IpV4Protocol.Udp)
+                return null;
+
+            UdpDatagram udp = ip.Udp;
+            return udp == null || udp.Length < UdpDatagram.HeaderLength ? null : udp;
+        }
+
+        /// <summary>
+        /// The first HTTP message of a TCP payload that starts like an HTTP message.
+        /// </summary>
+        public static HttpDatagram GetHttp(Packet packet)
+        {
+            TcpDatagram tcp = GetTcp(packet);
+            if (tcp == null || tcp.HeaderLength < TcpDatagram.HeaderMinimumLength || tcp.PayloadLength <= 0)
+                return null;
+
+            HttpDatagram http = tcp.Http;
+            return http == null || !http.IsValidStart ? null : http;
+        }
+
+        /// <summary>
+        /// The first HTTP message, if it is a request.
+        /// </summary>
+        public static HttpRequestDatagram GetHttpRequest(Packet packet)
+        {
+            return GetHttp(packet) as HttpRequestDatagram;
+        }
+
+        /// <summary>
+        /// The first HTTP message, if it is a response.
+        /// </summary>
+        public static HttpResponseDatagram GetHttpResponse(Packet packet)
+        {
+            return GetHttp(packet) as HttpResponseDatagram;
+        }
+
+        /// <summary>
+        /// The DNS layer of UDP datagrams from or to port 53.
+        /// </summary>
+        public static DnsDatagram GetDns(Packet packet)
+        {
+            UdpDatagram udp = GetUdp(packet);
+            if (udp == null || (udp.SourcePort != DnsPort && udp.DestinationPort != DnsPort))
+                return null;
+
+            DnsDatagram dns = udp.Dns;
+            return dns == null || dns.Length < DnsDatagram.HeaderLength ? null : dns;
+        }
+
+        private const ushort DnsPort = 53;
+    }
+}
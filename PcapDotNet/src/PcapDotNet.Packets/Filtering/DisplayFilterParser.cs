@@ -0,0 +1,534 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Globalization;
+using System.Linq;
+using System.Linq.Expressions;
+using System.Reflection;
+using System.Text;
+using PcapDotNet.Packets.IpV4;
+
+namespace PcapDotNet.Packets.Filtering
+{
+    /// <summary>
+    /// Parses a display filter expression into an expression tree.
+    /// <pre>
+    /// expression = and ( ("||" | "or") and )*
+    /// and        = not ( ("&amp;&amp;" | "and") not )*
+    /// not        = ("!" | "not") not | "(" expression ")" | field [ operator value ]
+    /// operator   = "==" | "eq" | "!=" | "ne" | "&gt;" | "gt" | "&lt;" | "lt" | "&gt;=" | "ge" | "&lt;=" | "le" | "contains"
+    /// </pre>
+    /// </summary>
+    internal sealed class DisplayFilterParser
+    {
+        private enum TokenKind
+        {
+            End,
+            Word,
+            String,
+            Operator,
+        }
+
+        private enum ComparisonOperator
+        {
+            Equal,
+            NotEqual,
+            GreaterThan,
+            LessThan,
+            GreaterThanOrEqual,
+            LessThanOrEqual,
+            Contains,
+        }
+
+        private struct Token
+        {
+            public Token(TokenKind kind, string text, int position)
+                : this()
+            {
+                Kind = kind;
+                Text = text;
+                Position = position;
+            }
+
+            public TokenKind Kind { get; private set; }
+            public string Text { get; private set; }
+            public int Position { get; private set; }
+
+            public bool Is(string text)
+            {
+                return (Kind == TokenKind.Operator || Kind == TokenKind.Word) && Text == text;
+            }
+        }
+
+        public DisplayFilterParser(string expression, DisplayFilterFieldRegistry registry)
+        {
+            _expression = expression;
+            _registry = registry;
+            _tokens = Tokenize(expression);
+        }
+
+        public Expression<Func<Packet, bool>> Parse()
+        {
+            Expression body = ParseOr();
+            if (Current.Kind != TokenKind.End)
+                throw Error("Unexpected " + Current.Text);
+
+            return Expression.Lambda<Func<Packet, bool>>(body, _packet);
+        }
+
+        private Token Current
+        {
+            get { return _tokens[_index]; }
+        }
+
+        private Expression ParseOr()
+        {
+            Expression result = ParseAnd();
+            while (Current.Is("||") || Current.Is("or"))
+            {
+                ++_index;
+                result = Expression.OrElse(result, ParseAnd());
+            }
+            return result;
+        }
+
+        private Expression ParseAnd()
+        {
+            Expression result = ParseNot();
+            while (Current.Is("&&") || Current.Is("and"))
+            {
+                ++_index;
+                result = Expression.AndAlso(result, ParseNot());
+            }
+            return result;
+        }
+
+        private Expression ParseNot()
+        {
+            if (Current.Is("!") || Current.Is("not"))
+            {
+                ++_index;
+                return Expression.Not(ParseNot());
+            }
+
+            if (Current.Is("("))
+            {
+                ++_index;
+                Expression result = ParseOr();
+                if (!Current.Is(")"))
+                    throw Error("Expected )");
+                ++_index;
+                return result;
+            }
+
+            return ParseComparison();
+        }
+
+        private Expression ParseComparison()
+        {
+            Token fieldToken = Current;
+            if (fieldToken.Kind != TokenKind.Word)
+                throw Error("Expected a field name");
+            ++_index;
+
+            DisplayFilterField field;
+            if (!_registry.TryGetField(fieldToken.Text, out field))
+                throw Error("Unknown field " + fieldToken.Text, fieldToken);
+
+            ComparisonOperator? comparisonOperator = ParseOperator();
+            if (comparisonOperator == null)
+                return BuildPresence(field);
+
+            if (field.IsProtocol)
+                throw Error("Protocol " + field.Name + " can't be compared", fieldToken);
+
+            Token value = Current;
+            if (value.Kind != TokenKind.Word && value.Kind != TokenKind.String)
+                throw Error("Expected a value to compare " + field.Name + " to");
+            ++_index;
+
+            return BuildComparison(field, comparisonOperator.Value, value);
+        }
+
+        private ComparisonOperator? ParseOperator()
+        {
+            ComparisonOperator comparisonOperator;
+            if (!Operators.TryGetValue(Current.Text, out comparisonOperator) || Current.Kind == TokenKind.String)
+                return null;
+
+            ++_index;
+            return comparisonOperator;
+        }
+
+        // layer = field.Layer(packet); layer != null && (any value is not null)
+        private Expression BuildPresence(DisplayFilterField field)
+        {
+            return BuildLayerCondition(field, value => Expression.Constant(true));
+        }
+
+        // layer = field.Layer(packet); layer != null && (any value compares)
+        private Expression BuildComparison(DisplayFilterField field, ComparisonOperator comparisonOperator, Token value)
+        {
+            Func<Expression, Expression> compare = BuildComparer(field, comparisonOperator, value);
+            return BuildLayerCondition(field, compare);
+        }
+
+        private Expression BuildLayerCondition(DisplayFilterField field, Func<Expression, Expression> valueCondition)
+        {
+            ParameterExpression layer = Expression.Variable(field.Layer.ReturnType, "layer");
+            Expression condition = field.IsProtocol
+                                       ? (Expression)Expression.Constant(true)
+                                       : field.Values.Select(value => BuildValueCondition(Expression.Invoke(value, layer), valueCondition)).Aggregate(Expression.OrElse);
+
+            Expression layerCondition = Expression.Block(new[] {layer},
+                                                         Expression.Assign(layer, Expression.Invoke(field.Layer, _packet)),
+                                                         Expression.AndAlso(Expression.NotEqual(layer, Expression.Constant(null, layer.Type)), condition));
+
+            // Datagram properties don't check the length of the datagram, so a truncated layer can make them read beyond the buffer.
+            // Such a field doesn't match, and the rest of the expression is evaluated as usual.
+            return Expression.TryCatch(layerCondition,
+                                       Expression.Catch(typeof(IndexOutOfRangeException), Expression.Constant(false)),
+                                       Expression.Catch(typeof(ArgumentOutOfRangeException), Expression.Constant(false)));
+        }
+
+        // Null values never match.
+        private static Expression BuildValueCondition(Expression value, Func<Expression, Expression> valueCondition)
+        {
+            Type nullableUnderlyingType = Nullable.GetUnderlyingType(value.Type);
+            if (nullableUnderlyingType == null && value.Type.IsValueType)
+                return valueCondition(value);
+
+            ParameterExpression variable = Expression.Variable(value.Type, "value");
+            Expression notNull = nullableUnderlyingType == null
+                                     ? (Expression)Expression.NotEqual(variable, Expression.Constant(null, value.Type))
+                                     : Expression.Property(variable, "HasValue");
+            Expression nonNullValue = nullableUnderlyingType == null ? (Expression)variable : Expression.Property(variable, "Value");
+
+            return Expression.Block(new[] {variable},
+                                    Expression.Assign(variable, value),
+                                    Expression.AndAlso(notNull, valueCondition(nonNullValue)));
+        }
+
+        private Func<Expression, Expression> BuildComparer(DisplayFilterField field, ComparisonOperator comparisonOperator, Token value)
+        {
+            Type type = Nullable.GetUnderlyingType(field.ValueType) ?? field.ValueType;
+
+            if (type == typeof(string))
+            {
+                Expression constant = Expression.Constant(value.Text);
+                if (comparisonOperator == ComparisonOperator.Contains)
+                    return fieldValue => Expression.Call(fieldValue, StringContainsMethod, constant);
+                return fieldValue => BuildComparison(Expression.Call(StringCompareOrdinalMethod, fieldValue, constant), Expression.Constant(0),
+                                                     comparisonOperator);
+            }
+
+            if (comparisonOperator == ComparisonOperator.Contains)
+                throw Error("contains can only be used with string fields", value);
+
+            if (type == typeof(bool))
+            {
+                Expression constant = Expression.Constant(ParseBoolean(value));
+                if (comparisonOperator != ComparisonOperator.Equal && comparisonOperator != ComparisonOperator.NotEqual)
+                    throw Error("Boolean field " + field.Name + " can only be compared for equality", value);
+                return fieldValue => BuildComparison(fieldValue, constant, comparisonOperator);
+            }
+
+            if (type == typeof(IpV4Address))
+                return BuildIpV4AddressComparer(comparisonOperator, value);
+
+            // UInt64 values above long.MaxValue would wrap when converted to long.
+            if (Type.GetTypeCode(type) == TypeCode.UInt64)
+            {
+                Expression constant = Expression.Constant(ParseUnsignedInteger(type, value));
+                return fieldValue => BuildComparison(Expression.Convert(fieldValue, typeof(ulong)), constant, comparisonOperator);
+            }
+
+            if (IsIntegral(type))
+            {
+                Expression constant = Expression.Constant(ParseInteger(type, value));
+                return fieldValue => BuildComparison(Expression.Convert(fieldValue, typeof(long)), constant, comparisonOperator);
+            }
+
+            return BuildObjectComparer(type, comparisonOperator, value);
+        }
+
+        private Func<Expression, Expression> BuildIpV4AddressComparer(ComparisonOperator comparisonOperator, Token value)
+        {
+            string text = value.Text;
+            int slashIndex = text.IndexOf('/');
+            if (slashIndex == -1)
+            {
+                Expression constant = Expression.Constant((long)ParseIpV4Address(text, value).ToValue());
+                return fieldValue => BuildComparison(Expression.Convert(Expression.Call(fieldValue, "ToValue", null), typeof(long)), constant, comparisonOperator);
+            }
+
+            // Subnet: (address & mask) == network
+            if (comparisonOperator != ComparisonOperator.Equal && comparisonOperator != ComparisonOperator.NotEqual)
+                throw Error("Subnets can only be compared for equality", value);
+
+            int prefixLength;
+            if (!int.TryParse(text.Substring(slashIndex + 1), NumberStyles.None, CultureInfo.InvariantCulture, out prefixLength) || prefixLength > 32)
+                throw Error("Invalid subnet " + text, value);
+            uint mask = prefixLength == 0 ? 0 : uint.MaxValue << (32 - prefixLength);
+            uint network = ParseIpV4Address(text.Substring(0, slashIndex), value).ToValue() & mask;
+
+            return fieldValue => BuildComparison(Expression.And(Expression.Call(fieldValue, "ToValue", null), Expression.Constant(mask)),
+                                                 Expression.Constant(network), comparisonOperator);
+        }
+
+        // Types like MacAddress and IpV6Address are parsed using their string constructor and compared using the default comparers.
+        private Func<Expression, Expression> BuildObjectComparer(Type type, ComparisonOperator comparisonOperator, Token value)
+        {
+            ConstructorInfo constructor = type.GetConstructor(new[] {typeof(string)});
+            if (constructor == null)
+                throw Error("Fields of type " + type.Name + " can't be compared", value);
+
+            object constantValue;
+            try
+            {
+                constantValue = constructor.Invoke(new object[] {value.Text});
+            }
+            catch (TargetInvocationException exception)
+            {
+                throw new ArgumentException("Invalid " + type.Name + " value " + value.Text + " at position " + value.Position + " in display filter <" + _expression + ">",
+                                            "expression", exception.InnerException);
+            }
+            Expression constant = Expression.Constant(constantValue, type);
+
+            if (comparisonOperator == ComparisonOperator.Equal || comparisonOperator == ComparisonOperator.NotEqual)
+            {
+                Type comparerType = typeof(EqualityComparer<>).MakeGenericType(type);
+                Expression comparer = Expression.Property(null, comparerType, "Default");
+                MethodInfo equalsMethod = comparerType.GetMethod("Equals", new[] {type, type});
+                return fieldValue =>
+                       {
+                           Expression isEqual = Expression.Call(comparer, equalsMethod, fieldValue, constant);
+                           return comparisonOperator == ComparisonOperator.Equal ? isEqual : Expression.Not(isEqual);
+                       };
+            }
+
+            if (!typeof(IComparable<>).MakeGenericType(type).IsAssignableFrom(type))
+                throw Error("Fields of type " + type.Name + " can only be compared for equality", value);
+
+            Type orderComparerType = typeof(Comparer<>).MakeGenericType(type);
+            Expression orderComparer = Expression.Property(null, orderComparerType, "Default");
+            return fieldValue => BuildComparison(Expression.Call(orderComparer, orderComparerType.GetMethod("Compare", new[] {type, type}), fieldValue, constant),
+                                                 Expression.Constant(0), comparisonOperator);
+        }
+
+        private static Expression BuildComparison(Expression left, Expression right, ComparisonOperator comparisonOperator)
+        {
+            switch (comparisonOperator)
+            {
+                case ComparisonOperator.Equal:
+                    return Expression.Equal(left, right);
+                case ComparisonOperator.NotEqual:
+                    return Expression.NotEqual(left, right);
+                case ComparisonOperator.GreaterThan:
+                    return Expression.GreaterThan(left, right);
+                case ComparisonOperator.LessThan:
+                    return Expression.LessThan(left, right);
+                case ComparisonOperator.GreaterThanOrEqual:
+                    return Expression.GreaterThanOrEqual(left, right);
+                case ComparisonOperator.LessThanOrEqual:
+                    return Expression.LessThanOrEqual(left, right);
+                default:
+                    throw new InvalidOperationException("Invalid comparison operator " + comparisonOperator);
+            }
+        }
+
+        private bool ParseBoolean(Token value)
+        {
+            switch (value.Text.ToUpperInvariant())
+            {
+                case "TRUE":
+                case "1":
+                    return true;
+                case "FALSE":
+                case "0":
+                    return false;
+                default:
+                    throw Error("Invalid boolean value " + value.Text, value);
+            }
+        }
+
+        private long ParseInteger(Type type, Token value)
+        {
+            string text = value.Text;
+            long result;
+            if (text.StartsWith("0x", StringComparison.OrdinalIgnoreCase))
+            {
+                if (long.TryParse(text.Substring(2), NumberStyles.AllowHexSpecifier, CultureInfo.InvariantCulture, out result))
+                    return result;
+            }
+            else if (long.TryParse(text, NumberStyles.AllowLeadingSign, CultureInfo.InvariantCulture, out result))
+            {
+                return result;
+            }
+
+            if (type.IsEnum && value.Kind == TokenKind.Word)
+            {
+                string name = Enum.GetNames(type).FirstOrDefault(enumName => string.Equals(enumName, text, StringComparison.OrdinalIgnoreCase));
+                if (name != null)
+                    return Convert.ToInt64(Enum.Parse(type, name), CultureInfo.InvariantCulture);
+            }
+
+            throw Error("Invalid " + type.Name + " value " + text, value);
+        }
+
+        private ulong ParseUnsignedInteger(Type type, Token value)
+        {
+            string text = value.Text;
+            ulong result;
+            if (text.StartsWith("0x", StringComparison.OrdinalIgnoreCase))
+            {
+                if (ulong.TryParse(text.Substring(2), NumberStyles.AllowHexSpecifier, CultureInfo.InvariantCulture, out result))
+                    return result;
+            }
+            else if (ulong.TryParse(text, NumberStyles.None, CultureInfo.InvariantCulture, out result))
+            {
+                return result;
+            }
+
+            if (type.IsEnum && value.Kind == TokenKind.Word)
+            {
+                string name = Enum.GetNames(type).FirstOrDefault(enumName => string.Equals(enumName, text, StringComparison.OrdinalIgnoreCase));
+                if (name != null)
+                    return Convert.ToUInt64(Enum.Parse(type, name), CultureInfo.InvariantCulture);
+            }
+
+            throw Error("Invalid " + type.Name + " value " + text, value);
+        }
+
+        private IpV4Address ParseIpV4Address(string text, Token value)
+        {
+            string[] parts = text.Split('.');
+            byte part;
+            if (parts.Length != 4 || parts.Any(addressPart => !byte.TryParse(addressPart, NumberStyles.None, CultureInfo.InvariantCulture, out part)))
+                throw Error("Invalid IPv4 address " + text, value);
+            return new IpV4Address(text);
+        }
+
+        private static bool IsIntegral(Type type)
+        {
+            if (type.IsEnum)
+                return true;
+
+            switch (Type.GetTypeCode(type))
+            {
+                case TypeCode.Byte:
+                case TypeCode.SByte:
+                case TypeCode.Int16:
+                case TypeCode.UInt16:
+                case TypeCode.Int32:
+                case TypeCode.UInt32:
+                case TypeCode.Int64:
+                case TypeCode.UInt64:
+                    return true;
+                default:
+                    return false;
+            }
+        }
+
+        private ArgumentException Error(string message)
+        {
+            return Error(message, Current);
+        }
+
+        private ArgumentException Error(string message, Token token)
+        {
+            return new ArgumentException(message + " at position " + token.Position + " in display filter <" + _expression + ">", "expression");
+        }
+
+        private static List<Token> Tokenize(string expression)
+        {
+            List<Token> tokens = new List<Token>();
+            int position = 0;
+            while (true)
+            {
+                while (position != expression.Length && char.IsWhiteSpace(expression[position]))
+                    ++position;
+                if (position == expression.Length)
+                    break;
+
+                char current = expression[position];
+                if (current == '"')
+                {
+                    tokens.Add(ReadString(expression, ref position));
+                    continue;
+                }
+
+                if (IsWordCharacter(current))
+                {
+                    int start = position;
+                    while (position != expression.Length && IsWordCharacter(expression[position]))
+                        ++position;
+                    tokens.Add(new Token(TokenKind.Word, expression.Substring(start, position - start), start));
+                    continue;
+                }
+
+                string symbol = Symbols.FirstOrDefault(candidate => string.CompareOrdinal(expression, position, candidate, 0, candidate.Length) == 0);
+                if (symbol == null)
+                    throw new ArgumentException("Unexpected character " + current + " at position " + position + " in display filter <" + expression + ">", "expression");
+                tokens.Add(new Token(TokenKind.Operator, symbol, position));
+                position += symbol.Length;
+            }
+
+            tokens.Add(new Token(TokenKind.End, "end of filter", expression.Length));
+            return tokens;
+        }
+
+        private static Token ReadString(string expression, ref int position)
+        {
+            int start = position;
+            StringBuilder text = new StringBuilder();
+            ++position;
+            while (position != expression.Length && expression[position] != '"')
+            {
+                if (expression[position] == '\\' && position + 1 != expression.Length)
+                    ++position;
+                text.Append(expression[position]);
+                ++position;
+            }
+
+            if (position == expression.Length)
+                throw new ArgumentException("Unterminated string at position " + start + " in display filter <" + expression + ">", "expression");
+            ++position;
+            return new Token(TokenKind.String, text.ToString(), start);
+        }
+
+        private static bool IsWordCharacter(char character)
+        {
+            return char.IsLetterOrDigit(character) || character == '.' || character == '_' || character == ':' || character == '/' || character == '-';
+        }
+
+        // Longer symbols first so "==" isn't read as "=".
+        private static readonly string[] Symbols = {"==", "!=", ">=", "<=", "&&", "||", ">", "<", "!", "(", ")"};
+
+        private static readonly Dictionary<string, ComparisonOperator> Operators =
+            new Dictionary<string, ComparisonOperator>
+            {
+                {"==", ComparisonOperator.Equal},
+                {"eq", ComparisonOperator.Equal},
+                {"!=", ComparisonOperator.NotEqual},
+                {"ne", ComparisonOperator.NotEqual},
+                {">", ComparisonOperator.GreaterThan},
+                {"gt", ComparisonOperator.GreaterThan},
+                {"<", ComparisonOperator.LessThan},
+                {"lt", ComparisonOperator.LessThan},
+                {">=", ComparisonOperator.GreaterThanOrEqual},
+                {"ge", ComparisonOperator.GreaterThanOrEqual},
+                {"<=", ComparisonOperator.LessThanOrEqual},
+                {"le", ComparisonOperator.LessThanOrEqual},
+                {"contains", ComparisonOperator.Contains},
+            };
+
+        private static readonly MethodInfo StringContainsMethod = typeof(string).GetMethod("Contains", new[] {typeof(string)});
+        private static readonly MethodInfo StringCompareOrdinalMethod = typeof(string).GetMethod("CompareOrdinal", new[] {typeof(string), typeof(string)});
+
+        private readonly string _expression;
+        private readonly DisplayFilterFieldRegistry _registry;
+        private readonly List<Token> _tokens;
+        private readonly ParameterExpression _packet = Expression.Parameter(typeof(Packet), "packet");
+        private int _index;
+    }
+}
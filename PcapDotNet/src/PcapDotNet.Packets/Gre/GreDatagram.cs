@@ -2,6 +2,7 @@ using System;
 using System.Collections.Generic;
 using System.Collections.ObjectModel;
 using System.Linq;
+using System.Threading;
 using PcapDotNet.Packets.Arp;
 using PcapDotNet.Packets.Ethernet;
 using PcapDotNet.Packets.IpV4;
@@ -194,9 +195,10 @@ namespace PcapDotNet.Packets.Gre
         {
             get
             {
-                if (_isChecksumCorrect == null)
-                    _isChecksumCorrect = (CalculateChecksum() == Checksum);
-                return _isChecksumCorrect.Value;
+                bool isChecksumCorrect;
+                if (!LazyCache.TryGet(ref _isChecksumCorrect, out isChecksumCorrect))
+                    isChecksumCorrect = LazyCache.Publish(ref _isChecksumCorrect, CalculateChecksum() == Checksum);
+                return isChecksumCorrect;
             }
         }
 
@@ -446,22 +448,24 @@ namespace PcapDotNet.Packets.Gre
 
         private void TryParseRouting()
         {
-            if (_routing != null || !RoutingPresent)
+            if (Volatile.Read(ref _routing) != null || !RoutingPresent)
                 return;
 
             List<GreSourceRouteEntry> entries = new List<GreSourceRouteEntry>();
             int routingStartOffset = StartOffset + OffsetRouting;
             int entryOffset = routingStartOffset;
+            int? activeSourceRouteEntryIndex = null;
+            bool isValidRouting = true;
 
             int totalLength = StartOffset + Length;
             while (totalLength >= entryOffset)
             {
                 GreSourceRouteEntry entry;
                 if (entryOffset == routingStartOffset + RoutingOffset)
-                    _activeSourceRouteEntryIndex = entries.Count;
+                    activeSourceRouteEntryIndex = entries.Count;
                 if (!GreSourceRouteEntry.TryReadEntry(Buffer, ref entryOffset, totalLength - entryOffset, out entry))
                 {
-                    _isValidRouting = false;
+                    isValidRouting = false;
                     break;
                 }
 
@@ -471,7 +475,10 @@ namespace PcapDotNet.Packets.Gre
                 entries.Add(entry);
             }
 
-            _routing = new ReadOnlyCollection<GreSourceRouteEntry>(entries);
+            // The routing fields are written before the routing is published, so a thread that sees the routing also sees them.
+            _activeSourceRouteEntryIndex = activeSourceRouteEntryIndex;
+            _isValidRouting = isValidRouting;
+            LazyCache.Publish(ref _routing, new ReadOnlyCollection<GreSourceRouteEntry>(entries));
         }
 
         private ushort CalculateChecksum()
@@ -499,7 +506,7 @@ namespace PcapDotNet.Packets.Gre
         
         private ReadOnlyCollection<GreSourceRouteEntry> _routing;
         private bool _isValidRouting = true;
-        private bool? _isChecksumCorrect;
+        private byte _isChecksumCorrect;
         private int? _activeSourceRouteEntryIndex;
     }
 }
\ No newline at end of file
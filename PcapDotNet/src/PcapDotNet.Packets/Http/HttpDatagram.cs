@@ -246,9 +246,10 @@ namespace PcapDotNet.Packets.Http
         {
             get
             {
-                if (_isValidStart == null)
-                    _isValidStart = CalculateIsValidStart();
-                return _isValidStart.Value;
+                bool isValidStart;
+                if (!LazyCache.TryGet(ref _isValidStart, out isValidStart))
+                    isValidStart = LazyCache.Publish(ref _isValidStart, CalculateIsValidStart());
+                return isValidStart;
             }
         }
 
@@ -374,6 +375,6 @@ namespace PcapDotNet.Packets.Http
 
         private static readonly byte[] _httpSlash = Encoding.ASCII.GetBytes("HTTP/");
 
-        private bool? _isValidStart;
+        private byte _isValidStart;
     }
 }
\ No newline at end of file
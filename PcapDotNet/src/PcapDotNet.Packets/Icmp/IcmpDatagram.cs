@@ -82,9 +82,10 @@ namespace PcapDotNet.Packets.Icmp
         {
             get
             {
-                if (_isChecksumCorrect == null)
-                    _isChecksumCorrect = (CalculateChecksum() == Checksum);
-                return _isChecksumCorrect.Value;
+                bool isChecksumCorrect;
+                if (!LazyCache.TryGet(ref _isChecksumCorrect, out isChecksumCorrect))
+                    isChecksumCorrect = LazyCache.Publish(ref _isChecksumCorrect, CalculateChecksum() == Checksum);
+                return isChecksumCorrect;
             }
         }
 
@@ -102,7 +103,7 @@ namespace PcapDotNet.Packets.Icmp
             get
             {
                 if (_payload == null && Length >= Offset.Payload)
-                    _payload = new Datagram(Buffer, StartOffset + Offset.Payload, Length - Offset.Payload);
+                    LazyCache.Publish(ref _payload, new Datagram(Buffer, StartOffset + Offset.Payload, Length - Offset.Payload));
                 return _payload;
             }
         }
@@ -187,7 +188,7 @@ namespace PcapDotNet.Packets.Icmp
 
         internal abstract IcmpDatagram CreateInstance(byte[] buffer, int offset, int length);
 
-        private bool? _isChecksumCorrect;
+        private byte _isChecksumCorrect;
         private Datagram _payload;
     }
 }
\ No newline at end of file
@@ -35,11 +35,11 @@ namespace PcapDotNet.Packets.Icmp
                     if (IsIpV4PayloadLimited)
                     {
                         int ipV4HeaderLength = IpV4Datagram.GetHeaderLength(Subsegment(HeaderLength, Length - HeaderLength));
-                        _ipV4 = new IpV4Datagram(Buffer, StartOffset + HeaderLength, Math.Min(Length - HeaderLength, ipV4HeaderLength + IpV4PayloadLimit));
+                        LazyCache.Publish(ref _ipV4, new IpV4Datagram(Buffer, StartOffset + HeaderLength, Math.Min(Length - HeaderLength, ipV4HeaderLength + IpV4PayloadLimit)));
                     }
                     else
                     {
-                        _ipV4 = new IpV4Datagram(Buffer, StartOffset + HeaderLength, Length - HeaderLength);
+                        LazyCache.Publish(ref _ipV4, new IpV4Datagram(Buffer, StartOffset + HeaderLength, Length - HeaderLength));
                     }
                 }
                 return _ipV4;
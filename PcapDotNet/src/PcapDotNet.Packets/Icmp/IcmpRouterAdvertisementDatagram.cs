@@ -96,7 +96,7 @@ namespace PcapDotNet.Packets.Icmp
                                                                       ReadInt(currentOffset + IpV4Address.SizeOf, Endianity.Big));
                         currentOffset += AddressEntrySize * IpV4Address.SizeOf;
                     }
-                    _entries = new ReadOnlyCollection<IcmpRouterAdvertisementEntry>(entries);
+                    LazyCache.Publish(ref _entries, new ReadOnlyCollection<IcmpRouterAdvertisementEntry>(entries));
                 }
 
                 return _entries;
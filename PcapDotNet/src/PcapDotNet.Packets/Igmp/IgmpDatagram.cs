@@ -398,9 +398,10 @@ namespace PcapDotNet.Packets.Igmp
         {
             get
             {
-                if (_isChecksumCorrect == null)
-                    _isChecksumCorrect = (CalculateChecksum() == Checksum);
-                return _isChecksumCorrect.Value;
+                bool isChecksumCorrect;
+                if (!LazyCache.TryGet(ref _isChecksumCorrect, out isChecksumCorrect))
+                    isChecksumCorrect = LazyCache.Publish(ref _isChecksumCorrect, CalculateChecksum() == Checksum);
+                return isChecksumCorrect;
             }
         }
 
@@ -576,7 +577,7 @@ namespace PcapDotNet.Packets.Igmp
                     IpV4Address[] sourceAddresses = new IpV4Address[actualNumberOfSources];
                     for (int i = 0; i != sourceAddresses.Length; ++i)
                         sourceAddresses[i] = ReadIpV4Address(Offset.SourceAddresses + IpV4Address.SizeOf * i, Endianity.Big);
-                    _sourceAddresses = new ReadOnlyCollection<IpV4Address>(sourceAddresses);
+                    LazyCache.Publish(ref _sourceAddresses, new ReadOnlyCollection<IpV4Address>(sourceAddresses));
                 }
 
                 return _sourceAddresses;
@@ -611,7 +612,7 @@ namespace PcapDotNet.Packets.Igmp
                         offset += groupRecords[i].Length;
                     }
 
-                    _groupRecords = new ReadOnlyCollection<IgmpGroupRecordDatagram>(groupRecords);
+                    LazyCache.Publish(ref _groupRecords, new ReadOnlyCollection<IgmpGroupRecordDatagram>(groupRecords));
                 }
 
                 return _groupRecords;
@@ -927,7 +928,7 @@ namespace PcapDotNet.Packets.Igmp
         private static readonly TimeSpan _maxVersion3MaxResponseTime = TimeSpan.FromSeconds(0.1 * CodeToValue(byte.MaxValue)) + TimeSpan.FromSeconds(0.1) - TimeSpan.FromTicks(1);
         private static readonly TimeSpan _maxQueryInterval = TimeSpan.FromSeconds(CodeToValue(byte.MaxValue)) + TimeSpan.FromSeconds(1) - TimeSpan.FromTicks(1);
 
-        private bool? _isChecksumCorrect;
+        private byte _isChecksumCorrect;
         private ReadOnlyCollection<IpV4Address> _sourceAddresses;
         private ReadOnlyCollection<IgmpGroupRecordDatagram> _groupRecords;
     }
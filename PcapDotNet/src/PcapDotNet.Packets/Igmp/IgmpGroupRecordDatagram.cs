@@ -98,7 +98,7 @@ namespace PcapDotNet.Packets.Igmp
                     IpV4Address[] sourceAddresses = new IpV4Address[actualNumberOfSource];
                     for (int i = 0; i != sourceAddresses.Length; ++i)
                         sourceAddresses[i] = ReadIpV4Address(Offset.SourceAddresses + IpV4Address.SizeOf * i, Endianity.Big);
-                    _sourceAddresses = new ReadOnlyCollection<IpV4Address>(sourceAddresses);
+                    LazyCache.Publish(ref _sourceAddresses, new ReadOnlyCollection<IpV4Address>(sourceAddresses));
                 }
 
                 return _sourceAddresses;
@@ -0,0 +1,241 @@
+﻿using System;
+using PcapDotNet.Base;
+using PcapDotNet.Packets.IpV4;
+using PcapDotNet.Packets.IpV6;
+
+namespace PcapDotNet.Packets
+{
+    /// <summary>
+    /// Updates Internet checksums (IPv4 header, TCP, UDP, ICMP) when a field they cover changes, without summing the data again.
+    /// Uses RFC 1624 equation 3: HC' = ~(~HC + ~m + m').
+    /// The result equals the checksum calculated over the whole data with the new field value.
+    /// </summary>
+    public static class IncrementalChecksum
+    {
+        /// <summary>
+        /// Returns the checksum after a 16 bits field it covers changed.
+        /// </summary>
+        /// <param name="checksum">The checksum before the change.</param>
+        /// <param name="oldValue">The field value before the change.</param>
+        /// <param name="newValue">The field value after the change.</param>
+        /// <returns>The checksum after the change.</returns>
+        public static ushort Update(ushort checksum, ushort oldValue, ushort newValue)
+        {
+            uint sum = (uint)(ushort)~checksum + (ushort)~oldValue + newValue;
+            return DataSegment.Sum16BitsToChecksum(sum);
+        }
+
+        /// <summary>
+        /// Returns the checksum after a 32 bits field it covers changed.
+        /// The field must start at an even offset from the start of the checksummed data.
+        /// </summary>
+        /// <param name="checksum">The checksum before the change.</param>
+        /// <param name="oldValue">The field value before the change.</param>
+        /// <param name="newValue">The field value after the change.</param>
+        /// <returns>The checksum after the change.</returns>
+        public static ushort Update(ushort checksum, uint oldValue, uint newValue)
+        {
+            uint sum = (ushort)~checksum + DataSegment.Sum16Bits(~oldValue) + DataSegment.Sum16Bits(newValue);
+            return DataSegment.Sum16BitsToChecksum(sum);
+        }
+
+        /// <summary>
+        /// Returns the checksum after a 64 bits field it covers changed.
+        /// The field must start at an even offset from the start of the checksummed data.
+        /// </summary>
+        /// <param name="checksum">The checksum before the change.</param>
+        /// <param name="oldValue">The field value before the change.</param>
+        /// <param name="newValue">The field value after the change.</param>
+        /// <returns>The checksum after the change.</returns>
+        public static ushort Update(ushort checksum, ulong oldValue, ulong newValue)
+        {
+            uint sum = (ushort)~checksum + DataSegment.Sum16Bits(~oldValue) + DataSegment.Sum16Bits(newValue);
+            return DataSegment.Sum16BitsToChecksum(sum);
+        }
+
+        /// <summary>
+        /// Returns the checksum after an IPv4 address it covers changed.
+        /// Use it for the IPv4 header checksum and for the TCP and UDP checksums that cover the addresses in their pseudo header.
+        /// </summary>
+        /// <param name="checksum">The checksum before the change.</param>
+        /// <param name="oldValue">The address before the change.</param>
+        /// <param name="newValue">The address after the change.</param>
+        /// <returns>The checksum after the change.</returns>
+        public static ushort Update(ushort checksum, IpV4Address oldValue, IpV4Address newValue)
+        {
+            return Update(checksum, oldValue.ToValue(), newValue.ToValue());
+        }
+
+        /// <summary>
+        /// Returns the checksum after an IPv6 address it covers changed.
+        /// Use it for the TCP, UDP and ICMPv6 checksums that cover the addresses in their pseudo header.
+        /// </summary>
+        /// <param name="checksum">The checksum before the change.</param>
+        /// <param name="oldValue">The address before the change.</param>
+        /// <param name="newValue">The address after the change.</param>
+        /// <returns>The checksum after the change.</returns>
+        public static ushort Update(ushort checksum, IpV6Address oldValue, IpV6Address newValue)
+        {
+            UInt128 oldAddress = oldValue.ToValue();
+            UInt128 newAddress = newValue.ToValue();
+            return Update(Update(checksum, (ulong)(oldAddress >> 64), (ulong)(newAddress >> 64)), (ulong)oldAddress, (ulong)newAddress);
+        }
+
+        /// <summary>
+        /// Returns an optional checksum, like the UDP checksum, after a 16 bits field it covers changed.
+        /// A zero checksum means there's no checksum so it stays zero.
+        /// A calculated zero checksum is replaced by 0xFFFF.
+        /// </summary>
+        /// <param name="checksum">The checksum before the change.</param>
+        /// <param name="oldValue">The field value before the change.</param>
+        /// <param name="newValue">The field value after the change.</param>
+        /// <returns>The checksum after the change.</returns>
+        public static ushort UpdateOptional(ushort checksum, ushort oldValue, ushort newValue)
+        {
+            if (checksum == 0)
+                return 0;
+            return ToOptional(Update(checksum, oldValue, newValue));
+        }
+
+        /// <summary>
+        /// Returns an optional checksum, like the UDP checksum, after a 32 bits field it covers changed.
+        /// A zero checksum means there's no checksum so it stays zero.
+        /// A calculated zero checksum is replaced by 0xFFFF.
+        /// </summary>
+        /// <param name="checksum">The checksum before the change.</param>
+        /// <param name="oldValue">The field value before the change.</param>
+        /// <param name="newValue">The field value after the change.</param>
+        /// <returns>The checksum after the change.</returns>
+        public static ushort UpdateOptional(ushort checksum, uint oldValue, uint newValue)
+        {
+            if (checksum == 0)
+                return 0;
+            return ToOptional(Update(checksum, oldValue, newValue));
+        }
+
+        /// <summary>
+        /// Returns an optional checksum, like the UDP checksum, after an IPv4 address in its pseudo header changed.
+        /// A zero checksum means there's no checksum so it stays zero.
+        /// A calculated zero checksum is replaced by 0xFFFF.
+        /// </summary>
+        /// <param name="checksum">The checksum before the change.</param>
+        /// <param name="oldValue">The address before the change.</param>
+        /// <param name="newValue">The address after the change.</param>
+        /// <returns>The checksum after the change.</returns>
+        public static ushort UpdateOptional(ushort checksum, IpV4Address oldValue, IpV4Address newValue)
+        {
+            return UpdateOptional(checksum, oldValue.ToValue(), newValue.ToValue());
+        }
+
+        /// <summary>
+        /// Returns an optional checksum, like the UDP checksum, after an IPv6 address in its pseudo header changed.
+        /// A zero checksum means there's no checksum so it stays zero.
+        /// A calculated zero checksum is replaced by 0xFFFF.
+        /// </summary>
+        /// <param name="checksum">The checksum before the change.</param>
+        /// <param name="oldValue">The address before the change.</param>
+        /// <param name="newValue">The address after the change.</param>
+        /// <returns>The checksum after the change.</returns>
+        public static ushort UpdateOptional(ushort checksum, IpV6Address oldValue, IpV6Address newValue)
+        {
+            if (checksum == 0)
+                return 0;
+            return ToOptional(Update(checksum, oldValue, newValue));
+        }
+
+        /// <summary>
+        /// Changes the IPv4 source address of the packet in the buffer and updates the IPv4 header checksum and the TCP or UDP checksum.
+        /// Takes constant time regardless of the packet length.
+        /// </summary>
+        /// <param name="buffer">
+        /// The buffer that holds the packet. It is changed, so it must be owned by the caller and not be the buffer of a Packet that is still used.
+        /// Create a new Packet over the buffer to read the changed packet.
+        /// </param>
+        /// <param name="offset">The offset of the packet in the buffer.</param>
+        /// <param name="length">The length of the packet.</param>
+        /// <param name="dataLink">The data link of the packet.</param>
+        /// <param name="source">The new source address.</param>
+        /// <exception cref="ArgumentNullException">The buffer is null.</exception>
+        /// <exception cref="ArgumentOutOfRangeException">The offset or the length are negative or the packet exceeds the buffer.</exception>
+        /// <exception cref="ArgumentException">The packet doesn't contain an IPv4 header.</exception>
+        public static void RewriteIpV4Source(byte[] buffer, int offset, int length, DataLinkKind dataLink, IpV4Address source)
+        {
+            Rewrite(buffer, offset, length, dataLink, PacketTemplateFieldKind.IpV4Source, source.ToValue());
+        }
+
+        /// <summary>
+        /// Changes the IPv4 destination address of the packet in the buffer and updates the IPv4 header checksum and the TCP or UDP checksum.
+        /// Takes constant time regardless of the packet length.
+        /// </summary>
+        /// <param name="buffer">
+        /// The buffer that holds the packet. It is changed, so it must be owned by the caller and not be the buffer of a Packet that is still used.
+        /// Create a new Packet over the buffer to read the changed packet.
+        /// </param>
+        /// <param name="offset">The offset of the packet in the buffer.</param>
+        /// <param name="length">The length of the packet.</param>
+        /// <param name="dataLink">The data link of the packet.</param>
+        /// <param name="destination">The new current destination address.</param>
+        /// <exception cref="ArgumentNullException">The buffer is null.</exception>
+        /// <exception cref="ArgumentOutOfRangeException">The offset or the length are negative or the packet exceeds the buffer.</exception>
+        /// <exception cref="ArgumentException">The packet doesn't contain an IPv4 header.</exception>
+        public static void RewriteIpV4Destination(byte[] buffer, int offset, int length, DataLinkKind dataLink, IpV4Address destination)
+        {
+            Rewrite(buffer, offset, length, dataLink, PacketTemplateFieldKind.IpV4Destination, destination.ToValue());
+        }
+
+        /// <summary>
+        /// Changes the TCP or UDP source port of the packet in the buffer and updates the TCP or UDP checksum.
+        /// Takes constant time regardless of the packet length.
+        /// </summary>
+        /// <param name="buffer">
+        /// The buffer that holds the packet. It is changed, so it must be owned by the caller and not be the buffer of a Packet that is still used.
+        /// Create a new Packet over the buffer to read the changed packet.
+        /// </param>
+        /// <param name="offset">The offset of the packet in the buffer.</param>
+        /// <param name="length">The length of the packet.</param>
+        /// <param name="dataLink">The data link of the packet.</param>
+        /// <param name="port">The new source port.</param>
+        /// <exception cref="ArgumentNullException">The buffer is null.</exception>
+        /// <exception cref="ArgumentOutOfRangeException">The offset or the length are negative or the packet exceeds the buffer.</exception>
+        /// <exception cref="ArgumentException">The packet doesn't contain a TCP or UDP header.</exception>
+        public static void RewriteTransportSourcePort(byte[] buffer, int offset, int length, DataLinkKind dataLink, ushort port)
+        {
+            Rewrite(buffer, offset, length, dataLink, PacketTemplateFieldKind.TransportSourcePort, port);
+        }
+
+        /// <summary>
+        /// Changes the TCP or UDP destination port of the packet in the buffer and updates the TCP or UDP checksum.
+        /// Takes constant time regardless of the packet length.
+        /// </summary>
+        /// <param name="buffer">
+        /// The buffer that holds the packet. It is changed, so it must be owned by the caller and not be the buffer of a Packet that is still used.
+        /// Create a new Packet over the buffer to read the changed packet.
+        /// </param>
+        /// <param name="offset">The offset of the packet in the buffer.</param>
+        /// <param name="length">The length of the packet.</param>
+        /// <param name="dataLink">The data link of the packet.</param>
+        /// <param name="port">The new destination port.</param>
+        /// <exception cref="ArgumentNullException">The buffer is null.</exception>
+        /// <exception cref="ArgumentOutOfRangeException">The offset or the length are negative or the packet exceeds the buffer.</exception>
+        /// <exception cref="ArgumentException">The packet doesn't contain a TCP or UDP header.</exception>
+        public static void RewriteTransportDestinationPort(byte[] buffer, int offset, int length, DataLinkKind dataLink, ushort port)
+        {
+            Rewrite(buffer, offset, length, dataLink, PacketTemplateFieldKind.TransportDestinationPort, port);
+        }
+
+        private static void Rewrite(byte[] buffer, int offset, int length, DataLinkKind dataLink, PacketTemplateFieldKind kind, uint value)
+        {
+            if (buffer == null)
+                throw new ArgumentNullException("buffer");
+
+            // The packet is only used to find the offsets, it isn't used after the buffer changes.
+            Packet packet = new Packet(buffer, offset, length, DateTime.MinValue, new DataLink(dataLink));
+            PacketTemplate.CreateField(packet, buffer, kind).Value = value;
+        }
+
+        private static ushort ToOptional(ushort checksum)
+        {
+            return checksum == 0 ? (ushort)0xFFFF : checksum;
+        }
+    }
+}
@@ -60,14 +60,16 @@ namespace PcapDotNet.Packets.Ip
         {
             get
             {
-                if (_isTransportChecksumCorrect == null)
+                bool isTransportChecksumCorrect;
+                if (!LazyCache.TryGet(ref _isTransportChecksumCorrect, out isTransportChecksumCorrect))
                 {
                     ushort transportChecksum = Transport.Checksum;
-                    _isTransportChecksumCorrect = Length >= TotalLength &&
-                                                  (Transport.IsChecksumOptional && transportChecksum == 0) ||
-                                                  (CalculateTransportChecksum() == transportChecksum);
+                    isTransportChecksumCorrect = LazyCache.Publish(ref _isTransportChecksumCorrect,
+                                                                   Length >= TotalLength &&
+                                                                   (Transport.IsChecksumOptional && transportChecksum == 0) ||
+                                                                   (CalculateTransportChecksum() == transportChecksum));
                 }
-                return _isTransportChecksumCorrect.Value;
+                return isTransportChecksumCorrect;
             }
         }
 
@@ -82,7 +84,7 @@ namespace PcapDotNet.Packets.Ip
                 {
                     DataSegment payload = GetPayload();
                     if (payload != null)
-                        _payload = new Datagram(payload.Buffer, payload.StartOffset, payload.Length);
+                        LazyCache.Publish(ref _payload, new Datagram(payload.Buffer, payload.StartOffset, payload.Length));
                 }
                 return _payload;
             }
@@ -99,7 +101,7 @@ namespace PcapDotNet.Packets.Ip
                 {
                     DataSegment payload = GetPayload();
                     if (payload != null)
-                        _ipV4 = new IpV4Datagram(payload.Buffer, payload.StartOffset, payload.Length);
+                        LazyCache.Publish(ref _ipV4, new IpV4Datagram(payload.Buffer, payload.StartOffset, payload.Length));
                 }
                 return _ipV4;
             }
@@ -116,7 +118,7 @@ namespace PcapDotNet.Packets.Ip
                 {
                     DataSegment payload = GetPayload();
                     if (payload != null)
-                        _ipV6 = new IpV6Datagram(payload.Buffer, payload.StartOffset, payload.Length);
+                        LazyCache.Publish(ref _ipV6, new IpV6Datagram(payload.Buffer, payload.StartOffset, payload.Length));
                 }
                 return _ipV6;
             }
@@ -155,7 +157,7 @@ namespace PcapDotNet.Packets.Ip
                 {
                     DataSegment payload = GetPayload();
                     if (payload != null)
-                        _icmp = IcmpDatagram.CreateDatagram(payload.Buffer, payload.StartOffset, payload.Length);
+                        LazyCache.Publish(ref _icmp, IcmpDatagram.CreateDatagram(payload.Buffer, payload.StartOffset, payload.Length));
                 }
                 return _icmp;
             }
@@ -172,7 +174,7 @@ namespace PcapDotNet.Packets.Ip
                 {
                     DataSegment payload = GetPayload();
                     if (payload != null)
-                        _igmp = new IgmpDatagram(payload.Buffer, payload.StartOffset, payload.Length);
+                        LazyCache.Publish(ref _igmp, new IgmpDatagram(payload.Buffer, payload.StartOffset, payload.Length));
                 }
                 return _igmp;
             }
@@ -189,7 +191,7 @@ namespace PcapDotNet.Packets.Ip
                 {
                     DataSegment payload = GetPayload();
                     if (payload != null)
-                        _tcp = new TcpDatagram(payload.Buffer, payload.StartOffset, payload.Length);
+                        LazyCache.Publish(ref _tcp, new TcpDatagram(payload.Buffer, payload.StartOffset, payload.Length));
                 }
                 return _tcp;
             }
@@ -206,7 +208,7 @@ namespace PcapDotNet.Packets.Ip
                 {
                     DataSegment payload = GetPayload();
                     if (payload != null)
-                        _gre = new GreDatagram(payload.Buffer, payload.StartOffset, payload.Length);
+                        LazyCache.Publish(ref _gre, new GreDatagram(payload.Buffer, payload.StartOffset, payload.Length));
                 }
                 return _gre;
             }
@@ -223,7 +225,7 @@ namespace PcapDotNet.Packets.Ip
                 {
                     DataSegment payload = GetPayload();
                     if (payload != null)
-                        _udp = new UdpDatagram(payload.Buffer, payload.StartOffset, payload.Length);
+                        LazyCache.Publish(ref _udp, new UdpDatagram(payload.Buffer, payload.StartOffset, payload.Length));
                 }
                 return _udp;
             }
@@ -297,7 +299,25 @@ namespace PcapDotNet.Packets.Ip
 
         internal abstract DataSegment GetPayload();
 
-        private bool? _isTransportChecksumCorrect;
+        internal override void ResetCache()
+        {
+            _isTransportChecksumCorrect = LazyCache.Unknown;
+            _icmp = null;
+            _igmp = null;
+            _gre = null;
+            if (_payload != null || _ipV4 != null || _ipV6 != null || _tcp != null || _udp != null)
+            {
+                DataSegment payload = GetPayload();
+                _payload = Reuse(_payload, payload);
+                _ipV4 = Reuse(_ipV4, payload);
+                _ipV6 = Reuse(_ipV6, payload);
+                _tcp = Reuse(_tcp, payload);
+                _udp = Reuse(_udp, payload);
+            }
+            base.ResetCache();
+        }
+
+        private byte _isTransportChecksumCorrect;
         private Datagram _payload;
         private IpV4Datagram _ipV4;
         private IpV6Datagram _ipV6;
@@ -46,7 +46,7 @@ namespace PcapDotNet.Packets.IpV4
         /// </summary>
         public const int HeaderMaximumLength = 60;
 
-        private static class Offset
+        internal static class Offset
         {
             public const int VersionAndHeaderLength = 0;
             public const int TypeOfService = 1;
@@ -145,9 +145,10 @@ namespace PcapDotNet.Packets.IpV4
         {
             get 
             { 
-                if (_isHeaderChecksumCorrect == null)
-                    _isHeaderChecksumCorrect = (CalculateHeaderChecksum() == HeaderChecksum);
-                return _isHeaderChecksumCorrect.Value;
+                bool isHeaderChecksumCorrect;
+                if (!LazyCache.TryGet(ref _isHeaderChecksumCorrect, out isHeaderChecksumCorrect))
+                    isHeaderChecksumCorrect = LazyCache.Publish(ref _isHeaderChecksumCorrect, CalculateHeaderChecksum() == HeaderChecksum);
+                return isHeaderChecksumCorrect;
             }
         }
 
@@ -176,10 +177,15 @@ namespace PcapDotNet.Packets.IpV4
         {
             get
             {
-                if (_destination == null)
+                // The destination is written before the flag is published, so a thread that sees the flag also sees the destination.
+                bool isDestinationCalculated;
+                if (!LazyCache.TryGet(ref _isDestinationCalculated, out isDestinationCalculated))
+                {
                     _destination = CalculateDestination(CurrentDestination, Options);
+                    LazyCache.Publish(ref _isDestinationCalculated, true);
+                }
 
-                return _destination.Value;
+                return _destination;
             }
         }
 
@@ -191,7 +197,7 @@ namespace PcapDotNet.Packets.IpV4
             get
             {
                 if (_options == null && RealHeaderLength >= HeaderMinimumLength)
-                    _options = new IpV4Options(Buffer, StartOffset + Offset.Options, RealHeaderLength - HeaderMinimumLength);
+                    LazyCache.Publish(ref _options, new IpV4Options(Buffer, StartOffset + Offset.Options, RealHeaderLength - HeaderMinimumLength));
                 
                 return _options;
             }
@@ -228,6 +234,14 @@ namespace PcapDotNet.Packets.IpV4
             return Subsegment(HeaderLength, Length - HeaderLength);
         }
 
+        internal override void ResetCache()
+        {
+            _isDestinationCalculated = LazyCache.Unknown;
+            _isHeaderChecksumCorrect = LazyCache.Unknown;
+            _options = null;
+            base.ResetCache();
+        }
+
         internal static int GetHeaderLength(DataSegment ipV4Datagram)
         {
             if (ipV4Datagram.Length < HeaderMinimumLength)
@@ -370,8 +384,9 @@ namespace PcapDotNet.Packets.IpV4
             return checksumResult;
         }
 
-        private IpV4Address? _destination;
-        private bool? _isHeaderChecksumCorrect;
+        private IpV4Address _destination;
+        private byte _isDestinationCalculated;
+        private byte _isHeaderChecksumCorrect;
         private IpV4Options _options;
     }
 }
\ No newline at end of file
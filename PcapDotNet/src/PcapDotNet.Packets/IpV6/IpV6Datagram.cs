@@ -2,6 +2,7 @@ using System;
 using System.Collections.Generic;
 using System.Collections.ObjectModel;
 using System.Linq;
+using System.Threading;
 using PcapDotNet.Base;
 using PcapDotNet.Packets.Ip;
 using PcapDotNet.Packets.IpV4;
@@ -46,7 +47,7 @@ namespace PcapDotNet.Packets.IpV6
         /// </summary>
         public const int MaxFlowLabel = 0xFFFFF;
 
-        private static class Offset
+        internal static class Offset
         {
             public const int Version = 0;
             public const int TrafficClass = Version;
@@ -242,6 +243,13 @@ namespace PcapDotNet.Packets.IpV6
             return Subsegment(HeaderLength + ExtensionHeaders.BytesLength, Length - HeaderLength - ExtensionHeaders.BytesLength);
         }
 
+        internal override void ResetCache()
+        {
+            _extensionHeaders = null;
+            _isValidExtensionHeaders = true;
+            base.ResetCache();
+        }
+
         internal static void WriteHeader(byte[] buffer, int offset,
                                          byte trafficClass, int flowLabel, ushort payloadLength, IpV4Protocol? nextHeader, IpV4Protocol? nextLayerProtocol,
                                          byte hopLimit, IpV6Address source, IpV6Address currentDestination, IpV6ExtensionHeaders extensionHeaders)
@@ -274,17 +282,19 @@ namespace PcapDotNet.Packets.IpV6
 
         private void ParseExtensionHeaders()
         {
-            if (_extensionHeaders != null)
+            if (Volatile.Read(ref _extensionHeaders) != null)
                 return;
 
+            // The validity is written before the extension headers are published, so a thread that sees the extension headers also sees their validity.
             if (Length < HeaderLength)
             {
                 _isValidExtensionHeaders = false;
-                _extensionHeaders = IpV6ExtensionHeaders.Empty;
+                LazyCache.Publish(ref _extensionHeaders, IpV6ExtensionHeaders.Empty);
                 return;
             }
-            _extensionHeaders = new IpV6ExtensionHeaders(Subsegment(HeaderLength, RealPayloadLength), NextHeader);
-            _isValidExtensionHeaders = _isValidExtensionHeaders && _extensionHeaders.IsValid;
+            IpV6ExtensionHeaders extensionHeaders = new IpV6ExtensionHeaders(Subsegment(HeaderLength, RealPayloadLength), NextHeader);
+            _isValidExtensionHeaders = extensionHeaders.IsValid;
+            LazyCache.Publish(ref _extensionHeaders, extensionHeaders);
         }
 
         private static ushort CalculateTransportChecksum(byte[] buffer, int offset, int fullHeaderLength, uint transportLength, int transportChecksumOffset, bool isChecksumOptional, IpV6Address destination)
@@ -157,13 +157,14 @@ namespace PcapDotNet.Packets.IpV6
         {
             get
             {
-                if (_isChecksumCorrect == null)
+                bool isChecksumCorrect;
+                if (!LazyCache.TryGet(ref _isChecksumCorrect, out isChecksumCorrect))
                 {
                     ushort expectedValue = CalculateChecksum(DomainOfInterpretation, SensitivityLevel, CompartmentBitmap);
-                    _isChecksumCorrect = (Checksum == expectedValue);
+                    isChecksumCorrect = LazyCache.Publish(ref _isChecksumCorrect, Checksum == expectedValue);
                 }
 
-                return _isChecksumCorrect.Value;
+                return isChecksumCorrect;
             }
         }
 
@@ -262,6 +263,6 @@ namespace PcapDotNet.Packets.IpV6
             return checksum;
         }
 
-        private bool? _isChecksumCorrect;
+        private byte _isChecksumCorrect;
     }
 }
\ No newline at end of file
@@ -0,0 +1,52 @@
+﻿using System.Threading;
+
+namespace PcapDotNet.Packets
+{
+    /// <summary>
+    /// Lock free lazy initialization of the values cached by packets and datagrams, so one packet can be read by several threads at the same time.
+    /// Every cached value is calculated only from the packet bytes, so threads that race to calculate the same value get equal results and any of them can be kept.
+    /// Objects are published using a compare exchange, so all the threads share the first object that was published.
+    /// Flags are kept in a single byte that is written only after its value was calculated, so a flag is never seen partially written.
+    /// When a cached object or flag guards other fields, the other fields are written before it is published and read after it is read with Volatile.Read().
+    /// </summary>
+    internal static class LazyCache
+    {
+        /// <summary>
+        /// The value of a flag that wasn't calculated yet.
+        /// </summary>
+        public const byte Unknown = 0;
+
+        /// <summary>
+        /// Publishes the given object unless another thread already published one.
+        /// </summary>
+        /// <returns>The object that was published first.</returns>
+        public static T Publish<T>(ref T field, T value) where T : class
+        {
+            return Interlocked.CompareExchange(ref field, value, null) ?? value;
+        }
+
+        /// <summary>
+        /// Reads a flag.
+        /// </summary>
+        /// <returns>True iff the flag was already calculated.</returns>
+        public static bool TryGet(ref byte flag, out bool value)
+        {
+            byte flagValue = Volatile.Read(ref flag);
+            value = flagValue == True;
+            return flagValue != Unknown;
+        }
+
+        /// <summary>
+        /// Publishes the calculated value of a flag.
+        /// </summary>
+        /// <returns>The given value.</returns>
+        public static bool Publish(ref byte flag, bool value)
+        {
+            Volatile.Write(ref flag, value ? True : False);
+            return value;
+        }
+
+        private const byte False = 1;
+        private const byte True = 2;
+    }
+}
@@ -1,7 +1,7 @@
 ﻿using System;
 using System.Collections;
 using System.Collections.Generic;
-using System.Linq;
+using System.Threading;
 using PcapDotNet.Base;
 using PcapDotNet.Packets.Ethernet;
 using PcapDotNet.Packets.IpV4;
@@ -11,9 +11,12 @@ namespace PcapDotNet.Packets
     /// <summary>
     /// A raw packet.
     /// Includes all packet layers as taken from an adapter including the type of the datalink.
-    /// Immutable.
+    /// The bytes can be a segment of a bigger array, which can be owned by an object that is released when the packet is disposed.
+    /// Immutable, unless created using CreateRebindable() for streaming over many packets.
+    /// A packet and the datagrams taken from it can be read by several threads at the same time without copying the packet.
+    /// The datagrams are parsed lazily without locks, and all the threads get the same datagram objects.
     /// </summary>
-    public sealed class Packet : IList<byte>, IEquatable<Packet>
+    public sealed class Packet : IList<byte>, IEquatable<Packet>, IDisposable
     {
         /// <summary>
         /// Creates a packet from a string that represents bytes in a hexadecimal format.
@@ -41,6 +44,30 @@ namespace PcapDotNet.Packets
             return new Packet(bytes, timestamp, dataLink);
         }
 
+        /// <summary>
+        /// Creates an empty packet that can be rebound to the bytes of different packets using Rebind().
+        /// Meant for iterating over many packets when each packet is only used until the next one arrives.
+        /// The datagrams created for a rebindable packet are reused for the next packets instead of being created again.
+        /// </summary>
+        /// <param name="dataLink">The type of the datalink of all the packets that will be bound to this packet.</param>
+        public static Packet CreateRebindable(IDataLink dataLink)
+        {
+            Packet packet = new Packet(new byte[0], 0, 0, DateTime.MinValue, dataLink, 0, null);
+            packet._isRebindable = true;
+            return packet;
+        }
+
+        /// <summary>
+        /// Creates an empty packet that can be rebound to the bytes of different packets using Rebind().
+        /// Meant for iterating over many packets when each packet is only used until the next one arrives.
+        /// The datagrams created for a rebindable packet are reused for the next packets instead of being created again.
+        /// </summary>
+        /// <param name="dataLink">The type of the datalink of all the packets that will be bound to this packet.</param>
+        public static Packet CreateRebindable(DataLinkKind dataLink)
+        {
+            return CreateRebindable(new DataLink(dataLink));
+        }
+
         /// <summary>
         /// Create a packet from an array of bytes.
         /// </summary>
@@ -52,13 +79,54 @@ namespace PcapDotNet.Packets
         /// If the value is less than the data size, it is ignored and the original length is considered to be equal to the data size.
         /// </param>
         public Packet(byte[] data, DateTime timestamp, IDataLink dataLink, uint originalLength)
+            : this(data, 0, data == null ? 0 : data.Length, timestamp, dataLink, originalLength, null)
         {
-            if (data == null)
-                throw new ArgumentNullException("data");
+        }
+
+        /// <summary>
+        /// Create a packet from a segment of an array of bytes.
+        /// Doesn't copy the bytes, so a packet can be taken directly from a pooled, shared or mapped buffer.
+        /// </summary>
+        /// <param name="data">The array that contains the bytes of the packet. The segment should not be changed after creating the packet until the packet is no longer used.</param>
+        /// <param name="offset">The offset in the array where the packet starts.</param>
+        /// <param name="length">The number of bytes in the packet.</param>
+        /// <param name="timestamp">A timestamp of the packet - when it was captured.</param>
+        /// <param name="dataLink">The type of the datalink of the packet.</param>
+        /// <param name="originalLength">
+        /// Length this packet (off wire). 
+        /// If the value is less than the data size, it is ignored and the original length is considered to be equal to the data size.
+        /// </param>
+        /// <param name="owner">
+        /// The object that owns the array, for example a lease on a pooled buffer.
+        /// Disposed when the packet is disposed. Can be null if there's nothing to release.
+        /// </param>
+        /// <exception cref="ArgumentNullException">The data is null.</exception>
+        /// <exception cref="ArgumentOutOfRangeException">The offset or the length are negative or the segment exceeds the array.</exception>
+        public Packet(byte[] data, int offset, int length, DateTime timestamp, IDataLink dataLink, uint originalLength, IDisposable owner)
+        {
+            CheckSegment(data, offset, length);
+
             _data = data;
+            _offset = offset;
+            _length = length;
             _timestamp = timestamp;
             _dataLink = dataLink;
-            OriginalLength = Math.Max((uint)_data.Length, originalLength);
+            _owner = owner;
+            OriginalLength = Math.Max((uint)length, originalLength);
+        }
+
+        /// <summary>
+        /// Create a packet from a segment of an array of bytes with no owner.
+        /// The original length is considered to be the actual size.
+        /// </summary>
+        /// <param name="data">The array that contains the bytes of the packet. The segment should not be changed after creating the packet until the packet is no longer used.</param>
+        /// <param name="offset">The offset in the array where the packet starts.</param>
+        /// <param name="length">The number of bytes in the packet.</param>
+        /// <param name="timestamp">A timestamp of the packet - when it was captured.</param>
+        /// <param name="dataLink">The type of the datalink of the packet.</param>
+        public Packet(byte[] data, int offset, int length, DateTime timestamp, IDataLink dataLink)
+            : this(data, offset, length, timestamp, dataLink, 0, null)
+        {
         }
 
         /// <summary>
@@ -106,7 +174,7 @@ namespace PcapDotNet.Packets
         /// </summary>
         public int Length
         {
-            get { return _data.Length; }
+            get { return _length; }
         }
 
         /// <summary>
@@ -133,6 +201,7 @@ namespace PcapDotNet.Packets
 
         /// <summary>
         /// The underlying array of bytes.
+        /// The packet bytes start at StartOffset and take Length bytes, the rest of the array isn't part of the packet.
         /// When taking this array the caller is responsible to make sure this array will not be modified while the packet is still in use.
         /// </summary>
         [System.Diagnostics.CodeAnalysis.SuppressMessage("Microsoft.Performance", "CA1819:PropertiesShouldNotReturnArrays")]
@@ -141,6 +210,82 @@ namespace PcapDotNet.Packets
             get { return _data; }
         }
 
+        /// <summary>
+        /// The offset in Buffer where the packet starts.
+        /// 0 unless the packet was created from a segment of an array.
+        /// </summary>
+        public int StartOffset
+        {
+            get { return _offset; }
+        }
+
+        /// <summary>
+        /// True iff the packet was created using CreateRebindable() and can be rebound to different bytes using Rebind().
+        /// </summary>
+        public bool IsRebindable
+        {
+            get { return _isRebindable; }
+        }
+
+        /// <summary>
+        /// Binds a rebindable packet to the bytes of a different packet.
+        /// The datagrams that were already taken from this packet are reused and represent the new bytes after this call,
+        /// so any value needed from the previous packet should be read before rebinding or the previous packet should be copied.
+        /// The previous owner is released unless it is the new owner.
+        /// Rebinding isn't thread safe, so the packet shouldn't be read by other threads while it is rebound.
+        /// </summary>
+        /// <param name="data">The array that contains the bytes of the packet. The segment should not be changed until the packet is rebound again or disposed.</param>
+        /// <param name="offset">The offset in the array where the packet starts.</param>
+        /// <param name="length">The number of bytes in the packet.</param>
+        /// <param name="timestamp">A timestamp of the packet - when it was captured.</param>
+        /// <param name="originalLength">
+        /// Length this packet (off wire). 
+        /// If the value is less than the data size, it is ignored and the original length is considered to be equal to the data size.
+        /// </param>
+        /// <param name="owner">
+        /// The object that owns the array, for example a lease on a pooled buffer.
+        /// Disposed when the packet is rebound again or disposed. Can be null if there's nothing to release.
+        /// </param>
+        /// <exception cref="InvalidOperationException">The packet wasn't created using CreateRebindable().</exception>
+        /// <exception cref="ArgumentNullException">The data is null.</exception>
+        /// <exception cref="ArgumentOutOfRangeException">The offset or the length are negative or the segment exceeds the array.</exception>
+        public void Rebind(byte[] data, int offset, int length, DateTime timestamp, uint originalLength, IDisposable owner)
+        {
+            if (!IsRebindable)
+                throw new InvalidOperationException("Only a packet created using CreateRebindable() can be rebound");
+            CheckSegment(data, offset, length);
+
+            IDisposable previousOwner = Interlocked.Exchange(ref _owner, owner);
+            if (previousOwner != null && !ReferenceEquals(previousOwner, owner))
+                previousOwner.Dispose();
+
+            _data = data;
+            _offset = offset;
+            _length = length;
+            _timestamp = timestamp;
+            OriginalLength = Math.Max((uint)length, originalLength);
+            _isValid = LazyCache.Unknown;
+            _ethernet = Datagram.Reuse(_ethernet, data, offset, length);
+            _ipV4 = Datagram.Reuse(_ipV4, data, offset, length);
+        }
+
+        /// <summary>
+        /// Binds a rebindable packet to the bytes of a different packet with no owner.
+        /// The original length is considered to be the actual size.
+        /// The datagrams that were already taken from this packet are reused and represent the new bytes after this call.
+        /// </summary>
+        /// <param name="data">The array that contains the bytes of the packet. The segment should not be changed until the packet is rebound again.</param>
+        /// <param name="offset">The offset in the array where the packet starts.</param>
+        /// <param name="length">The number of bytes in the packet.</param>
+        /// <param name="timestamp">A timestamp of the packet - when it was captured.</param>
+        /// <exception cref="InvalidOperationException">The packet wasn't created using CreateRebindable().</exception>
+        /// <exception cref="ArgumentNullException">The data is null.</exception>
+        /// <exception cref="ArgumentOutOfRangeException">The offset or the length are negative or the segment exceeds the array.</exception>
+        public void Rebind(byte[] data, int offset, int length, DateTime timestamp)
+        {
+            Rebind(data, offset, length, timestamp, 0, null);
+        }
+
         /// <summary>
         /// Equals means that the packets have equal data.
         /// </summary>
@@ -148,7 +293,7 @@ namespace PcapDotNet.Packets
         /// <returns>True iff the packets have equal data.</returns>
         public bool Equals(Packet other)
         {
-            return (other != null && Length == other.Length && this.SequenceEqual(other));
+            return (other != null && Length == other.Length && Buffer.SequenceEqual(StartOffset, other.Buffer, other.StartOffset, Length));
         }
 
         /// <summary>
@@ -182,7 +327,8 @@ namespace PcapDotNet.Packets
         /// </summary>
         public IEnumerator<byte> GetEnumerator()
         {
-            return ((IEnumerable<byte>)Buffer).GetEnumerator();
+            for (int i = 0; i != Length; ++i)
+                yield return Buffer[StartOffset + i];
         }
 
         IEnumerator IEnumerable.GetEnumerator()
@@ -195,7 +341,8 @@ namespace PcapDotNet.Packets
         /// </summary>
         public int IndexOf(byte item)
         {
-            return ((IList<byte>)Buffer).IndexOf(item);
+            int index = Array.IndexOf(Buffer, item, StartOffset, Length);
+            return index < 0 ? index : index - StartOffset;
         }
 
         /// <summary>
@@ -220,7 +367,12 @@ namespace PcapDotNet.Packets
         /// </summary>
         public byte this[int index]
         {
-            get { return Buffer[index]; }
+            get
+            {
+                if (index < 0 || index >= Length)
+                    throw new ArgumentOutOfRangeException("index", index, "Must be between 0 and the packet length " + Length);
+                return Buffer[StartOffset + index];
+            }
             set { throw new InvalidOperationException("Immutable collection"); ; }
         }
 
@@ -245,7 +397,7 @@ namespace PcapDotNet.Packets
         /// </summary>
         public bool Contains(byte item)
         {
-            return Buffer.Contains(item);
+            return IndexOf(item) >= 0;
         }
 
         /// <summary>
@@ -253,7 +405,7 @@ namespace PcapDotNet.Packets
         /// </summary>
         public void CopyTo(byte[] array, int arrayIndex)
         {
-            Buffer.BlockCopy(0, array, arrayIndex, Length);
+            Buffer.BlockCopy(StartOffset, array, arrayIndex, Length);
         }
 
         /// <summary>
@@ -292,9 +444,10 @@ namespace PcapDotNet.Packets
         {
             get
             {
-                if (_isValid == null)
-                    _isValid = CalculateIsValid();
-                return _isValid.Value;
+                bool isValid;
+                if (!LazyCache.TryGet(ref _isValid, out isValid))
+                    isValid = LazyCache.Publish(ref _isValid, CalculateIsValid());
+                return isValid;
             }
         }
 
@@ -304,7 +457,7 @@ namespace PcapDotNet.Packets
         /// </summary>
         public EthernetDatagram Ethernet
         {
-            get { return _ethernet ?? (_ethernet = new EthernetDatagram(Buffer, 0, Length)); }
+            get { return _ethernet ?? LazyCache.Publish(ref _ethernet, new EthernetDatagram(Buffer, StartOffset, Length)); }
         }
 
         /// <summary>
@@ -313,7 +466,29 @@ namespace PcapDotNet.Packets
         /// </summary>
         public IpV4Datagram IpV4
         {
-            get { return _ipV4 ?? (_ipV4 = new IpV4Datagram(Buffer, 0, Length)); }
+            get { return _ipV4 ?? LazyCache.Publish(ref _ipV4, new IpV4Datagram(Buffer, StartOffset, Length)); }
+        }
+
+        /// <summary>
+        /// Releases the owner of the packet bytes if the packet was created with one.
+        /// The packet shouldn't be used after it is disposed, since the owner may reuse the bytes.
+        /// Disposing more than once releases the owner only once.
+        /// </summary>
+        public void Dispose()
+        {
+            IDisposable owner = Interlocked.Exchange(ref _owner, null);
+            if (owner != null)
+                owner.Dispose();
+        }
+
+        private static void CheckSegment(byte[] data, int offset, int length)
+        {
+            if (data == null)
+                throw new ArgumentNullException("data");
+            if (offset < 0 || offset > data.Length)
+                throw new ArgumentOutOfRangeException("offset", offset, "Must be between 0 and the data length " + data.Length);
+            if (length < 0 || length > data.Length - offset)
+                throw new ArgumentOutOfRangeException("length", length, "Must be non negative and fit in the data after the offset");
         }
 
         private bool CalculateIsValid()
@@ -331,10 +506,14 @@ namespace PcapDotNet.Packets
             }
         }
 
-        private readonly byte[] _data;
-        private readonly DateTime _timestamp;
+        private byte[] _data;
+        private int _offset;
+        private int _length;
+        private IDisposable _owner;
+        private DateTime _timestamp;
         private readonly IDataLink _dataLink;
-        private bool? _isValid;
+        private bool _isRebindable;
+        private byte _isValid;
 
         private EthernetDatagram _ethernet;
         private IpV4Datagram _ipV4;
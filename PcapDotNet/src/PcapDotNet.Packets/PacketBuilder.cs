@@ -145,8 +145,8 @@ namespace PcapDotNet.Packets
             int length = layersLength.Sum();
             byte[] buffer = new byte[length];
 
-            WriteLayers(layersLength, buffer, length);
-            FinalizeLayers(buffer, length);
+            WriteLayers(_layers, layersLength, buffer, 0, length);
+            FinalizeLayers(_layers, layersLength, buffer, 0, length);
 
             return new Packet(buffer, timestamp, _dataLink, originalLength);
         }
@@ -162,29 +162,41 @@ namespace PcapDotNet.Packets
             return Build(timestamp, 0);
         }
 
-        private void WriteLayers(int[] layersLength, byte[] buffer, int length)
+        /// <summary>
+        /// Computes the layers' lengths once and returns a builder that writes packets into given buffers without allocating.
+        /// The layers' properties can be modified after compiling as long as the layers' lengths don't change.
+        /// If a layer's length changes, Compile() should be called again.
+        /// </summary>
+        /// <returns>A builder with the layout of the current layers.</returns>
+        public CompiledPacketBuilder Compile()
+        {
+            return new CompiledPacketBuilder(_layers, _layers.Select(layer => layer.Length).ToArray(), _dataLink);
+        }
+
+        internal static void WriteLayers(ILayer[] layers, int[] layersLength, byte[] buffer, int offset, int length)
         {
-            int offset = 0;
-            for (int i = 0; i != _layers.Length; ++i)
+            int endOffset = offset + length;
+            for (int i = 0; i != layers.Length; ++i)
             {
-                ILayer layer = _layers[i];
+                ILayer layer = layers[i];
                 int layerLength = layersLength[i];
-                ILayer previousLayer = i == 0 ? null : _layers[i - 1];
-                ILayer nextLayer = i == _layers.Length - 1 ? null : _layers[i + 1];
-                layer.Write(buffer, offset, length - offset - layerLength, previousLayer, nextLayer);
+                ILayer previousLayer = i == 0 ? null : layers[i - 1];
+                ILayer nextLayer = i == layers.Length - 1 ? null : layers[i + 1];
+                layer.Write(buffer, offset, endOffset - offset - layerLength, previousLayer, nextLayer);
                 offset += layerLength;
             }
         }
 
-        private void FinalizeLayers(byte[] buffer, int length)
+        internal static void FinalizeLayers(ILayer[] layers, int[] layersLength, byte[] buffer, int offset, int length)
         {
-            int offset = length;
-            for (int i = _layers.Length - 1; i >= 0; --i)
+            int endOffset = offset + length;
+            int layerOffset = endOffset;
+            for (int i = layers.Length - 1; i >= 0; --i)
             {
-                ILayer layer = _layers[i];
-                ILayer nextLayer = i == _layers.Length - 1 ? null : _layers[i + 1];
-                offset -= layer.Length;
-                layer.Finalize(buffer, offset, length - offset - layer.Length, nextLayer);
+                ILayer layer = layers[i];
+                ILayer nextLayer = i == layers.Length - 1 ? null : layers[i + 1];
+                layerOffset -= layersLength[i];
+                layer.Finalize(buffer, layerOffset, endOffset - layerOffset - layersLength[i], nextLayer);
             }
         }
 
@@ -0,0 +1,68 @@
+﻿using PcapDotNet.Packets.Ethernet;
+using PcapDotNet.Packets.IpV4;
+
+namespace PcapDotNet.Packets
+{
+    /// <summary>
+    /// The result of a single pass over the headers of a packet made by PacketFlowParser.
+    /// All the offsets are relative to the start of the packet.
+    /// </summary>
+    public struct PacketFlowInfo
+    {
+        /// <summary>
+        /// The number of VLAN tags (802.1Q, 802.1ad or QinQ) the parser skipped.
+        /// </summary>
+        public int VLanTagCount { get; internal set; }
+
+        /// <summary>
+        /// The Ethernet type of the network layer.
+        /// EthernetType.None if the packet has no known network layer.
+        /// </summary>
+        public EthernetType NetworkType { get; internal set; }
+
+        /// <summary>
+        /// The offset of the IPv4 or IPv6 header or -1 if there is no such header.
+        /// </summary>
+        public int NetworkOffset { get; internal set; }
+
+        /// <summary>
+        /// The offset of the transport header or -1 if the transport header wasn't found.
+        /// For IPv6, this is the offset after all the skipped extension headers.
+        /// </summary>
+        public int TransportOffset { get; internal set; }
+
+        /// <summary>
+        /// The protocol of the transport layer.
+        /// For IPv6, this is the next header value of the last extension header.
+        /// </summary>
+        public IpV4Protocol TransportProtocol { get; internal set; }
+
+        /// <summary>
+        /// The length of all the headers that were parsed.
+        /// This is the offset of the transport payload when the transport header was parsed.
+        /// </summary>
+        public int HeadersLength { get; internal set; }
+
+        /// <summary>
+        /// True iff the IP datagram is a fragment that isn't the first fragment, so it doesn't contain the transport header.
+        /// </summary>
+        public bool IsFragment { get; internal set; }
+
+        /// <summary>
+        /// The protocol type of the GRE payload if the transport is GRE, otherwise EthernetType.None.
+        /// </summary>
+        public EthernetType GreProtocolType { get; internal set; }
+
+        /// <summary>
+        /// True iff the packet has an IP header and FlowKey is valid.
+        /// </summary>
+        public bool HasFlowKey { get; internal set; }
+
+        /// <summary>
+        /// The addresses, protocol and ports of the packet.
+        /// The ports are 0 if the transport has no ports.
+        /// The protocol and the ports are 0 if the packet is a non first fragment, so all the non first fragments between two addresses have the same key.
+        /// </summary>
+        public PacketFlowKey FlowKey { get; internal set; }
+    }
+}
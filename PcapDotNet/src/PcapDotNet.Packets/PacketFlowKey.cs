@@ -0,0 +1,166 @@
+﻿using System;
+using PcapDotNet.Base;
+using PcapDotNet.Packets.IpV4;
+using PcapDotNet.Packets.IpV6;
+
+namespace PcapDotNet.Packets
+{
+    /// <summary>
+    /// The addresses, protocol and ports that identify the flow of an IP packet in one direction.
+    /// IPv4 addresses are kept in the least significant 32 bits of the address values.
+    /// </summary>
+    public struct PacketFlowKey : IEquatable<PacketFlowKey>
+    {
+        /// <summary>
+        /// Creates a flow key.
+        /// </summary>
+        /// <param name="isIpV6">True iff the addresses are IPv6 addresses.</param>
+        /// <param name="source">The source address value.</param>
+        /// <param name="destination">The destination address value.</param>
+        /// <param name="protocol">The transport protocol.</param>
+        /// <param name="sourcePort">The source port, 0 if the transport has no ports or wasn't captured.</param>
+        /// <param name="destinationPort">The destination port, 0 if the transport has no ports or wasn't captured.</param>
+        public PacketFlowKey(bool isIpV6, UInt128 source, UInt128 destination, IpV4Protocol protocol, ushort sourcePort, ushort destinationPort)
+        {
+            _isIpV6 = isIpV6;
+            _source = source;
+            _destination = destination;
+            _protocol = protocol;
+            _sourcePort = sourcePort;
+            _destinationPort = destinationPort;
+        }
+
+        /// <summary>
+        /// True iff the addresses are IPv6 addresses.
+        /// </summary>
+        public bool IsIpV6
+        {
+            get { return _isIpV6; }
+        }
+
+        /// <summary>
+        /// The source address value.
+        /// </summary>
+        public UInt128 Source
+        {
+            get { return _source; }
+        }
+
+        /// <summary>
+        /// The destination address value.
+        /// </summary>
+        public UInt128 Destination
+        {
+            get { return _destination; }
+        }
+
+        /// <summary>
+        /// The transport protocol.
+        /// </summary>
+        public IpV4Protocol Protocol
+        {
+            get { return _protocol; }
+        }
+
+        /// <summary>
+        /// The source port, 0 if the transport has no ports or wasn't captured.
+        /// </summary>
+        public ushort SourcePort
+        {
+            get { return _sourcePort; }
+        }
+
+        /// <summary>
+        /// The destination port, 0 if the transport has no ports or wasn't captured.
+        /// </summary>
+        public ushort DestinationPort
+        {
+            get { return _destinationPort; }
+        }
+
+        /// <summary>
+        /// Returns the key of the other direction of the flow.
+        /// </summary>
+        public PacketFlowKey Reverse()
+        {
+            return new PacketFlowKey(IsIpV6, Destination, Source, Protocol, DestinationPort, SourcePort);
+        }
+
+        /// <summary>
+        /// Two keys are equal if all their fields are equal.
+        /// </summary>
+        public bool Equals(PacketFlowKey other)
+        {
+            return IsIpV6 == other.IsIpV6 && Source == other.Source && Destination == other.Destination && Protocol == other.Protocol &&
+                   SourcePort == other.SourcePort && DestinationPort == other.DestinationPort;
+        }
+
+        /// <summary>
+        /// Two keys are equal if all their fields are equal.
+        /// </summary>
+        public override bool Equals(object obj)
+        {
+            return (obj is PacketFlowKey &&
+                    Equals((PacketFlowKey)obj));
+        }
+
+        /// <summary>
+        /// Two keys are equal if all their fields are equal.
+        /// </summary>
+        public static bool operator ==(PacketFlowKey value1, PacketFlowKey value2)
+        {
+            return value1.Equals(value2);
+        }
+
+        /// <summary>
+        /// Two keys are different if any of their fields is different.
+        /// </summary>
+        public static bool operator !=(PacketFlowKey value1, PacketFlowKey value2)
+        {
+            return !(value1 == value2);
+        }
+
+        /// <summary>
+        /// A hash of all the fields that doesn't allocate, so it can be used for every packet.
+        /// </summary>
+        public override int GetHashCode()
+        {
+            ulong hash = Mix((ulong)Source ^ Mix((ulong)(Source >> 64)));
+            hash = Mix(hash ^ (ulong)Destination);
+            hash = Mix(hash ^ (ulong)(Destination >> 64));
+            hash = Mix(hash ^ ((ulong)SourcePort << 32 | (ulong)DestinationPort << 16 | (ulong)Protocol << 1 | (IsIpV6 ? 1UL : 0UL)));
+            return (int)hash ^ (int)(hash >> 32);
+        }
+
+        /// <summary>
+        /// The key in the format source:port -> destination:port (protocol).
+        /// </summary>
+        public override string ToString()
+        {
+            return FormatAddress(Source) + ":" + SourcePort + " -> " + FormatAddress(Destination) + ":" + DestinationPort + " (" + Protocol + ")";
+        }
+
+        private string FormatAddress(UInt128 address)
+        {
+            return IsIpV6 ? new IpV6Address(address).ToString() : new IpV4Address((uint)(ulong)address).ToString();
+        }
+
+        private static ulong Mix(ulong value)
+        {
+            // The SplitMix64 finalizer.
+            value ^= value >> 30;
+            value *= 0xBF58476D1CE4E5B9UL;
+            value ^= value >> 27;
+            value *= 0x94D049BB133111EBUL;
+            value ^= value >> 31;
+            return value;
+        }
+
+        private readonly bool _isIpV6;
+        private readonly UInt128 _source;
+        private readonly UInt128 _destination;
+        private readonly IpV4Protocol _protocol;
+        private readonly ushort _sourcePort;
+        private readonly ushort _destinationPort;
+    }
+}
@@ -0,0 +1,309 @@
+﻿using System;
+using PcapDotNet.Base;
+using PcapDotNet.Packets.Ethernet;
+using PcapDotNet.Packets.Gre;
+using PcapDotNet.Packets.Icmp;
+using PcapDotNet.Packets.IpV4;
+using PcapDotNet.Packets.IpV6;
+using PcapDotNet.Packets.Transport;
+
+namespace PcapDotNet.Packets
+{
+    /// <summary>
+    /// Walks the headers of a packet in a single pass and extracts the layer offsets, the protocols and the flow key without creating any datagram or other object.
+    /// Supports Ethernet with any number of VLAN tags, IPv4 datalinks, IPv4, IPv6 with its extension headers, TCP, UDP, UDP-Lite, SCTP, ICMP and GRE.
+    /// Meant for flow tables and load balancers that need to classify every packet; use the datagrams to read the rest of the fields.
+    /// <example>This sample shows how to count packets per flow.
+    /// <code>
+    ///   PacketFlowInfo info;
+    ///   if (PacketFlowParser.TryParse(packet, out info) &amp;&amp; info.HasFlowKey)
+    ///       ++flows[info.FlowKey];
+    /// </code>
+    /// </example>
+    /// </summary>
+    public static class PacketFlowParser
+    {
+        /// <summary>
+        /// The maximum number of IPv6 extension headers skipped before the transport header.
+        /// </summary>
+        public const int MaxIpV6ExtensionHeaders = 8;
+
+        /// <summary>
+        /// Parses the headers of the given packet according to its datalink.
+        /// </summary>
+        /// <param name="packet">The packet to parse.</param>
+        /// <param name="info">The offsets, protocols and flow key that were found.</param>
+        /// <returns>True iff the packet contains an IPv4 or IPv6 header, so the flow key is valid.</returns>
+        /// <exception cref="ArgumentNullException">The packet is null.</exception>
+        public static bool TryParse(Packet packet, out PacketFlowInfo info)
+        {
+            if (packet == null)
+                throw new ArgumentNullException("packet");
+
+            return TryParse(packet.Buffer, packet.StartOffset, packet.Length, packet.DataLink.Kind, out info);
+        }
+
+        /// <summary>
+        /// Parses the headers of the packet in the given segment of an array.
+        /// </summary>
+        /// <param name="buffer">The array that contains the packet.</param>
+        /// <param name="offset">The offset in the array where the packet starts.</param>
+        /// <param name="length">The number of bytes in the packet.</param>
+        /// <param name="dataLink">The datalink of the packet. Only Ethernet and IPv4 (raw IP) datalinks are supported.</param>
+        /// <param name="info">The offsets, protocols and flow key that were found. The offsets are relative to the given offset.</param>
+        /// <returns>True iff the packet contains an IPv4 or IPv6 header, so the flow key is valid.</returns>
+        /// <exception cref="ArgumentNullException">The buffer is null.</exception>
+        /// <exception cref="ArgumentOutOfRangeException">The offset or the length are negative or the segment exceeds the array.</exception>
+        public static bool TryParse(byte[] buffer, int offset, int length, DataLinkKind dataLink, out PacketFlowInfo info)
+        {
+            if (buffer == null)
+                throw new ArgumentNullException("buffer");
+            if (offset < 0 || offset > buffer.Length)
+                throw new ArgumentOutOfRangeException("offset", offset, "Must be between 0 and the buffer length " + buffer.Length);
+            if (length < 0 || length > buffer.Length - offset)
+                throw new ArgumentOutOfRangeException("length", length, "Must be non negative and fit in the buffer after the offset");
+
+            info = new PacketFlowInfo
+                   {
+                       NetworkType = EthernetType.None,
+                       NetworkOffset = -1,
+                       TransportOffset = -1,
+                       GreProtocolType = EthernetType.None,
+                   };
+            int end = offset + length;
+
+            switch (dataLink)
+            {
+                case DataLinkKind.Ethernet:
+                {
+                    if (length < EthernetDatagram.HeaderLengthValue)
+                        return false;
+
+                    int headerOffset = offset + EthernetDatagram.HeaderLengthValue;
+                    EthernetType etherType = (EthernetType)buffer.ReadUShort(headerOffset - sizeof(ushort), Endianity.Big);
+                    while (IsVLanTag(etherType) && end - headerOffset >= VLanTaggedFrameDatagram.HeaderLengthValue)
+                    {
+                        etherType = (EthernetType)buffer.ReadUShort(headerOffset + VLanTaggedFrameDatagram.HeaderLengthValue - sizeof(ushort), Endianity.Big);
+                        headerOffset += VLanTaggedFrameDatagram.HeaderLengthValue;
+                        ++info.VLanTagCount;
+                    }
+                    info.HeadersLength = headerOffset - offset;
+
+                    switch (etherType)
+                    {
+                        case EthernetType.IpV4:
+                            return ParseIpV4(buffer, offset, headerOffset, end, ref info);
+                        case EthernetType.IpV6:
+                            return ParseIpV6(buffer, offset, headerOffset, end, ref info);
+                        default:
+                            return false;
+                    }
+                }
+
+                case DataLinkKind.IpV4:
+                    if (length == 0)
+                        return false;
+
+                    switch (buffer[offset] >> 4)
+                    {
+                        case 4:
+                            return ParseIpV4(buffer, offset, offset, end, ref info);
+                        case 6:
+                            return ParseIpV6(buffer, offset, offset, end, ref info);
+                        default:
+                            return false;
+                    }
+
+                default:
+                    return false;
+            }
+        }
+
+        private static bool IsVLanTag(EthernetType etherType)
+        {
+            return etherType == EthernetType.VLanTaggedFrame || etherType == EthernetType.ProviderBridging || etherType == EthernetType.QInQ;
+        }
+
+        private static bool ParseIpV4(byte[] buffer, int packetOffset, int headerOffset, int end, ref PacketFlowInfo info)
+        {
+            if (end - headerOffset < IpV4Datagram.HeaderMinimumLength)
+                return false;
+
+            int headerLength = (buffer[headerOffset + IpV4Datagram.Offset.VersionAndHeaderLength] & 0x0F) * 4;
+            if (headerLength < IpV4Datagram.HeaderMinimumLength)
+                return false;
+
+            info.NetworkType = EthernetType.IpV4;
+            info.NetworkOffset = headerOffset - packetOffset;
+            info.TransportProtocol = (IpV4Protocol)buffer[headerOffset + IpV4Datagram.Offset.Protocol];
+
+            // Only the first fragment contains the transport header.
+            info.IsFragment = (buffer.ReadUShort(headerOffset + IpV4Datagram.Offset.Fragmentation, Endianity.Big) & 0x1FFF) != 0;
+
+            UInt128 source = buffer.ReadUInt(headerOffset + IpV4Datagram.Offset.Source, Endianity.Big);
+            UInt128 destination = buffer.ReadUInt(headerOffset + IpV4Datagram.Offset.Destination, Endianity.Big);
+            ParseTransport(buffer, packetOffset, headerOffset + headerLength, end, false, source, destination, ref info);
+            return true;
+        }
+
+        private static bool ParseIpV6(byte[] buffer, int packetOffset, int headerOffset, int end, ref PacketFlowInfo info)
+        {
+            if (end - headerOffset < IpV6Datagram.HeaderLength)
+                return false;
+
+            info.NetworkType = EthernetType.IpV6;
+            info.NetworkOffset = headerOffset - packetOffset;
+            UInt128 source = buffer.ReadUInt128(headerOffset + IpV6Datagram.Offset.SourceAddress, Endianity.Big);
+            UInt128 destination = buffer.ReadUInt128(headerOffset + IpV6Datagram.Offset.DestinationAddress, Endianity.Big);
+
+            IpV4Protocol nextHeader = (IpV4Protocol)buffer[headerOffset + IpV6Datagram.Offset.NextHeader];
+            int offset = headerOffset + IpV6Datagram.HeaderLength;
+            bool isTruncated = false;
+            for (int i = 0; i != MaxIpV6ExtensionHeaders && IsSkippedExtensionHeader(nextHeader); ++i)
+            {
+                if (end - offset < ExtensionHeaderMinimumLength)
+                {
+                    isTruncated = true;
+                    break;
+                }
+
+                IpV4Protocol currentHeader = nextHeader;
+                nextHeader = (IpV4Protocol)buffer[offset];
+                int extensionHeaderLength = buffer[offset + 1];
+                switch (currentHeader)
+                {
+                    case IpV4Protocol.FragmentHeaderForIpV6:
+                        // Only the first fragment contains the transport header.
+                        if ((buffer.ReadUShort(offset + 2, Endianity.Big) >> 3) != 0)
+                            info.IsFragment = true;
+                        offset += ExtensionHeaderMinimumLength;
+                        break;
+
+                    case IpV4Protocol.AuthenticationHeader:
+                        offset += (extensionHeaderLength + 2) * 4;
+                        break;
+
+                    default:
+                        offset += (extensionHeaderLength + 1) * 8;
+                        break;
+                }
+
+                if (info.IsFragment)
+                    break;
+            }
+
+            info.TransportProtocol = nextHeader;
+            ParseTransport(buffer, packetOffset, isTruncated ? end : offset, end, true, source, destination, ref info);
+            return true;
+        }
+
+        private static bool IsSkippedExtensionHeader(IpV4Protocol nextHeader)
+        {
+            switch (nextHeader)
+            {
+                case IpV4Protocol.IpV6HopByHopOption:
+                case IpV4Protocol.IpV6Route:
+                case IpV4Protocol.IpV6Opts:
+                case IpV4Protocol.FragmentHeaderForIpV6:
+                case IpV4Protocol.AuthenticationHeader:
+                    return true;
+
+                default:
+                    return false;
+            }
+        }
+
+        private static void ParseTransport(byte[] buffer, int packetOffset, int offset, int end, bool isIpV6, UInt128 source, UInt128 destination,
+                                           ref PacketFlowInfo info)
+        {
+            ushort sourcePort = 0;
+            ushort destinationPort = 0;
+            int headerLength = 0;
+            if (!info.IsFragment && offset < end)
+            {
+                info.TransportOffset = offset - packetOffset;
+                switch (info.TransportProtocol)
+                {
+                    case IpV4Protocol.Tcp:
+                        headerLength = TcpDatagram.HeaderMinimumLength;
+                        if (end - offset > TcpDatagram.Offset.HeaderLengthAndFlags)
+                            headerLength = Math.Max(headerLength, (buffer[offset + TcpDatagram.Offset.HeaderLengthAndFlags] >> 4) * 4);
+                        break;
+
+                    case IpV4Protocol.Udp:
+                    case IpV4Protocol.UdpLite:
+                        headerLength = UdpDatagram.HeaderLength;
+                        break;
+
+                    case IpV4Protocol.StreamControlTransmissionProtocol:
+                        headerLength = SctpCommonHeaderLength;
+                        break;
+
+                    case IpV4Protocol.InternetControlMessageProtocol:
+                    case IpV4Protocol.InternetControlMessageProtocolForIpV6:
+                        headerLength = IcmpDatagram.HeaderLength;
+                        break;
+
+                    case IpV4Protocol.Gre:
+                        headerLength = GetGreHeaderLength(buffer, offset, end, ref info);
+                        break;
+                }
+
+                if (HasPorts(info.TransportProtocol) && end - offset >= 2 * sizeof(ushort))
+                {
+                    sourcePort = buffer.ReadUShort(offset, Endianity.Big);
+                    destinationPort = buffer.ReadUShort(offset + sizeof(ushort), Endianity.Big);
+                }
+            }
+
+            info.HeadersLength = Math.Min(offset + headerLength, end) - packetOffset;
+
+            // Non first fragments can't be matched to the ports of their first fragment, so their key has neither ports nor a protocol.
+            IpV4Protocol flowProtocol = info.IsFragment ? 0 : info.TransportProtocol;
+            info.FlowKey = new PacketFlowKey(isIpV6, source, destination, flowProtocol, sourcePort, destinationPort);
+            info.HasFlowKey = true;
+        }
+
+        private static bool HasPorts(IpV4Protocol protocol)
+        {
+            return protocol == IpV4Protocol.Tcp || protocol == IpV4Protocol.Udp || protocol == IpV4Protocol.UdpLite ||
+                   protocol == IpV4Protocol.StreamControlTransmissionProtocol;
+        }
+
+        private static int GetGreHeaderLength(byte[] buffer, int offset, int end, ref PacketFlowInfo info)
+        {
+            if (end - offset < GreDatagram.HeaderMinimumLength)
+                return GreDatagram.HeaderMinimumLength;
+
+            byte flags = buffer[offset];
+            info.GreProtocolType = (EthernetType)buffer.ReadUShort(offset + sizeof(ushort), Endianity.Big);
+            bool isRoutingPresent = (flags & GreRoutingPresentMask) != 0;
+            int headerLength = GreDatagram.HeaderMinimumLength +
+                               ((flags & GreChecksumPresentMask) != 0 || isRoutingPresent ? sizeof(uint) : 0) +
+                               ((flags & GreKeyPresentMask) != 0 ? sizeof(uint) : 0) +
+                               ((flags & GreSequenceNumberPresentMask) != 0 ? sizeof(uint) : 0) +
+                               ((buffer[offset + 1] & GreAcknowledgmentSequenceNumberPresentMask) != 0 ? sizeof(uint) : 0);
+            if (!isRoutingPresent)
+                return headerLength;
+
+            // The source route entries end with an entry with a zero length.
+            while (end - offset >= headerLength + GreSourceRouteEntry.HeaderLength)
+            {
+                byte entryLength = buffer[offset + headerLength + 3];
+                headerLength += GreSourceRouteEntry.HeaderLength + entryLength;
+                if (entryLength == 0)
+                    break;
+            }
+            return headerLength;
+        }
+
+        private const int ExtensionHeaderMinimumLength = 8;
+        private const int SctpCommonHeaderLength = 12;
+
+        private const byte GreChecksumPresentMask = 0x80;
+        private const byte GreRoutingPresentMask = 0x40;
+        private const byte GreKeyPresentMask = 0x20;
+        private const byte GreSequenceNumberPresentMask = 0x10;
+        private const byte GreAcknowledgmentSequenceNumberPresentMask = 0x80;
+    }
+}
@@ -0,0 +1,286 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Collections.ObjectModel;
+using PcapDotNet.Packets.Dns;
+using PcapDotNet.Packets.Ethernet;
+using PcapDotNet.Packets.Ip;
+using PcapDotNet.Packets.IpV4;
+using PcapDotNet.Packets.Transport;
+
+namespace PcapDotNet.Packets
+{
+    /// <summary>
+    /// Generates many packets that differ only in a few fields from a single packet built once.
+    /// The fields that change are declared using DeclareField().
+    /// Setting a field value patches the template bytes and adjusts the checksums incrementally, so generating a packet costs a copy of its bytes and not building its layers.
+    /// <example>This sample shows how to generate TCP SYN packets to different ports.
+    /// <code>
+    ///   PacketTemplate template = new PacketTemplate(new EthernetLayer(), new IpV4Layer {Source = new IpV4Address("1.2.3.4")}, new TcpLayer {ControlBits = TcpControlBits.Synchronize});
+    ///   PacketTemplateField port = template.DeclareField(PacketTemplateFieldKind.TransportDestinationPort);
+    ///
+    ///   byte[] buffer = new byte[template.Length];
+    ///   for (uint i = 1; i != 1024; ++i)
+    ///   {
+    ///       port.Value = i;
+    ///       template.Write(buffer, 0);
+    ///       // Send the buffer.
+    ///   }
+    /// </code>
+    /// </example>
+    /// </summary>
+    /// <remarks>
+    /// This class is not thread safe.
+    /// </remarks>
+    public sealed class PacketTemplate
+    {
+        /// <summary>
+        /// Creates a template from a packet.
+        /// The packet bytes are copied, so the packet isn't changed by the template.
+        /// </summary>
+        /// <param name="packet">The packet to generate the packets from.</param>
+        /// <exception cref="ArgumentNullException">The packet is null.</exception>
+        public PacketTemplate(Packet packet)
+        {
+            if (packet == null)
+                throw new ArgumentNullException("packet");
+
+            Packet = packet;
+
+            // The fields are located in a copy that starts at offset 0 like the generated packets and stays valid if the packet is disposed.
+            byte[] templateBuffer = new byte[packet.Length];
+            packet.CopyTo(templateBuffer, 0);
+            _templatePacket = new Packet(templateBuffer, packet.Timestamp, packet.DataLink, packet.OriginalLength);
+            _buffer = new byte[packet.Length];
+            Reset();
+            _readOnlyFields = _fields.AsReadOnly();
+        }
+
+        /// <summary>
+        /// Creates a template by building the given layers once.
+        /// </summary>
+        /// <param name="layers">The layers to build the packet accordingly and by their order.</param>
+        public PacketTemplate(params ILayer[] layers)
+            : this(PacketBuilder.Build(DateTime.MinValue, layers))
+        {
+        }
+
+        /// <summary>
+        /// The packet the template was created from.
+        /// </summary>
+        public Packet Packet { get; private set; }
+
+        /// <summary>
+        /// The length of the generated packets in bytes.
+        /// </summary>
+        public int Length
+        {
+            get { return _buffer.Length; }
+        }
+
+        /// <summary>
+        /// The fields declared so far.
+        /// </summary>
+        public ReadOnlyCollection<PacketTemplateField> Fields
+        {
+            get { return _readOnlyFields; }
+        }
+
+        /// <summary>
+        /// Declares a field that can be changed between the generated packets.
+        /// Declaring the same kind twice returns the same field.
+        /// </summary>
+        /// <param name="kind">The kind of the field.</param>
+        /// <returns>The field to set the values with.</returns>
+        /// <exception cref="ArgumentException">The template packet doesn't contain the field.</exception>
+        public PacketTemplateField DeclareField(PacketTemplateFieldKind kind)
+        {
+            foreach (PacketTemplateField declaredField in _fields)
+            {
+                if (declaredField.Kind == kind)
+                    return declaredField;
+            }
+
+            PacketTemplateField field = CreateField(_templatePacket, _buffer, kind);
+            _fields.Add(field);
+            return field;
+        }
+
+        /// <summary>
+        /// Writes the current packet, with the current values of the declared fields, to the given buffer.
+        /// </summary>
+        /// <param name="buffer">The buffer to write the packet to.</param>
+        /// <param name="offset">The offset in the buffer to start writing the packet at.</param>
+        /// <exception cref="ArgumentNullException">The buffer is null.</exception>
+        /// <exception cref="ArgumentOutOfRangeException">The offset is negative or the packet doesn't fit in the buffer after the offset.</exception>
+        public void Write(byte[] buffer, int offset)
+        {
+            if (buffer == null)
+                throw new ArgumentNullException("buffer");
+            if (offset < 0 || offset > buffer.Length - Length)
+                throw new ArgumentOutOfRangeException("offset", offset, "The packet of " + Length + " bytes must fit in the buffer of " + buffer.Length + " bytes");
+
+            Buffer.BlockCopy(_buffer, 0, buffer, offset, Length);
+        }
+
+        /// <summary>
+        /// Creates a new packet with the current values of the declared fields.
+        /// </summary>
+        /// <param name="timestamp">The packet's timestamp.</param>
+        /// <returns>A new packet that doesn't change when the template changes.</returns>
+        public Packet CreatePacket(DateTime timestamp)
+        {
+            byte[] buffer = new byte[Length];
+            Write(buffer, 0);
+            return new Packet(buffer, timestamp, Packet.DataLink, Packet.OriginalLength);
+        }
+
+        /// <summary>
+        /// Restores the values of all the fields to the values in the template packet.
+        /// </summary>
+        public void Reset()
+        {
+            Buffer.BlockCopy(_templatePacket.Buffer, 0, _buffer, 0, _buffer.Length);
+        }
+
+        // Finds the field in the given packet and creates it over the given buffer that has the same layout.
+        internal static PacketTemplateField CreateField(Packet packet, byte[] buffer, PacketTemplateFieldKind kind)
+        {
+            switch (kind)
+            {
+                case PacketTemplateFieldKind.IpV4Source:
+                    return CreateIpV4AddressField(packet, buffer, kind, IpV4Datagram.Offset.Source);
+
+                case PacketTemplateFieldKind.IpV4Destination:
+                    return CreateIpV4AddressField(packet, buffer, kind, IpV4Datagram.Offset.Destination);
+
+                case PacketTemplateFieldKind.IpV4Identification:
+                {
+                    IpV4Datagram ipV4 = GetIpV4(packet, kind);
+                    return new PacketTemplateField(buffer, kind, ipV4.StartOffset + IpV4Datagram.Offset.Identification, sizeof(ushort),
+                                                   new[] {GetHeaderChecksum(ipV4)});
+                }
+
+                case PacketTemplateFieldKind.TransportSourcePort:
+                    return CreateTransportField(buffer, kind, GetTransport(packet, kind), TransportOffset.SourcePort, sizeof(ushort));
+
+                case PacketTemplateFieldKind.TransportDestinationPort:
+                    return CreateTransportField(buffer, kind, GetTransport(packet, kind), TransportOffset.DestinationPort, sizeof(ushort));
+
+                case PacketTemplateFieldKind.TcpSequenceNumber:
+                    return CreateTransportField(buffer, kind, GetTcp(packet, kind), TcpDatagram.Offset.SequenceNumber, sizeof(uint));
+
+                case PacketTemplateFieldKind.TcpAcknowledgmentNumber:
+                    return CreateTransportField(buffer, kind, GetTcp(packet, kind), TcpDatagram.Offset.AcknowledgmentNumber, sizeof(uint));
+
+                case PacketTemplateFieldKind.DnsId:
+                {
+                    UdpDatagram udp = GetTransport(packet, kind) as UdpDatagram;
+                    if (udp == null || udp.Payload.Length < DnsDatagram.HeaderLength)
+                        throw NotFound(kind);
+                    return new PacketTemplateField(buffer, kind, udp.Payload.StartOffset + DnsDatagram.Offset.Id, sizeof(ushort),
+                                                   new[] {GetTransportChecksum(udp)});
+                }
+
+                default:
+                    throw new ArgumentOutOfRangeException("kind", kind, "Invalid field kind");
+            }
+        }
+
+        // The addresses are part of the TCP and UDP pseudo header.
+        // The destination is part of the pseudo header only if there's no source routing option that changes the final destination.
+        private static PacketTemplateField CreateIpV4AddressField(Packet packet, byte[] buffer, PacketTemplateFieldKind kind, int offsetInHeader)
+        {
+            IpV4Datagram ipV4 = GetIpV4(packet, kind);
+            List<PacketTemplateField.ChecksumLocation> checksums = new List<PacketTemplateField.ChecksumLocation> {GetHeaderChecksum(ipV4)};
+            TransportDatagram transport = GetTransport(ipV4);
+            if (transport != null && (kind == PacketTemplateFieldKind.IpV4Source || ipV4.Destination == ipV4.CurrentDestination))
+                checksums.Add(GetTransportChecksum(transport));
+
+            return new PacketTemplateField(buffer, kind, ipV4.StartOffset + offsetInHeader, IpV4Address.SizeOf, checksums);
+        }
+
+        private static PacketTemplateField CreateTransportField(byte[] buffer, PacketTemplateFieldKind kind, TransportDatagram transport, int offsetInHeader, int length)
+        {
+            return new PacketTemplateField(buffer, kind, transport.StartOffset + offsetInHeader, length, new[] {GetTransportChecksum(transport)});
+        }
+
+        private static PacketTemplateField.ChecksumLocation GetHeaderChecksum(IpV4Datagram ipV4)
+        {
+            return new PacketTemplateField.ChecksumLocation(ipV4.StartOffset + IpV4Datagram.Offset.HeaderChecksum, false);
+        }
+
+        private static PacketTemplateField.ChecksumLocation GetTransportChecksum(TransportDatagram transport)
+        {
+            return new PacketTemplateField.ChecksumLocation(transport.StartOffset + transport.ChecksumOffset, transport.IsChecksumOptional);
+        }
+
+        internal static IpDatagram GetIp(Packet packet)
+        {
+            if (packet.DataLink.Kind == DataLinkKind.IpV4)
+                return packet.IpV4;
+            if (packet.DataLink.Kind != DataLinkKind.Ethernet)
+                return null;
+
+            EthernetBaseDatagram ethernet = packet.Ethernet;
+            while (ethernet.EtherType == EthernetType.VLanTaggedFrame)
+                ethernet = ethernet.VLanTaggedFrame;
+            return ethernet.Ip;
+        }
+
+        private static IpV4Datagram GetIpV4(Packet packet, PacketTemplateFieldKind kind)
+        {
+            IpV4Datagram ipV4 = GetIp(packet) as IpV4Datagram;
+            if (ipV4 == null || ipV4.Length < IpV4Datagram.HeaderMinimumLength)
+                throw NotFound(kind);
+            return ipV4;
+        }
+
+        private static TransportDatagram GetTransport(Packet packet, PacketTemplateFieldKind kind)
+        {
+            TransportDatagram transport = GetTransport(GetIp(packet));
+            if (transport == null)
+                throw NotFound(kind);
+            return transport;
+        }
+
+        private static TcpDatagram GetTcp(Packet packet, PacketTemplateFieldKind kind)
+        {
+            TcpDatagram tcp = GetTransport(packet, kind) as TcpDatagram;
+            if (tcp == null)
+                throw NotFound(kind);
+            return tcp;
+        }
+
+        // Only the first fragment contains the transport header.
+        private static TransportDatagram GetTransport(IpDatagram ip)
+        {
+            if (ip == null)
+                return null;
+
+            IpV4Datagram ipV4 = ip as IpV4Datagram;
+            if (ipV4 != null && ipV4.Fragmentation.Offset != 0)
+                return null;
+
+            TransportDatagram transport = ip.Transport;
+            if (transport == null || transport.Length < transport.ChecksumOffset + sizeof(ushort))
+                return null;
+            return transport;
+        }
+
+        private static ArgumentException NotFound(PacketTemplateFieldKind kind)
+        {
+            return new ArgumentException("The template packet doesn't contain the field " + kind, "kind");
+        }
+
+        private static class TransportOffset
+        {
+            public const int SourcePort = 0;
+            public const int DestinationPort = 2;
+        }
+
+        private readonly Packet _templatePacket;
+        private readonly byte[] _buffer;
+        private readonly List<PacketTemplateField> _fields = new List<PacketTemplateField>();
+        private readonly ReadOnlyCollection<PacketTemplateField> _readOnlyFields;
+    }
+}
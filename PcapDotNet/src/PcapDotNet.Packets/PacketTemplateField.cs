@@ -0,0 +1,115 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Globalization;
+
+namespace PcapDotNet.Packets
+{
+    /// <summary>
+    /// A field of a PacketTemplate that can be changed between the packets generated from it.
+    /// Setting the value patches the bytes of the template and adjusts the checksums that cover the field incrementally, without summing the packet again.
+    /// </summary>
+    public sealed class PacketTemplateField
+    {
+        /// <summary>
+        /// The kind of the field.
+        /// </summary>
+        public PacketTemplateFieldKind Kind { get; private set; }
+
+        /// <summary>
+        /// The offset of the field in the packet in bytes.
+        /// </summary>
+        public int Offset { get; private set; }
+
+        /// <summary>
+        /// The length of the field in bytes. Either 2 or 4.
+        /// </summary>
+        public int Length { get; private set; }
+
+        /// <summary>
+        /// The current value of the field in the template.
+        /// IPv4 addresses are given by their 32 bits value.
+        /// </summary>
+        /// <exception cref="ArgumentOutOfRangeException">The value doesn't fit in a 16 bits field.</exception>
+        public uint Value
+        {
+            get
+            {
+                return Length == sizeof(ushort)
+                           ? _buffer.ReadUShort(Offset, Endianity.Big)
+                           : _buffer.ReadUInt(Offset, Endianity.Big);
+            }
+            set
+            {
+                if (Length == sizeof(ushort) && value > ushort.MaxValue)
+                    throw new ArgumentOutOfRangeException("value", value, "Must fit in " + Length + " bytes");
+
+                uint oldValue = Value;
+                if (value == oldValue)
+                    return;
+
+                if (Length == sizeof(ushort))
+                    _buffer.Write(Offset, (ushort)value, Endianity.Big);
+                else
+                    _buffer.Write(Offset, value, Endianity.Big);
+
+                foreach (ChecksumLocation checksum in _checksums)
+                    AdjustChecksum(checksum, oldValue, value);
+            }
+        }
+
+        /// <summary>
+        /// The kind, the position and the value of the field.
+        /// </summary>
+        public override string ToString()
+        {
+            return string.Format(CultureInfo.InvariantCulture, "{0} [{1}, {2}) = {3}", Kind, Offset, Offset + Length, Value);
+        }
+
+        internal struct ChecksumLocation
+        {
+            public ChecksumLocation(int offset, bool isOptional)
+                : this()
+            {
+                Offset = offset;
+                IsOptional = isOptional;
+            }
+
+            public int Offset { get; private set; }
+
+            /// <summary>
+            /// A zero optional checksum (UDP) means there's no checksum.
+            /// </summary>
+            public bool IsOptional { get; private set; }
+        }
+
+        internal PacketTemplateField(byte[] buffer, PacketTemplateFieldKind kind, int offset, int length, IEnumerable<ChecksumLocation> checksums)
+        {
+            _buffer = buffer;
+            Kind = kind;
+            Offset = offset;
+            Length = length;
+            _checksums = new List<ChecksumLocation>(checksums).ToArray();
+        }
+
+        private void AdjustChecksum(ChecksumLocation location, uint oldValue, uint newValue)
+        {
+            ushort checksum = _buffer.ReadUShort(location.Offset, Endianity.Big);
+            if (Length == sizeof(ushort))
+            {
+                checksum = location.IsOptional
+                               ? IncrementalChecksum.UpdateOptional(checksum, (ushort)oldValue, (ushort)newValue)
+                               : IncrementalChecksum.Update(checksum, (ushort)oldValue, (ushort)newValue);
+            }
+            else
+            {
+                checksum = location.IsOptional
+                               ? IncrementalChecksum.UpdateOptional(checksum, oldValue, newValue)
+                               : IncrementalChecksum.Update(checksum, oldValue, newValue);
+            }
+            _buffer.Write(location.Offset, checksum, Endianity.Big);
+        }
+
+        private readonly byte[] _buffer;
+        private readonly ChecksumLocation[] _checksums;
+    }
+}
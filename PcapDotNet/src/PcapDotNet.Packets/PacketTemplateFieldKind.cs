@@ -0,0 +1,48 @@
+﻿namespace PcapDotNet.Packets
+{
+    /// <summary>
+    /// The fields of a PacketTemplate that can be changed between the packets generated from it.
+    /// </summary>
+    public enum PacketTemplateFieldKind
+    {
+        /// <summary>
+        /// The IPv4 source address. Changing it adjusts the IPv4 header checksum and the TCP or UDP checksum.
+        /// </summary>
+        IpV4Source,
+
+        /// <summary>
+        /// The IPv4 destination address. Changing it adjusts the IPv4 header checksum and the TCP or UDP checksum.
+        /// </summary>
+        IpV4Destination,
+
+        /// <summary>
+        /// The IPv4 identification. Changing it adjusts the IPv4 header checksum.
+        /// </summary>
+        IpV4Identification,
+
+        /// <summary>
+        /// The TCP or UDP source port. Changing it adjusts the TCP or UDP checksum.
+        /// </summary>
+        TransportSourcePort,
+
+        /// <summary>
+        /// The TCP or UDP destination port. Changing it adjusts the TCP or UDP checksum.
+        /// </summary>
+        TransportDestinationPort,
+
+        /// <summary>
+        /// The TCP sequence number. Changing it adjusts the TCP checksum.
+        /// </summary>
+        TcpSequenceNumber,
+
+        /// <summary>
+        /// The TCP acknowledgment number. Changing it adjusts the TCP checksum.
+        /// </summary>
+        TcpAcknowledgmentNumber,
+
+        /// <summary>
+        /// The id of a DNS message over UDP. Changing it adjusts the UDP checksum.
+        /// </summary>
+        DnsId,
+    }
+}
@@ -187,7 +187,7 @@ namespace PcapDotNet.Packets.Transport
             get
             {
                 if (_options == null && Length >= HeaderMinimumLength && HeaderLength >= HeaderMinimumLength)
-                    _options = new TcpOptions(Buffer, StartOffset + Offset.Options, RealHeaderLength - HeaderMinimumLength);
+                    LazyCache.Publish(ref _options, new TcpOptions(Buffer, StartOffset + Offset.Options, RealHeaderLength - HeaderMinimumLength));
                 return _options;
             }
         }
@@ -321,7 +321,7 @@ namespace PcapDotNet.Packets.Transport
                         httpList.Add(httpDatagram);
                     } while (Length > HeaderLength + httpParsed);
 
-                    _httpCollection = httpList.AsReadOnly();
+                    LazyCache.Publish(ref _httpCollection, httpList.AsReadOnly());
                 }
                 return _httpCollection;
             }
@@ -359,6 +359,13 @@ namespace PcapDotNet.Packets.Transport
             get { return Offset.Checksum; }
         }
 
+        internal override void ResetCache()
+        {
+            _options = null;
+            _httpCollection = null;
+            base.ResetCache();
+        }
+
         internal static void WriteHeader(byte[] buffer, int offset,
                                          ushort sourcePort, ushort destinationPort,
                                          uint sequenceNumber, uint acknowledgmentNumber,
@@ -0,0 +1,153 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Collections.ObjectModel;
+using PcapDotNet.Packets.Ip;
+using PcapDotNet.Packets.IpV4;
+using PcapDotNet.Packets.IpV6;
+
+namespace PcapDotNet.Packets.Transport
+{
+    /// <summary>
+    /// Splits a large TCP payload into segments the way TCP segmentation offload does.
+    /// The headers are built once from the given layers.
+    /// For each segment only the lengths, the IPv4 identification, the TCP sequence number and the TCP flags are written
+    /// and the checksums are updated incrementally, so only the segment payload is summed.
+    /// Supports IPv4 and IPv6 over Ethernet, with or without VLAN tags, and IPv4 datalinks.
+    /// <example>This sample shows how to segment 1MB of data to 1460 bytes segments.
+    /// <code>
+    ///   TcpSegmenter segmenter = new TcpSegmenter(new EthernetLayer(), new IpV4Layer(), new TcpLayer {ControlBits = TcpControlBits.Acknowledgment | TcpControlBits.Push});
+    ///   ReadOnlyCollection&lt;Packet&gt; segments = segmenter.Segment(DateTime.Now, new byte[1024 * 1024], 1460);
+    /// </code>
+    /// </example>
+    /// </summary>
+    /// <remarks>
+    ///   <list type="bullet">
+    ///     <item>The first segment has the sequence number and the IPv4 identification of the given layers. Each segment continues the sequence number by the payload length before it and increments the IPv4 identification.</item>
+    ///     <item>Push and Fin are only set on the last segment, if they are set in the given TCP layer.</item>
+    ///     <item>Changing the layers after creating the segmenter doesn't change the segments.</item>
+    ///   </list>
+    /// </remarks>
+    public sealed class TcpSegmenter
+    {
+        /// <summary>
+        /// Creates a segmenter that builds the headers from the given layers.
+        /// </summary>
+        /// <param name="layers">The layers of the header, ending with an IPv4 or IPv6 layer and a TCP layer.</param>
+        /// <exception cref="ArgumentNullException">The layers are null.</exception>
+        /// <exception cref="ArgumentException">The layers don't end with an IP layer and a TCP layer.</exception>
+        public TcpSegmenter(params ILayer[] layers)
+        {
+            if (layers == null)
+                throw new ArgumentNullException("layers");
+            if (layers.Length == 0 || !(layers[layers.Length - 1] is TcpLayer))
+                throw new ArgumentException("The last layer must be a TCP layer", "layers");
+
+            _header = PacketBuilder.Build(DateTime.MinValue, layers);
+
+            IpDatagram ip = PacketTemplate.GetIp(_header);
+            TcpDatagram tcp = ip == null ? null : ip.Transport as TcpDatagram;
+            if (tcp == null || tcp.StartOffset + tcp.HeaderLength != _header.Length)
+                throw new ArgumentException("The layers must end with an IPv4 or an IPv6 layer and a TCP layer", "layers");
+
+            _ipOffset = ip.StartOffset;
+            _isIpV4 = ip is IpV4Datagram;
+            _tcpOffset = tcp.StartOffset;
+            _tcpHeaderLength = tcp.HeaderLength;
+            _ipLength = _header.Buffer.ReadUShort(_ipOffset + (_isIpV4 ? IpV4Datagram.Offset.TotalLength : IpV6Datagram.Offset.PayloadLength), Endianity.Big);
+        }
+
+        /// <summary>
+        /// The length of the headers of every segment in bytes.
+        /// </summary>
+        public int HeaderLength
+        {
+            get { return _header.Length; }
+        }
+
+        /// <summary>
+        /// Splits the payload to segments of at most the given maximum segment size.
+        /// An empty payload results in a single segment with no payload.
+        /// </summary>
+        /// <param name="timestamp">The timestamp of the segments.</param>
+        /// <param name="payload">The TCP payload to split.</param>
+        /// <param name="maximumSegmentSize">The maximum TCP payload length of a segment.</param>
+        /// <returns>The segments by their order.</returns>
+        /// <exception cref="ArgumentNullException">The payload is null.</exception>
+        /// <exception cref="ArgumentOutOfRangeException">The maximum segment size is not positive or the IP length of a segment would exceed 65535 bytes.</exception>
+        public ReadOnlyCollection<Packet> Segment(DateTime timestamp, byte[] payload, int maximumSegmentSize)
+        {
+            if (payload == null)
+                throw new ArgumentNullException("payload");
+            if (maximumSegmentSize <= 0)
+                throw new ArgumentOutOfRangeException("maximumSegmentSize", maximumSegmentSize, "Must be positive");
+            if (_ipLength + Math.Min(maximumSegmentSize, payload.Length) > ushort.MaxValue)
+                throw new ArgumentOutOfRangeException("maximumSegmentSize", maximumSegmentSize, "The IP length of a segment can't exceed " + ushort.MaxValue);
+
+            int numSegments = Math.Max(1, (payload.Length + maximumSegmentSize - 1) / maximumSegmentSize);
+            List<Packet> segments = new List<Packet>(numSegments);
+            for (int i = 0; i != numSegments; ++i)
+            {
+                int payloadOffset = i * maximumSegmentSize;
+                int payloadLength = Math.Min(maximumSegmentSize, payload.Length - payloadOffset);
+                byte[] buffer = new byte[HeaderLength + payloadLength];
+                WriteSegment(buffer, payload, payloadOffset, payloadLength, i, i == numSegments - 1);
+                segments.Add(new Packet(buffer, timestamp, _header.DataLink));
+            }
+
+            return segments.AsReadOnly();
+        }
+
+        private void WriteSegment(byte[] buffer, byte[] payload, int payloadOffset, int payloadLength, int segmentIndex, bool isLast)
+        {
+            byte[] header = _header.Buffer;
+            Buffer.BlockCopy(header, 0, buffer, 0, HeaderLength);
+            Buffer.BlockCopy(payload, payloadOffset, buffer, HeaderLength, payloadLength);
+
+            ushort ipLength = (ushort)(_ipLength + payloadLength);
+            if (_isIpV4)
+            {
+                int identificationOffset = _ipOffset + IpV4Datagram.Offset.Identification;
+                int headerChecksumOffset = _ipOffset + IpV4Datagram.Offset.HeaderChecksum;
+                ushort identification = header.ReadUShort(identificationOffset, Endianity.Big);
+                ushort segmentIdentification = (ushort)(identification + segmentIndex);
+                ushort headerChecksum = header.ReadUShort(headerChecksumOffset, Endianity.Big);
+                headerChecksum = IncrementalChecksum.Update(headerChecksum, _ipLength, ipLength);
+                headerChecksum = IncrementalChecksum.Update(headerChecksum, identification, segmentIdentification);
+
+                buffer.Write(_ipOffset + IpV4Datagram.Offset.TotalLength, ipLength, Endianity.Big);
+                buffer.Write(identificationOffset, segmentIdentification, Endianity.Big);
+                buffer.Write(headerChecksumOffset, headerChecksum, Endianity.Big);
+            }
+            else
+            {
+                buffer.Write(_ipOffset + IpV6Datagram.Offset.PayloadLength, ipLength, Endianity.Big);
+            }
+
+            int sequenceNumberOffset = _tcpOffset + TcpDatagram.Offset.SequenceNumber;
+            int flagsOffset = _tcpOffset + TcpDatagram.Offset.HeaderLengthAndFlags;
+            int checksumOffset = _tcpOffset + TcpDatagram.Offset.Checksum;
+            uint sequenceNumber = header.ReadUInt(sequenceNumberOffset, Endianity.Big);
+            uint segmentSequenceNumber = sequenceNumber + (uint)payloadOffset;
+            ushort flags = header.ReadUShort(flagsOffset, Endianity.Big);
+            ushort segmentFlags = isLast ? flags : (ushort)(flags & ~(ushort)(TcpControlBits.Push | TcpControlBits.Fin));
+
+            // The TCP length is part of the pseudo header.
+            ushort checksum = header.ReadUShort(checksumOffset, Endianity.Big);
+            checksum = IncrementalChecksum.Update(checksum, (ushort)_tcpHeaderLength, (ushort)(_tcpHeaderLength + payloadLength));
+            checksum = IncrementalChecksum.Update(checksum, sequenceNumber, segmentSequenceNumber);
+            checksum = IncrementalChecksum.Update(checksum, flags, segmentFlags);
+            checksum = DataSegment.Sum16BitsToChecksum((ushort)~checksum + DataSegment.Sum16Bits(payload, payloadOffset, payloadLength));
+
+            buffer.Write(sequenceNumberOffset, segmentSequenceNumber, Endianity.Big);
+            buffer.Write(flagsOffset, segmentFlags, Endianity.Big);
+            buffer.Write(checksumOffset, checksum, Endianity.Big);
+        }
+
+        private readonly Packet _header;
+        private readonly int _ipOffset;
+        private readonly bool _isIpV4;
+        private readonly int _tcpOffset;
+        private readonly int _tcpHeaderLength;
+        private readonly ushort _ipLength;
+    }
+}
@@ -103,7 +103,7 @@ namespace PcapDotNet.Packets.Transport
             get
             {
                 if (_dns == null && Length >= HeaderLength)
-                    _dns = new DnsDatagram(Buffer, StartOffset + HeaderLength, Length - HeaderLength);
+                    LazyCache.Publish(ref _dns, new DnsDatagram(Buffer, StartOffset + HeaderLength, Length - HeaderLength));
 
                 return _dns;
             }
@@ -133,6 +133,12 @@ namespace PcapDotNet.Packets.Transport
             return Length >= HeaderLength;
         }
 
+        internal override void ResetCache()
+        {
+            _dns = null;
+            base.ResetCache();
+        }
+
         private DnsDatagram _dns;
     }
 }
\ No newline at end of file